@@ -0,0 +1,165 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addressindex.h>
+
+#include <crypto/sha256.h>
+#include <memusage.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <undo.h>
+#include <util.h>
+
+static const char DB_ADDRESS_OUTPUT = 'a';
+
+std::unique_ptr<CAddressIndex> paddressindex;
+
+uint256 AddressIndexScriptHash(const CScript& scriptPubKey)
+{
+    uint256 hash;
+    CSHA256().Write(scriptPubKey.data(), scriptPubKey.size()).Finalize(hash.begin());
+    return hash;
+}
+
+static bool IsIndexed(const CScript& scriptPubKey)
+{
+    return !scriptPubKey.empty() && !scriptPubKey.IsUnspendable();
+}
+
+CAddressIndex::CAddressIndex(size_t nCacheSize, bool fMemory, bool fWipe)
+    : db(GetDataDir() / "blocks" / "index" / "address", nCacheSize, fMemory, fWipe)
+{
+}
+
+void CAddressIndex::ConnectBlock(const CBlock& block, const CBlockUndo& blockUndo, int nHeight)
+{
+    assert(blockUndo.vtxundo.size() + 1 == block.vtx.size());
+
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256& txid = tx.GetHash();
+
+        // Mark the outputs spent first: an output spent by a later
+        // transaction in the same block is then marked after its creation
+        if (i > 0) {
+            const CTxUndo& txundo = blockUndo.vtxundo[i - 1];
+            assert(txundo.vprevout.size() == tx.vin.size());
+            for (size_t j = 0; j < tx.vin.size(); j++) {
+                const Coin& coin = txundo.vprevout[j];
+                if (!IsIndexed(coin.out.scriptPubKey))
+                    continue;
+                const COutPoint& prevout = tx.vin[j].prevout;
+                CAddressIndexValue& value = mapPending[CAddressIndexKey(AddressIndexScriptHash(coin.out.scriptPubKey), coin.nHeight, prevout.hash, prevout.n)];
+                value = CAddressIndexValue(coin.out.nValue);
+                value.spentTxid = txid;
+                value.nSpentIndex = j;
+                value.nSpentHeight = nHeight;
+            }
+        }
+
+        for (size_t o = 0; o < tx.vout.size(); o++) {
+            const CTxOut& txout = tx.vout[o];
+            if (!IsIndexed(txout.scriptPubKey))
+                continue;
+            mapPending[CAddressIndexKey(AddressIndexScriptHash(txout.scriptPubKey), nHeight, txid, o)] = CAddressIndexValue(txout.nValue);
+        }
+    }
+}
+
+void CAddressIndex::DisconnectBlock(const CBlock& block, const CBlockUndo& blockUndo, int nHeight)
+{
+    assert(blockUndo.vtxundo.size() + 1 == block.vtx.size());
+
+    // In reverse order, so outputs created and spent within the block end up erased
+    for (size_t i = block.vtx.size(); i-- > 0;) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256& txid = tx.GetHash();
+
+        for (size_t o = 0; o < tx.vout.size(); o++) {
+            const CTxOut& txout = tx.vout[o];
+            if (!IsIndexed(txout.scriptPubKey))
+                continue;
+            mapPending[CAddressIndexKey(AddressIndexScriptHash(txout.scriptPubKey), nHeight, txid, o)] = CAddressIndexValue();
+        }
+
+        if (i > 0) {
+            const CTxUndo& txundo = blockUndo.vtxundo[i - 1];
+            assert(txundo.vprevout.size() == tx.vin.size());
+            for (size_t j = 0; j < tx.vin.size(); j++) {
+                const Coin& coin = txundo.vprevout[j];
+                if (!IsIndexed(coin.out.scriptPubKey))
+                    continue;
+                const COutPoint& prevout = tx.vin[j].prevout;
+                mapPending[CAddressIndexKey(AddressIndexScriptHash(coin.out.scriptPubKey), coin.nHeight, prevout.hash, prevout.n)] = CAddressIndexValue(coin.out.nValue);
+            }
+        }
+    }
+}
+
+bool CAddressIndex::Flush()
+{
+    if (mapPending.empty())
+        return true;
+
+    CDBBatch batch(db);
+    for (const auto& entry : mapPending) {
+        if (entry.second.IsNull()) {
+            batch.Erase(std::make_pair(DB_ADDRESS_OUTPUT, entry.first));
+        } else {
+            batch.Write(std::make_pair(DB_ADDRESS_OUTPUT, entry.first), entry.second);
+        }
+    }
+    LogPrint(BCLog::COINDB, "Writing %u address index entries\n", mapPending.size());
+    if (!db.WriteBatch(batch))
+        return false;
+    mapPending.clear();
+    return true;
+}
+
+size_t CAddressIndex::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(mapPending);
+}
+
+void CAddressIndex::ForEachOutput(const uint256& scriptHash, const EntryFunc& fn) const
+{
+    const CAddressIndexKey start(scriptHash, 0, uint256(), 0);
+
+    // Merge the database entries with the pending changes, which take
+    // precedence. Both are sorted the same way.
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(DB_ADDRESS_OUTPUT, start));
+    auto itPending = mapPending.lower_bound(start);
+
+    std::pair<char, CAddressIndexKey> dbKey;
+    CAddressIndexValue dbValue;
+    bool fDB = false;
+    auto readDB = [&] {
+        fDB = pcursor->Valid() && pcursor->GetKey(dbKey) && dbKey.first == DB_ADDRESS_OUTPUT &&
+              dbKey.second.scriptHash == scriptHash && pcursor->GetValue(dbValue);
+    };
+    readDB();
+
+    while (true) {
+        bool fPending = itPending != mapPending.end() && itPending->first.scriptHash == scriptHash;
+        if (!fDB && !fPending)
+            break;
+
+        if (fPending && (!fDB || !(dbKey.second < itPending->first))) {
+            if (fDB && !(itPending->first < dbKey.second)) {
+                // Same output: the pending change replaces the database entry
+                pcursor->Next();
+                readDB();
+            }
+            if (!itPending->second.IsNull() && !fn(itPending->first, itPending->second))
+                return;
+            ++itPending;
+        } else {
+            if (!fn(dbKey.second, dbValue))
+                return;
+            pcursor->Next();
+            readDB();
+        }
+    }
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ADDRESSINDEX_H
+#define BITCOIN_ADDRESSINDEX_H
+
+#include <amount.h>
+#include <crypto/common.h>
+#include <dbwrapper.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdint.h>
+
+class CBlock;
+class CBlockUndo;
+class CScript;
+
+static const bool DEFAULT_ADDRESSINDEX = false;
+//! Max memory allocated to the address index DB specific cache in MiB
+static const int64_t nMaxAddressIndexCache = 1024;
+
+/** Hash identifying an output script in the address index: SHA256 of the script */
+uint256 AddressIndexScriptHash(const CScript& scriptPubKey);
+
+/**
+ * An output in the address index, ordered by output script, then by the
+ * height of the block creating it. Serialized big endian, so the database
+ * iterates the outputs of a script in chain order.
+ */
+struct CAddressIndexKey
+{
+    uint256 scriptHash;
+    uint32_t nHeight;
+    uint256 txid;
+    uint32_t nOut;
+
+    CAddressIndexKey() : nHeight(0), nOut(0) {}
+    CAddressIndexKey(const uint256& scriptHashIn, uint32_t nHeightIn, const uint256& txidIn, uint32_t nOutIn)
+        : scriptHash(scriptHashIn), nHeight(nHeightIn), txid(txidIn), nOut(nOutIn) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        unsigned char buf[4];
+        s << scriptHash;
+        WriteBE32(buf, nHeight);
+        s.write((const char*)buf, 4);
+        s << txid;
+        WriteBE32(buf, nOut);
+        s.write((const char*)buf, 4);
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        unsigned char buf[4];
+        s >> scriptHash;
+        s.read((char*)buf, 4);
+        nHeight = ReadBE32(buf);
+        s >> txid;
+        s.read((char*)buf, 4);
+        nOut = ReadBE32(buf);
+    }
+
+    friend bool operator<(const CAddressIndexKey& a, const CAddressIndexKey& b)
+    {
+        int cmp = a.scriptHash.Compare(b.scriptHash);
+        if (cmp != 0) return cmp < 0;
+        if (a.nHeight != b.nHeight) return a.nHeight < b.nHeight;
+        cmp = a.txid.Compare(b.txid);
+        if (cmp != 0) return cmp < 0;
+        return a.nOut < b.nOut;
+    }
+};
+
+/** Value of an output in the address index, and the input spending it if any */
+struct CAddressIndexValue
+{
+    CAmount nValue;
+    //! spending transaction, null while unspent
+    uint256 spentTxid;
+    uint32_t nSpentIndex;
+    uint32_t nSpentHeight;
+
+    CAddressIndexValue() : nValue(-1), nSpentIndex(0), nSpentHeight(0) {}
+    explicit CAddressIndexValue(CAmount nValueIn) : nValue(nValueIn), nSpentIndex(0), nSpentHeight(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nValue);
+        READWRITE(spentTxid);
+        READWRITE(nSpentIndex);
+        READWRITE(nSpentHeight);
+    }
+
+    bool IsSpent() const { return !spentTxid.IsNull(); }
+    //! Null values mark pending erasures
+    bool IsNull() const { return nValue == -1; }
+};
+
+/**
+ * Optional index (-addressindex) of the outputs paying each output script,
+ * with the input spending them, for per-address history, balance and
+ * unspent output queries.
+ *
+ * It is updated by ConnectBlock() and DisconnectBlock() from the block and
+ * its undo data. Changes are collected in memory and only written to the
+ * database by Flush(), which FlushStateToDisk() calls right before flushing
+ * the coins cache, so the index costs one batched write per flush instead of
+ * a database write per block. Entries are plain values, so blocks connected
+ * again after a crash just rewrite them.
+ *
+ * All methods require cs_main.
+ */
+class CAddressIndex
+{
+public:
+    typedef std::function<bool(const CAddressIndexKey&, const CAddressIndexValue&)> EntryFunc;
+
+    CAddressIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    CAddressIndex(const CAddressIndex&) = delete;
+    CAddressIndex& operator=(const CAddressIndex&) = delete;
+
+    /** Index the outputs a block creates and mark those it spends. blockUndo holds the spent coins. */
+    void ConnectBlock(const CBlock& block, const CBlockUndo& blockUndo, int nHeight);
+    /** Revert ConnectBlock() */
+    void DisconnectBlock(const CBlock& block, const CBlockUndo& blockUndo, int nHeight);
+
+    /** Write pending changes to the database */
+    bool Flush();
+
+    /** Memory used by pending changes */
+    size_t DynamicMemoryUsage() const;
+
+    /**
+     * Call fn for the outputs of a script in chain order, including pending
+     * changes, until it returns false.
+     */
+    void ForEachOutput(const uint256& scriptHash, const EntryFunc& fn) const;
+
+private:
+    //! mutable for the iterators of the const lookups
+    mutable CDBWrapper db;
+    std::map<CAddressIndexKey, CAddressIndexValue> mapPending;
+};
+
+/** The address index, if enabled with -addressindex */
+extern std::unique_ptr<CAddressIndex> paddressindex;
+
+#endif // BITCOIN_ADDRESSINDEX_H
@@ -0,0 +1,93 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addressindex.h>
+#include <bench/bench.h>
+#include <chainparamsbase.h>
+#include <fs.h>
+#include <pubkey.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <script/standard.h>
+#include <undo.h>
+#include <util.h>
+
+// Measures what -addressindex adds to connecting a block: indexing a
+// synthetic block of 500 transactions with two inputs and two outputs each,
+// and writing the changes to an on-disk database, either batched over ten
+// blocks as FlushStateToDisk typically does or after every block.
+
+static const int BENCH_TXS_PER_BLOCK = 500;
+
+static CScript RandomScript()
+{
+    uint160 hash;
+    GetRandBytes(hash.begin(), hash.size());
+    return GetScriptForDestination(CKeyID(hash));
+}
+
+static void BuildBlock(CBlock& block, CBlockUndo& blockUndo)
+{
+    std::vector<CScript> vScripts;
+    for (int i = 0; i < 100; i++)
+        vScripts.push_back(RandomScript());
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(50 * COIN, vScripts[0]);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    for (int i = 0; i < BENCH_TXS_PER_BLOCK; i++) {
+        CMutableTransaction tx;
+        CTxUndo txundo;
+        for (int j = 0; j < 2; j++) {
+            tx.vin.emplace_back(COutPoint(GetRandHash(), j));
+            txundo.vprevout.emplace_back(CTxOut(COIN, vScripts[GetRand(vScripts.size())]), 1 + GetRand(1000), false);
+        }
+        tx.vout.emplace_back(COIN, vScripts[GetRand(vScripts.size())]);
+        tx.vout.emplace_back(COIN, RandomScript());
+        block.vtx.push_back(MakeTransactionRef(tx));
+        blockUndo.vtxundo.push_back(txundo);
+    }
+}
+
+static void AddressIndexConnect(benchmark::State& state, int nFlushInterval)
+{
+    fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    gArgs.ForceSetArg("-datadir", dir.string());
+    fs::create_directories(dir);
+    SelectBaseParams(CBaseChainParams::MAIN);
+    ClearDatadirCache();
+
+    CBlock block;
+    CBlockUndo blockUndo;
+    BuildBlock(block, blockUndo);
+
+    {
+        CAddressIndex index(8 << 20, false, true);
+        int nHeight = 1000;
+        while (state.KeepRunning()) {
+            index.ConnectBlock(block, blockUndo, nHeight++);
+            if (nHeight % nFlushInterval == 0)
+                assert(index.Flush());
+        }
+        assert(index.Flush());
+    }
+
+    fs::remove_all(dir);
+    ClearDatadirCache();
+}
+
+static void AddressIndexConnectBatched(benchmark::State& state)
+{
+    AddressIndexConnect(state, 10);
+}
+
+static void AddressIndexConnectFlushEach(benchmark::State& state)
+{
+    AddressIndexConnect(state, 1);
+}
+
+BENCHMARK(AddressIndexConnectBatched, 200);
+BENCHMARK(AddressIndexConnectFlushEach, 100);
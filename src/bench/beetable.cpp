@@ -0,0 +1,100 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <base58.h>
+#include <chainparams.h>
+#include <random.h>
+#include <wallet/wallet.h>
+
+// The hive miner's view of a wallet with 50k BCTs spread over the blocks
+// of a bee lifespan. BeeTableBins slices and bins the bees able to mine on
+// the tip, as BusyBees now does for each new tip. BeeTableConnect adds and
+// removes a block's worth of BCTs, as block notifications do.
+// BeeRoundStrings is the per-BCT string work BusyBees used to redo on every
+// tip through GetBCTs (not counting the wallet scan itself), for comparison.
+
+static const int BENCH_BCTS = 50000;
+static const int BENCH_BINS = 8;
+
+static CBeeTableEntry MakeEntry(FastRandomContext& rng, int nHeight, const Consensus::Params& params)
+{
+    CBeeTableEntry entry;
+    entry.txid = rng.rand256();
+    entry.honeyDestination = CKeyID(uint160(rng.randbytes(20)));
+    entry.communityContrib = rng.randbool();
+    entry.beeCount = 1 + rng.randrange(1000);
+    entry.nHeight = nHeight;
+    entry.nMatureHeight = nHeight + params.beeGestationBlocks;
+    entry.nExpiryHeight = nHeight + params.beeGestationBlocks + params.beeLifespanBlocks - 1;
+    return entry;
+}
+
+static int FillTable(CBeeTable& table)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& params = Params().GetConsensus();
+    const int nSpan = params.beeGestationBlocks + params.beeLifespanBlocks;
+    FastRandomContext rng(true);
+    for (int i = 0; i < BENCH_BCTS; i++)
+        table.Add(MakeEntry(rng, (int)rng.randrange(nSpan), params));
+    return nSpan;
+}
+
+static void BeeTableBins(benchmark::State& state)
+{
+    CBeeTable table;
+    int nTipHeight = FillTable(table);
+    std::vector<std::vector<CBeeRange>> vBins;
+    while (state.KeepRunning()) {
+        int nBees = table.GetBins(nTipHeight, BENCH_BINS, vBins);
+        assert(nBees > 0);
+    }
+}
+
+static void BeeTableConnect(benchmark::State& state)
+{
+    CBeeTable table;
+    int nTipHeight = FillTable(table);
+    const Consensus::Params& params = Params().GetConsensus();
+    FastRandomContext rng(true);
+    std::vector<CBeeTableEntry> vBlock;
+    for (int i = 0; i < 10; i++)
+        vBlock.push_back(MakeEntry(rng, nTipHeight + 1, params));
+    while (state.KeepRunning()) {
+        for (const CBeeTableEntry& entry : vBlock)
+            table.Add(entry);
+        for (const CBeeTableEntry& entry : vBlock)
+            table.Remove(entry.txid);
+    }
+}
+
+static void BeeRoundStrings(benchmark::State& state)
+{
+    CBeeTable table;
+    int nTipHeight = FillTable(table);
+    const Consensus::Params& params = Params().GetConsensus();
+    FastRandomContext rng(true);
+    std::vector<CBeeTableEntry> vEntries;
+    for (int i = 0; i < BENCH_BCTS; i++)
+        vEntries.push_back(MakeEntry(rng, (int)rng.randrange(nTipHeight), params));
+    while (state.KeepRunning()) {
+        std::vector<CBeeCreationTransactionInfo> bcts;
+        for (const CBeeTableEntry& entry : vEntries) {
+            CBeeCreationTransactionInfo bct;
+            bct.txid = entry.txid.GetHex();
+            bct.honeyAddress = EncodeDestination(entry.honeyDestination);
+            bct.beeCount = entry.beeCount;
+            bct.communityContrib = entry.communityContrib;
+            bct.beeStatus = nTipHeight < entry.nMatureHeight ? "immature" : nTipHeight > entry.nExpiryHeight ? "expired" : "mature";
+            if (bct.beeStatus == "mature")
+                bcts.push_back(bct);
+        }
+        assert(!bcts.empty());
+    }
+}
+
+BENCHMARK(BeeTableBins, 200);
+BENCHMARK(BeeTableConnect, 200);
+BENCHMARK(BeeRoundStrings, 5);
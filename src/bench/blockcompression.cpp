@@ -0,0 +1,178 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <blockcompression.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <streams.h>
+#include <undo.h>
+
+#include <stdio.h>
+
+namespace block_bench {
+#include <bench/data/block413567.raw.h>
+} // namespace block_bench
+
+// Compares block and undo records as -blockcompression writes them with
+// the plain serialization: encoding (write) and decoding (read) the bench
+// block of 3808 transactions, and undo data for it with coins drawn from
+// its outputs. The record sizes are printed once.
+
+static const int BENCH_BLOCK_HEIGHT = 878439;
+
+static CBlock LoadBlock()
+{
+    CDataStream stream((const char*)block_bench::block413567,
+            (const char*)&block_bench::block413567[sizeof(block_bench::block413567)],
+            SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+    return block;
+}
+
+static std::vector<CScript> Dictionary()
+{
+    SelectParams(CBaseChainParams::MAIN);
+    return GetBlockScriptDictionary(Params().GetConsensus());
+}
+
+static CBlockUndo BuildUndo(const CBlock& block)
+{
+    // Spent coins reuse the block's own output scripts and amounts, at
+    // depths from a few blocks to a few months
+    std::vector<CTxOut> vOutputs;
+    for (const CTransactionRef& tx : block.vtx)
+        vOutputs.insert(vOutputs.end(), tx->vout.begin(), tx->vout.end());
+
+    CBlockUndo blockundo;
+    size_t n = 0;
+    for (size_t i = 1; i < block.vtx.size(); i++) {
+        CTxUndo txundo;
+        for (size_t j = 0; j < block.vtx[i]->vin.size(); j++, n++)
+            txundo.vprevout.emplace_back(vOutputs[(n * 7919) % vOutputs.size()], BENCH_BLOCK_HEIGHT - 1 - (n * n) % 100000, n % 50 == 0);
+        blockundo.vtxundo.push_back(txundo);
+    }
+    return blockundo;
+}
+
+static void ReportFootprint()
+{
+    static bool fReported = false;
+    if (fReported)
+        return;
+    fReported = true;
+
+    CBlock block = LoadBlock();
+    CBlockUndo blockundo = BuildUndo(block);
+    std::vector<CScript> vDictionary = Dictionary();
+    std::vector<unsigned char> vchBlock, vchUndo;
+    assert(CompressBlock(block, vDictionary, vchBlock));
+    assert(CompressBlockUndo(blockundo, BENCH_BLOCK_HEIGHT, vDictionary, vchUndo));
+
+    size_t nRawBlock = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+    size_t nRawUndo = ::GetSerializeSize(blockundo, SER_DISK, CLIENT_VERSION);
+    printf("# block record: %u bytes raw, %u bytes compressed (%.1f%%)\n", (unsigned int)nRawBlock, (unsigned int)vchBlock.size(), 100.0 * vchBlock.size() / nRawBlock);
+    printf("# undo record: %u bytes raw, %u bytes compact (%.1f%%)\n", (unsigned int)nRawUndo, (unsigned int)vchUndo.size(), 100.0 * vchUndo.size() / nRawUndo);
+}
+
+static void BlockStorageWriteRaw(benchmark::State& state)
+{
+    ReportFootprint();
+    CBlock block = LoadBlock();
+    std::vector<unsigned char> vch;
+    while (state.KeepRunning()) {
+        vch.clear();
+        CVectorWriter(SER_DISK, CLIENT_VERSION, vch, 0, block);
+    }
+}
+
+static void BlockStorageWriteCompressed(benchmark::State& state)
+{
+    ReportFootprint();
+    CBlock block = LoadBlock();
+    std::vector<CScript> vDictionary = Dictionary();
+    std::vector<unsigned char> vch;
+    while (state.KeepRunning()) {
+        assert(CompressBlock(block, vDictionary, vch));
+    }
+}
+
+static void BlockStorageReadRaw(benchmark::State& state)
+{
+    ReportFootprint();
+    std::vector<unsigned char> vch;
+    CVectorWriter(SER_DISK, CLIENT_VERSION, vch, 0, LoadBlock());
+    while (state.KeepRunning()) {
+        CBlock block;
+        CVectorReader(SER_DISK, CLIENT_VERSION, vch, 0) >> block;
+    }
+}
+
+static void BlockStorageReadCompressed(benchmark::State& state)
+{
+    ReportFootprint();
+    std::vector<CScript> vDictionary = Dictionary();
+    std::vector<unsigned char> vch;
+    assert(CompressBlock(LoadBlock(), vDictionary, vch));
+    while (state.KeepRunning()) {
+        CBlock block;
+        DecompressBlock(vch, vDictionary, block);
+    }
+}
+
+static void UndoStorageWriteRaw(benchmark::State& state)
+{
+    ReportFootprint();
+    CBlockUndo blockundo = BuildUndo(LoadBlock());
+    std::vector<unsigned char> vch;
+    while (state.KeepRunning()) {
+        vch.clear();
+        CVectorWriter(SER_DISK, CLIENT_VERSION, vch, 0, blockundo);
+    }
+}
+
+static void UndoStorageWriteCompact(benchmark::State& state)
+{
+    ReportFootprint();
+    CBlockUndo blockundo = BuildUndo(LoadBlock());
+    std::vector<CScript> vDictionary = Dictionary();
+    std::vector<unsigned char> vch;
+    while (state.KeepRunning()) {
+        assert(CompressBlockUndo(blockundo, BENCH_BLOCK_HEIGHT, vDictionary, vch));
+    }
+}
+
+static void UndoStorageReadRaw(benchmark::State& state)
+{
+    ReportFootprint();
+    std::vector<unsigned char> vch;
+    CVectorWriter(SER_DISK, CLIENT_VERSION, vch, 0, BuildUndo(LoadBlock()));
+    while (state.KeepRunning()) {
+        CBlockUndo blockundo;
+        CVectorReader(SER_DISK, CLIENT_VERSION, vch, 0) >> blockundo;
+    }
+}
+
+static void UndoStorageReadCompact(benchmark::State& state)
+{
+    ReportFootprint();
+    std::vector<CScript> vDictionary = Dictionary();
+    std::vector<unsigned char> vch;
+    assert(CompressBlockUndo(BuildUndo(LoadBlock()), BENCH_BLOCK_HEIGHT, vDictionary, vch));
+    while (state.KeepRunning()) {
+        CBlockUndo blockundo;
+        DecompressBlockUndo(vch, BENCH_BLOCK_HEIGHT, vDictionary, blockundo);
+    }
+}
+
+BENCHMARK(BlockStorageWriteRaw, 200);
+BENCHMARK(BlockStorageWriteCompressed, 50);
+BENCHMARK(BlockStorageReadRaw, 130);
+BENCHMARK(BlockStorageReadCompressed, 100);
+BENCHMARK(UndoStorageWriteRaw, 200);
+BENCHMARK(UndoStorageWriteCompact, 50);
+BENCHMARK(UndoStorageReadRaw, 130);
+BENCHMARK(UndoStorageReadCompact, 100);
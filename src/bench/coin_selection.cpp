@@ -57,3 +57,87 @@ static void CoinSelection(benchmark::State& state)
 }
 
 BENCHMARK(CoinSelection, 650);
+
+// Large-wallet scenarios: a hive wallet accumulates one small honey output per
+// mined block, so selection has to cope with very large numbers of similar
+// coins. The wallet is built once; each run only performs the selection.
+static const int LARGE_WALLET_COINS = 100000;
+
+static void buildLargeWallet(const CWallet& wallet, std::vector<COutput>& vCoins)
+{
+    vCoins.reserve(LARGE_WALLET_COINS);
+    for (int i = 0; i < LARGE_WALLET_COINS; i++)
+        addCoin((1 + i % 97) * CENT + i % 13, wallet, vCoins);
+}
+
+static void freeLargeWallet(std::vector<COutput>& vCoins)
+{
+    for (COutput output : vCoins)
+        delete output.tx;
+    vCoins.clear();
+}
+
+static void CoinSelectionLargeWalletBnB(benchmark::State& state)
+{
+    const CWallet wallet;
+    std::vector<COutput> vCoins;
+    LOCK(wallet.cs_wallet);
+    buildLargeWallet(wallet, vCoins);
+
+    CoinSelectionParams params;
+    params.use_bnb = true;
+    params.nCostOfChange = 2000;
+
+    while (state.KeepRunning()) {
+        std::set<CInputCoin> setCoinsRet;
+        CAmount nValueRet;
+        bool fBnBUsed;
+        bool success = wallet.SelectCoinsMinConf(25 * COIN, 1, 6, 0, vCoins, setCoinsRet, nValueRet, &params, &fBnBUsed);
+        assert(success);
+        assert(fBnBUsed);
+        assert(nValueRet >= 25 * COIN && nValueRet <= 25 * COIN + params.nCostOfChange);
+    }
+    freeLargeWallet(vCoins);
+}
+
+static void CoinSelectionLargeWalletKnapsack(benchmark::State& state)
+{
+    const CWallet wallet;
+    std::vector<COutput> vCoins;
+    LOCK(wallet.cs_wallet);
+    buildLargeWallet(wallet, vCoins);
+
+    while (state.KeepRunning()) {
+        std::set<CInputCoin> setCoinsRet;
+        CAmount nValueRet;
+        bool success = wallet.SelectCoinsMinConf(25 * COIN, 1, 6, 0, vCoins, setCoinsRet, nValueRet);
+        assert(success);
+        assert(nValueRet >= 25 * COIN);
+    }
+    freeLargeWallet(vCoins);
+}
+
+static void CoinSelectionLargeWalletHighFee(benchmark::State& state)
+{
+    const CWallet wallet;
+    std::vector<COutput> vCoins;
+    LOCK(wallet.cs_wallet);
+    buildLargeWallet(wallet, vCoins);
+
+    // Above the consolidation feerate the fallback takes the fewest inputs
+    CoinSelectionParams params;
+    params.effective_fee = CFeeRate(10 * DEFAULT_CONSOLIDATE_FEERATE);
+
+    while (state.KeepRunning()) {
+        std::set<CInputCoin> setCoinsRet;
+        CAmount nValueRet;
+        bool success = wallet.SelectCoinsMinConf(25 * COIN, 1, 6, 0, vCoins, setCoinsRet, nValueRet, &params);
+        assert(success);
+        assert(nValueRet >= 25 * COIN);
+    }
+    freeLargeWallet(vCoins);
+}
+
+BENCHMARK(CoinSelectionLargeWalletBnB, 5);
+BENCHMARK(CoinSelectionLargeWalletKnapsack, 5);
+BENCHMARK(CoinSelectionLargeWalletHighFee, 5);
@@ -0,0 +1,75 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <fs.h>
+#include <random.h>
+#include <uint256.h>
+
+// Compares the -dbprofile settings on a chainstate-like workload: loading
+// batches of coin-sized entries under random outpoint keys as a reindex
+// flushes them, and random lookups afterwards, on the tables the load left
+// behind and after the compaction the node runs once initial sync is done.
+
+static const size_t BENCH_DB_CACHE = 8 << 20;
+static const int BENCH_BATCH_ENTRIES = 5000;
+
+static void WriteBatch(CDBWrapper& db, std::vector<uint256>& vKeys)
+{
+    std::vector<unsigned char> vchCoin(40, 0x5a);
+    CDBBatch batch(db);
+    for (int i = 0; i < BENCH_BATCH_ENTRIES; i++) {
+        vKeys.push_back(GetRandHash());
+        batch.Write(std::make_pair('C', vKeys.back()), vchCoin);
+    }
+    db.WriteBatch(batch);
+}
+
+static void DBBulkLoad(benchmark::State& state, DBProfile profile)
+{
+    fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    {
+        CDBWrapper db(dir, BENCH_DB_CACHE, false, true, false, profile);
+        std::vector<uint256> vKeys;
+        while (state.KeepRunning()) {
+            WriteBatch(db, vKeys);
+        }
+    }
+    fs::remove_all(dir);
+}
+
+static void DBRandomRead(benchmark::State& state, bool fCompact)
+{
+    fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    {
+        CDBWrapper db(dir, BENCH_DB_CACHE, false, true, false, DBProfile::IBD);
+        std::vector<uint256> vKeys;
+        for (int i = 0; i < 40; i++)
+            WriteBatch(db, vKeys);
+        if (fCompact)
+            db.CompactFull();
+
+        std::vector<unsigned char> vchCoin;
+        while (state.KeepRunning()) {
+            for (int i = 0; i < 100; i++) {
+                bool fFound = db.Read(std::make_pair('C', vKeys[GetRand(vKeys.size())]), vchCoin);
+                assert(fFound);
+            }
+        }
+    }
+    fs::remove_all(dir);
+}
+
+static void DBBulkLoadSteady(benchmark::State& state) { DBBulkLoad(state, DBProfile::STEADY); }
+static void DBBulkLoadIBD(benchmark::State& state) { DBBulkLoad(state, DBProfile::IBD); }
+static void DBBulkLoadLowMemory(benchmark::State& state) { DBBulkLoad(state, DBProfile::LOW_MEMORY); }
+static void DBRandomReadUncompacted(benchmark::State& state) { DBRandomRead(state, false); }
+static void DBRandomReadCompacted(benchmark::State& state) { DBRandomRead(state, true); }
+
+BENCHMARK(DBBulkLoadSteady, 40);
+BENCHMARK(DBBulkLoadIBD, 40);
+BENCHMARK(DBBulkLoadLowMemory, 40);
+BENCHMARK(DBRandomReadUncompacted, 500);
+BENCHMARK(DBRandomReadCompacted, 500);
@@ -0,0 +1,124 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <rpc/blockchain.h>
+
+// Runs the difficulty functions at the tip of a synthetic index of 1M
+// blocks: 1000 legacy blocks followed by a MinotaurX-era mix of sha256d,
+// MinotaurX and hive blocks. DifficultyHiveHeaderWalk is the hive
+// retarget walk as it was written before block types were packed into
+// CBlockIndex, building every block's header, for comparison.
+
+static const int BENCH_INDEX_BLOCKS = 1000000;
+static const int BENCH_LEGACY_BLOCKS = 1000;
+
+static const CBlockIndex* GetBenchTip()
+{
+    static std::vector<CBlockIndex> vIndex;
+    static std::vector<uint256> vHashes;
+    if (!vIndex.empty())
+        return &vIndex.back();
+
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& params = Params().GetConsensus();
+    vIndex.resize(BENCH_INDEX_BLOCKS);
+    vHashes.resize(BENCH_INDEX_BLOCKS);
+    for (int i = 0; i < BENCH_INDEX_BLOCKS; i++) {
+        CBlockIndex& block = vIndex[i];
+        vHashes[i] = ArithToUint256(arith_uint256(i));
+        block.phashBlock = &vHashes[i];
+        block.pprev = i ? &vIndex[i - 1] : nullptr;
+        block.nHeight = i;
+        block.nTime = 1530000000 + i * params.nPowTargetSpacing;
+        if (i < BENCH_LEGACY_BLOCKS) {
+            block.nVersion = 0x20000000;
+            block.nBits = UintToArith256(params.powTypeLimits[POW_TYPE_SHA256]).GetCompact();
+        } else {
+            // Roughly two pow blocks of each type for each hive block
+            int nSlot = (i % 11) * 7 % 11;
+            if (nSlot < 9) {
+                POW_TYPE powType = nSlot < 5 ? POW_TYPE_SHA256 : POW_TYPE_MINOTAURX;
+                block.nVersion = 0x10000000 | (powType << 16);
+                block.nBits = UintToArith256(params.powTypeLimits[powType]).GetCompact();
+            } else {
+                block.nVersion = 0x10000000;
+                block.nNonce = params.hiveNonceMarker;
+                block.nBits = UintToArith256(params.powLimitHive).GetCompact();
+            }
+        }
+        if (block.pprev)
+            block.BuildSkip();
+        block.BuildBlockType(params);
+        if (i == BENCH_LEGACY_BLOCKS - 1)
+            block.nBlockType |= BLOCK_TYPE_MINOTAURX;
+    }
+    return &vIndex.back();
+}
+
+static void DifficultyLWMA(benchmark::State& state)
+{
+    const CBlockIndex* pindexTip = GetBenchTip();
+    CBlockHeader header;
+    header.nTime = pindexTip->nTime + Params().GetConsensus().nPowTargetSpacing;
+    while (state.KeepRunning()) {
+        GetNextWorkRequiredLWMA(pindexTip, &header, Params().GetConsensus(), POW_TYPE_SHA256);
+        GetNextWorkRequiredLWMA(pindexTip, &header, Params().GetConsensus(), POW_TYPE_MINOTAURX);
+    }
+}
+
+static void DifficultyHive(benchmark::State& state)
+{
+    const CBlockIndex* pindexTip = GetBenchTip();
+    while (state.KeepRunning()) {
+        GetNextHiveWorkRequired(pindexTip, Params().GetConsensus());
+    }
+}
+
+static void DifficultyHiveHeaderWalk(benchmark::State& state)
+{
+    const CBlockIndex* pindexTip = GetBenchTip();
+    const Consensus::Params& params = Params().GetConsensus();
+    while (state.KeepRunning()) {
+        const CBlockIndex* pindex = pindexTip;
+        arith_uint256 beeHashTarget = 0;
+        int hiveBlockCount = 0;
+        while (hiveBlockCount < params.hiveDifficultyWindow && pindex->pprev) {
+            if (pindex->GetBlockHeader().IsHiveMined(params)) {
+                beeHashTarget += arith_uint256().SetCompact(pindex->nBits);
+                hiveBlockCount++;
+            }
+            pindex = pindex->pprev;
+        }
+        assert(hiveBlockCount == params.hiveDifficultyWindow);
+    }
+}
+
+static void DifficultyGetDifficulty(benchmark::State& state)
+{
+    const CBlockIndex* pindexTip = GetBenchTip();
+    while (state.KeepRunning()) {
+        GetDifficulty(pindexTip, true);
+        GetDifficulty(pindexTip, false, POW_TYPE_SHA256);
+        GetDifficulty(pindexTip, false, POW_TYPE_MINOTAURX);
+    }
+}
+
+static void DifficultyBlockProof(benchmark::State& state)
+{
+    const CBlockIndex* pindexTip = GetBenchTip();
+    while (state.KeepRunning()) {
+        for (const CBlockIndex* pindex = pindexTip; pindex->nHeight > pindexTip->nHeight - 10; pindex = pindex->pprev)
+            GetBlockProofK(*pindex);
+    }
+}
+
+BENCHMARK(DifficultyLWMA, 2000);
+BENCHMARK(DifficultyHive, 20000);
+BENCHMARK(DifficultyHiveHeaderWalk, 20000);
+BENCHMARK(DifficultyGetDifficulty, 20000);
+BENCHMARK(DifficultyBlockProof, 20000);
@@ -0,0 +1,70 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <miner.h>
+#include <primitives/block.h>
+
+// Each iteration solves one block header at regtest difficulty (nBits
+// 0x207fffff, so about two hashes a block), as generate and
+// generatetoaddress do, with a new merkle root each time. Blocks/minute is
+// 60 over the seconds per iteration. GenerateGetPoWHash* are the old
+// single-threaded search, calling CBlockHeader::GetPoWHash() for every
+// nonce; GenerateSolve* use the nonce search engine on 1 and 4 threads.
+
+static const uint32_t REGTEST_NBITS = 0x207fffff;
+static const uint32_t BENCH_NONCE_END = 0x10000;
+
+static CBlockHeader GetBenchHeader(POW_TYPE powType)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    CBlockHeader header;
+    header.nVersion = 0x10000000 | (powType << 16);
+    header.hashPrevBlock = ArithToUint256(arith_uint256(1));
+    header.nTime = Params().GetConsensus().powForkTime + 1;
+    header.nBits = REGTEST_NBITS;
+    return header;
+}
+
+static void GenerateGetPoWHash(benchmark::State& state, POW_TYPE powType)
+{
+    CBlockHeader header = GetBenchHeader(powType);
+    arith_uint256 bnTarget = arith_uint256().SetCompact(header.nBits);
+    uint64_t nBlock = 0;
+    while (state.KeepRunning()) {
+        header.hashMerkleRoot = ArithToUint256(arith_uint256(++nBlock));
+        header.nNonce = 0;
+        while (header.nNonce < BENCH_NONCE_END && UintToArith256(header.GetPoWHash()) > bnTarget)
+            ++header.nNonce;
+        assert(header.nNonce < BENCH_NONCE_END);
+    }
+}
+
+static void GenerateSolve(benchmark::State& state, POW_TYPE powType, int nThreads)
+{
+    CBlockHeader header = GetBenchHeader(powType);
+    uint64_t nBlock = 0;
+    while (state.KeepRunning()) {
+        header.hashMerkleRoot = ArithToUint256(arith_uint256(++nBlock));
+        uint64_t nMaxTries = BENCH_NONCE_END;
+        bool fSolved = SolveBlockNonce(header, Params().GetConsensus(), nThreads, BENCH_NONCE_END, nMaxTries);
+        assert(fSolved);
+    }
+}
+
+static void GenerateGetPoWHashSHA256d(benchmark::State& state) { GenerateGetPoWHash(state, POW_TYPE_SHA256); }
+static void GenerateGetPoWHashMinotaurX(benchmark::State& state) { GenerateGetPoWHash(state, POW_TYPE_MINOTAURX); }
+static void GenerateSolveSHA256dThreads1(benchmark::State& state) { GenerateSolve(state, POW_TYPE_SHA256, 1); }
+static void GenerateSolveSHA256dThreads4(benchmark::State& state) { GenerateSolve(state, POW_TYPE_SHA256, 4); }
+static void GenerateSolveMinotaurXThreads1(benchmark::State& state) { GenerateSolve(state, POW_TYPE_MINOTAURX, 1); }
+static void GenerateSolveMinotaurXThreads4(benchmark::State& state) { GenerateSolve(state, POW_TYPE_MINOTAURX, 4); }
+
+BENCHMARK(GenerateGetPoWHashSHA256d, 20000);
+BENCHMARK(GenerateGetPoWHashMinotaurX, 50);
+BENCHMARK(GenerateSolveSHA256dThreads1, 20000);
+BENCHMARK(GenerateSolveSHA256dThreads4, 2000);
+BENCHMARK(GenerateSolveMinotaurXThreads1, 50);
+BENCHMARK(GenerateSolveMinotaurXThreads4, 50);
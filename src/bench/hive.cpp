@@ -0,0 +1,311 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <base58.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <consensus/merkle.h>
+#include <fs.h>
+#include <key.h>
+#include <miner.h>
+#include <pow.h>
+#include <script/standard.h>
+#include <util.h>
+#include <validation.h>
+#include <wallet/wallet.h>
+
+// The hive hot paths on a synthetic main chain of 1000 blocks, held in a
+// temporary datadir. Every third block is a hive block, which only the index
+// knows about. The other blocks are written to a block file, each with a few
+// BCTs paying honey to a single key. The key and times are fixed, so the
+// chain and every seed are the same from run to run.
+//
+// HiveCheckBin and HiveCheckBinMinotaur hash one bin of 10000 bees against
+// an impossible target with CheckBin and CheckBinMinotaur, so bees/sec is
+// 10000 over the time per iteration.
+// HiveCheckBeeBins is the part of BusyBees that follows the wallet lookup:
+// binning the chain's mature bees and checking the bins, with a fixed seed
+// and target, until a bee meets the target.
+// HiveProofUTXO and HiveProofDeepDrill check a hive block on the tip. The
+// first claims a bee of a BCT in the UTXO set. The second claims a bee of a
+// BCT that can only be found by reading its block, as when reindexing.
+// HiveNetworkInfo counts the network's bees, reading the chain's pow blocks.
+// GetNextHiveWorkRequired is covered by DifficultyHive in difficulty.cpp.
+
+static const int BENCH_HIVE_BLOCKS = 1000;
+static const int BENCH_BCTS_PER_BLOCK = 4;
+static const int BENCH_BEES_PER_BCT = 1000;
+static const int BENCH_BCT_HEIGHT = 30;             // mature on the tip, and a pow block
+static const int BENCH_BIN_RANGES = 10;
+static const int BENCH_SOLUTION_BEES = 20000;       // bees per solution for HiveCheckBeeBins
+static const int64_t BENCH_HIVE_TIME = 1650000000;  // tip time, after MinotaurX activation
+
+struct BenchHiveChain
+{
+    fs::path dir;
+    CKey key;
+    std::vector<CBlockIndex> vIndex;
+    std::vector<uint256> vHashes;
+    std::vector<CBeeTableEntry> vBCTs;
+    CCoinsView viewEmpty;
+    CBlock blockUTXO;
+    CBlock blockDeepDrill;
+
+    BenchHiveChain();
+    ~BenchHiveChain();
+};
+
+static CMutableTransaction MakeBCT(const CScript& scriptPubKeyHoney, CAmount totalBeeCost, bool communityContrib, const COutPoint& prevout, const Consensus::Params& params)
+{
+    // As CWallet::CreateBeeTransaction builds them, once MinotaurX is enabled
+    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(params.beeCreationAddress));
+    scriptPubKeyBCF << OP_RETURN << OP_BEE;
+    scriptPubKeyBCF += scriptPubKeyHoney;
+    CAmount donationValue = totalBeeCost / params.communityContribFactor;
+    donationValue += donationValue >> 1;
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = prevout;
+    tx.vout.emplace_back(communityContrib ? totalBeeCost - donationValue : totalBeeCost, scriptPubKeyBCF);
+    if (communityContrib)
+        tx.vout.emplace_back(donationValue, GetScriptForDestination(DecodeDestination(params.hiveCommunityAddress)));
+    return tx;
+}
+
+static CBlock MakeHiveBlock(const CBlockIndex* pindexPrev, const CTransaction& bct, int nBCTHeight, const CKey& key, const Consensus::Params& params)
+{
+    // Find the first bee of the BCT meeting the target, as CheckHiveProof hashes it
+    std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
+    arith_uint256 beeHashTarget;
+    beeHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, params));
+    std::string txid = bct.GetHash().GetHex();
+    uint32_t beeNonce = 0;
+    while (arith_uint256(CBlockHeader::MinotaurHashString(deterministicRandString + txid + std::to_string(beeNonce)).ToString()) >= beeHashTarget)
+        beeNonce++;
+    assert(beeNonce < (uint32_t)BENCH_BEES_PER_BCT);
+
+    std::vector<unsigned char> messageProofVec;
+    bool fSigned = key.SignCompact((CHashWriter(SER_GETHASH, 0) << deterministicRandString).GetHash(), messageProofVec);
+    assert(fSigned);
+
+    // The proof script as BusyBees assembles it
+    unsigned char beeNonceEncoded[4];
+    WriteLE32(beeNonceEncoded, beeNonce);
+    unsigned char bctHeightEncoded[4];
+    WriteLE32(bctHeightEncoded, nBCTHeight);
+    CScript hiveProofScript;
+    hiveProofScript << OP_RETURN << OP_BEE << std::vector<unsigned char>(beeNonceEncoded, beeNonceEncoded + 4)
+        << std::vector<unsigned char>(bctHeightEncoded, bctHeightEncoded + 4) << (bct.vout.size() > 1 ? OP_TRUE : OP_FALSE)
+        << std::vector<unsigned char>(txid.begin(), txid.end()) << messageProofVec;
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript() << (pindexPrev->nHeight + 1) << OP_0;
+    coinbase.vout.emplace_back(0, hiveProofScript);
+    coinbase.vout.emplace_back(GetBlockSubsidy(pindexPrev->nHeight + 1, params), GetScriptForDestination(key.GetPubKey().GetID()));
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+    block.nVersion = 0x10000000;
+    block.hashPrevBlock = pindexPrev->GetBlockHash();
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.nTime = pindexPrev->nTime + params.nPowTargetSpacing;
+    block.nBits = GetNextHiveWorkRequired(pindexPrev, params);
+    block.nNonce = params.hiveNonceMarker;
+    return block;
+}
+
+BenchHiveChain::BenchHiveChain()
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& params = Params().GetConsensus();
+    dir = fs::temp_directory_path() / fs::unique_path();
+    gArgs.ForceSetArg("-datadir", dir.string());
+    ClearDatadirCache();
+    SetMockTime(BENCH_HIVE_TIME);
+
+    uint256 secret = ArithToUint256(arith_uint256(1));
+    key.Set(secret.begin(), secret.end(), true);
+    CScript scriptPubKeyHoney = GetScriptForDestination(key.GetPubKey().GetID());
+    CTransactionRef bctUTXO, bctDeepDrill;
+
+    LOCK(cs_main);
+    pcoinsTip.reset(new CCoinsViewCache(&viewEmpty));
+    vIndex.resize(BENCH_HIVE_BLOCKS);
+    vHashes.resize(BENCH_HIVE_BLOCKS);
+    CAutoFile fileout(OpenBlockFile(CDiskBlockPos(0, 0)), SER_DISK, CLIENT_VERSION);
+    assert(!fileout.IsNull());
+    int64_t nTime = BENCH_HIVE_TIME - (BENCH_HIVE_BLOCKS - 1) * params.nPowTargetSpacing;
+    for (int i = 0; i < BENCH_HIVE_BLOCKS; i++) {
+        CBlock block;
+        block.nVersion = 0x10000000;
+        block.hashPrevBlock = i ? vHashes[i - 1] : uint256();
+        block.nTime = nTime + i * params.nPowTargetSpacing;
+        bool fHive = i % 3 == 2;
+        if (fHive) {
+            block.hashMerkleRoot = ArithToUint256(arith_uint256(i));
+            block.nBits = UintToArith256(params.powLimitHive).GetCompact();
+            block.nNonce = params.hiveNonceMarker;
+        } else {
+            CMutableTransaction coinbase;
+            coinbase.vin.resize(1);
+            coinbase.vin[0].prevout.SetNull();
+            coinbase.vin[0].scriptSig = CScript() << i << OP_0;
+            coinbase.vout.emplace_back(GetBlockSubsidy(i, params), scriptPubKeyHoney);
+            block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+            for (int j = 0; j < BENCH_BCTS_PER_BLOCK; j++) {
+                CTransactionRef bct = MakeTransactionRef(MakeBCT(scriptPubKeyHoney, BENCH_BEES_PER_BCT * GetBeeCost(i, params), j % 2 == 0, COutPoint(block.vtx[0]->GetHash(), j), params));
+                block.vtx.push_back(bct);
+                vBCTs.push_back({bct->GetHash(), key.GetPubKey().GetID(), bct->vout.size() > 1, BENCH_BEES_PER_BCT,
+                    i, i + params.beeGestationBlocks, i + params.beeGestationBlocks + params.beeLifespanBlocks - 1});
+            }
+            block.hashMerkleRoot = BlockMerkleRoot(block);
+            // A sha256d block at the highest pow limit, which CheckProofOfWork accepts for any pow type
+            block.nBits = UintToArith256(params.powTypeLimits[POW_TYPE_MINOTAURX]).GetCompact();
+            block.nNonce = params.hiveNonceMarker + 1;
+            while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, params))
+                block.nNonce++;
+            if (i == BENCH_BCT_HEIGHT) {
+                bctUTXO = block.vtx[1];
+                bctDeepDrill = block.vtx[3];
+            }
+        }
+
+        CBlockIndex& index = vIndex[i];
+        index = CBlockIndex(block.GetBlockHeader());
+        vHashes[i] = block.GetHash();
+        index.phashBlock = &vHashes[i];
+        index.pprev = i ? &vIndex[i - 1] : nullptr;
+        index.nHeight = i;
+        index.nStatus = BLOCK_VALID_SCRIPTS;
+        if (!fHive) {
+            fileout << FLATDATA(Params().MessageStart()) << (unsigned int)GetSerializeSize(fileout, block);
+            index.nFile = 0;
+            index.nDataPos = ftell(fileout.Get());
+            index.nStatus |= BLOCK_HAVE_DATA;
+            index.nTx = block.vtx.size();
+            fileout << block;
+        }
+        if (index.pprev)
+            index.BuildSkip();
+        index.BuildBlockType(params);
+        if (i == 0)
+            index.nBlockType |= BLOCK_TYPE_MINOTAURX;
+        mapBlockIndex[vHashes[i]] = &index;
+    }
+    fileout.fclose();
+    chainActive.SetTip(&vIndex.back());
+    bool fInitialDownload = IsInitialBlockDownload();   // latches to false for the tip time
+    assert(!fInitialDownload);
+    SetMockTime(0);
+
+    // Only one of the BCTs claimed by the hive blocks is in the UTXO set
+    for (unsigned int n = 0; n < bctUTXO->vout.size(); n++)
+        pcoinsTip->AddCoin(COutPoint(bctUTXO->GetHash(), n), Coin(bctUTXO->vout[n], BENCH_BCT_HEIGHT, false), false);
+    blockUTXO = MakeHiveBlock(chainActive.Tip(), *bctUTXO, BENCH_BCT_HEIGHT, key, params);
+    blockDeepDrill = MakeHiveBlock(chainActive.Tip(), *bctDeepDrill, BENCH_BCT_HEIGHT, key, params);
+}
+
+BenchHiveChain::~BenchHiveChain()
+{
+    {
+        LOCK(cs_main);
+        chainActive.SetTip(nullptr);
+        mapBlockIndex.clear();
+        pcoinsTip.reset();
+    }
+    fs::remove_all(dir);
+}
+
+static const BenchHiveChain& GetBenchHiveChain()
+{
+    static BenchHiveChain chain;
+    return chain;
+}
+
+static std::vector<CBeeRange> GetBenchBin()
+{
+    std::vector<CBeeRange> bin;
+    for (int i = 0; i < BENCH_BIN_RANGES; i++)
+        bin.push_back({ArithToUint256(arith_uint256(i + 1)), CKeyID(), i % 2 == 0, 0, BENCH_BEES_PER_BCT});
+    return bin;
+}
+
+static void HiveCheckBin(benchmark::State& state)
+{
+    const BenchHiveChain& chain = GetBenchHiveChain();
+    std::string deterministicRandString = GetDeterministicRandString(&chain.vIndex.back());
+    std::vector<CBeeRange> bin = GetBenchBin();
+    while (state.KeepRunning()) {
+        CheckBeeBins({bin}, deterministicRandString, arith_uint256(0), false);
+    }
+}
+
+static void HiveCheckBinMinotaur(benchmark::State& state)
+{
+    const BenchHiveChain& chain = GetBenchHiveChain();
+    std::string deterministicRandString = GetDeterministicRandString(&chain.vIndex.back());
+    std::vector<CBeeRange> bin = GetBenchBin();
+    while (state.KeepRunning()) {
+        CheckBeeBins({bin}, deterministicRandString, arith_uint256(0), true);
+    }
+}
+
+static void HiveCheckBeeBins(benchmark::State& state)
+{
+    const BenchHiveChain& chain = GetBenchHiveChain();
+    const CBlockIndex* pindexTip = &chain.vIndex.back();
+    std::string deterministicRandString = GetDeterministicRandString(pindexTip);
+    arith_uint256 beeHashTarget = ~arith_uint256(0) / BENCH_SOLUTION_BEES;
+    CBeeTable table;
+    for (const CBeeTableEntry& entry : chain.vBCTs)
+        table.Add(entry);
+    std::vector<std::vector<CBeeRange>> beeBins;
+    while (state.KeepRunning()) {
+        int nBees = table.GetBins(pindexTip->nHeight, GetNumVirtualCores(), beeBins);
+        assert(nBees > BENCH_SOLUTION_BEES);
+        bool fSolved = CheckBeeBins(beeBins, deterministicRandString, beeHashTarget, true);
+        assert(fSolved);
+    }
+}
+
+static void HiveProofUTXO(benchmark::State& state)
+{
+    const BenchHiveChain& chain = GetBenchHiveChain();
+    while (state.KeepRunning()) {
+        bool fValid = CheckHiveProof(&chain.blockUTXO, Params().GetConsensus());
+        assert(fValid);
+    }
+}
+
+static void HiveProofDeepDrill(benchmark::State& state)
+{
+    const BenchHiveChain& chain = GetBenchHiveChain();
+    while (state.KeepRunning()) {
+        bool fValid = CheckHiveProof(&chain.blockDeepDrill, Params().GetConsensus());
+        assert(fValid);
+    }
+}
+
+static void HiveNetworkInfo(benchmark::State& state)
+{
+    GetBenchHiveChain();
+    int immatureBees, immatureBCTs, matureBees, matureBCTs;
+    CAmount potentialLifespanRewards;
+    while (state.KeepRunning()) {
+        bool fCounted = GetNetworkHiveInfo(immatureBees, immatureBCTs, matureBees, matureBCTs, potentialLifespanRewards, Params().GetConsensus());
+        assert(fCounted && matureBCTs > 0);
+    }
+}
+
+BENCHMARK(HiveCheckBin, 20);
+BENCHMARK(HiveCheckBinMinotaur, 5);
+BENCHMARK(HiveCheckBeeBins, 2);
+BENCHMARK(HiveProofUTXO, 500);
+BENCHMARK(HiveProofDeepDrill, 200);
+BENCHMARK(HiveNetworkInfo, 20);
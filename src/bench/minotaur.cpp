@@ -0,0 +1,234 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <crypto/minotaurx/minotaur.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <util.h>
+#include <utilstrencodings.h>
+#include <version.h>
+
+#include <iostream>
+
+#include <boost/thread.hpp>
+
+// Each iteration is one hash, except in the threaded benches, so hashes/sec
+// is the inverse of the time per iteration.
+//
+// MinotaurAlgo* run each of the 16 torture garden algos on a 64-byte input.
+// YespowerFreshLocal sets up and frees the yespower memory for every hash,
+// YespowerReusedLocal reuses one region, as the hive miner threads can, and
+// YespowerTLS leaves the region to yespower's thread-local storage, as
+// header validation does. MinotaurHeader and MinotaurXHeader hash a block
+// header with a new nonce each time, and MinotaurXHeaderHasher does the same
+// through a MinotaurHeaderHasher with its own yespower region, as the nonce
+// search does. MinotaurXThreads* hash 64 headers
+// split over 1, 2, 4 and 8 threads, each with its own yespower region, so
+// hashes/sec is 64 over the time per iteration.
+//
+// With -minotaurpaths, the header benches count the algos run and the paths
+// taken through the garden, and print the counts on exit.
+
+static const int BENCH_THREAD_HEADERS = 64;
+
+static const char* ALGO_NAMES[MINOTAUR_ALGO_COUNT + 1] = {
+    "blake", "bmw", "cubehash", "echo", "fugue", "groestl", "hamsi", "sha512",
+    "jh", "keccak", "luffa", "shabal", "shavite", "simd", "skein", "whirlpool", "yespower"
+};
+
+static struct MinotaurPathReport
+{
+    MinotaurStats stats = {};
+
+    ~MinotaurPathReport()
+    {
+        if (!stats.hashes)
+            return;
+        std::cout << "# Minotaur garden over " << stats.hashes << " hashes" << std::endl;
+        std::cout << "# Algo, runs, runs per hash" << std::endl;
+        for (int i = 0; i <= MINOTAUR_ALGO_COUNT; i++)
+            std::cout << ALGO_NAMES[i] << ", " << stats.algoRuns[i] << ", " << (double)stats.algoRuns[i] / stats.hashes << std::endl;
+        std::cout << "# Path (turns, first turn first), hashes, share" << std::endl;
+        for (int i = 0; i < 64; i++) {
+            std::string turns;
+            for (int n = 0; n < 6; n++)
+                turns += (i >> n) & 1 ? 'R' : 'L';
+            std::cout << turns << ", " << stats.paths[i] << ", " << (double)stats.paths[i] / stats.hashes << std::endl;
+        }
+    }
+} pathReport;
+
+static MinotaurStats* GetPathStats()
+{
+    return gArgs.GetBoolArg("-minotaurpaths", false) ? &pathReport.stats : nullptr;
+}
+
+static CBlockHeader GetBenchHeader()
+{
+    SelectParams(CBaseChainParams::MAIN);
+    CBlockHeader header;
+    header.nVersion = 0x10000000 | (POW_TYPE_MINOTAURX << 16);
+    header.hashPrevBlock = ArithToUint256(arith_uint256(1));
+    header.hashMerkleRoot = ArithToUint256(arith_uint256(2));
+    header.nTime = Params().GetConsensus().powForkTime + 1;
+    header.nBits = UintToArith256(Params().GetConsensus().powTypeLimits[POW_TYPE_MINOTAURX]).GetCompact();
+    header.nNonce = 0;
+    return header;
+}
+
+static void MinotaurAlgo(benchmark::State& state, unsigned int algo)
+{
+    TortureGarden garden;
+    uint512 hash;
+    while (state.KeepRunning()) {
+        hash = GetHash(hash, &garden, algo, NULL);
+    }
+}
+
+static void MinotaurAlgoBlake(benchmark::State& state) { MinotaurAlgo(state, 0); }
+static void MinotaurAlgoBMW(benchmark::State& state) { MinotaurAlgo(state, 1); }
+static void MinotaurAlgoCubeHash(benchmark::State& state) { MinotaurAlgo(state, 2); }
+static void MinotaurAlgoEcho(benchmark::State& state) { MinotaurAlgo(state, 3); }
+static void MinotaurAlgoFugue(benchmark::State& state) { MinotaurAlgo(state, 4); }
+static void MinotaurAlgoGroestl(benchmark::State& state) { MinotaurAlgo(state, 5); }
+static void MinotaurAlgoHamsi(benchmark::State& state) { MinotaurAlgo(state, 6); }
+static void MinotaurAlgoSHA512(benchmark::State& state) { MinotaurAlgo(state, 7); }
+static void MinotaurAlgoJH(benchmark::State& state) { MinotaurAlgo(state, 8); }
+static void MinotaurAlgoKeccak(benchmark::State& state) { MinotaurAlgo(state, 9); }
+static void MinotaurAlgoLuffa(benchmark::State& state) { MinotaurAlgo(state, 10); }
+static void MinotaurAlgoShabal(benchmark::State& state) { MinotaurAlgo(state, 11); }
+static void MinotaurAlgoSHAvite(benchmark::State& state) { MinotaurAlgo(state, 12); }
+static void MinotaurAlgoSIMD(benchmark::State& state) { MinotaurAlgo(state, 13); }
+static void MinotaurAlgoSkein(benchmark::State& state) { MinotaurAlgo(state, 14); }
+static void MinotaurAlgoWhirlpool(benchmark::State& state) { MinotaurAlgo(state, 15); }
+
+static void YespowerFreshLocal(benchmark::State& state)
+{
+    uint512 hash, output;
+    while (state.KeepRunning()) {
+        yespower_local_t local;
+        yespower_init_local(&local);
+        yespower(&local, hash.begin(), 64, &yespower_params, (yespower_binary_t*)output.begin());
+        hash = output;
+        yespower_free_local(&local);
+    }
+}
+
+static void YespowerReusedLocal(benchmark::State& state)
+{
+    uint512 hash, output;
+    yespower_local_t local;
+    yespower_init_local(&local);
+    while (state.KeepRunning()) {
+        yespower(&local, hash.begin(), 64, &yespower_params, (yespower_binary_t*)output.begin());
+        hash = output;
+    }
+    yespower_free_local(&local);
+}
+
+static void YespowerTLS(benchmark::State& state)
+{
+    uint512 hash, output;
+    while (state.KeepRunning()) {
+        yespower_tls(hash.begin(), 64, &yespower_params, (yespower_binary_t*)output.begin());
+        hash = output;
+    }
+}
+
+static void MinotaurHeader(benchmark::State& state)
+{
+    CBlockHeader header = GetBenchHeader();
+    MinotaurStats* stats = GetPathStats();
+    while (state.KeepRunning()) {
+        Minotaur(BEGIN(header.nVersion), END(header.nNonce), false, NULL, stats);
+        header.nNonce++;
+    }
+}
+
+static void MinotaurXHeader(benchmark::State& state)
+{
+    CBlockHeader header = GetBenchHeader();
+    MinotaurStats* stats = GetPathStats();
+    while (state.KeepRunning()) {
+        Minotaur(BEGIN(header.nVersion), END(header.nNonce), true, NULL, stats);
+        header.nNonce++;
+    }
+}
+
+static void MinotaurXHeaderHasher(benchmark::State& state)
+{
+    CBlockHeader header = GetBenchHeader();
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << header;
+    std::vector<unsigned char> prefix(ss.begin(), ss.begin() + MinotaurHeaderHasher::PREFIX_SIZE);
+    MinotaurStats* stats = GetPathStats();
+    yespower_local_t local;
+    yespower_init_local(&local);
+    {
+        MinotaurHeaderHasher hasher(prefix.data(), true, &local);
+        while (state.KeepRunning()) {
+            hasher.Hash(header.nNonce, stats);
+            header.nNonce++;
+        }
+    }
+    yespower_free_local(&local);
+}
+
+static void HashHeaders(CBlockHeader header, int nThread, int nThreads)
+{
+    yespower_local_t local;
+    yespower_init_local(&local);
+    for (int i = nThread; i < BENCH_THREAD_HEADERS; i += nThreads) {
+        header.nNonce = i;
+        Minotaur(BEGIN(header.nVersion), END(header.nNonce), true, &local);
+    }
+    yespower_free_local(&local);
+}
+
+static void MinotaurXThreads(benchmark::State& state, int nThreads)
+{
+    CBlockHeader header = GetBenchHeader();
+    while (state.KeepRunning()) {
+        std::vector<boost::thread> threads;
+        for (int i = 0; i < nThreads; i++)
+            threads.push_back(boost::thread(HashHeaders, header, i, nThreads));
+        for (auto& t : threads)
+            t.join();
+    }
+}
+
+static void MinotaurXThreads1(benchmark::State& state) { MinotaurXThreads(state, 1); }
+static void MinotaurXThreads2(benchmark::State& state) { MinotaurXThreads(state, 2); }
+static void MinotaurXThreads4(benchmark::State& state) { MinotaurXThreads(state, 4); }
+static void MinotaurXThreads8(benchmark::State& state) { MinotaurXThreads(state, 8); }
+
+BENCHMARK(MinotaurAlgoBlake, 20000);
+BENCHMARK(MinotaurAlgoBMW, 20000);
+BENCHMARK(MinotaurAlgoCubeHash, 20000);
+BENCHMARK(MinotaurAlgoEcho, 20000);
+BENCHMARK(MinotaurAlgoFugue, 20000);
+BENCHMARK(MinotaurAlgoGroestl, 20000);
+BENCHMARK(MinotaurAlgoHamsi, 20000);
+BENCHMARK(MinotaurAlgoSHA512, 20000);
+BENCHMARK(MinotaurAlgoJH, 20000);
+BENCHMARK(MinotaurAlgoKeccak, 20000);
+BENCHMARK(MinotaurAlgoLuffa, 20000);
+BENCHMARK(MinotaurAlgoShabal, 20000);
+BENCHMARK(MinotaurAlgoSHAvite, 20000);
+BENCHMARK(MinotaurAlgoSIMD, 20000);
+BENCHMARK(MinotaurAlgoSkein, 20000);
+BENCHMARK(MinotaurAlgoWhirlpool, 20000);
+BENCHMARK(YespowerFreshLocal, 50);
+BENCHMARK(YespowerReusedLocal, 50);
+BENCHMARK(YespowerTLS, 50);
+BENCHMARK(MinotaurHeader, 2000);
+BENCHMARK(MinotaurXHeader, 50);
+BENCHMARK(MinotaurXHeaderHasher, 50);
+BENCHMARK(MinotaurXThreads1, 2);
+BENCHMARK(MinotaurXThreads2, 2);
+BENCHMARK(MinotaurXThreads4, 2);
+BENCHMARK(MinotaurXThreads8, 2);
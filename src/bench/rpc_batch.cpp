@@ -0,0 +1,124 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparamsbase.h>
+#include <httprpc.h>
+#include <httpserver.h>
+#include <rpc/server.h>
+#include <support/events.h>
+#include <util.h>
+#include <utilstrencodings.h>
+#include <utiltime.h>
+
+#include <event2/buffer.h>
+#include <event2/http.h>
+
+#include <assert.h>
+
+// Drives a JSON-RPC batch through a local HTTP server. Each call waits a
+// couple of milliseconds, standing in for calls like getblock that mostly
+// wait on disk, so the benchmark shows how well a batch is spread over the
+// RPC threads rather than measuring raw CPU throughput.
+
+static const int BENCH_RPC_PORT = 19932;
+static const int BENCH_BATCH_SIZE = 64;
+
+static UniValue benchwait(const JSONRPCRequest& request)
+{
+    MilliSleep(2);
+    return request.params.size() ? request.params[0] : NullUniValue;
+}
+
+static const CRPCCommand benchCommand = { "hidden", "benchwait", &benchwait, {"value"} };
+
+struct BenchReply
+{
+    int status = 0;
+    std::string body;
+};
+
+static void bench_request_done(struct evhttp_request* req, void* ctx)
+{
+    BenchReply* reply = static_cast<BenchReply*>(ctx);
+    if (req == nullptr)
+        return;
+    reply->status = evhttp_request_get_response_code(req);
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    size_t size = evbuffer_get_length(buf);
+    reply->body = std::string((const char*)evbuffer_pullup(buf, size), size);
+}
+
+static BenchReply PostRPC(const std::string& strRequest)
+{
+    raii_event_base base = obtain_event_base();
+    raii_evhttp_connection evcon = obtain_evhttp_connection_base(base.get(), "127.0.0.1", BENCH_RPC_PORT);
+
+    BenchReply reply;
+    raii_evhttp_request req = obtain_evhttp_request(bench_request_done, (void*)&reply);
+    struct evkeyvalq* headers = evhttp_request_get_output_headers(req.get());
+    evhttp_add_header(headers, "Host", "127.0.0.1");
+    evhttp_add_header(headers, "Connection", "close");
+    evhttp_add_header(headers, "Authorization", ("Basic " + EncodeBase64("bench:bench")).c_str());
+    evbuffer_add(evhttp_request_get_output_buffer(req.get()), strRequest.data(), strRequest.size());
+    int r = evhttp_make_request(evcon.get(), req.get(), EVHTTP_REQ_POST, "/");
+    req.release(); // ownership moved to evcon in above call
+    assert(r == 0);
+    event_base_dispatch(base.get());
+    return reply;
+}
+
+static void RunBatch(benchmark::State& state, int nBatchThreads)
+{
+    SelectBaseParams(CBaseChainParams::MAIN);
+    gArgs.ForceSetArg("-rpcuser", "bench");
+    gArgs.ForceSetArg("-rpcpassword", "bench");
+    gArgs.ForceSetArg("-rpcport", std::to_string(BENCH_RPC_PORT));
+    gArgs.ForceSetArg("-rpcthreads", "4");
+    gArgs.ForceSetArg("-rpcbatchthreads", std::to_string(nBatchThreads));
+    tableRPC.appendCommand(benchCommand.name, &benchCommand);
+
+    bool fStarted = InitHTTPServer() && StartRPC() && StartHTTPRPC() && StartHTTPServer();
+    assert(fStarted);
+    if (RPCIsInWarmup(nullptr))
+        SetRPCWarmupFinished();
+
+    UniValue batch(UniValue::VARR);
+    for (int i = 0; i < BENCH_BATCH_SIZE; i++) {
+        UniValue params(UniValue::VARR);
+        params.push_back(i);
+        batch.push_back(JSONRPCRequestObj("benchwait", params, i));
+    }
+    std::string strRequest = batch.write();
+
+    while (state.KeepRunning()) {
+        BenchReply reply = PostRPC(strRequest);
+        assert(reply.status == HTTP_OK);
+        UniValue result;
+        bool fParsed = result.read(reply.body);
+        assert(fParsed && result.size() == (size_t)BENCH_BATCH_SIZE);
+        // Replies come back in request order
+        assert(result[BENCH_BATCH_SIZE - 1]["result"].get_int() == BENCH_BATCH_SIZE - 1);
+    }
+
+    InterruptHTTPServer();
+    InterruptHTTPRPC();
+    InterruptRPC();
+    StopHTTPRPC();
+    StopRPC();
+    StopHTTPServer();
+}
+
+static void RPCBatchSequential(benchmark::State& state)
+{
+    RunBatch(state, 1);
+}
+
+static void RPCBatchParallel(benchmark::State& state)
+{
+    RunBatch(state, 0);
+}
+
+BENCHMARK(RPCBatchSequential, 5);
+BENCHMARK(RPCBatchParallel, 5);
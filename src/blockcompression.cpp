@@ -0,0 +1,415 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockcompression.h>
+
+#include <amount.h>
+#include <base58.h>
+#include <clientversion.h>
+#include <compressor.h>
+#include <consensus/params.h>
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <sync.h>
+#include <undo.h>
+#include <utilstrencodings.h>
+
+#include <map>
+
+/** Flags at the start of every compressed transaction */
+static const unsigned char TX_WITNESS = 0x01;           //!< witness data follows the outputs
+static const unsigned char TX_HIVE_PROOF = 0x02;        //!< the first output is a packed hive proof
+static const unsigned char TX_VERSION_1 = 0x04;         //!< nVersion is 1 and not stored
+static const unsigned char TX_VERSION_2 = 0x08;         //!< nVersion is 2 and not stored
+static const unsigned char TX_NO_LOCKTIME = 0x10;       //!< nLockTime is 0 and not stored
+
+/** Prevout hash codes; higher codes refer to an earlier transaction of the block */
+static const uint64_t PREVOUT_LITERAL = 0;
+static const uint64_t PREVOUT_NULL = 1;
+static const uint64_t PREVOUT_IN_BLOCK = 2;
+
+// Maza: Hive: A hive proof script holds the BCT txid as 64 hex characters in this range
+static const size_t HIVE_PROOF_TXID_BEGIN = 14;
+static const size_t HIVE_PROOF_TXID_END = 78;
+
+/**
+ * Output scripts already written in a record. Code 0 is followed by a new
+ * script (which is added), any other code is the index + 1 of a known one.
+ */
+class ScriptEncoder
+{
+private:
+    std::map<CScript, uint64_t> mapIndex;
+
+    void Add(const CScript& script)
+    {
+        mapIndex.emplace(script, mapIndex.size());
+    }
+
+public:
+    explicit ScriptEncoder(const std::vector<CScript>& vDictionary)
+    {
+        for (const CScript& script : vDictionary)
+            Add(script);
+    }
+
+    template <typename Stream>
+    void Write(Stream& s, const CScript& script)
+    {
+        auto it = mapIndex.find(script);
+        if (it != mapIndex.end()) {
+            uint64_t nCode = it->second + 1;
+            s << VARINT(nCode);
+            return;
+        }
+        uint64_t nCode = 0;
+        s << VARINT(nCode);
+        s << CScriptCompressor(REF(script));
+        Add(script);
+    }
+};
+
+class ScriptDecoder
+{
+private:
+    std::vector<CScript> vScripts;
+
+public:
+    explicit ScriptDecoder(const std::vector<CScript>& vDictionary) : vScripts(vDictionary) {}
+
+    template <typename Stream>
+    void Read(Stream& s, CScript& script)
+    {
+        uint64_t nCode = 0;
+        s >> VARINT(nCode);
+        if (nCode == 0) {
+            script.clear();
+            s >> REF(CScriptCompressor(script));
+            vScripts.push_back(script);
+        } else if (nCode <= vScripts.size()) {
+            script = vScripts[nCode - 1];
+        } else {
+            throw std::ios_base::failure("Unknown script reference");
+        }
+    }
+};
+
+/** Whether the script survives the CScriptCompressor round trip */
+static bool IsCompressibleScript(const CScript& script)
+{
+    return script.size() <= MAX_SCRIPT_SIZE;
+}
+
+static bool IsLowerHexDigit(unsigned char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+}
+
+// Maza: Hive: Whether the first output of a coinbase is a hive proof whose BCT txid can be packed
+static bool IsPackableHiveProof(const CTransaction& tx)
+{
+    if (!tx.IsCoinBase() || tx.vout.empty())
+        return false;
+    const CScript& script = tx.vout[0].scriptPubKey;
+    if (script.size() < HIVE_PROOF_TXID_END || script[0] != OP_RETURN || script[1] != OP_BEE)
+        return false;
+    for (size_t i = HIVE_PROOF_TXID_BEGIN; i < HIVE_PROOF_TXID_END; i++) {
+        if (!IsLowerHexDigit(script[i]))
+            return false;
+    }
+    return true;
+}
+
+template <typename Stream>
+static void WriteHiveProof(Stream& s, const CScript& script)
+{
+    s.write((const char*)script.data(), HIVE_PROOF_TXID_BEGIN);
+    std::vector<unsigned char> vchTxid = ParseHex(std::string(script.begin() + HIVE_PROOF_TXID_BEGIN, script.begin() + HIVE_PROOF_TXID_END));
+    s.write((const char*)vchTxid.data(), vchTxid.size());
+    std::vector<unsigned char> vchRest(script.begin() + HIVE_PROOF_TXID_END, script.end());
+    s << vchRest;
+}
+
+template <typename Stream>
+static void ReadHiveProof(Stream& s, CScript& script)
+{
+    const size_t nTxidSize = (HIVE_PROOF_TXID_END - HIVE_PROOF_TXID_BEGIN) / 2;
+    unsigned char pch[HIVE_PROOF_TXID_BEGIN + nTxidSize];
+    s.read((char*)pch, sizeof(pch));
+    std::vector<unsigned char> vchRest;
+    s >> vchRest;
+    std::string strTxid = HexStr(pch + HIVE_PROOF_TXID_BEGIN, pch + sizeof(pch));
+    script.assign(pch, pch + HIVE_PROOF_TXID_BEGIN);
+    script.insert(script.end(), strTxid.begin(), strTxid.end());
+    script.insert(script.end(), vchRest.begin(), vchRest.end());
+}
+
+template <typename Stream>
+static void WriteAmount(Stream& s, CAmount nValue)
+{
+    uint64_t nCompressed = CTxOutCompressor::CompressAmount(nValue);
+    s << VARINT(nCompressed);
+}
+
+template <typename Stream>
+static CAmount ReadAmount(Stream& s)
+{
+    uint64_t nCompressed = 0;
+    s >> VARINT(nCompressed);
+    return CTxOutCompressor::DecompressAmount(nCompressed);
+}
+
+/** Read a count of items that take at least a byte each, rejecting counts the input cannot hold */
+template <typename Stream>
+static uint64_t ReadCount(Stream& s)
+{
+    uint64_t nCount = ReadCompactSize(s);
+    if (nCount > s.size())
+        throw std::ios_base::failure("Count exceeds record size");
+    return nCount;
+}
+
+static bool CanCompressTransaction(const CTransaction& tx)
+{
+    for (const CTxOut& txout : tx.vout) {
+        if (!MoneyRange(txout.nValue) || !IsCompressibleScript(txout.scriptPubKey))
+            return false;
+    }
+    return true;
+}
+
+template <typename Stream>
+static void WriteTransaction(Stream& s, const CTransaction& tx, const std::map<uint256, uint64_t>& mapTxIndex, ScriptEncoder& scripts)
+{
+    const bool fHiveProof = IsPackableHiveProof(tx);
+
+    unsigned char nFlags = 0;
+    if (tx.HasWitness())
+        nFlags |= TX_WITNESS;
+    if (fHiveProof)
+        nFlags |= TX_HIVE_PROOF;
+    if (tx.nVersion == 1)
+        nFlags |= TX_VERSION_1;
+    else if (tx.nVersion == 2)
+        nFlags |= TX_VERSION_2;
+    if (tx.nLockTime == 0)
+        nFlags |= TX_NO_LOCKTIME;
+    s << nFlags;
+    if (!(nFlags & (TX_VERSION_1 | TX_VERSION_2)))
+        s << tx.nVersion;
+
+    WriteCompactSize(s, tx.vin.size());
+    for (const CTxIn& txin : tx.vin) {
+        uint64_t nCode = PREVOUT_LITERAL;
+        if (txin.prevout.hash.IsNull()) {
+            nCode = PREVOUT_NULL;
+        } else {
+            auto it = mapTxIndex.find(txin.prevout.hash);
+            if (it != mapTxIndex.end())
+                nCode = PREVOUT_IN_BLOCK + it->second;
+        }
+        s << VARINT(nCode);
+        if (nCode == PREVOUT_LITERAL)
+            s << txin.prevout.hash;
+        s << VARINT(txin.prevout.n);
+        s << txin.scriptSig;
+        // Final sequence numbers are by far the most common, complementing makes them small
+        uint32_t nSequence = ~txin.nSequence;
+        s << VARINT(nSequence);
+    }
+
+    WriteCompactSize(s, tx.vout.size());
+    for (size_t i = 0; i < tx.vout.size(); i++) {
+        WriteAmount(s, tx.vout[i].nValue);
+        if (i == 0 && fHiveProof)
+            WriteHiveProof(s, tx.vout[i].scriptPubKey);
+        else
+            scripts.Write(s, tx.vout[i].scriptPubKey);
+    }
+
+    if (nFlags & TX_WITNESS) {
+        for (const CTxIn& txin : tx.vin)
+            s << txin.scriptWitness.stack;
+    }
+
+    if (!(nFlags & TX_NO_LOCKTIME))
+        s << tx.nLockTime;
+}
+
+template <typename Stream>
+static CTransactionRef ReadTransaction(Stream& s, const std::vector<CTransactionRef>& vtx, ScriptDecoder& scripts)
+{
+    CMutableTransaction tx;
+
+    unsigned char nFlags;
+    s >> nFlags;
+    if (nFlags & TX_VERSION_1)
+        tx.nVersion = 1;
+    else if (nFlags & TX_VERSION_2)
+        tx.nVersion = 2;
+    else
+        s >> tx.nVersion;
+
+    tx.vin.resize(ReadCount(s));
+    for (CTxIn& txin : tx.vin) {
+        uint64_t nCode = 0;
+        s >> VARINT(nCode);
+        if (nCode == PREVOUT_LITERAL) {
+            s >> txin.prevout.hash;
+        } else if (nCode == PREVOUT_NULL) {
+            txin.prevout.hash.SetNull();
+        } else if (nCode - PREVOUT_IN_BLOCK < vtx.size()) {
+            txin.prevout.hash = vtx[nCode - PREVOUT_IN_BLOCK]->GetHash();
+        } else {
+            throw std::ios_base::failure("Unknown prevout reference");
+        }
+        s >> VARINT(txin.prevout.n);
+        s >> txin.scriptSig;
+        uint32_t nSequence = 0;
+        s >> VARINT(nSequence);
+        txin.nSequence = ~nSequence;
+    }
+
+    tx.vout.resize(ReadCount(s));
+    for (size_t i = 0; i < tx.vout.size(); i++) {
+        tx.vout[i].nValue = ReadAmount(s);
+        if (i == 0 && (nFlags & TX_HIVE_PROOF))
+            ReadHiveProof(s, tx.vout[i].scriptPubKey);
+        else
+            scripts.Read(s, tx.vout[i].scriptPubKey);
+    }
+
+    if (nFlags & TX_WITNESS) {
+        for (CTxIn& txin : tx.vin)
+            s >> txin.scriptWitness.stack;
+    }
+
+    if (nFlags & TX_NO_LOCKTIME)
+        tx.nLockTime = 0;
+    else
+        s >> tx.nLockTime;
+
+    return MakeTransactionRef(std::move(tx));
+}
+
+const std::vector<CScript>& GetBlockScriptDictionary(const Consensus::Params& consensusParams)
+{
+    // Decoding the addresses costs more than reading many records, and every
+    // block and undo record read or written needs the dictionary
+    static CCriticalSection cs_dictionary;
+    static std::map<uint256, std::vector<CScript>> mapDictionary;
+
+    LOCK(cs_dictionary);
+    auto it = mapDictionary.find(consensusParams.hashGenesisBlock);
+    if (it == mapDictionary.end()) {
+        std::vector<CScript> vDictionary;
+        vDictionary.push_back(GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress)));
+        vDictionary.push_back(GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress)));
+        it = mapDictionary.emplace(consensusParams.hashGenesisBlock, std::move(vDictionary)).first;
+    }
+    return it->second;
+}
+
+bool CompressBlock(const CBlock& block, const std::vector<CScript>& vDictionary, std::vector<unsigned char>& vch)
+{
+    for (const CTransactionRef& tx : block.vtx) {
+        if (!CanCompressTransaction(*tx))
+            return false;
+    }
+
+    vch.clear();
+    CVectorWriter s(SER_DISK, CLIENT_VERSION, vch, 0);
+    s << BLOCK_COMPRESSION_VERSION;
+    s << static_cast<const CBlockHeader&>(block);
+
+    ScriptEncoder scripts(vDictionary);
+    std::map<uint256, uint64_t> mapTxIndex;
+    WriteCompactSize(s, block.vtx.size());
+    for (const CTransactionRef& tx : block.vtx) {
+        WriteTransaction(s, *tx, mapTxIndex, scripts);
+        mapTxIndex.emplace(tx->GetHash(), mapTxIndex.size());
+    }
+    return true;
+}
+
+void DecompressBlock(const std::vector<unsigned char>& vch, const std::vector<CScript>& vDictionary, CBlock& block)
+{
+    CVectorReader s(SER_DISK, CLIENT_VERSION, vch, 0);
+    unsigned char nVersion;
+    s >> nVersion;
+    if (nVersion != BLOCK_COMPRESSION_VERSION)
+        throw std::ios_base::failure("Unknown block compression version");
+
+    block.SetNull();
+    s >> static_cast<CBlockHeader&>(block);
+
+    ScriptDecoder scripts(vDictionary);
+    uint64_t nTx = ReadCount(s);
+    block.vtx.reserve(nTx);
+    for (uint64_t i = 0; i < nTx; i++)
+        block.vtx.push_back(ReadTransaction(s, block.vtx, scripts));
+
+    if (!s.empty())
+        throw std::ios_base::failure("Compressed block has excess data");
+}
+
+bool CompressBlockUndo(const CBlockUndo& blockundo, int nHeight, const std::vector<CScript>& vDictionary, std::vector<unsigned char>& vch)
+{
+    for (const CTxUndo& txundo : blockundo.vtxundo) {
+        for (const Coin& coin : txundo.vprevout) {
+            if (coin.nHeight > (uint32_t)nHeight || !MoneyRange(coin.out.nValue) || !IsCompressibleScript(coin.out.scriptPubKey))
+                return false;
+        }
+    }
+
+    vch.clear();
+    CVectorWriter s(SER_DISK, CLIENT_VERSION, vch, 0);
+    s << BLOCK_COMPRESSION_VERSION;
+
+    ScriptEncoder scripts(vDictionary);
+    WriteCompactSize(s, blockundo.vtxundo.size());
+    for (const CTxUndo& txundo : blockundo.vtxundo) {
+        WriteCompactSize(s, txundo.vprevout.size());
+        for (const Coin& coin : txundo.vprevout) {
+            // Most spent coins are young, so their depth is much smaller than their height
+            uint64_t nCode = (uint64_t)(nHeight - coin.nHeight) * 2 + (coin.fCoinBase ? 1 : 0);
+            s << VARINT(nCode);
+            WriteAmount(s, coin.out.nValue);
+            scripts.Write(s, coin.out.scriptPubKey);
+        }
+    }
+    return true;
+}
+
+void DecompressBlockUndo(const std::vector<unsigned char>& vch, int nHeight, const std::vector<CScript>& vDictionary, CBlockUndo& blockundo)
+{
+    CVectorReader s(SER_DISK, CLIENT_VERSION, vch, 0);
+    unsigned char nVersion;
+    s >> nVersion;
+    if (nVersion != BLOCK_COMPRESSION_VERSION)
+        throw std::ios_base::failure("Unknown undo compression version");
+
+    ScriptDecoder scripts(vDictionary);
+    blockundo.vtxundo.resize(ReadCount(s));
+    for (CTxUndo& txundo : blockundo.vtxundo) {
+        uint64_t nCoins = ReadCount(s);
+        if (nCoins > MAX_INPUTS_PER_BLOCK)
+            throw std::ios_base::failure("Too many input undo records");
+        txundo.vprevout.resize(nCoins);
+        for (Coin& coin : txundo.vprevout) {
+            uint64_t nCode = 0;
+            s >> VARINT(nCode);
+            if (nCode / 2 > (uint64_t)nHeight)
+                throw std::ios_base::failure("Invalid undo coin height");
+            coin.nHeight = nHeight - nCode / 2;
+            coin.fCoinBase = nCode & 1;
+            coin.out.nValue = ReadAmount(s);
+            scripts.Read(s, coin.out.scriptPubKey);
+        }
+    }
+
+    if (!s.empty())
+        throw std::ios_base::failure("Compact undo data has excess data");
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKCOMPRESSION_H
+#define BITCOIN_BLOCKCOMPRESSION_H
+
+#include <script/script.h>
+
+#include <stdint.h>
+#include <vector>
+
+class CBlock;
+class CBlockUndo;
+
+namespace Consensus {
+struct Params;
+}
+
+/**
+ * Set in the size field of a blk*.dat or rev*.dat record header when the
+ * record holds a compressed block or compact undo data instead of the usual
+ * serialization. Block and undo records are far below 2^31 bytes, so the
+ * bit is never set by older versions.
+ */
+static const unsigned int DISK_RECORD_COMPRESSED = 0x80000000;
+
+/** Format of compressed block and compact undo records, the first byte of each */
+static const unsigned char BLOCK_COMPRESSION_VERSION = 1;
+
+/**
+ * Output scripts every compressed record can refer to by index: the bee
+ * creation and community fund scripts paid by BCTs and hive coinbases.
+ * Derived from consensus parameters only, so it never changes for a network
+ * and is built once per network.
+ */
+const std::vector<CScript>& GetBlockScriptDictionary(const Consensus::Params& consensusParams);
+
+/**
+ * Compressed block encoding, used for block file records.
+ *
+ * The header is stored as is. Transactions use compressed amounts and
+ * scripts (as in the UTXO database), short codes for the common versions,
+ * sequence numbers and lock times, and refer back to earlier transactions of
+ * the block and to output scripts seen earlier (or in the dictionary) instead
+ * of repeating them. The hex BCT txid in a hive coinbase is stored as binary.
+ *
+ * Returns false if the block cannot be represented exactly, in which case it
+ * has to be stored uncompressed.
+ */
+bool CompressBlock(const CBlock& block, const std::vector<CScript>& vDictionary, std::vector<unsigned char>& vch);
+
+/** Decode a compressed block. Throws std::ios_base::failure if the encoding is invalid */
+void DecompressBlock(const std::vector<unsigned char>& vch, const std::vector<CScript>& vDictionary, CBlock& block);
+
+/**
+ * Compact undo encoding, used for undo file records. Coin heights are stored
+ * relative to the height of the block (nHeight) that spends them, without
+ * the legacy version dummy, and output scripts go through the same
+ * dictionary as blocks. Returns false if the undo data cannot be represented.
+ */
+bool CompressBlockUndo(const CBlockUndo& blockundo, int nHeight, const std::vector<CScript>& vDictionary, std::vector<unsigned char>& vch);
+
+/** Decode compact undo data of the block at nHeight. Throws std::ios_base::failure if the encoding is invalid */
+void DecompressBlockUndo(const std::vector<unsigned char>& vch, int nHeight, const std::vector<CScript>& vDictionary, CBlockUndo& blockundo);
+
+#endif // BITCOIN_BLOCKCOMPRESSION_H
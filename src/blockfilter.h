@@ -0,0 +1,124 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKFILTER_H
+#define BITCOIN_BLOCKFILTER_H
+
+#include <serialize.h>
+#include <uint256.h>
+
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CBlockUndo;
+
+/**
+ * Golomb-coded set (GCS) filter, the compact probabilistic set of BIP 158.
+ * Elements are hashed into [0, N * M) with SipHash; the sorted hashes are
+ * stored as Golomb-Rice coded deltas.
+ */
+class GCSFilter
+{
+public:
+    typedef std::vector<unsigned char> Element;
+    typedef std::set<Element> ElementSet;
+
+    struct Params
+    {
+        uint64_t nSipHashK0;
+        uint64_t nSipHashK1;
+        //! Golomb-Rice coding parameter
+        uint8_t nP;
+        //! inverse false positive rate
+        uint32_t nM;
+
+        Params(uint64_t nSipHashK0In = 0, uint64_t nSipHashK1In = 0, uint8_t nPIn = 0, uint32_t nMIn = 1)
+            : nSipHashK0(nSipHashK0In), nSipHashK1(nSipHashK1In), nP(nPIn), nM(nMIn) {}
+    };
+
+private:
+    Params params;
+    //! number of elements in the filter
+    uint32_t nN;
+    //! range of element hashes, N * M
+    uint64_t nF;
+    std::vector<unsigned char> vEncoded;
+
+    /** Hash an element to an integer in [0, N * M) */
+    uint64_t HashToRange(const Element& element) const;
+    std::vector<uint64_t> BuildHashedSet(const ElementSet& elements) const;
+    bool MatchInternal(const uint64_t* pSortedHashes, size_t nSize) const;
+
+public:
+    /** Construct an empty filter */
+    explicit GCSFilter(const Params& paramsIn = Params());
+    /** Reconstruct a filter from its encoding. Throws std::ios_base::failure if the encoding is invalid */
+    GCSFilter(const Params& paramsIn, std::vector<unsigned char> vEncodedIn);
+    /** Build a filter of a set of elements */
+    GCSFilter(const Params& paramsIn, const ElementSet& elements);
+
+    uint32_t GetN() const { return nN; }
+    const Params& GetParams() const { return params; }
+    const std::vector<unsigned char>& GetEncoded() const { return vEncoded; }
+
+    /** Check whether the element may be in the set; false positives occur at a rate of about 1/M */
+    bool Match(const Element& element) const;
+    /** Check whether any of the elements may be in the set, much faster than matching them one by one */
+    bool MatchAny(const ElementSet& elements) const;
+};
+
+static const uint8_t BASIC_FILTER_P = 19;
+static const uint32_t BASIC_FILTER_M = 784931;
+
+enum class BlockFilterType : uint8_t
+{
+    BASIC = 0,
+    INVALID = 255,
+};
+
+/** Name of a filter type, as used in RPCs and log messages */
+const std::string& BlockFilterTypeName(BlockFilterType filterType);
+/** Look up a filter type by name; returns false if unknown */
+bool BlockFilterTypeByName(const std::string& name, BlockFilterType& filterType);
+
+/**
+ * Compact filter of a block, as defined by BIP 158. The basic filter holds
+ * every output script the block creates (but OP_RETURN outputs) and every
+ * output script it spends, so it tells a wallet whether the block can
+ * involve any of its scripts without reading the block.
+ */
+class BlockFilter
+{
+private:
+    BlockFilterType filterType;
+    uint256 blockHash;
+    GCSFilter filter;
+
+    bool BuildParams(GCSFilter::Params& paramsOut) const;
+
+public:
+    BlockFilter() : filterType(BlockFilterType::INVALID) {}
+
+    /** Reconstruct a filter from its encoding */
+    BlockFilter(BlockFilterType filterTypeIn, const uint256& blockHashIn, std::vector<unsigned char> vEncoded);
+
+    /** Compute the filter of a block, with the undo data telling which outputs it spends */
+    BlockFilter(BlockFilterType filterTypeIn, const CBlock& block, const CBlockUndo& blockUndo);
+
+    BlockFilterType GetFilterType() const { return filterType; }
+    const uint256& GetBlockHash() const { return blockHash; }
+    const GCSFilter& GetFilter() const { return filter; }
+    const std::vector<unsigned char>& GetEncodedFilter() const { return filter.GetEncoded(); }
+
+    /** Double SHA256 of the encoded filter */
+    uint256 GetHash() const;
+    /** Filter header, committing to this filter and the header of the previous block's filter */
+    uint256 ComputeHeader(const uint256& prevHeader) const;
+};
+
+#endif // BITCOIN_BLOCKFILTER_H
@@ -122,12 +122,128 @@ void CBlockIndex::BuildSkip()
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
 }
 
+void CBlockIndex::BuildBlockType(const Consensus::Params& consensusParams)
+{
+    assert(!pprev || (pprev->nBlockType & BLOCK_TYPE_KNOWN));
+
+    const bool fHive = nNonce == consensusParams.hiveNonceMarker;
+    const POW_TYPE powType = GetPoWType();
+    nBlockType = BLOCK_TYPE_KNOWN;
+    if (fHive)
+        nBlockType |= BLOCK_TYPE_HIVE;
+    else
+        nBlockType |= powType < NUM_BLOCK_TYPES ? (uint8_t)powType : (uint8_t)BLOCK_TYPE_POW_OTHER;
+    if (nVersion >= 0x20000000)
+        nBlockType |= BLOCK_TYPE_LEGACY;
+
+    nLegacyHeight = (nBlockType & BLOCK_TYPE_LEGACY) ? nHeight : (pprev ? pprev->nLegacyHeight : -1);
+    nHiveRun = fHive ? std::min(pprev ? pprev->nHiveRun + 1 : 1, (int)std::numeric_limits<uint16_t>::max()) : 0;
+
+    pprevHive = nullptr;
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        pprevPoW[i] = pprev ? pprev->pprevPoW[i] : nullptr;
+    if (pprev) {
+        if (pprev->nBlockType & BLOCK_TYPE_HIVE) {
+            pprevHive = pprev;
+        } else {
+            pprevHive = pprev->pprevHive;
+            if ((pprev->nBlockType & BLOCK_TYPE_POW_MASK) != BLOCK_TYPE_POW_OTHER)
+                pprevPoW[pprev->nBlockType & BLOCK_TYPE_POW_MASK] = pprev;
+        }
+    }
+
+    // Once active, MinotaurX stays active for all descendants
+    if ((pprev && (pprev->nBlockType & BLOCK_TYPE_MINOTAURX)) || IsMinotaurXEnabled(this, consensusParams))
+        nBlockType |= BLOCK_TYPE_MINOTAURX;
+}
+
+bool CBlockIndex::IsMinotaurXActive(const Consensus::Params& consensusParams) const
+{
+    if (nBlockType & BLOCK_TYPE_KNOWN)
+        return nBlockType & BLOCK_TYPE_MINOTAURX;
+    return IsMinotaurXEnabled(this, consensusParams);
+}
+
+const CBlockIndex* CBlockIndex::GetLastHiveBlock(const Consensus::Params& consensusParams) const
+{
+    if (nBlockType & BLOCK_TYPE_KNOWN)
+        return (nBlockType & BLOCK_TYPE_HIVE) ? this : pprevHive;
+
+    const CBlockIndex* pindex = this;
+    while (pindex && !pindex->IsHiveMined(consensusParams))
+        pindex = pindex->pprev;
+    return pindex;
+}
+
+const CBlockIndex* CBlockIndex::GetLastPoWBlock(POW_TYPE powType, const Consensus::Params& consensusParams) const
+{
+    assert(powType < NUM_BLOCK_TYPES);
+    if (nBlockType & BLOCK_TYPE_KNOWN)
+        return (nBlockType & (BLOCK_TYPE_HIVE | BLOCK_TYPE_POW_MASK)) == powType ? this : pprevPoW[powType];
+
+    const CBlockIndex* pindex = this;
+    while (pindex && (pindex->IsHiveMined(consensusParams) || pindex->GetPoWType() != powType))
+        pindex = pindex->pprev;
+    return pindex;
+}
+
+int CBlockIndex::GetLastLegacyHeight() const
+{
+    if (nBlockType & BLOCK_TYPE_KNOWN)
+        return nLegacyHeight;
+
+    const CBlockIndex* pindex = this;
+    while (pindex && pindex->nVersion < 0x20000000)
+        pindex = pindex->pprev;
+    return pindex ? pindex->nHeight : -1;
+}
+
+int CBlockIndex::GetHiveRun(const Consensus::Params& consensusParams) const
+{
+    if (nBlockType & BLOCK_TYPE_KNOWN && nHiveRun < std::numeric_limits<uint16_t>::max())
+        return nHiveRun;
+
+    int nRun = 0;
+    for (const CBlockIndex* pindex = this; pindex && pindex->IsHiveMined(consensusParams); pindex = pindex->pprev)
+        nRun++;
+    return nRun;
+}
+
+CBlockIndex* CBlockIndexArena::Allocate()
+{
+    if (nUsed == CHUNK_ENTRIES) {
+        pchunkCurrent = new CBlockIndex[CHUNK_ENTRIES];
+        vChunks.insert(std::upper_bound(vChunks.begin(), vChunks.end(), pchunkCurrent, std::less<CBlockIndex*>()), pchunkCurrent);
+        nUsed = 0;
+    }
+    nEntries++;
+    return &pchunkCurrent[nUsed++];
+}
+
+bool CBlockIndexArena::Owns(const CBlockIndex* pindex) const
+{
+    auto it = std::upper_bound(vChunks.begin(), vChunks.end(), pindex, std::less<const CBlockIndex*>());
+    if (it == vChunks.begin())
+        return false;
+    --it;
+    return std::less<const CBlockIndex*>()(pindex, *it + CHUNK_ENTRIES);
+}
+
+void CBlockIndexArena::Clear()
+{
+    for (CBlockIndex* pchunk : vChunks)
+        delete[] pchunk;
+    vChunks.clear();
+    pchunkCurrent = nullptr;
+    nUsed = CHUNK_ENTRIES;
+    nEntries = 0;
+}
+
 // Maza: Hive: Grant hive-mined blocks bonus work value - they get the work value of
 // their own block plus that of the PoW block behind them
-arith_uint256 GetBlockProof(const CBlockIndex& block)
+static arith_uint256 GetBlockProofBase(const CBlockIndex& block)
 {
     const Consensus::Params& consensusParams = Params().GetConsensus();
-    bool verbose = false;//LogAcceptCategory(BCLog::HIVE);
 
     arith_uint256 bnTarget;
     bool fNegative;
@@ -143,12 +259,12 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
     // or ~bnTarget / (bnTarget+1) + 1.
     arith_uint256 bnTargetScaled = (~bnTarget / (bnTarget + 1)) + 1;
 
-    if (block.GetBlockHeader().IsHiveMined(consensusParams)) {
+    if (block.IsHiveMined(consensusParams)) {
         assert(block.pprev);
 
         // Maza: Hive 1.1: Set bnPreviousTarget from nBits in most recent pow block, not just assuming it's one back. Note this logic is still valid for Hive 1.0 so doesn't need to be gated.
         CBlockIndex* pindexTemp = block.pprev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
+        while (pindexTemp->IsHiveMined(consensusParams)) {
             assert(pindexTemp->pprev);
             pindexTemp = pindexTemp->pprev;
         }
@@ -158,68 +274,64 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
         if (fNegative || fOverflow || bnPreviousTarget == 0)
             return 0;
         bnTargetScaled += (~bnPreviousTarget / (bnPreviousTarget + 1)) + 1;
+    }
 
-        // Hive 1.1: Enable bonus chainwork for Hive blocks
-        if (IsMinotaurXEnabled(&block, consensusParams)) {
-            if (verbose) {
-                LogPrintf("**** HIVE-1.1: ENABLING BONUS CHAINWORK ON HIVE BLOCK %s\n", block.GetBlockHash().ToString());
-                LogPrintf("**** Initial block chainwork = %s\n", bnTargetScaled.ToString());
-            }
-            double hiveDiff = GetDifficulty(&block, true);                                  // Current hive diff
-            if (verbose) LogPrintf("**** Hive diff = %.12f\n", hiveDiff);
-            unsigned int k = floor(std::min(hiveDiff/consensusParams.maxHiveDiff, 1.0) * (consensusParams.maxK - consensusParams.minK) + consensusParams.minK);
-
-            bnTargetScaled *= k;
-
-            if (verbose) {
-                LogPrintf("**** k = %d\n", k);
-                LogPrintf("**** Final scaled chainwork =  %s\n", bnTargetScaled.ToString());
-            }
-        }
-    // Hive 1.1: Enable bonus chainwork for PoW blocks
-    } else if (IsMinotaurXEnabled(&block, consensusParams)) {
-        if (verbose) {
-            LogPrintf("**** HIVE-1.1: CHECKING FOR BONUS CHAINWORK ON POW BLOCK %s\n", block.GetBlockHash().ToString());
-            LogPrintf("**** Initial block chainwork = %s\n", bnTargetScaled.ToString());
-        }
+    return bnTargetScaled;
+}
 
-        // Find last hive block
-        CBlockIndex *currBlock = block.pprev;
-        int blocksSinceHive;
-        double lastHiveDifficulty = 0;
+// Maza: Hive 1.1: Bonus chainwork factor for a block, 1 when it earns no bonus
+unsigned int GetBlockProofK(const CBlockIndex& block)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    bool verbose = false;//LogAcceptCategory(BCLog::HIVE);
 
-        for (blocksSinceHive = 0; blocksSinceHive < consensusParams.maxKPow; blocksSinceHive++) {
-            if (currBlock->GetBlockHeader().IsHiveMined(consensusParams)) {
-                lastHiveDifficulty = GetDifficulty(currBlock, true);
-                if (verbose) LogPrintf("**** Got last Hive diff = %.12f, at %s\n", lastHiveDifficulty, currBlock->GetBlockHash().ToString());
-                break;
-            }
+    if (!block.IsMinotaurXActive(consensusParams))
+        return 1;
 
-            assert(currBlock->pprev);
-            currBlock = currBlock->pprev;
-        }
+    // Hive 1.1: Enable bonus chainwork for Hive blocks
+    if (block.IsHiveMined(consensusParams)) {
+        double hiveDiff = GetDifficulty(&block, true);                                  // Current hive diff
+        unsigned int k = floor(std::min(hiveDiff/consensusParams.maxHiveDiff, 1.0) * (consensusParams.maxK - consensusParams.minK) + consensusParams.minK);
+        if (verbose) LogPrintf("**** HIVE-1.1: Hive block %s: hive diff = %.12f, k = %d\n", block.GetBlockHash().ToString(), hiveDiff, k);
+        return k;
+    }
 
-        if (verbose) LogPrintf("**** Pow blocks since last Hive block = %d\n", blocksSinceHive);
+    // Hive 1.1: Enable bonus chainwork for PoW blocks
+    // Find last hive block, if within maxKPow blocks
+    assert(block.pprev);
+    const CBlockIndex* pindexHive = block.pprev->GetLastHiveBlock(consensusParams);
+    int blocksSinceHive = consensusParams.maxKPow;
+    double lastHiveDifficulty = 0;
+
+    if (pindexHive && block.pprev->nHeight - pindexHive->nHeight < consensusParams.maxKPow) {
+        blocksSinceHive = block.pprev->nHeight - pindexHive->nHeight;
+        lastHiveDifficulty = GetDifficulty(pindexHive, true);
+    }
 
-        // Apply k scaling
-        unsigned int k = consensusParams.maxKPow - blocksSinceHive;
-        if (lastHiveDifficulty < consensusParams.powSplit1)
-            k = k >> 1;
-        if (lastHiveDifficulty < consensusParams.powSplit2)
-            k = k >> 1;
+    // Apply k scaling
+    unsigned int k = consensusParams.maxKPow - blocksSinceHive;
+    if (lastHiveDifficulty < consensusParams.powSplit1)
+        k = k >> 1;
+    if (lastHiveDifficulty < consensusParams.powSplit2)
+        k = k >> 1;
 
-        if (k < 1)
-            k = 1;
+    if (k < 1)
+        k = 1;
 
-        bnTargetScaled *= k;
+    if (verbose) LogPrintf("**** HIVE-1.1: PoW block %s: %d pow blocks since last Hive block, last hive diff = %.12f, k = %d\n", block.GetBlockHash().ToString(), blocksSinceHive, lastHiveDifficulty, k);
+    return k;
+}
 
-        if (verbose) {
-            LogPrintf("**** k = %d\n", k);
-            LogPrintf("**** Final scaled chainwork =  %s\n", bnTargetScaled.ToString());
-        }
-    }
+// Maza: Hive 1.1: Work value of a block, scaled by its bonus factor. Entries
+// loaded from the block tree DB or added to the index carry the factor in
+// nProofK; it is only recomputed for entries that don't have it.
+arith_uint256 GetBlockProof(const CBlockIndex& block)
+{
+    arith_uint256 bnProof = GetBlockProofBase(block);
+    if (bnProof == 0)
+        return 0;
 
-    return bnTargetScaled;
+    return bnProof * (block.nProofK ? block.nProofK : GetBlockProofK(block));
 }
 
 // Maza: Hive: Use this to compute estimated hashes for GetNetworkHashPS()
@@ -231,14 +343,14 @@ arith_uint256 GetNumHashes(const CBlockIndex& block, POW_TYPE powType)
     bool fOverflow;
 
     bnTarget.SetCompact(block.nBits, &fNegative, &fOverflow);
-    if (fNegative || fOverflow || bnTarget == 0 || block.GetBlockHeader().IsHiveMined(Params().GetConsensus()))
+    if (fNegative || fOverflow || bnTarget == 0 || block.IsHiveMined(Params().GetConsensus()))
         return 0;
 
     // Maza: MinotaurX+Hive1.2: skip the wrong pow type
-    if (IsMinotaurXEnabled(&block, Params().GetConsensus()) && block.GetBlockHeader().GetPoWType() != powType)
+    if (block.IsMinotaurXActive(Params().GetConsensus()) && block.GetPoWType() != powType)
         return 0;
     // Maza: MinotaurX+Hive1.2: if you ask for minotaurx hashes before it's enabled, there aren't any!
-    if (!IsMinotaurXEnabled(&block, Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX) 
+    if (!block.IsMinotaurXActive(Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX)
         return 0;
  
     // We need to compute 2**256 / (bnTarget+1), but we can't represent 2**256
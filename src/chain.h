@@ -163,6 +163,18 @@ enum BlockStatus: uint32_t {
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
 };
 
+//! Maza: Packed block type of a CBlockIndex, see CBlockIndex::BuildBlockType()
+enum BlockType: uint8_t {
+    //! Pow type of a PoW block, or BLOCK_TYPE_POW_OTHER when it isn't a known one
+    BLOCK_TYPE_POW_MASK     =   0x0f,
+    BLOCK_TYPE_POW_OTHER    =   0x0f,
+
+    BLOCK_TYPE_HIVE         =   0x10, //!< mined by the hive
+    BLOCK_TYPE_LEGACY       =   0x20, //!< version from before pow types were encoded in it
+    BLOCK_TYPE_MINOTAURX    =   0x40, //!< IsMinotaurXEnabled() holds for this block
+    BLOCK_TYPE_KNOWN        =   0x80, //!< the flags above have been set
+};
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -192,9 +204,13 @@ public:
     //! Byte offset within rev?????.dat where this block's undo data is stored
     unsigned int nUndoPos;
 
-    //! (memory only) Total amount of work (expected number of hashes) in the chain up to and including this block
+    //! Total amount of work (expected number of hashes) in the chain up to and including this block.
+    //! Kept in the block tree DB apart from the entry itself, see CDiskBlockWork
     arith_uint256 nChainWork;
 
+    //! Maza: Hive 1.1: Bonus factor applied to the work of this block, 0 until known
+    unsigned int nProofK;
+
     //! Number of transactions in this block.
     //! Note: in a potential headers-first mode, this number cannot be relied upon
     unsigned int nTx;
@@ -220,6 +236,21 @@ public:
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
+    //! (memory only) Maza: Packed block type. See enum BlockType
+    uint8_t nBlockType;
+
+    //! (memory only) Maza: Hive 1.1: Number of consecutive hive blocks ending with this one
+    uint16_t nHiveRun;
+
+    //! (memory only) Maza: Height of the last block up to and including this one with a legacy version, -1 if none
+    int32_t nLegacyHeight;
+
+    //! (memory only) Maza: Last hive block before this one
+    CBlockIndex* pprevHive;
+
+    //! (memory only) Maza: MinotaurX+Hive1.2: Last PoW block of each pow type before this one
+    CBlockIndex* pprevPoW[NUM_BLOCK_TYPES];
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -230,11 +261,18 @@ public:
         nDataPos = 0;
         nUndoPos = 0;
         nChainWork = arith_uint256();
+        nProofK = 0;
         nTx = 0;
         nChainTx = 0;
         nStatus = 0;
         nSequenceId = 0;
         nTimeMax = 0;
+        nBlockType = 0;
+        nHiveRun = 0;
+        nLegacyHeight = -1;
+        pprevHive = nullptr;
+        for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+            pprevPoW[i] = nullptr;
 
         nVersion       = 0;
         hashMerkleRoot = uint256();
@@ -305,6 +343,24 @@ public:
         return (int64_t)nTime;
     }
 
+    // The block type accessors below read the packed block type once
+    // BuildBlockType() has run, and the header fields otherwise, so they
+    // never need to build the header.
+
+    // Maza: Hive: Check if this block is hivemined
+    bool IsHiveMined(const Consensus::Params& consensusParams) const
+    {
+        if (nBlockType & BLOCK_TYPE_KNOWN)
+            return nBlockType & BLOCK_TYPE_HIVE;
+        return nNonce == consensusParams.hiveNonceMarker;
+    }
+
+    // Maza: MinotaurX+Hive1.2: Get pow type from version bits
+    POW_TYPE GetPoWType() const
+    {
+        return (POW_TYPE)((nVersion >> 16) & 0xFF);
+    }
+
     int64_t GetBlockTimeMax() const
     {
         return (int64_t)nTimeMax;
@@ -360,12 +416,33 @@ public:
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
+    //! Maza: Set the packed block type and the links to earlier blocks by type.
+    //! The previous entry must have its block type built already.
+    void BuildBlockType(const Consensus::Params& consensusParams);
+
+    //! Maza: MinotaurX+Hive1.2: IsMinotaurXEnabled() for this entry
+    bool IsMinotaurXActive(const Consensus::Params& consensusParams) const;
+
+    //! Maza: Hive: Last hive block up to and including this one
+    const CBlockIndex* GetLastHiveBlock(const Consensus::Params& consensusParams) const;
+
+    //! Maza: MinotaurX+Hive1.2: Last PoW block of a pow type up to and including this one
+    const CBlockIndex* GetLastPoWBlock(POW_TYPE powType, const Consensus::Params& consensusParams) const;
+
+    //! Maza: Height of the last block up to and including this one with a legacy version, -1 if none
+    int GetLastLegacyHeight() const;
+
+    //! Maza: Hive 1.1: Number of consecutive hive blocks ending with this one
+    int GetHiveRun(const Consensus::Params& consensusParams) const;
+
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
 };
 
 arith_uint256 GetBlockProof(const CBlockIndex& block);
+// Maza: Hive 1.1: Bonus chainwork factor for a block, 1 when it earns no bonus
+unsigned int GetBlockProofK(const CBlockIndex& block);
 // Maza: Hive: Reimplement un-boosted GetBlockProof for getnetworkhashps estimation.
 // Maza: MinotaurX+Hive1.2
 arith_uint256 GetNumHashes(const CBlockIndex& block, POW_TYPE powType);
@@ -440,6 +517,66 @@ public:
     }
 };
 
+/** Chain work of a block index entry as kept in the block tree DB, so it
+ *  doesn't have to be recomputed for every block at startup. Records of
+ *  another version are ignored and recomputed. */
+class CDiskBlockWork
+{
+public:
+    //! Bump when the work rules change, so stored values are recomputed
+    static const int CURRENT_VERSION = 1;
+
+    int nVersion;
+    arith_uint256 nChainWork;
+    unsigned int nProofK;
+
+    CDiskBlockWork() : nVersion(CURRENT_VERSION), nProofK(0) {}
+
+    explicit CDiskBlockWork(const CBlockIndex* pindex) : nVersion(CURRENT_VERSION), nChainWork(pindex->nChainWork), nProofK(pindex->nProofK) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(VARINT(nVersion));
+        uint256 work = ArithToUint256(nChainWork);
+        READWRITE(work);
+        if (ser_action.ForRead())
+            nChainWork = UintToArith256(work);
+        READWRITE(VARINT(nProofK));
+    }
+};
+
+/** Bulk storage for block index entries. Entries are carved out of large
+ *  chunks instead of being allocated one by one, and all live until Clear(). */
+class CBlockIndexArena
+{
+private:
+    static const size_t CHUNK_ENTRIES = 16384;
+
+    //! Chunks, ordered by address for Owns()
+    std::vector<CBlockIndex*> vChunks;
+    CBlockIndex* pchunkCurrent;
+    size_t nUsed;
+    size_t nEntries;
+
+public:
+    CBlockIndexArena() : pchunkCurrent(nullptr), nUsed(CHUNK_ENTRIES), nEntries(0) {}
+    ~CBlockIndexArena() { Clear(); }
+
+    CBlockIndexArena(const CBlockIndexArena&) = delete;
+    CBlockIndexArena& operator=(const CBlockIndexArena&) = delete;
+
+    //! Returns a new entry, initialized as by CBlockIndex()
+    CBlockIndex* Allocate();
+    //! Whether an entry was handed out by this arena
+    bool Owns(const CBlockIndex* pindex) const;
+    //! Frees all entries at once
+    void Clear();
+
+    size_t size() const { return nEntries; }
+};
+
 /** An in-memory indexed chain of blocks. */
 class CChain {
 private:
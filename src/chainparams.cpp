@@ -340,6 +340,7 @@ public:
         consensus.BIP65Height = 1351; // BIP65 activated on regtest (Used in rpc activation tests)
         consensus.BIP66Height = 1251; // BIP66 activated on regtest (Used in rpc activation tests)
         consensus.powLimitSHA = uint256S("7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+        consensus.startingDifficulty = consensus.powLimitSHA;
         consensus.nPowTargetTimespan = 8 * 60; // 8 minutes
         consensus.nPowTargetSpacing = 2 * 60;
         consensus.fPowAllowMinDifficultyBlocks = true;
@@ -347,6 +348,7 @@ public:
         consensus.nRuleChangeActivationThreshold = 108; // 75% for testchains
         consensus.nMinerConfirmationWindow = 144; // Faster than normal for regtest (144 instead of 2016)
 		consensus.nPowDGWHeight = 4001;
+        consensus.powForkTime = 0xffffffff; // Maza: MinotaurX isn't deployed on regtest, so blocks are always sha256d
         consensus.vDeployments[Consensus::DEPLOYMENT_TESTDUMMY].bit = 28;
         consensus.vDeployments[Consensus::DEPLOYMENT_TESTDUMMY].nStartTime = 0;
         consensus.vDeployments[Consensus::DEPLOYMENT_TESTDUMMY].nTimeout = Consensus::BIP9Deployment::NO_TIMEOUT;
@@ -357,10 +359,40 @@ public:
         consensus.vDeployments[Consensus::DEPLOYMENT_SEGWIT].nStartTime = Consensus::BIP9Deployment::ALWAYS_ACTIVE;
         consensus.vDeployments[Consensus::DEPLOYMENT_SEGWIT].nTimeout = Consensus::BIP9Deployment::NO_TIMEOUT;
 
-        // Maza fields
-        
+        // Maza: MinotaurX+Hive1.2: Deployment (fails from the start on regtest)
+        consensus.vDeployments[Consensus::DEPLOYMENT_MINOTAURX].bit = 7;
+        consensus.vDeployments[Consensus::DEPLOYMENT_MINOTAURX].nStartTime = 0;
+        consensus.vDeployments[Consensus::DEPLOYMENT_MINOTAURX].nTimeout = 0;
+
+        // Maza: Hive: Consensus Fields
+        consensus.minBeeCost = 10000;                       // Minimum cost of a bee, used when no more block rewards
+        consensus.beeCostFactor = 2500;                     // Bee cost is block_reward/beeCostFactor
+        consensus.beeCreationAddress = "yLKSrCjLQFsfVgX8RjdctZ797d54atPjnV";        // Unspendable address for bee creation
+        consensus.hiveCommunityAddress = "yLQkj9a5TNjotA96dLkkEuc67JzLvi9DbJ";      // Community fund address
+        consensus.communityContribFactor = 10;              // Optionally, donate bct_value/maxCommunityContribFactor to community fund
+        consensus.beeGestationBlocks = 40;                  // The number of blocks for a new bee to mature
+        consensus.beeLifespanBlocks = 48*24*14;             // The number of blocks a bee lives for after maturation
+        consensus.powLimitHive = uint256S("0fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");  // Highest (easiest) bee hash target
+        consensus.minHiveCheckBlock = 0;                    // Don't bother checking below this height for Hive blocks (not used for consensus/validation checks, just efficiency when looking for potential BCTs)
+        consensus.hiveBlockSpacingTarget = 2;               // Target Hive block frequency (1 out of this many blocks should be Hivemined)
+        consensus.hiveBlockSpacingTargetTypical_1_1 = 2;    // Observed Hive block frequency in Hive 1.1 (1 out of this many blocks are observed to be Hive)
         consensus.hiveNonceMarker = 192;                    // Nonce marker for hivemined blocks
 
+        // Maza: Hive 1.1-related consensus fields
+        consensus.minK = 2;                                 // Minimum chainwork scale for Hive blocks (see Hive whitepaper section 5)
+        consensus.maxK = 10;                                // Maximum chainwork scale for Hive blocks (see Hive whitepaper section 5)
+        consensus.maxHiveDiff = 0.002;                      // Hive difficulty at which max chainwork bonus is awarded
+        consensus.maxKPow = 5;                              // Maximum chainwork scale for PoW blocks
+        consensus.powSplit1 = 0.001;                        // Below this Hive difficulty threshold, PoW block chainwork bonus is halved
+        consensus.powSplit2 = 0.0005;                       // Below this Hive difficulty threshold, PoW block chainwork bonus is halved again
+        consensus.maxConsecutiveHiveBlocks = 2;             // Maximum hive blocks that can occur consecutively before a PoW block is required
+        consensus.hiveDifficultyWindow = 36;                // How many blocks the SMA averages over in hive difficulty adjust
+
+        // Maza: MinotaurX+Hive1.2-related consensus fields
+        consensus.lwmaAveragingWindow = 90;                 // Averaging window size for LWMA diff adjust
+        consensus.powTypeLimits.emplace_back(uint256S("0x7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));   // sha256d limit
+        consensus.powTypeLimits.emplace_back(uint256S("0x7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));   // MinotaurX limit
+
         // The best chain should have at least this much work.
         consensus.nMinimumChainWork = uint256S("0x00");
 
@@ -377,7 +409,7 @@ public:
         genesis = CreateGenesisBlock(1390748221, 4, 0x207fffff, 1, 5000 * COIN);
         consensus.hashGenesisBlock = genesis.GetHash();
         assert(consensus.hashGenesisBlock == uint256S("0x57939ce0a96bf42965fee5956528a456d0edfb879b8bd699bcbb4786d27b979d"));
-        assert(genesis.hashMerkleRoot == uint256S("0xe0028eb9648db56b1ac77cf090b99048a8007e2bb64b68f092c03c7f56a662c7"));
+        assert(genesis.hashMerkleRoot == uint256S("0x62d496378e5834989dd9594cfc168dbb76f84a39bbda18286cddc7d1d1589f4f"));
 
         vFixedSeeds.clear(); //!< Regtest mode doesn't have any fixed seeds.
         vSeeds.clear();      //!< Regtest mode doesn't have any DNS seeds.
@@ -388,7 +420,7 @@ public:
 
         checkpointData = {
             {
-                {0, uint256S("000008ca1832a4baf228eb1553c03d3a2c8e02399550dd6ea8d65cec3ef23d2e")}
+                {0, uint256S("57939ce0a96bf42965fee5956528a456d0edfb879b8bd699bcbb4786d27b979d")}
             }
         };
 
@@ -58,8 +58,15 @@ struct TortureGarden {
     TortureNode nodes[22];
 };
 
+// Optional instrumentation: counts of the algos run and the paths taken through the garden
+struct MinotaurStats {
+    uint64_t hashes;
+    uint64_t algoRuns[MINOTAUR_ALGO_COUNT + 1];     // Indexed by algo; the last entry counts the CPU-hard gate
+    uint64_t paths[64];                             // Indexed by the turns taken; bit n is set if turn n went right
+};
+
 // Get a 64-byte hash for given 64-byte input, using given TortureGarden contexts and given algo index
-uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo, yespower_local_t *local) {
+inline uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo, yespower_local_t *local) {
     uint512 outputHash;
     switch (algo) {
         case 0:
@@ -159,8 +166,11 @@ uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo, yes
 }
 
 // Recursively traverse a given torture garden starting with a given hash and given node within the garden. The hash is overwritten with the final hash.
-uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node, yespower_local_t *local) {
+// Optionally, count the algos run and the path taken in stats; turns and depth track the path so far.
+inline uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node, yespower_local_t *local, MinotaurStats *stats = NULL, unsigned int turns = 0, unsigned int depth = 0) {
     uint512 partialHash = GetHash(hash, garden, node->algo, local);
+    if (stats != NULL)
+        stats->algoRuns[node->algo]++;
 
 #ifdef MINOTAUR_DEBUG
     printf("* Ran algo %d. Partial hash:\t%s\n", node->algo, partialHash.ToString().c_str());
@@ -169,51 +179,82 @@ uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node, y
 
     if (partialHash.ByteAt(63) % 2 == 0) {      // Last byte of output hash is even
         if (node->childLeft != NULL)
-            return TraverseGarden(garden, partialHash, node->childLeft, local);
+            return TraverseGarden(garden, partialHash, node->childLeft, local, stats, turns, depth + 1);
     } else {                                    // Last byte of output hash is odd
         if (node->childRight != NULL)
-            return TraverseGarden(garden, partialHash, node->childRight, local);
+            return TraverseGarden(garden, partialHash, node->childRight, local, stats, turns | (1 << depth), depth + 1);
     }
 
+    if (stats != NULL)
+        stats->paths[turns]++;
     return partialHash;
 }
 
 // Associate child nodes with a parent node
-void LinkNodes(TortureNode *parent, TortureNode *childLeft, TortureNode *childRight) {
+inline void LinkNodes(TortureNode *parent, TortureNode *childLeft, TortureNode *childRight) {
     parent->childLeft = childLeft;
     parent->childRight = childRight;
 }
 
+// Link the torture garden nodes. Note that both sides of 19 and 20 lead to 21, and 21 has no children (to make traversal complete).
+// Every path through the garden stops at 7 nodes.
+inline void BuildGarden(TortureGarden *garden) {
+    LinkNodes(&garden->nodes[0], &garden->nodes[1], &garden->nodes[2]);
+    LinkNodes(&garden->nodes[1], &garden->nodes[3], &garden->nodes[4]);
+    LinkNodes(&garden->nodes[2], &garden->nodes[5], &garden->nodes[6]);
+    LinkNodes(&garden->nodes[3], &garden->nodes[7], &garden->nodes[8]);
+    LinkNodes(&garden->nodes[4], &garden->nodes[9], &garden->nodes[10]);
+    LinkNodes(&garden->nodes[5], &garden->nodes[11], &garden->nodes[12]);
+    LinkNodes(&garden->nodes[6], &garden->nodes[13], &garden->nodes[14]);
+    LinkNodes(&garden->nodes[7], &garden->nodes[15], &garden->nodes[16]);
+    LinkNodes(&garden->nodes[8], &garden->nodes[15], &garden->nodes[16]);
+    LinkNodes(&garden->nodes[9], &garden->nodes[15], &garden->nodes[16]);
+    LinkNodes(&garden->nodes[10], &garden->nodes[15], &garden->nodes[16]);
+    LinkNodes(&garden->nodes[11], &garden->nodes[17], &garden->nodes[18]);
+    LinkNodes(&garden->nodes[12], &garden->nodes[17], &garden->nodes[18]);
+    LinkNodes(&garden->nodes[13], &garden->nodes[17], &garden->nodes[18]);
+    LinkNodes(&garden->nodes[14], &garden->nodes[17], &garden->nodes[18]);
+    LinkNodes(&garden->nodes[15], &garden->nodes[19], &garden->nodes[20]);
+    LinkNodes(&garden->nodes[16], &garden->nodes[19], &garden->nodes[20]);
+    LinkNodes(&garden->nodes[17], &garden->nodes[19], &garden->nodes[20]);
+    LinkNodes(&garden->nodes[18], &garden->nodes[19], &garden->nodes[20]);
+    LinkNodes(&garden->nodes[19], &garden->nodes[21], &garden->nodes[21]);
+    LinkNodes(&garden->nodes[20], &garden->nodes[21], &garden->nodes[21]);
+    garden->nodes[21].childLeft = NULL;
+    garden->nodes[21].childRight = NULL;
+}
+
+// Send the initial sha512 hash through a built garden, with algos assigned to the nodes by the hash
+inline uint256 WalkGarden(TortureGarden *garden, uint512 hash, bool minotaurX, yespower_local_t *local, MinotaurStats *stats) {
+    // Assign algos to torture net nodes based on initial hash
+    for (int i = 0; i < 22; i++)
+        garden->nodes[i].algo = hash.ByteAt(i) % MINOTAUR_ALGO_COUNT;
+
+    // Hardened garden gates on MinotaurX
+    if (minotaurX)
+        garden->nodes[21].algo = MINOTAUR_ALGO_COUNT;
+
+    // Send the initial hash through the torture garden
+    if (stats != NULL)
+        stats->hashes++;
+    hash = TraverseGarden(garden, hash, &garden->nodes[0], local, stats);
+
+#ifdef MINOTAUR_DEBUG
+    printf("** Final hash:\t\t\t%s\n", uint256(hash).ToString().c_str());
+    fflush(0);
+#endif
+
+    // Return truncated result
+    return uint256(hash);
+}
+
 // Produce a Minotaur 32-byte hash from variable length data
 // Optionally, use the MinotaurX hardened hash.
 // Optionally, use provided thread-local memory for yespower.
-template<typename T> uint256 Minotaur(const T begin, const T end, bool minotaurX, yespower_local_t *local = NULL) {
-    // Create torture garden nodes. Note that both sides of 19 and 20 lead to 21, and 21 has no children (to make traversal complete).
-    // Every path through the garden stops at 7 nodes.
+// Optionally, count the algos run and the path taken in stats.
+template<typename T> uint256 Minotaur(const T begin, const T end, bool minotaurX, yespower_local_t *local = NULL, MinotaurStats *stats = NULL) {
     TortureGarden garden;
-    LinkNodes(&garden.nodes[0], &garden.nodes[1], &garden.nodes[2]);
-    LinkNodes(&garden.nodes[1], &garden.nodes[3], &garden.nodes[4]);
-    LinkNodes(&garden.nodes[2], &garden.nodes[5], &garden.nodes[6]);
-    LinkNodes(&garden.nodes[3], &garden.nodes[7], &garden.nodes[8]);
-    LinkNodes(&garden.nodes[4], &garden.nodes[9], &garden.nodes[10]);
-    LinkNodes(&garden.nodes[5], &garden.nodes[11], &garden.nodes[12]);
-    LinkNodes(&garden.nodes[6], &garden.nodes[13], &garden.nodes[14]);
-    LinkNodes(&garden.nodes[7], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[8], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[9], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[10], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[11], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[12], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[13], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[14], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[15], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[16], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[17], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[18], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[19], &garden.nodes[21], &garden.nodes[21]);
-    LinkNodes(&garden.nodes[20], &garden.nodes[21], &garden.nodes[21]);
-    garden.nodes[21].childLeft = NULL;
-    garden.nodes[21].childRight = NULL;
+    BuildGarden(&garden);
         
     // Find initial sha512 hash of the variable length data
     uint512 hash;
@@ -227,24 +268,45 @@ template<typename T> uint256 Minotaur(const T begin, const T end, bool minotaurX
     fflush(0);
 #endif    
 
-    // Assign algos to torture net nodes based on initial hash
-    for (int i = 0; i < 22; i++)
-        garden.nodes[i].algo = hash.ByteAt(i) % MINOTAUR_ALGO_COUNT;
+    return WalkGarden(&garden, hash, minotaurX, local, stats);
+}
 
-    // Hardened garden gates on MinotaurX
-    if (minotaurX)
-        garden.nodes[21].algo = MINOTAUR_ALGO_COUNT;
+// Minotaur hashes of an 80-byte block header for many nonces, as for Minotaur(BEGIN(nVersion), END(nNonce), ...).
+// The 76 bytes before the nonce are absorbed into the sha512 stage once, and the garden is built once; each
+// nonce then only finishes the sha512 stage and walks the garden. Not thread safe: use one hasher per thread.
+class MinotaurHeaderHasher {
+public:
+    static const size_t PREFIX_SIZE = 76;
 
-    // Send the initial hash through the torture garden
-    hash = TraverseGarden(&garden, hash, &garden.nodes[0], local);
+    // prefix is the serialised header up to the nonce (nVersion to nBits). local is as for Minotaur(), and
+    // must outlive the hasher.
+    MinotaurHeaderHasher(const unsigned char *prefix, bool minotaurXIn, yespower_local_t *localIn = NULL) : minotaurX(minotaurXIn), local(localIn) {
+        BuildGarden(&garden);
+        sph_sha512_init(&prefixContext);
+        sph_sha512(&prefixContext, prefix, PREFIX_SIZE);
+    }
 
-#ifdef MINOTAUR_DEBUG
-    printf("** Final hash:\t\t\t%s\n", uint256(hash).ToString().c_str());
-    fflush(0);
-#endif
+    // Hash of the header with the given nonce
+    uint256 Hash(uint32_t nonce, MinotaurStats *stats = NULL) {
+        const unsigned char nonceBytes[4] = {(unsigned char)nonce, (unsigned char)(nonce >> 8), (unsigned char)(nonce >> 16), (unsigned char)(nonce >> 24)};
+        uint512 hash;
+        garden.context_sha2 = prefixContext;
+        sph_sha512(&garden.context_sha2, nonceBytes, sizeof(nonceBytes));
+        sph_sha512_close(&garden.context_sha2, static_cast<void*>(&hash));
+        return WalkGarden(&garden, hash, minotaurX, local, stats);
+    }
 
-    // Return truncated result
-    return uint256(hash);
-}
+    // Hashes of the header with nonces nonceBegin to nonceBegin + count - 1, in order
+    void HashRange(uint32_t nonceBegin, uint32_t count, uint256 *hashes, MinotaurStats *stats = NULL) {
+        for (uint32_t i = 0; i < count; i++)
+            hashes[i] = Hash(nonceBegin + i, stats);
+    }
+
+private:
+    bool minotaurX;
+    yespower_local_t *local;
+    sph_sha512_context prefixContext;
+    TortureGarden garden;
+};
 
 #endif // LCC_CRYPTO_MINOTAURX_MINOTAUR_H
@@ -475,6 +475,20 @@ public:
             }
         return false;
     }
+
+    /** get_entries appends every element not yet marked for garbage
+     * collection to entries, in table order.
+     *
+     * @param entries the vector to append to
+     *
+     * @pre no concurrent insert is in progress
+     */
+    void get_entries(std::vector<Element>& entries) const
+    {
+        for (uint32_t i = 0; i < size; ++i)
+            if (!collection_flags.bit_is_set(i))
+                entries.push_back(table[i]);
+    }
 };
 } // namespace CuckooCache
 
@@ -71,14 +71,62 @@ public:
     }
 };
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static const std::string PROFILE_NAME_STEADY = "steady";
+static const std::string PROFILE_NAME_IBD = "ibd";
+static const std::string PROFILE_NAME_LOW_MEMORY = "lowmem";
+
+const std::string& DBProfileName(DBProfile profile)
+{
+    switch (profile) {
+    case DBProfile::IBD: return PROFILE_NAME_IBD;
+    case DBProfile::LOW_MEMORY: return PROFILE_NAME_LOW_MEMORY;
+    case DBProfile::STEADY: break;
+    }
+    return PROFILE_NAME_STEADY;
+}
+
+bool DBProfileFromName(const std::string& name, DBProfile& profile)
+{
+    if (name == PROFILE_NAME_STEADY) {
+        profile = DBProfile::STEADY;
+    } else if (name == PROFILE_NAME_IBD) {
+        profile = DBProfile::IBD;
+    } else if (name == PROFILE_NAME_LOW_MEMORY) {
+        profile = DBProfile::LOW_MEMORY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static leveldb::Options GetOptions(size_t nCacheSize, DBProfile profile)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
+    switch (profile) {
+    case DBProfile::STEADY:
+        options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
+        options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
+        options.max_open_files = 64;
+        break;
+    case DBProfile::IBD:
+        // Coins are mostly written in large batches and read through the
+        // coins cache, so favour the write buffers. Larger buffers and
+        // tables mean fewer level-0 files, so compactions run less often
+        // and move more data at once.
+        options.block_cache = leveldb::NewLRUCache(nCacheSize / 4);
+        options.write_buffer_size = nCacheSize * 3 / 8;
+        options.max_open_files = 128;
+        options.max_file_size = 8 << 20;
+        break;
+    case DBProfile::LOW_MEMORY:
+        // Every open table keeps its index and filter blocks in memory
+        options.block_cache = leveldb::NewLRUCache(nCacheSize / 4);
+        options.write_buffer_size = nCacheSize / 8;
+        options.max_open_files = 16;
+        break;
+    }
     options.filter_policy = leveldb::NewBloomFilterPolicy(10);
     options.compression = leveldb::kNoCompression;
-    options.max_open_files = 64;
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -88,14 +136,15 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, DBProfile profileIn)
+    : profile(profileIn)
 {
     penv = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, profile);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -107,7 +156,7 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
             dbwrapper_private::HandleError(result);
         }
         TryCreateDirectories(path);
-        LogPrintf("Opening LevelDB in %s\n", path.string());
+        LogPrintf("Opening LevelDB in %s (profile %s)\n", path.string(), DBProfileName(profile));
     }
     leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
     dbwrapper_private::HandleError(status);
@@ -115,7 +164,7 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
 
     if (gArgs.GetBoolArg("-forcecompactdb", false)) {
         LogPrintf("Starting database compaction of %s\n", path.string());
-        pdb->CompactRange(nullptr, nullptr);
+        CompactFull();
         LogPrintf("Finished database compaction of %s\n", path.string());
     }
 
@@ -180,6 +229,26 @@ std::vector<unsigned char> CDBWrapper::CreateObfuscateKey() const
 
 }
 
+bool CDBWrapper::GetProperty(const std::string& name, std::string& value) const
+{
+    return pdb->GetProperty(name, &value);
+}
+
+size_t CDBWrapper::DynamicMemoryUsage() const
+{
+    std::string memory;
+    if (!GetProperty("leveldb.approximate-memory-usage", memory)) {
+        LogPrint(BCLog::LEVELDB, "Failed to get approximate-memory-usage property\n");
+        return 0;
+    }
+    return std::stoul(memory);
+}
+
+void CDBWrapper::CompactFull() const
+{
+    pdb->CompactRange(nullptr, nullptr);
+}
+
 bool CDBWrapper::IsEmpty()
 {
     std::unique_ptr<CDBIterator> it(NewIterator());
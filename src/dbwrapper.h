@@ -25,6 +25,24 @@ public:
     explicit dbwrapper_error(const std::string& msg) : std::runtime_error(msg) {}
 };
 
+/**
+ * LevelDB tuning for the expected workload of a database. The profile
+ * decides how the cache size given to CDBWrapper is split between the block
+ * cache and the write buffers, how many table files may be open and how
+ * large they grow.
+ */
+enum class DBProfile
+{
+    STEADY,     //!< mixed reads and writes of a synced node (the historical settings)
+    IBD,        //!< bulk writes of initial sync and reindex: large write buffers and tables, fewer compactions
+    LOW_MEMORY, //!< small caches and few open files
+};
+
+/** Name of a profile, as used by -dbprofile and getdbstats */
+const std::string& DBProfileName(DBProfile profile);
+/** Look up a profile by name; returns false if unknown */
+bool DBProfileFromName(const std::string& name, DBProfile& profile);
+
 class CDBWrapper;
 
 /** These should be considered an implementation detail of the specific database.
@@ -209,6 +227,9 @@ private:
 
     std::vector<unsigned char> CreateObfuscateKey() const;
 
+    //! profile the database was opened with
+    DBProfile profile;
+
 public:
     /**
      * @param[in] path        Location in the filesystem where leveldb data will be stored.
@@ -217,8 +238,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] profile     LevelDB tuning for the expected workload.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, DBProfile profile = DBProfile::STEADY);
     ~CDBWrapper();
 
     template <typename K, typename V>
@@ -322,6 +344,14 @@ public:
         return size;
     }
 
+    DBProfile GetProfile() const { return profile; }
+
+    /** Read a LevelDB property, such as "leveldb.stats"; returns false if unknown */
+    bool GetProperty(const std::string& name, std::string& value) const;
+
+    /** Memory held by the memtables and the block cache, as estimated by LevelDB */
+    size_t DynamicMemoryUsage() const;
+
     /**
      * Compact a certain range of keys in the database.
      */
@@ -338,6 +368,9 @@ public:
         pdb->CompactRange(&slKey1, &slKey2);
     }
 
+    /** Compact the whole database; may take several minutes for a large one */
+    void CompactFull() const;
+
 };
 
 #endif // BITCOIN_DBWRAPPER_H
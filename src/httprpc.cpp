@@ -7,6 +7,7 @@
 #include <base58.h>
 #include <chainparams.h>
 #include <httpserver.h>
+#include <rpc/jsonstream.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <random.h>
@@ -63,6 +64,9 @@ private:
 static std::string strRPCUserColonPass;
 /* Stored RPC timer interface (for unregistration) */
 static std::unique_ptr<HTTPRPCTimerInterface> httpRPCTimerInterface;
+/* Threads a JSON-RPC batch may spread over, and the reply bytes it may produce */
+static int g_rpc_batch_threads = 1;
+static size_t g_rpc_batch_max_bytes = (size_t)DEFAULT_RPC_BATCH_MAX_MEMORY << 20;
 
 static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const UniValue& id)
 {
@@ -81,6 +85,53 @@ static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const Uni
     req->WriteReply(nStatus, strReply);
 }
 
+/** Sends the result of a single JSON-RPC call as a chunked HTTP reply, wrapped
+ * in the same envelope JSONRPCReply produces.
+ */
+class HTTPRPCResultStream : public RPCResultStream
+{
+private:
+    HTTPRequest* req;
+    UniValue id;
+    std::unique_ptr<JSONStreamWriter> writer;
+
+public:
+    HTTPRPCResultStream(HTTPRequest* reqIn, const UniValue& idIn) : req(reqIn), id(idIn) {}
+
+    bool IsStarted() const { return writer != nullptr; }
+
+    JSONStreamWriter& Begin() override
+    {
+        assert(!writer);
+        req->WriteHeader("Content-Type", "application/json");
+        req->StartChunkedReply(HTTP_OK);
+        HTTPRequest* reqChunks = req;
+        writer = MakeUnique<JSONStreamWriter>([reqChunks](const std::string& strChunk) {
+            reqChunks->WriteReplyChunk(strChunk);
+        });
+        writer->BeginObject();
+        writer->Key("result");
+        return *writer;
+    }
+
+    void Finish()
+    {
+        writer->KeyValue("error", NullUniValue);
+        writer->KeyValue("id", id);
+        writer->EndObject();
+        writer->Flush();
+        req->WriteReplyChunk("\n");
+        req->EndChunkedReply();
+    }
+
+    /** The status line is out already, so a failure half way can only cut the reply short */
+    void Abort()
+    {
+        writer->Flush();
+        req->EndChunkedReply();
+    }
+};
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool multiUserAuthorized(std::string strUserPass)
@@ -185,14 +236,29 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
 
-            UniValue result = tableRPC.execute(jreq);
+            HTTPRPCResultStream stream(req, jreq.id);
+            jreq.stream = &stream;
+            UniValue result;
+            try {
+                result = tableRPC.execute(jreq);
+            } catch (...) {
+                if (!stream.IsStarted())
+                    throw;
+                LogPrintf("%s: %s failed while streaming its result\n", __func__, jreq.strMethod);
+                stream.Abort();
+                return false;
+            }
+            if (stream.IsStarted()) {
+                stream.Finish();
+                return true;
+            }
 
             // Send reply
             strReply = JSONRPCReply(result, NullUniValue, jreq.id);
 
         // array of requests
         } else if (valRequest.isArray())
-            strReply = JSONRPCExecBatch(jreq, valRequest.get_array());
+            strReply = JSONRPCExecBatch(jreq, valRequest.get_array(), g_rpc_batch_max_bytes, g_rpc_batch_threads, QueueHTTPWorkIfIdle);
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
@@ -232,6 +298,11 @@ bool StartHTTPRPC()
     if (!InitRPCAuthentication())
         return false;
 
+    g_rpc_batch_threads = gArgs.GetArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS);
+    if (g_rpc_batch_threads <= 0)
+        g_rpc_batch_threads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
+    g_rpc_batch_max_bytes = std::max<int64_t>(gArgs.GetArg("-rpcbatchmaxmemory", DEFAULT_RPC_BATCH_MAX_MEMORY), 1) << 20;
+
     RegisterHTTPHandler("/", true, HTTPReq_JSONRPC);
 #ifdef ENABLE_WALLET
     // ifdef can be removed once we switch to better endpoint support and API versioning
@@ -252,6 +323,9 @@ void StopHTTPRPC()
 {
     LogPrint(BCLog::RPC, "Stopping HTTP RPC server\n");
     UnregisterHTTPHandler("/", true);
+#ifdef ENABLE_WALLET
+    UnregisterHTTPHandler("/wallet/", false);
+#endif
     if (httpRPCTimerInterface) {
         RPCUnsetTimerInterface(httpRPCTimerInterface.get());
         httpRPCTimerInterface.reset();
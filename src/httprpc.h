@@ -8,6 +8,11 @@
 #include <string>
 #include <map>
 
+//! -rpcbatchthreads default: a JSON-RPC batch may use every idle RPC thread
+static const int DEFAULT_RPC_BATCH_THREADS = 0;
+//! -rpcbatchmaxmemory default, in MiB of reply data per JSON-RPC batch
+static const unsigned int DEFAULT_RPC_BATCH_MAX_MEMORY = 256;
+
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
  */
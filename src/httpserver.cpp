@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <signal.h>
+#include <deque>
 #include <future>
 
 #include <event2/thread.h>
@@ -60,6 +61,22 @@ private:
     HTTPRequestHandler func;
 };
 
+/** Function work item, used to spread work such as JSON-RPC batches over idle workers */
+class HTTPFunctionItem final : public HTTPClosure
+{
+public:
+    explicit HTTPFunctionItem(const std::function<void()>& _func): func(_func)
+    {
+    }
+    void operator()() override
+    {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
  */
@@ -73,10 +90,12 @@ private:
     std::deque<std::unique_ptr<WorkItem>> queue;
     bool running;
     size_t maxDepth;
+    size_t numIdle;
 
 public:
     explicit WorkQueue(size_t _maxDepth) : running(true),
-                                 maxDepth(_maxDepth)
+                                 maxDepth(_maxDepth),
+                                 numIdle(0)
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
@@ -95,6 +114,18 @@ public:
         cond.notify_one();
         return true;
     }
+    /** Enqueue a work item only if a worker is waiting to pick it up right
+     * away, so that it never takes queue space from incoming requests */
+    bool EnqueueIfIdle(WorkItem* item)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        if (!running || queue.size() >= numIdle) {
+            return false;
+        }
+        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        cond.notify_one();
+        return true;
+    }
     /** Thread function */
     void Run()
     {
@@ -102,8 +133,10 @@ public:
             std::unique_ptr<WorkItem> i;
             {
                 std::unique_lock<std::mutex> lock(cs);
+                ++numIdle;
                 while (running && queue.empty())
                     cond.wait(lock);
+                --numIdle;
                 if (!running)
                     break;
                 i = std::move(queue.front());
@@ -445,6 +478,7 @@ void InterruptHTTPServer()
         for (evhttp_bound_socket *socket : boundSockets) {
             evhttp_del_accept_socket(eventHTTP, socket);
         }
+        boundSockets.clear();
         // Reject requests on current connections
         evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
     }
@@ -452,6 +486,17 @@ void InterruptHTTPServer()
         workQueue->Interrupt();
 }
 
+bool QueueHTTPWorkIfIdle(const std::function<void()>& func)
+{
+    if (!workQueue)
+        return false;
+    std::unique_ptr<HTTPFunctionItem> item(new HTTPFunctionItem(func));
+    if (!workQueue->EnqueueIfIdle(item.get()))
+        return false;
+    item.release(); /* if true, queue took ownership */
+    return true;
+}
+
 void StopHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Stopping HTTP server\n");
@@ -606,6 +651,143 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     req = nullptr; // transferred back to main thread
 }
 
+/** Flow control for a chunked reply: how much of it is queued for the http
+ * thread or sits in the output buffer of the connection, and whether the
+ * connection is gone. A client that stops reading is dropped by the
+ * -rpcservertimeout write timeout, which ends the wait of the worker.
+ */
+struct HTTPChunkedReply
+{
+    std::mutex cs;
+    std::condition_variable cond;
+    size_t nQueued = 0;
+    size_t nBuffered = 0;
+    bool fClosed = false;
+
+    // Only used on the http thread
+    struct evbuffer* output = nullptr;
+    struct evbuffer_cb_entry* outputCb = nullptr;
+
+    void SetClosed()
+    {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            fClosed = true;
+        }
+        cond.notify_all();
+    }
+
+    /** Stop watching the connection */
+    void Detach(struct evhttp_connection* conn)
+    {
+        if (outputCb) {
+            evbuffer_remove_cb_entry(output, outputCb);
+            outputCb = nullptr;
+            evhttp_connection_set_closecb(conn, nullptr, nullptr);
+        }
+    }
+};
+
+static void http_chunked_output_cb(struct evbuffer* buf, const struct evbuffer_cb_info*, void* arg)
+{
+    HTTPChunkedReply* chunked = static_cast<HTTPChunkedReply*>(arg);
+    {
+        std::lock_guard<std::mutex> lock(chunked->cs);
+        chunked->nBuffered = evbuffer_get_length(buf);
+    }
+    chunked->cond.notify_all();
+}
+
+static void http_chunked_close_cb(struct evhttp_connection* conn, void* arg)
+{
+    HTTPChunkedReply* chunked = static_cast<HTTPChunkedReply*>(arg);
+    chunked->Detach(conn);
+    chunked->SetClosed();
+}
+
+/** Chunked replies go through the main http thread too. Events triggered
+ * from one thread are run in the order they were triggered, which keeps the
+ * chunks of a reply in order.
+ */
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && req);
+    chunked = std::make_shared<HTTPChunkedReply>();
+    auto req_copy = req;
+    auto chunked_copy = chunked;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus, chunked_copy]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+        evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+        bufferevent* bev = conn ? evhttp_connection_get_bufferevent(conn) : nullptr;
+        if (!bev) {
+            chunked_copy->SetClosed();
+            return;
+        }
+        chunked_copy->output = bufferevent_get_output(bev);
+        chunked_copy->outputCb = evbuffer_add_cb(chunked_copy->output, http_chunked_output_cb, chunked_copy.get());
+        evhttp_connection_set_closecb(conn, http_chunked_close_cb, chunked_copy.get());
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+}
+
+void HTTPRequest::WriteReplyChunk(const std::string& strChunk)
+{
+    assert(replySent && req && chunked);
+    if (strChunk.empty())
+        return;
+    {
+        std::unique_lock<std::mutex> lock(chunked->cs);
+        while (!chunked->fClosed && chunked->nQueued + chunked->nBuffered > MAX_HTTP_REPLY_BUFFERED)
+            chunked->cond.wait(lock);
+        if (chunked->fClosed)
+            return;
+        chunked->nQueued += strChunk.size();
+    }
+    struct evbuffer* evb = evbuffer_new();
+    assert(evb);
+    evbuffer_add(evb, strChunk.data(), strChunk.size());
+    auto req_copy = req;
+    auto chunked_copy = chunked;
+    size_t nSize = strChunk.size();
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, evb, chunked_copy, nSize]{
+        evhttp_send_reply_chunk(req_copy, evb);
+        evbuffer_free(evb);
+        {
+            std::lock_guard<std::mutex> lock(chunked_copy->cs);
+            chunked_copy->nQueued -= nSize;
+        }
+        chunked_copy->cond.notify_all();
+    });
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(replySent && req && chunked);
+    auto req_copy = req;
+    auto chunked_copy = chunked;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, chunked_copy]{
+        evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+        if (conn)
+            chunked_copy->Detach(conn);
+        evhttp_send_reply_end(req_copy);
+        // Re-enable reading from the socket, as in WriteReply
+        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+            if (conn) {
+                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+                if (bev) {
+                    bufferevent_enable(bev, EV_READ | EV_WRITE);
+                }
+            }
+        }
+    });
+    ev->trigger(nullptr);
+    req = nullptr; // transferred back to main thread
+    chunked.reset();
+}
+
 CService HTTPRequest::GetPeer()
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
@@ -8,14 +8,18 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <memory>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+/** Bytes of a chunked reply that may wait for the client before WriteReplyChunk blocks */
+static const size_t MAX_HTTP_REPLY_BUFFERED=1 << 20;
 
 struct evhttp_request;
 struct event_base;
 class CService;
+struct HTTPChunkedReply;
 class HTTPRequest;
 
 /** Initialize HTTP server.
@@ -46,6 +50,12 @@ void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPR
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Run func on one of the HTTP worker threads, but only if one is idle.
+ * Returns false without queueing anything otherwise; the caller should then
+ * do the work itself.
+ */
+bool QueueHTTPWorkIfIdle(const std::function<void()>& func);
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -59,6 +69,7 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    std::shared_ptr<HTTPChunkedReply> chunked;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req);
@@ -114,6 +125,30 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Start a reply whose body is sent in pieces with WriteReplyChunk (using
+     * chunked transfer encoding for HTTP/1.1 clients), finished by
+     * EndChunkedReply.
+     *
+     * @note Takes the place of WriteReply, so can be called only once. Write
+     * headers before calling this.
+     */
+    void StartChunkedReply(int nStatus);
+
+    /**
+     * Queue a piece of the body of a chunked reply. Chunks are sent in the
+     * order they were queued. Blocks while more than MAX_HTTP_REPLY_BUFFERED
+     * bytes are waiting for the client to read them; once the connection is
+     * gone the chunks are dropped.
+     */
+    void WriteReplyChunk(const std::string& strChunk);
+
+    /**
+     * Finish a chunked reply. As this will give the request back to the main
+     * thread, do not call any other HTTPRequest methods after calling this.
+     */
+    void EndChunkedReply();
 };
 
 /** Event handler closure.
@@ -0,0 +1,338 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/base.h>
+
+#include <chainparams.h>
+#include <init.h>
+#include <tinyformat.h>
+#include <ui_interface.h>
+#include <util.h>
+#include <utiltime.h>
+#include <validation.h>
+#include <warnings.h>
+
+static const char DB_BEST_BLOCK = 'B';
+
+static const int64_t SYNC_LOG_INTERVAL = 30; // seconds
+static const int64_t SYNC_LOCATOR_WRITE_INTERVAL = 30; // seconds
+
+template<typename... Args>
+static void FatalError(const char* fmt, const Args&... args)
+{
+    std::string strMessage = tfm::format(fmt, args...);
+    SetMiscWarning(strMessage);
+    LogPrintf("*** %s\n", strMessage);
+    uiInterface.ThreadSafeMessageBox(
+        "Error: A fatal internal error occurred, see debug.log for details",
+        "", CClientUIInterface::MSG_ERROR);
+    StartShutdown();
+}
+
+BaseIndex::DB::DB(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate) :
+    CDBWrapper(path, nCacheSize, fMemory, fWipe, obfuscate)
+{}
+
+bool BaseIndex::DB::ReadBestBlock(CBlockLocator& locator) const
+{
+    bool success = Read(DB_BEST_BLOCK, locator);
+    if (!success) {
+        locator.SetNull();
+    }
+    return success;
+}
+
+bool BaseIndex::DB::WriteBestBlock(const CBlockLocator& locator)
+{
+    return Write(DB_BEST_BLOCK, locator);
+}
+
+BaseIndex::BaseIndex() : fSynced(false), pbestBlockIndex(nullptr)
+{
+}
+
+BaseIndex::~BaseIndex()
+{
+    Interrupt();
+    Stop();
+}
+
+bool BaseIndex::Init()
+{
+    CBlockLocator locator;
+    if (!GetDB().ReadBestBlock(locator)) {
+        locator.SetNull();
+    }
+
+    LOCK(cs_main);
+    if (locator.IsNull()) {
+        pbestBlockIndex = nullptr;
+    } else {
+        pbestBlockIndex = FindForkInGlobalIndex(chainActive, locator);
+    }
+    fSynced = pbestBlockIndex.load() == chainActive.Tip();
+    return true;
+}
+
+static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindexPrev)
+{
+    AssertLockHeld(cs_main);
+
+    if (!pindexPrev) {
+        return chainActive.Genesis();
+    }
+
+    const CBlockIndex* pindex = chainActive.Next(pindexPrev);
+    if (pindex) {
+        return pindex;
+    }
+
+    // The index is on a branch that is no longer active: resume from the fork
+    return chainActive.Next(chainActive.FindFork(pindexPrev));
+}
+
+size_t BaseIndex::WriteBlocks(const std::vector<const CBlockIndex*>& vIndex)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    size_t nWritten = 0;
+    for (const CBlockIndex* pindex : vIndex) {
+        if (interrupt) {
+            break;
+        }
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, consensusParams)) {
+            error("%s: Failed to read block %s from disk",
+                  __func__, pindex->GetBlockHash().ToString());
+            break;
+        }
+        if (!WriteBlock(block, pindex)) {
+            break;
+        }
+        ++nWritten;
+    }
+    return nWritten;
+}
+
+void BaseIndex::ThreadSync()
+{
+    const CBlockIndex* pindex = pbestBlockIndex.load();
+    if (!fSynced) {
+        int64_t nLastLogTime = 0;
+        int64_t nLastLocatorWriteTime = 0;
+        size_t nBatchSize = std::max<size_t>(1, GetSyncBatchSize());
+        while (true) {
+            if (interrupt) {
+                WriteBestBlock(pindex);
+                return;
+            }
+
+            std::vector<const CBlockIndex*> vIndex;
+            {
+                LOCK(cs_main);
+                const CBlockIndex* pindexNext = NextSyncBlock(pindex);
+                if (!pindexNext) {
+                    WriteBestBlock(pindex);
+                    pbestBlockIndex = pindex;
+                    fSynced = true;
+                    break;
+                }
+                vIndex.push_back(pindexNext);
+                while (vIndex.size() < nBatchSize) {
+                    pindexNext = chainActive.Next(vIndex.back());
+                    if (!pindexNext) {
+                        break;
+                    }
+                    vIndex.push_back(pindexNext);
+                }
+            }
+
+            int64_t nCurrentTime = GetTime();
+            if (nLastLogTime + SYNC_LOG_INTERVAL < nCurrentTime) {
+                LogPrintf("Syncing %s with block chain from height %d\n",
+                          GetName(), vIndex.front()->nHeight);
+                nLastLogTime = nCurrentTime;
+            }
+
+            size_t nWritten = WriteBlocks(vIndex);
+            if (nWritten > 0) {
+                pindex = vIndex[nWritten - 1];
+                pbestBlockIndex = pindex;
+            }
+            if (nWritten < vIndex.size()) {
+                if (!interrupt) {
+                    FatalError("%s: Failed to write block %s to index database",
+                               __func__, vIndex[nWritten]->GetBlockHash().ToString());
+                }
+                WriteBestBlock(pindex);
+                return;
+            }
+
+            if (nLastLocatorWriteTime + SYNC_LOCATOR_WRITE_INTERVAL < nCurrentTime) {
+                WriteBestBlock(pindex);
+                nLastLocatorWriteTime = nCurrentTime;
+            }
+        }
+    }
+
+    if (pindex) {
+        LogPrintf("%s is enabled at height %d\n", GetName(), pindex->nHeight);
+    } else {
+        LogPrintf("%s is enabled\n", GetName());
+    }
+}
+
+bool BaseIndex::WriteBestBlock(const CBlockIndex* pindex)
+{
+    if (!pindex) {
+        return true;
+    }
+
+    CBlockLocator locator;
+    {
+        LOCK(cs_main);
+        locator = chainActive.GetLocator(pindex);
+    }
+    if (!GetDB().WriteBestBlock(locator)) {
+        return error("%s: Failed to write locator to disk", __func__);
+    }
+    return true;
+}
+
+void BaseIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                               const std::vector<CTransactionRef>& txnConflicted)
+{
+    if (!fSynced) {
+        return;
+    }
+
+    const CBlockIndex* pbest = pbestBlockIndex.load();
+    if (!pbest) {
+        if (pindex->nHeight != 0) {
+            FatalError("%s: First block connected is not the genesis block (height=%d)",
+                       __func__, pindex->nHeight);
+            return;
+        }
+    } else {
+        // The sync thread may have indexed this block itself just before
+        // handing over, while its notification was still queued.
+        if (pbest->GetAncestor(pindex->nHeight) == pindex) {
+            return;
+        }
+
+        // Ensure the block connects to an ancestor of the current best block.
+        // Right after the sync thread caught up this may not be the case if
+        // blocks of a stale branch are still in the notification queue; they
+        // are of no interest anymore, so let the queue clear.
+        if (pbest->GetAncestor(pindex->nHeight - 1) != pindex->pprev) {
+            LogPrintf("%s: WARNING: Block %s does not connect to an ancestor of known best chain "
+                      "(tip=%s); not updating index\n",
+                      __func__, pindex->GetBlockHash().ToString(),
+                      pbest->GetBlockHash().ToString());
+            return;
+        }
+    }
+
+    if (WriteBlock(*block, pindex)) {
+        pbestBlockIndex = pindex;
+    } else {
+        FatalError("%s: Failed to write block %s to index",
+                   __func__, pindex->GetBlockHash().ToString());
+        return;
+    }
+}
+
+void BaseIndex::SetBestChain(const CBlockLocator& locator)
+{
+    if (!fSynced) {
+        return;
+    }
+
+    if (locator.vHave.empty()) {
+        return;
+    }
+    const uint256& hashTip = locator.vHave.front();
+
+    const CBlockIndex* pindexTip;
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(hashTip);
+        if (it == mapBlockIndex.end()) {
+            FatalError("%s: First block (hash=%s) in locator was not found",
+                       __func__, hashTip.ToString());
+            return;
+        }
+        pindexTip = it->second;
+    }
+
+    // This checks that SetBestChain callbacks are received after BlockConnected.
+    // The check may fail immediately after the sync thread catches up and sets
+    // fSynced. Consider the case where there is a reorg and the blocks on the
+    // stale branch are in the notification queue backlog even after the sync
+    // thread has caught up to the new chain tip. In this unlikely event, log a
+    // warning and let the queue clear.
+    const CBlockIndex* pbest = pbestBlockIndex.load();
+    if (!pbest || pbest->GetAncestor(pindexTip->nHeight) != pindexTip) {
+        LogPrintf("%s: WARNING: Locator contains block (hash=%s) not on known best "
+                  "chain (tip=%s); not writing index locator\n",
+                  __func__, hashTip.ToString(),
+                  pbest ? pbest->GetBlockHash().ToString() : "null");
+        return;
+    }
+
+    if (!GetDB().WriteBestBlock(locator)) {
+        error("%s: Failed to write locator to disk", __func__);
+    }
+}
+
+bool BaseIndex::BlockUntilSyncedToCurrentChain()
+{
+    if (!fSynced) {
+        return false;
+    }
+
+    {
+        // Skip the queue-draining stuff if we know we're caught up with
+        // chainActive.Tip().
+        LOCK(cs_main);
+        const CBlockIndex* pindexTip = chainActive.Tip();
+        const CBlockIndex* pbest = pbestBlockIndex.load();
+        if (pbest && pindexTip && pbest->GetAncestor(pindexTip->nHeight) == pindexTip) {
+            return true;
+        }
+    }
+
+    LogPrintf("%s: %s is catching up on block notifications\n", __func__, GetName());
+    SyncWithValidationInterfaceQueue();
+    return true;
+}
+
+void BaseIndex::Interrupt()
+{
+    interrupt();
+}
+
+bool BaseIndex::Start()
+{
+    // Need to register this ValidationInterface before running Init(), so that
+    // callbacks are not missed if Init sets fSynced to true.
+    RegisterValidationInterface(this);
+    if (!Init()) {
+        FatalError("%s: %s failed to initialize", __func__, GetName());
+        return false;
+    }
+
+    threadSync = std::thread(&TraceThread<std::function<void()>>, GetName(),
+                             std::function<void()>(std::bind(&BaseIndex::ThreadSync, this)));
+    return true;
+}
+
+void BaseIndex::Stop()
+{
+    UnregisterValidationInterface(this);
+
+    if (threadSync.joinable()) {
+        threadSync.join();
+    }
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BASE_H
+#define BITCOIN_INDEX_BASE_H
+
+#include <dbwrapper.h>
+#include <primitives/block.h>
+#include <threadinterrupt.h>
+#include <validationinterface.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class CBlockIndex;
+
+/**
+ * Base class for indices of blockchain data, kept in their own database
+ * under blocks/index/. An index is built in the background: on start it
+ * catches up from the last block it committed to the active chain tip on
+ * its own thread, then follows the tip through BlockConnected
+ * notifications. It records the chain it has indexed as a block locator,
+ * so it can be enabled or resumed at any time without a reindex.
+ */
+class BaseIndex : public CValidationInterface
+{
+protected:
+    class DB : public CDBWrapper
+    {
+    public:
+        DB(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+
+        /** Read the locator of the chain the index is in sync with */
+        bool ReadBestBlock(CBlockLocator& locator) const;
+        /** Write the locator of the chain the index is in sync with */
+        bool WriteBestBlock(const CBlockLocator& locator);
+    };
+
+private:
+    /**
+     * Whether the index caught up with the active chain: from then on it is
+     * updated by BlockConnected notifications instead of the sync thread.
+     * Only set with cs_main held, so a block connected at the same time is
+     * picked up by exactly one of them.
+     */
+    std::atomic<bool> fSynced;
+
+    /** The last block in the chain that the index is in sync with */
+    std::atomic<const CBlockIndex*> pbestBlockIndex;
+
+    std::thread threadSync;
+    CThreadInterrupt interrupt;
+
+    /**
+     * Sync the index with the block index starting from the current best
+     * block. Intended to be run in its own thread, threadSync, and can be
+     * interrupted with interrupt. Once the index gets in sync, fSynced is
+     * set and BlockConnected takes over.
+     */
+    void ThreadSync();
+
+    /** Write the current chain block locator to the DB */
+    bool WriteBestBlock(const CBlockIndex* pindex);
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                        const std::vector<CTransactionRef>& txnConflicted) override;
+
+    void SetBestChain(const CBlockLocator& locator) override;
+
+    /** Initialize internal state from the database and block index */
+    virtual bool Init();
+
+    /** Write update index entries for a newly connected block */
+    virtual bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) { return true; }
+
+    /**
+     * Write index entries for a run of successive blocks of the active chain
+     * during the initial sync. The default reads and writes them one by one;
+     * indices that can build entries concurrently override this.
+     * Returns the number of blocks written, all of them unless the sync was
+     * interrupted or an error occurred, which stops the node.
+     */
+    virtual size_t WriteBlocks(const std::vector<const CBlockIndex*>& vIndex);
+
+    /** Number of blocks the sync thread hands to WriteBlocks at once */
+    virtual size_t GetSyncBatchSize() const { return 1; }
+
+    /** Whether the sync thread was asked to stop */
+    bool IsInterrupted() const { return static_cast<bool>(interrupt); }
+
+    virtual DB& GetDB() const = 0;
+
+    /** Get the name of the index for display in logs */
+    virtual const char* GetName() const = 0;
+
+public:
+    BaseIndex();
+    virtual ~BaseIndex();
+
+    /** Whether the index caught up with the active chain */
+    bool IsSynced() const { return fSynced; }
+
+    /** The last block the index is in sync with, or nullptr if none */
+    const CBlockIndex* GetBestBlockIndex() const { return pbestBlockIndex; }
+
+    /**
+     * Blocks the current thread until the index is caught up to the current
+     * state of the block chain. This only blocks if the index has gotten in
+     * sync once and only needs to process blocks in the ValidationInterface
+     * queue. If the index is catching up from far behind, this method does
+     * not block and immediately returns false.
+     */
+    bool BlockUntilSyncedToCurrentChain();
+
+    void Interrupt();
+
+    /** Start initializes the sync state and registers the instance as a
+     * ValidationInterface so that it stays in sync with blockchain updates. */
+    bool Start();
+
+    /** Stops the instance from staying in sync with blockchain updates. */
+    void Stop();
+};
+
+#endif // BITCOIN_INDEX_BASE_H
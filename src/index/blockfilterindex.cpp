@@ -0,0 +1,178 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockfilterindex.h>
+
+#include <chainparams.h>
+#include <undo.h>
+#include <util.h>
+#include <validation.h>
+
+#include <atomic>
+#include <thread>
+
+/* The database stores one entry per indexed block, keyed by block hash:
+ *
+ *   'f' + block hash -> (filter hash, filter header, encoded filter)
+ *
+ * Entries of blocks that were disconnected are kept, so a reorg back onto
+ * their branch does not need to rebuild them.
+ */
+static const char DB_BLOCK_FILTER = 'f';
+
+std::unique_ptr<BlockFilterIndex> g_blockfilterindex;
+
+namespace {
+
+struct DBVal {
+    uint256 hash;
+    uint256 header;
+    std::vector<unsigned char> vEncoded;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hash);
+        READWRITE(header);
+        READWRITE(vEncoded);
+    }
+};
+
+} // namespace
+
+BlockFilterIndex::BlockFilterIndex(BlockFilterType filterTypeIn, size_t nCacheSize, bool fMemory, bool fWipe)
+    : filterType(filterTypeIn)
+{
+    const std::string& strFilterName = BlockFilterTypeName(filterType);
+    if (strFilterName.empty()) throw std::invalid_argument("unknown filter_type");
+
+    strName = strFilterName + " block filter index";
+    db = MakeUnique<BaseIndex::DB>(GetDataDir() / "blocks" / "index" / "blockfilter" / strFilterName,
+                                   nCacheSize, fMemory, fWipe);
+    nSyncThreads = std::max(1, std::min(GetNumCores(), MAX_BLOCKFILTERINDEX_SYNC_THREADS));
+}
+
+static bool BuildFilter(BlockFilterType filterType, const CBlockIndex* pindex, const CBlock& block, BlockFilter& filterOut)
+{
+    CBlockUndo blockUndo;
+    // The genesis block spends nothing and has no undo data
+    if (pindex->nHeight > 0 && !UndoReadFromDisk(blockUndo, pindex)) {
+        return error("%s: Failed to read undo data of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    filterOut = BlockFilter(filterType, block, blockUndo);
+    return true;
+}
+
+bool BlockFilterIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    uint256 prevHeader;
+    if (pindex->pprev && !LookupFilterHeader(pindex->pprev, prevHeader)) {
+        return error("%s: Filter header of block %s not found", __func__, pindex->pprev->GetBlockHash().ToString());
+    }
+
+    BlockFilter filter;
+    if (!BuildFilter(filterType, pindex, block, filter)) {
+        return false;
+    }
+
+    DBVal value;
+    value.hash = filter.GetHash();
+    value.header = filter.ComputeHeader(prevHeader);
+    value.vEncoded = filter.GetEncodedFilter();
+    if (!db->Write(std::make_pair(DB_BLOCK_FILTER, pindex->GetBlockHash()), value)) {
+        return error("%s: Failed to write filter of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    return true;
+}
+
+size_t BlockFilterIndex::WriteBlocks(const std::vector<const CBlockIndex*>& vIndex)
+{
+    if (vIndex.empty()) {
+        return 0;
+    }
+
+    uint256 prevHeader;
+    const CBlockIndex* pindexPrev = vIndex.front()->pprev;
+    if (pindexPrev && !LookupFilterHeader(pindexPrev, prevHeader)) {
+        error("%s: Filter header of block %s not found", __func__, pindexPrev->GetBlockHash().ToString());
+        return 0;
+    }
+
+    // Reading a block and its undo data and hashing its scripts is
+    // independent of the other blocks, only the headers need to be chained
+    // in order. Let the threads claim blocks one at a time.
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    std::vector<BlockFilter> vFilters(vIndex.size());
+    std::vector<char> vBuilt(vIndex.size(), 0);
+    std::atomic<size_t> nNext(0);
+    std::function<void()> build = [&] {
+        size_t i;
+        while (!IsInterrupted() && (i = nNext++) < vIndex.size()) {
+            CBlock block;
+            if (!ReadBlockFromDisk(block, vIndex[i], consensusParams)) {
+                error("%s: Failed to read block %s from disk", __func__, vIndex[i]->GetBlockHash().ToString());
+                return;
+            }
+            if (!BuildFilter(filterType, vIndex[i], block, vFilters[i])) {
+                return;
+            }
+            vBuilt[i] = 1;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    int nThreads = std::min<int>(nSyncThreads, vIndex.size());
+    for (int i = 1; i < nThreads; i++) {
+        threads.emplace_back(&TraceThread<std::function<void()>>, "blkfilter", build);
+    }
+    build();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CDBBatch batch(*db);
+    size_t nWritten = 0;
+    while (nWritten < vIndex.size() && vBuilt[nWritten]) {
+        const BlockFilter& filter = vFilters[nWritten];
+        DBVal value;
+        value.hash = filter.GetHash();
+        value.header = filter.ComputeHeader(prevHeader);
+        value.vEncoded = filter.GetEncodedFilter();
+        batch.Write(std::make_pair(DB_BLOCK_FILTER, vIndex[nWritten]->GetBlockHash()), value);
+        prevHeader = value.header;
+        ++nWritten;
+    }
+    if (nWritten > 0 && !db->WriteBatch(batch)) {
+        error("%s: Failed to write filters to index database", __func__);
+        return 0;
+    }
+    return nWritten;
+}
+
+bool BlockFilterIndex::LookupFilter(const CBlockIndex* pindex, BlockFilter& filterOut) const
+{
+    DBVal value;
+    if (!db->Read(std::make_pair(DB_BLOCK_FILTER, pindex->GetBlockHash()), value)) {
+        return false;
+    }
+
+    try {
+        filterOut = BlockFilter(filterType, pindex->GetBlockHash(), std::move(value.vEncoded));
+    } catch (const std::exception& e) {
+        return error("%s: Invalid filter of block %s in index database: %s", __func__, pindex->GetBlockHash().ToString(), e.what());
+    }
+    return true;
+}
+
+bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* pindex, uint256& headerOut) const
+{
+    DBVal value;
+    if (!db->Read(std::make_pair(DB_BLOCK_FILTER, pindex->GetBlockHash()), value)) {
+        return false;
+    }
+    headerOut = value.header;
+    return true;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BLOCKFILTERINDEX_H
+#define BITCOIN_INDEX_BLOCKFILTERINDEX_H
+
+#include <blockfilter.h>
+#include <index/base.h>
+
+#include <memory>
+#include <string>
+
+class CBlockIndex;
+
+static const bool DEFAULT_BLOCKFILTERINDEX = false;
+//! Max memory allocated to the block filter index DB specific cache in MiB
+static const int64_t nMaxBlockFilterIndexCache = 1024;
+//! Max threads building filters while the index catches up with the chain
+static const int MAX_BLOCKFILTERINDEX_SYNC_THREADS = 8;
+//! Blocks per sync batch and thread
+static const int BLOCKFILTERINDEX_SYNC_BATCH = 16;
+
+/**
+ * BlockFilterIndex keeps the BIP 158 filter of every block and the chain of
+ * filter headers committing to them, keyed by block hash, so filters stay
+ * available for blocks of stale branches too. While catching up with the
+ * chain, filters of a batch of blocks are built by several threads at once
+ * and written together; the headers are then chained in block order.
+ */
+class BlockFilterIndex final : public BaseIndex
+{
+private:
+    BlockFilterType filterType;
+    std::string strName;
+    std::unique_ptr<BaseIndex::DB> db;
+    int nSyncThreads;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    size_t WriteBlocks(const std::vector<const CBlockIndex*>& vIndex) override;
+
+    size_t GetSyncBatchSize() const override { return nSyncThreads * BLOCKFILTERINDEX_SYNC_BATCH; }
+
+    BaseIndex::DB& GetDB() const override { return *db; }
+
+    const char* GetName() const override { return strName.c_str(); }
+
+public:
+    /** Constructs the index, which becomes available to be queried. */
+    explicit BlockFilterIndex(BlockFilterType filterType, size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    BlockFilterType GetFilterType() const { return filterType; }
+
+    /** Get the filter of a block; returns false if the block is not indexed (yet) */
+    bool LookupFilter(const CBlockIndex* pindex, BlockFilter& filterOut) const;
+
+    /** Get the filter header of a block; returns false if the block is not indexed (yet) */
+    bool LookupFilterHeader(const CBlockIndex* pindex, uint256& headerOut) const;
+};
+
+/** The basic block filter index, if enabled with -blockfilterindex */
+extern std::unique_ptr<BlockFilterIndex> g_blockfilterindex;
+
+#endif // BITCOIN_INDEX_BLOCKFILTERINDEX_H
@@ -0,0 +1,229 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/txindex.h>
+
+#include <blockcompression.h>
+#include <chainparams.h>
+#include <txdb.h>
+#include <util.h>
+#include <validation.h>
+
+/* The database stores one entry per transaction:
+ *
+ *   't' + txid -> position of the transaction on disk
+ *
+ * Older versions used the same entries in the block tree database, along
+ * with the block tree flag "txindex".
+ */
+static const char DB_TXINDEX = 't';
+
+//! Bytes of entries moved from the block tree database per batch
+static const size_t MIGRATE_BATCH_SIZE = 16 << 20;
+
+std::unique_ptr<TxIndex> g_txindex;
+
+TxIndex::TxIndex(size_t nCacheSize, bool fMemory, bool fWipe)
+    : db(MakeUnique<BaseIndex::DB>(GetDataDir() / "blocks" / "index" / "txindex", nCacheSize, fMemory, fWipe))
+{
+}
+
+/**
+ * Erase the legacy entries from the block tree database batch by batch,
+ * copying them to pdb first unless it is null. Returns the number of
+ * entries in nEntries.
+ */
+static bool MoveLegacyEntries(CBlockTreeDB& blockTreeDB, CDBWrapper* pdb, uint64_t& nEntries)
+{
+    nEntries = 0;
+    std::unique_ptr<CDBIterator> pcursor(blockTreeDB.NewIterator());
+    pcursor->Seek(std::make_pair(DB_TXINDEX, uint256()));
+    while (true) {
+        CDBBatch batch(pdb ? *pdb : static_cast<CDBWrapper&>(blockTreeDB));
+        CDBBatch batchErase(blockTreeDB);
+        std::pair<char, uint256> key;
+        CDiskTxPos pos;
+        while (batchErase.SizeEstimate() < MIGRATE_BATCH_SIZE && pcursor->Valid() &&
+               pcursor->GetKey(key) && key.first == DB_TXINDEX) {
+            if (pdb) {
+                if (!pcursor->GetValue(pos)) {
+                    return error("%s: Failed to read transaction index entry %s", __func__, key.second.ToString());
+                }
+                batch.Write(key, pos);
+            }
+            batchErase.Erase(key);
+            ++nEntries;
+            pcursor->Next();
+        }
+        if (batchErase.SizeEstimate() == 0) {
+            break;
+        }
+        if ((pdb && !pdb->WriteBatch(batch, true)) || !blockTreeDB.WriteBatch(batchErase)) {
+            return error("%s: Failed to move transaction index entries", __func__);
+        }
+    }
+    return true;
+}
+
+bool EraseLegacyTxIndex(CBlockTreeDB& blockTreeDB)
+{
+    bool fLegacyIndex = false;
+    blockTreeDB.ReadFlag("txindex", fLegacyIndex);
+
+    // Entries are erased before the flag, so an interrupted run is completed
+    // on the next start
+    uint64_t nErased = 0;
+    if (!MoveLegacyEntries(blockTreeDB, nullptr, nErased)) {
+        return false;
+    }
+    if (fLegacyIndex && !blockTreeDB.WriteFlag("txindex", false)) {
+        return error("%s: Failed to clear the transaction index flag", __func__);
+    }
+    if (nErased > 0) {
+        LogPrintf("Erased %u transaction index entries left in the block tree database by an older version\n", nErased);
+    }
+    return true;
+}
+
+bool TxIndex::MigrateLegacyIndex(CBlockTreeDB& blockTreeDB)
+{
+    bool fLegacyIndex = false;
+    if (!blockTreeDB.ReadFlag("txindex", fLegacyIndex) || !fLegacyIndex) {
+        // Entries without the flag are stale, e.g. left by an erase that
+        // was interrupted
+        return EraseLegacyTxIndex(blockTreeDB);
+    }
+
+    // The legacy index was written as blocks were connected, so it covers
+    // the active chain. Entries are copied and then erased from the block
+    // tree database batch by batch; if interrupted, the migration resumes
+    // with the remaining entries on the next start.
+    LogPrintf("Moving transaction index from the block tree database to %s\n", (GetDataDir() / "blocks" / "index" / "txindex").string());
+    uint64_t nMoved = 0;
+    if (!MoveLegacyEntries(blockTreeDB, db.get(), nMoved)) {
+        return false;
+    }
+
+    CBlockLocator locator;
+    {
+        LOCK(cs_main);
+        locator = chainActive.GetLocator();
+    }
+    if (!db->WriteBestBlock(locator) || !blockTreeDB.WriteFlag("txindex", false)) {
+        return error("%s: Failed to complete transaction index migration", __func__);
+    }
+    LogPrintf("Moved %u transaction index entries\n", nMoved);
+    return true;
+}
+
+bool TxIndex::Init()
+{
+    if (!MigrateLegacyIndex(*pblocktree)) {
+        return false;
+    }
+    return BaseIndex::Init();
+}
+
+/** Add the positions of the transactions of a block to batch */
+static void AddBlockTxPositions(CDBBatch& batch, const CBlock& block, const CBlockIndex* pindex)
+{
+    CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
+    for (const CTransactionRef& tx : block.vtx) {
+        batch.Write(std::make_pair(DB_TXINDEX, tx->GetHash()), pos);
+        pos.nTxOffset += ::GetSerializeSize(*tx, SER_DISK, CLIENT_VERSION);
+    }
+}
+
+bool TxIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CDBBatch batch(*db);
+    AddBlockTxPositions(batch, block, pindex);
+    if (!db->WriteBatch(batch)) {
+        return error("%s: Failed to write transactions of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    return true;
+}
+
+size_t TxIndex::WriteBlocks(const std::vector<const CBlockIndex*>& vIndex)
+{
+    // Collect the entries of the whole batch of blocks in one database write
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CDBBatch batch(*db);
+    size_t nRead = 0;
+    for (const CBlockIndex* pindex : vIndex) {
+        if (IsInterrupted()) {
+            break;
+        }
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, consensusParams)) {
+            error("%s: Failed to read block %s from disk", __func__, pindex->GetBlockHash().ToString());
+            break;
+        }
+        AddBlockTxPositions(batch, block, pindex);
+        ++nRead;
+    }
+    if (nRead > 0 && !db->WriteBatch(batch)) {
+        error("%s: Failed to write transactions to index database", __func__);
+        return 0;
+    }
+    return nRead;
+}
+
+/** Look up a transaction by reading the whole block, for blocks stored compressed */
+static bool FindTxInBlock(const CDiskBlockPos& pos, const uint256& txid, uint256& hashBlock, CTransactionRef& tx)
+{
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pos, Params().GetConsensus())) {
+        return false;
+    }
+    for (const CTransactionRef& blockTx : block.vtx) {
+        if (blockTx->GetHash() == txid) {
+            tx = blockTx;
+            hashBlock = block.GetHash();
+            return true;
+        }
+    }
+    return error("%s: txid %s not found in block", __func__, txid.ToString());
+}
+
+bool TxIndex::FindTx(const uint256& txid, uint256& hashBlock, CTransactionRef& tx) const
+{
+    CDiskTxPos postx;
+    if (!db->Read(std::make_pair(DB_TXINDEX, txid), postx)) {
+        return false;
+    }
+
+    // Open the block file at the index header of the block record
+    if (postx.nPos < 8) {
+        return error("%s: Invalid transaction position", __func__);
+    }
+    CAutoFile file(OpenBlockFile(CDiskBlockPos(postx.nFile, postx.nPos - 8), true), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        return error("%s: OpenBlockFile failed", __func__);
+    }
+    CBlockHeader header;
+    try {
+        CMessageHeader::MessageStartChars blkStart;
+        unsigned int nSize;
+        file >> FLATDATA(blkStart) >> nSize;
+        if (nSize & DISK_RECORD_COMPRESSED) {
+            // Transactions of compressed blocks can't be read on their own
+            file.fclose();
+            return FindTxInBlock(postx, txid, hashBlock, tx);
+        }
+        file >> header;
+        if (fseek(file.Get(), postx.nTxOffset, SEEK_CUR)) {
+            return error("%s: fseek(...) failed", __func__);
+        }
+        file >> tx;
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+    }
+    if (tx->GetHash() != txid) {
+        return error("%s: txid mismatch", __func__);
+    }
+    hashBlock = header.GetHash();
+    return true;
+}
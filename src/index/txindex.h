@@ -0,0 +1,77 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TXINDEX_H
+#define BITCOIN_INDEX_TXINDEX_H
+
+#include <index/base.h>
+#include <primitives/transaction.h>
+
+#include <memory>
+
+class CBlockTreeDB;
+
+//! Max memory allocated to the transaction index DB specific cache in MiB
+// Unlike for the UTXO database, for the txindex scenario the leveldb cache make
+// a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
+static const int64_t nMaxTxIndexCache = 1024;
+//! Blocks per sync batch, written to the database at once
+static const int TXINDEX_SYNC_BATCH = 64;
+
+/**
+ * TxIndex maps the hash of every transaction in the active chain to its
+ * position on disk. It is built in the background and follows the chain
+ * tip through validation notifications, so it can be enabled on a synced
+ * node without a reindex and never holds up block connection.
+ *
+ * Older versions kept the index in the block tree database, written by
+ * ConnectBlock; such an index is moved over to the new database on start.
+ */
+class TxIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> db;
+
+    /** Move the entries of an index kept in the block tree database by older versions */
+    bool MigrateLegacyIndex(CBlockTreeDB& blockTreeDB);
+
+protected:
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    size_t WriteBlocks(const std::vector<const CBlockIndex*>& vIndex) override;
+
+    size_t GetSyncBatchSize() const override { return TXINDEX_SYNC_BATCH; }
+
+    BaseIndex::DB& GetDB() const override { return *db; }
+
+    const char* GetName() const override { return "txindex"; }
+
+public:
+    /** Constructs the index, which becomes available to be queried. */
+    explicit TxIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    /**
+     * Look up a transaction by hash.
+     *
+     * @param[in]   txid  The hash of the transaction to be returned.
+     * @param[out]  hashBlock  The hash of the block the transaction is found in.
+     * @param[out]  tx  The transaction itself.
+     * @return  true if the transaction is indexed, false otherwise
+     */
+    bool FindTx(const uint256& txid, uint256& hashBlock, CTransactionRef& tx) const;
+};
+
+/**
+ * Erase a transaction index kept in the block tree database by older
+ * versions, for nodes running without -txindex.
+ */
+bool EraseLegacyTxIndex(CBlockTreeDB& blockTreeDB);
+
+/** The global transaction index, used in GetTransaction. May be null. */
+extern std::unique_ptr<TxIndex> g_txindex;
+
+#endif // BITCOIN_INDEX_TXINDEX_H
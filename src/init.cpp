@@ -9,6 +9,7 @@
 
 #include <init.h>
 
+#include <addressindex.h>
 #include <addrman.h>
 #include <amount.h>
 #include <chain.h>
@@ -19,6 +20,8 @@
 #include <fs.h>
 #include <httpserver.h>
 #include <httprpc.h>
+#include <index/blockfilterindex.h>
+#include <index/txindex.h>
 #include <key.h>
 #include <validation.h>
 #include <miner.h>
@@ -64,6 +67,7 @@
 #include <openssl/crypto.h>
 
 #if ENABLE_ZMQ
+#include <zmq/zmqabstractnotifier.h>
 #include <zmq/zmqnotificationinterface.h>
 #endif
 
@@ -119,6 +123,7 @@ static const char* FEE_ESTIMATES_FILENAME="fee_estimates.dat";
 
 std::atomic<bool> fRequestShutdown(false);
 std::atomic<bool> fDumpMempoolLater(false);
+static bool fDumpScriptCachesLater = false;
 
 void StartShutdown()
 {
@@ -167,6 +172,10 @@ void Interrupt()
     InterruptRPC();
     InterruptREST();
     InterruptTorControl();
+    if (g_txindex)
+        g_txindex->Interrupt();
+    if (g_blockfilterindex)
+        g_blockfilterindex->Interrupt();
     if (g_connman)
         g_connman->Interrupt();
 }
@@ -213,6 +222,11 @@ void Shutdown()
         DumpMempool();
     }
 
+    if (fDumpScriptCachesLater) {
+        DumpScriptCaches();
+        fDumpScriptCachesLater = false;
+    }
+
     if (fFeeEstimatesInitialized)
     {
         ::feeEstimator.FlushUnconfirmed(::mempool);
@@ -234,6 +248,15 @@ void Shutdown()
     // CValidationInterface callbacks, flush them...
     GetMainSignals().FlushBackgroundCallbacks();
 
+    if (g_txindex) {
+        g_txindex->Stop();
+        g_txindex.reset();
+    }
+    if (g_blockfilterindex) {
+        g_blockfilterindex->Stop();
+        g_blockfilterindex.reset();
+    }
+
     // Any future callbacks will be dropped. This should absolutely be safe - if
     // missing a callback results in an unrecoverable situation, unclean shutdown
     // would too. The only reason to do the above flushes is to let the wallet catch
@@ -248,6 +271,7 @@ void Shutdown()
         pcoinsTip.reset();
         pcoinscatcher.reset();
         pcoinsdbview.reset();
+        paddressindex.reset();
         pblocktree.reset();
     }
 #ifdef ENABLE_WALLET
@@ -333,6 +357,9 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-?", _("Print this help message and exit"));
     strUsage += HelpMessageOpt("-version", _("Print version and exit"));
     strUsage += HelpMessageOpt("-alertnotify=<cmd>", _("Execute command when a relevant alert is received or we see a really long fork (%s in cmd is replaced by message)"));
+    strUsage += HelpMessageOpt("-addressindex", strprintf(_("Maintain an index of the outputs paying each address, used by the getaddresshistory, getaddressbalance and getaddressutxos rpc calls (default: %u)"), DEFAULT_ADDRESSINDEX));
+    strUsage += HelpMessageOpt("-blockcompression", strprintf(_("Store new blocks and undo data compressed. Once compressed records are written, block files can't be read by older versions and the option can't be turned off again without a fresh sync (default: %u)"), DEFAULT_BLOCK_COMPRESSION));
+    strUsage += HelpMessageOpt("-blockfilterindex", strprintf(_("Maintain an index of compact block filters (BIP 158), used by the getblockfilter rpc call and to speed up wallet rescans (default: %u)"), DEFAULT_BLOCKFILTERINDEX));
     strUsage += HelpMessageOpt("-blocknotify=<cmd>", _("Execute command when the best block changes (%s in cmd is replaced by block hash)"));
     if (showDebug)
         strUsage += HelpMessageOpt("-blocksonly", strprintf(_("Whether to operate in a blocks only mode (default: %u)"), DEFAULT_BLOCKSONLY));
@@ -348,6 +375,7 @@ std::string HelpMessage(HelpMessageMode mode)
     if (showDebug) {
         strUsage += HelpMessageOpt("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize));
     }
+    strUsage += HelpMessageOpt("-dbprofile=<profile>", _("LevelDB tuning of the chainstate database: ibd, steady or lowmem (default: ibd while catching up with the network, steady otherwise). A database written with ibd is compacted once the initial sync is complete and keeps the ibd profile until the next restart"));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
     if (showDebug)
         strUsage += HelpMessageOpt("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER));
@@ -360,7 +388,9 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()));
     }
     strUsage += HelpMessageOpt("-persistmempool", strprintf(_("Whether to save the mempool on shutdown and load on restart (default: %u)"), DEFAULT_PERSIST_MEMPOOL));
+    strUsage += HelpMessageOpt("-persistsigcache", strprintf(_("Whether to save the signature and script execution caches on shutdown and load them on restart (default: %u)"), DEFAULT_PERSIST_SIGCACHE));
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
+    strUsage += HelpMessageOpt("-blockreconstructionmaxmem=<n>", strprintf(_("Keep the extra transactions for compact block reconstructions under <n> megabytes (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_MAX_MEM));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
 #ifndef WIN32
@@ -374,7 +404,7 @@ std::string HelpMessage(HelpMessageMode mode)
 #ifndef WIN32
     strUsage += HelpMessageOpt("-sysperms", _("Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)"));
 #endif
-    strUsage += HelpMessageOpt("-txindex", strprintf(_("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)"), DEFAULT_TXINDEX));
+    strUsage += HelpMessageOpt("-txindex", strprintf(_("Maintain a full transaction index, used by the getrawtransaction rpc call. It is built in the background and can be enabled without a reindex (default: %u)"), DEFAULT_TXINDEX));
 
     strUsage += HelpMessageGroup(_("Connection options:"));
     strUsage += HelpMessageOpt("-addnode=<ip>", _("Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info)"));
@@ -427,6 +457,9 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-zmqpubhashtx=<address>", _("Enable publish hash transaction in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawblock=<address>", _("Enable publish raw block in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawtx=<address>", _("Enable publish raw transaction in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubrawhiveblock=<address>", _("Enable publish raw hive mined block in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubhashhiveinfo=<address>", _("Enable publish hash and bee of hive mined block in <address>"));
+    strUsage += HelpMessageOpt("-zmqpub<topic>hwm=<n>", strprintf(_("Set publish <topic> outbound message high water mark: messages queued for slow subscribers beyond it are dropped (default: %d)"), DEFAULT_ZMQ_SNDHWM));
 #endif
 
     strUsage += HelpMessageGroup(_("Debugging/Testing options:"));
@@ -510,13 +543,14 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-rpcallowip=<ip>", _("Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times"));
     strUsage += HelpMessageOpt("-rpcserialversion", strprintf(_("Sets the serialization of raw transaction or block hex returned in non-verbose mode, non-segwit(0) or segwit(1) (default: %d)"), DEFAULT_RPC_SERIALIZE_VERSION));
     strUsage += HelpMessageOpt("-rpcthreads=<n>", strprintf(_("Set the number of threads to service RPC calls (default: %d)"), DEFAULT_HTTP_THREADS));
+    strUsage += HelpMessageOpt("-rpcbatchthreads=<n>", strprintf(_("Maximum number of RPC threads a single JSON-RPC batch may use, 0 = as many as -rpcthreads (default: %d)"), DEFAULT_RPC_BATCH_THREADS));
+    strUsage += HelpMessageOpt("-rpcbatchmaxmemory=<n>", strprintf(_("Maximum size of the replies of a single JSON-RPC batch in megabytes; calls beyond it fail (default: %u)"), DEFAULT_RPC_BATCH_MAX_MEMORY));
     if (showDebug) {
         strUsage += HelpMessageOpt("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE));
         strUsage += HelpMessageOpt("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT));
     }
 
     // Maza: Hive: Mining optimisations
-    strUsage += HelpMessageOpt("-hivecheckdelay=<ms>", strprintf(_("Time between Hive checks in ms. This should be left at default unless performance degradation is observed (default: %u)"), DEFAULT_HIVE_CHECK_DELAY));
     strUsage += HelpMessageOpt("-hivecheckthreads=<threads>", strprintf(_("Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores (default: %u)"), DEFAULT_HIVE_THREADS));
     strUsage += HelpMessageOpt("-hiveearlyabort", strprintf(_("Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed. (default: %u)"), DEFAULT_HIVE_EARLY_OUT));
 
@@ -547,6 +581,27 @@ std::string LicenseInfo()
            "\n";
 }
 
+/**
+ * Wait for the initial sync to complete, then compact the chainstate
+ * database it was written into with the ibd profile, which defers much of
+ * the compaction work. The profile itself stays in effect until the next
+ * restart.
+ */
+static void ThreadCompactChainstate()
+{
+    while (IsInitialBlockDownload())
+        MilliSleep(10000);
+
+    LogPrintf("Initial sync complete, compacting chainstate database\n");
+    if (!pcoinsdbview->Compact([] { return ShutdownRequested() || boost::this_thread::interruption_requested(); })) {
+        LogPrintf("Chainstate database compaction interrupted\n");
+        return;
+    }
+    // The LevelDB options can't be changed on an open database, and the
+    // chainstate can't be reopened underneath its cursors
+    LogPrintf("Chainstate database still uses the ibd profile, restart to switch to the steady profile\n");
+}
+
 static void BlockNotifyCallback(bool initialSync, const CBlockIndex *pBlockIndex)
 {
     if (initialSync || !pBlockIndex)
@@ -918,6 +973,10 @@ bool AppInitParameterInteraction()
     if (gArgs.GetArg("-prune", 0)) {
         if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        if (gArgs.GetBoolArg("-blockfilterindex", DEFAULT_BLOCKFILTERINDEX))
+            return InitError(_("Prune mode is incompatible with -blockfilterindex."));
+        if (gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX))
+            return InitError(_("Prune mode is incompatible with -addressindex."));
     }
 
     // -bind and -whitebind can't be set when not listening
@@ -988,6 +1047,10 @@ bool AppInitParameterInteraction()
     if (gArgs.IsArgSet("-blockminsize"))
         InitWarning("Unsupported argument -blockminsize ignored.");
 
+    // Maza: Hive: Checks start as soon as a new block is connected
+    if (gArgs.IsArgSet("-hivecheckdelay"))
+        InitWarning(_("Unsupported argument -hivecheckdelay ignored, Hive checks start as soon as a new block is connected."));
+
     // Checkmempool and checkblockindex default to true in regtest mode
     int ratio = std::min<int>(std::max<int>(gArgs.GetArg("-checkmempool", chainparams.DefaultConsistencyChecks() ? 1 : 0), 0), 1000000);
     if (ratio != 0) {
@@ -1105,6 +1168,7 @@ bool AppInitParameterInteraction()
 #endif
 
     fIsBareMultisigStd = gArgs.GetBoolArg("-permitbaremultisig", DEFAULT_PERMIT_BAREMULTISIG);
+    fBlockCompression = gArgs.GetBoolArg("-blockcompression", DEFAULT_BLOCK_COMPRESSION);
     fAcceptDatacarrier = gArgs.GetBoolArg("-datacarrier", DEFAULT_ACCEPT_DATACARRIER);
     nMaxDatacarrierBytes = gArgs.GetArg("-datacarriersize", nMaxDatacarrierBytes);
 
@@ -1122,6 +1186,12 @@ bool AppInitParameterInteraction()
 
     nMaxTipAge = gArgs.GetArg("-maxtipage", DEFAULT_MAX_TIP_AGE);
 
+    if (gArgs.IsArgSet("-dbprofile")) {
+        DBProfile profile;
+        if (!DBProfileFromName(gArgs.GetArg("-dbprofile", ""), profile))
+            return InitError(strprintf(_("Unknown database profile '%s'"), gArgs.GetArg("-dbprofile", "")));
+    }
+
     fEnableReplacement = gArgs.GetBoolArg("-mempoolreplacement", DEFAULT_ENABLE_REPLACEMENT);
     if ((!fEnableReplacement) && gArgs.IsArgSet("-mempoolreplacement")) {
         // Minimal effort at forwards compatibility
@@ -1247,6 +1317,10 @@ bool AppInitMain()
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    if (gArgs.GetBoolArg("-persistsigcache", DEFAULT_PERSIST_SIGCACHE)) {
+        LoadScriptCaches();
+        fDumpScriptCachesLater = true;
+    }
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
@@ -1412,9 +1486,23 @@ bool AppInitMain()
     int64_t nTotalCache = (gArgs.GetArg("-dbcache", nDefaultDbCache) << 20);
     nTotalCache = std::max(nTotalCache, nMinDbCache << 20); // total cache cannot be less than nMinDbCache
     nTotalCache = std::min(nTotalCache, nMaxDbCache << 20); // total cache cannot be greater than nMaxDbcache
-    int64_t nBlockTreeDBCache = nTotalCache / 8;
-    nBlockTreeDBCache = std::min(nBlockTreeDBCache, (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxBlockDBAndTxIndexCache : nMaxBlockDBCache) << 20);
+    int64_t nBlockTreeDBCache = std::min(nTotalCache / 8, nMaxBlockDBCache << 20);
     nTotalCache -= nBlockTreeDBCache;
+    int64_t nTxIndexCache = 0;
+    if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
+        nTxIndexCache = std::min(nTotalCache / 8, nMaxTxIndexCache << 20);
+        nTotalCache -= nTxIndexCache;
+    }
+    int64_t nBlockFilterIndexCache = 0;
+    if (gArgs.GetBoolArg("-blockfilterindex", DEFAULT_BLOCKFILTERINDEX)) {
+        nBlockFilterIndexCache = std::min(nTotalCache / 8, nMaxBlockFilterIndexCache << 20);
+        nTotalCache -= nBlockFilterIndexCache;
+    }
+    int64_t nAddressIndexCache = 0;
+    if (gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+        nAddressIndexCache = std::min(nTotalCache / 8, nMaxAddressIndexCache << 20);
+        nTotalCache -= nAddressIndexCache;
+    }
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1422,6 +1510,15 @@ bool AppInitMain()
     int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
+    if (nTxIndexCache > 0) {
+        LogPrintf("* Using %.1fMiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
+    }
+    if (nBlockFilterIndexCache > 0) {
+        LogPrintf("* Using %.1fMiB for block filter index database\n", nBlockFilterIndexCache * (1.0 / 1024 / 1024));
+    }
+    if (nAddressIndexCache > 0) {
+        LogPrintf("* Using %.1fMiB for address index database\n", nAddressIndexCache * (1.0 / 1024 / 1024));
+    }
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
@@ -1433,12 +1530,16 @@ bool AppInitMain()
         uiInterface.InitMessage(_("Loading block index..."));
 
         nStart = GetTimeMillis();
+        // Time spent in each step, for the startup timing breakdown
+        int64_t nTimeIndex = 0, nTimeReplay = 0, nTimeTip = 0, nTimeRewind = 0, nTimeVerify = 0;
         do {
             try {
+                int64_t nTimeStep = GetTimeMillis();
                 UnloadBlockIndex();
                 pcoinsTip.reset();
                 pcoinsdbview.reset();
                 pcoinscatcher.reset();
+                paddressindex.reset();
                 // new CBlockTreeDB tries to delete the existing file, which
                 // fails if it's still open from the previous loop. Close it first:
                 pblocktree.reset();
@@ -1453,7 +1554,7 @@ bool AppInitMain()
 
                 if (fRequestShutdown) break;
 
-                // LoadBlockIndex will load fTxIndex from the db, or set it if
+                // LoadBlockIndex will load fAddressIndex from the db, or set it if
                 // we're reindexing. It will also load fHavePruned if we've
                 // ever removed a block file from disk.
                 // Note that it also sets fReindex based on the disk flag!
@@ -1462,15 +1563,24 @@ bool AppInitMain()
                     strLoadError = _("Error loading block database");
                     break;
                 }
+                nTimeIndex = GetTimeMillis() - nTimeStep;
 
                 // If the loaded chain has a wrong genesis, bail out immediately
                 // (we're likely using a testnet datadir, or the other way around).
                 if (!mapBlockIndex.empty() && mapBlockIndex.count(chainparams.GetConsensus().hashGenesisBlock) == 0)
                     return InitError(_("Incorrect or no genesis block found. Wrong datadir for network?"));
 
-                // Check for changed -txindex state
-                if (fTxIndex != gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -txindex");
+                // A transaction index kept in the block tree database by older
+                // versions is no longer updated without -txindex: erase it,
+                // so TxIndex does not take it over when enabled again later
+                if (!gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) && !EraseLegacyTxIndex(*pblocktree)) {
+                    strLoadError = _("Error erasing the old transaction index");
+                    break;
+                }
+
+                // Check for changed -addressindex state
+                if (fAddressIndex != gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+                    strLoadError = _("You need to rebuild the database using -reindex to change -addressindex");
                     break;
                 }
 
@@ -1481,6 +1591,13 @@ bool AppInitMain()
                     break;
                 }
 
+                // Block files holding compressed records can't be read without
+                // block compression support, and reindexing leaves the records
+                // as they are: only a fresh sync goes back to plain storage.
+                if (fHaveCompressedBlocks && !fBlockCompression) {
+                    return InitError(_("The block files hold compressed blocks, written with -blockcompression. Keep -blockcompression enabled, or delete the blocks and chainstate directories to sync again without it"));
+                }
+
                 // At this point blocktree args are consistent with what's on disk.
                 // If we're not mid-reindex (based on disk + args), add a genesis block on disk
                 // (otherwise we use the one already on disk).
@@ -1493,8 +1610,18 @@ bool AppInitMain()
                 // At this point we're either in reindex or we've loaded a useful
                 // block tree into mapBlockIndex!
 
-                pcoinsdbview.reset(new CCoinsViewDB(nCoinDBCache, false, fReset || fReindexChainState));
+                // The chainstate is tuned for bulk writes while the node is catching up
+                DBProfile coinsDBProfile = DBProfile::STEADY;
+                if (gArgs.IsArgSet("-dbprofile")) {
+                    DBProfileFromName(gArgs.GetArg("-dbprofile", ""), coinsDBProfile);
+                } else if (fReindex || fReindexChainState || pindexBestHeader == nullptr || pindexBestHeader->GetBlockTime() < GetTime() - nMaxTipAge) {
+                    coinsDBProfile = DBProfile::IBD;
+                }
+                pcoinsdbview.reset(new CCoinsViewDB(nCoinDBCache, false, fReset || fReindexChainState, coinsDBProfile));
                 pcoinscatcher.reset(new CCoinsViewErrorCatcher(pcoinsdbview.get()));
+                // The address index is rebuilt along with the chainstate
+                if (fAddressIndex)
+                    paddressindex.reset(new CAddressIndex(nAddressIndexCache, false, fReset || fReindexChainState));
 
                 // If necessary, upgrade from older database format.
                 // This is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
@@ -1504,10 +1631,12 @@ bool AppInitMain()
                 }
 
                 // ReplayBlocks is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
+                nTimeStep = GetTimeMillis();
                 if (!ReplayBlocks(chainparams, pcoinsdbview.get())) {
                     strLoadError = _("Unable to replay blocks. You will need to rebuild the database using -reindex-chainstate.");
                     break;
                 }
+                nTimeReplay = GetTimeMillis() - nTimeStep;
 
                 // The on-disk coinsdb is now in a good state, create the cache
                 pcoinsTip.reset(new CCoinsViewCache(pcoinscatcher.get()));
@@ -1515,11 +1644,13 @@ bool AppInitMain()
                 bool is_coinsview_empty = fReset || fReindexChainState || pcoinsTip->GetBestBlock().IsNull();
                 if (!is_coinsview_empty) {
                     // LoadChainTip sets chainActive based on pcoinsTip's best block
+                    nTimeStep = GetTimeMillis();
                     if (!LoadChainTip(chainparams)) {
                         strLoadError = _("Error initializing block database");
                         break;
                     }
                     assert(chainActive.Tip() != nullptr);
+                    nTimeTip = GetTimeMillis() - nTimeStep;
                 }
 
                 if (!fReset) {
@@ -1527,10 +1658,12 @@ bool AppInitMain()
                     // It both disconnects blocks based on chainActive, and drops block data in
                     // mapBlockIndex based on lack of available witness data.
                     uiInterface.InitMessage(_("Rewinding blocks..."));
+                    nTimeStep = GetTimeMillis();
                     if (!RewindBlockIndex(chainparams)) {
                         strLoadError = _("Unable to rewind the database to a pre-fork state. You will need to redownload the blockchain");
                         break;
                     }
+                    nTimeRewind = GetTimeMillis() - nTimeStep;
                 }
 
                 if (!is_coinsview_empty) {
@@ -1552,11 +1685,13 @@ bool AppInitMain()
                         }
                     }
 
+                    nTimeStep = GetTimeMillis();
                     if (!CVerifyDB().VerifyDB(chainparams, pcoinsdbview.get(), gArgs.GetArg("-checklevel", DEFAULT_CHECKLEVEL),
                                   gArgs.GetArg("-checkblocks", DEFAULT_CHECKBLOCKS))) {
                         strLoadError = _("Corrupted block database detected");
                         break;
                     }
+                    nTimeVerify = GetTimeMillis() - nTimeStep;
                 }
             } catch (const std::exception& e) {
                 LogPrintf("%s\n", e.what());
@@ -1565,6 +1700,8 @@ bool AppInitMain()
             }
 
             fLoaded = true;
+            LogPrintf("Startup timing: block index %dms, replay %dms, chain tip %dms, rewind %dms, verify %dms\n",
+                nTimeIndex, nTimeReplay, nTimeTip, nTimeRewind, nTimeVerify);
         } while(false);
 
         if (!fLoaded && !fRequestShutdown) {
@@ -1606,6 +1743,20 @@ bool AppInitMain()
         ::feeEstimator.Read(est_filein);
     fFeeEstimatesInitialized = true;
 
+    // The transaction and block filter indices catch up with the chain in the
+    // background, from wherever they stopped before (so they can be enabled
+    // at any time).
+    if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
+        g_txindex = MakeUnique<TxIndex>(nTxIndexCache, false, fReindex);
+        if (!g_txindex->Start())
+            return false;
+    }
+    if (gArgs.GetBoolArg("-blockfilterindex", DEFAULT_BLOCKFILTERINDEX)) {
+        g_blockfilterindex = MakeUnique<BlockFilterIndex>(BlockFilterType::BASIC, nBlockFilterIndexCache, false, fReindex);
+        if (!g_blockfilterindex->Start())
+            return false;
+    }
+
     // ********************************************************* Step 8: load wallet
 #ifdef ENABLE_WALLET
     if (!OpenWallets())
@@ -1659,6 +1810,9 @@ bool AppInitMain()
 
     threadGroup.create_thread(boost::bind(&ThreadImport, vImportFiles));
 
+    if (pcoinsdbview->GetDB().GetProfile() == DBProfile::IBD)
+        threadGroup.create_thread(boost::bind(&TraceThread<void (*)()>, "dbcompact", &ThreadCompactChainstate));
+
     // Wait for genesis block to be processed
     {
         WaitableLock lock(cs_GenesisWait);
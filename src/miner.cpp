@@ -36,6 +36,10 @@
 #include <sync.h>           // Maza: Hive
 #include <boost/thread.hpp> // Maza: Hive: Mining optimisations
 #include <crypto/minotaurx/yespower/yespower.h>  // Maza: MinotaurX+Hive1.2
+#include <crypto/minotaurx/minotaur.h>          // Maza: MinotaurX+Hive1.2: Nonce search
+#include <crypto/common.h>                      // Maza: MinotaurX+Hive1.2: Nonce search
+#include <streams.h>                            // Maza: MinotaurX+Hive1.2: Nonce search
+#include <atomic>                               // Maza: MinotaurX+Hive1.2: Nonce search
 
 
 static CCriticalSection cs_solution_vars;
@@ -43,6 +47,10 @@ std::atomic<bool> solutionFound;            // Maza: Hive: Mining optimisations:
 std::atomic<bool> earlyAbort;               // Maza: Hive: Mining optimisations: Thread-safe atomic flag to signal early abort needed
 CBeeRange solvingRange;                     // Maza: Hive: Mining optimisations: The solving range (protected by mutex)
 uint32_t solvingBee;                        // Maza: Hive: Mining optimisations: The solving bee (protected by mutex)
+std::atomic<int64_t> firstBeeTime;          // Maza: Hive: When the first bee of the running check was hashed, 0 until then
+
+static CCriticalSection cs_hive_latency;
+static CHiveCheckLatency hiveCheckLatency;  // Maza: Hive: Protected by cs_hive_latency
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -556,80 +564,225 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
 
+// Maza: MinotaurX+Hive1.2: Pick the pow hash as CBlockHeader::GetPoWHash() does: sha256d up to the MinotaurX fork,
+// then by the pow type in the version
+CHeaderNonceHasher::CHeaderNonceHasher(const CBlockHeader& header, const Consensus::Params& consensusParams, bool fThreadRegion)
+{
+    POW_TYPE powType = header.nTime <= consensusParams.powForkTime ? POW_TYPE_SHA256 : header.GetPoWType();
+    bool fMinotaurX = powType == POW_TYPE_MINOTAURX;
+    fValidType = fMinotaurX || powType == POW_TYPE_SHA256;
+    fOwnRegion = fMinotaurX && !fThreadRegion;
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << header;
+    assert(ss.size() == sizeof(vchHeader));
+    memcpy(vchHeader, ss.data(), sizeof(vchHeader));
+
+    if (fOwnRegion)
+        yespower_init_local(&local);
+    if (fMinotaurX)
+        minotaurHasher.reset(new MinotaurHeaderHasher(vchHeader, true, fOwnRegion ? &local : NULL));
+    else
+        midstate.Write(vchHeader, 64);
+}
+
+CHeaderNonceHasher::~CHeaderNonceHasher()
+{
+    minotaurHasher.reset();
+    if (fOwnRegion)
+        yespower_free_local(&local);
+}
+
+uint256 CHeaderNonceHasher::GetPoWHash(uint32_t nNonce)
+{
+    if (!fValidType)
+        return HIGH_HASH;
+
+    if (minotaurHasher)
+        return minotaurHasher->Hash(nNonce);
+
+    // Only the last 16 bytes of the header are left to hash; the nonce is the last 4 of them
+    WriteLE32(vchHeader + 76, nNonce);
+    uint256 hash;
+    CSHA256(midstate).Write(vchHeader + 64, 16).Finalize(hash.begin());
+    CSHA256().Write(hash.begin(), CSHA256::OUTPUT_SIZE).Finalize(hash.begin());
+    return hash;
+}
+
+// Maza: MinotaurX+Hive1.2: Split the nonces to try into a contiguous slice per thread. The calling thread takes
+// the first slice, hashing in its thread-local yespower region so that it is set up once rather than for every
+// block; the others stop as soon as any of them finds a solution.
+bool SolveBlockNonce(CBlockHeader& header, const Consensus::Params& consensusParams, int nThreads, uint32_t nNonceEnd, uint64_t& nMaxTries)
+{
+    bool fNegative, fOverflow;
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(header.nBits, &fNegative, &fOverflow);
+    if (fNegative || fOverflow || bnTarget == 0)
+        return false;
+
+    uint64_t nTries = std::min<uint64_t>(nMaxTries, nNonceEnd);
+    if (nTries == 0)
+        return false;
+    nThreads = (int)std::max<uint64_t>(1, std::min<uint64_t>(std::max(nThreads, 1), nTries));
+
+    std::atomic<bool> fFound(false);
+    std::atomic<uint64_t> nTried(0);
+    uint32_t nFoundNonce = 0;
+    auto searchSlice = [&](uint32_t nBegin, uint32_t nEnd, bool fThreadRegion) {
+        CHeaderNonceHasher hasher(header, consensusParams, fThreadRegion);
+        uint32_t nNonce = nBegin;
+        while (nNonce < nEnd && !fFound.load(std::memory_order_relaxed)) {
+            if (UintToArith256(hasher.GetPoWHash(nNonce++)) <= bnTarget) {
+                bool fExpected = false;
+                if (fFound.compare_exchange_strong(fExpected, true))
+                    nFoundNonce = nNonce - 1;
+                break;
+            }
+        }
+        nTried += nNonce - nBegin;
+    };
+
+    std::vector<boost::thread> threads;
+    for (int i = 1; i < nThreads; i++)
+        threads.push_back(boost::thread(searchSlice, (uint32_t)(nTries * i / nThreads), (uint32_t)(nTries * (i + 1) / nThreads), false));
+    searchSlice(0, (uint32_t)(nTries / nThreads), true);
+    for (auto& t : threads)
+        t.join();
+
+    nMaxTries -= nTried.load();
+    if (fFound.load())
+        header.nNonce = nFoundNonce;
+    return fFound.load();
+}
+
+// Maza: Hive: Wake the BeeKeeper for a check of the new tip
+void CBeeKeeperNotifier::UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    if (fInitialDownload)
+        return;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fNewTip = true;
+        nTipTime = GetTimeMicros();
+        // A check still running on the previous tip can't give a useful block any more
+        if (gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT))
+            earlyAbort.store(true);
+    }
+    cond.notify_one();
+}
+
+bool CBeeKeeperNotifier::HasNewTip()
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return fNewTip;
+}
+
+bool CBeeKeeperNotifier::WaitForNewTip(int64_t& nTipTimeOut, int64_t nTimeoutMillis)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (nTimeoutMillis < 0) {
+        while (!fNewTip)
+            cond.wait(lock);
+    } else {
+        boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::milliseconds(nTimeoutMillis);
+        while (!fNewTip)
+            if (cond.wait_until(lock, deadline) == boost::cv_status::timeout)
+                break;
+        if (!fNewTip)
+            return false;
+    }
+    fNewTip = false;
+    nTipTimeOut = nTipTime;
+    // Under the lock, so a tip arriving right after still aborts the new check
+    earlyAbort.store(false);
+    return true;
+}
+
+static CBeeKeeperNotifier beeKeeperNotifier;
+
+// Maza: Hive: Bring the wallet's BCT table up to date while waiting for the next tip
+static void PrepareNextBeeRound()
+{
+    JSONRPCRequest request;
+    CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(pwallet, true))
+        return;
+
+    LOCK2(cs_main, pwallet->cs_wallet);
+    if (!IsInitialBlockDownload())
+        pwallet->RefreshBeeTable();
+}
+
+void CHiveCheckLatency::AddCheck(int64_t nTipTime, int64_t nFirstBeeTime, int64_t nCheckTime, bool fAborted)
+{
+    nChecks++;
+    if (fAborted)
+        nAborted++;
+    if (nTipTime && nFirstBeeTime) {
+        nTimedChecks++;
+        nLastTipToFirstBee = nFirstBeeTime - nTipTime;
+        nTotalTipToFirstBee += nLastTipToFirstBee;
+    }
+    nLastCheck = nCheckTime;
+}
+
+void CHiveCheckLatency::AddSolution(int64_t nTipTime, int64_t nSubmitTime)
+{
+    nSolutions++;
+    if (nTipTime)
+        nLastTipToSubmit = nSubmitTime - nTipTime;
+}
+
+CHiveCheckLatency GetHiveCheckLatency()
+{
+    LOCK(cs_hive_latency);
+    return hiveCheckLatency;
+}
+
 // Maza: Hive: Bee management thread
 void BeeKeeper(const CChainParams& chainparams) {
     const Consensus::Params& consensusParams = chainparams.GetConsensus();
 
     LogPrintf("BeeKeeper: Thread started\n");
     RenameThread("hive-beekeeper");
-
-    int height;
-    {
-        LOCK(cs_main);
-        height = chainActive.Tip()->nHeight;
-    }
+    RegisterValidationInterface(&beeKeeperNotifier);
 
     try {
         while (true) {
-            // Maza: Hive: Mining optimisations: Parameterised sleep time
-            int sleepTime = std::max((int64_t) 1, gArgs.GetArg("-hivecheckdelay", DEFAULT_HIVE_CHECK_DELAY));
-            MilliSleep(sleepTime);
-
-            int newHeight;
-            {
-                LOCK(cs_main);
-                newHeight = chainActive.Tip()->nHeight;
+            try {
+                if (!beeKeeperNotifier.HasNewTip())
+                    PrepareNextBeeRound();
+            } catch (const std::runtime_error &e) {
+                LogPrintf("! BeeKeeper: Error: %s\n", e.what());
             }
-            if (newHeight != height) {
-                // Height changed; release the bees!
-                height = newHeight;
-                try {
-                    BusyBees(consensusParams, height);
-                } catch (const std::runtime_error &e) {
-                    LogPrintf("! BeeKeeper: Error: %s\n", e.what());
-                }
+
+            // Wait for a new tip; release the bees!
+            int64_t nTipTime;
+            beeKeeperNotifier.WaitForNewTip(nTipTime);
+            try {
+                BusyBees(consensusParams, nTipTime);
+            } catch (const std::runtime_error &e) {
+                LogPrintf("! BeeKeeper: Error: %s\n", e.what());
             }
         }
     } catch (const boost::thread_interrupted&) {
+        UnregisterValidationInterface(&beeKeeperNotifier);
         LogPrintf("!!! BeeKeeper: FATAL: Thread interrupted\n");
         throw;
     }
 }
 
-// Maza: Hive: Mining optimisations: Thread to signal abort on new block
-void AbortWatchThread(int height) {
-    // Loop until any exit condition
-    while (true) {
-        // Yield to OS
-        MilliSleep(1);
-
-        // Check pre-existing abort conditions
-        if (solutionFound.load() || earlyAbort.load())
-            return;
-
-        // Get tip height, keeping lock scope as short as possible
-        int newHeight;
-        {
-            LOCK(cs_main);
-            newHeight = chainActive.Tip()->nHeight;
-        }
-
-        // Check for abort from tip height change
-        if (newHeight != height) {
-            //LogPrintf("*** ABORT FIRE\n");
-            earlyAbort.store(true);
-            return;
-        }
-    }
-}
-
 // Maza: Hive: Mining optimisations: Thread to check a single bin
 void CheckBin(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget) {
+    int64_t nNotHashed = 0;
+    firstBeeTime.compare_exchange_strong(nNotHashed, GetTimeMicros());
+
     // Iterate over ranges in this bin
     int checkCount = 0;
     for (std::vector<CBeeRange>::const_iterator it = bin.begin(); it != bin.end(); it++) {
         CBeeRange beeRange = *it;
-        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, beeRange.offset, beeRange.offset + beeRange.count - 1, beeRange.txid);
+        std::string txid = beeRange.txid.GetHex();
+        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, beeRange.offset, beeRange.offset + beeRange.count - 1, txid);
         // Iterate over bees in this range
         for (int i = beeRange.offset; i < beeRange.offset + beeRange.count; i++) {
             // Check abort conditions (Only every N bees. The atomic load is expensive, but much cheaper than a mutex - esp on Windows, see https://www.arangodb.com/2015/02/comparing-atomic-mutex-rwlocks/)
@@ -640,7 +793,7 @@ void CheckBin(int threadID, std::vector<CBeeRange> bin, std::string deterministi
                 }
             }
             // Hash the bee
-            std::string hashHex = (CHashWriter(SER_GETHASH, 0) << deterministicRandString << beeRange.txid << i).GetHash().GetHex();
+            std::string hashHex = (CHashWriter(SER_GETHASH, 0) << deterministicRandString << txid << i).GetHash().GetHex();
             arith_uint256 beeHash = arith_uint256(hashHex);
             // Compare to target and write out result if successful
             if (beeHash < beeHashTarget) {
@@ -664,11 +817,15 @@ void CheckBinMinotaur(int threadID, std::vector<CBeeRange> bin, std::string dete
     yespower_init_local(&local);
     */
 
+    int64_t nNotHashed = 0;
+    firstBeeTime.compare_exchange_strong(nNotHashed, GetTimeMicros());
+
     // Iterate over ranges in this bin
     int checkCount = 0;
     for (std::vector<CBeeRange>::const_iterator it = bin.begin(); it != bin.end(); it++) {
         CBeeRange beeRange = *it;
-        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, beeRange.offset, beeRange.offset + beeRange.count - 1, beeRange.txid);
+        std::string txid = beeRange.txid.GetHex();
+        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, beeRange.offset, beeRange.offset + beeRange.count - 1, txid);
         // Iterate over bees in this range
         for (int i = beeRange.offset; i < beeRange.offset + beeRange.count; i++) {
             // Check abort conditions (Only every N bees. The atomic load is expensive, but much cheaper than a mutex - esp on Windows, see https://www.arangodb.com/2015/02/comparing-atomic-mutex-rwlocks/)
@@ -683,7 +840,7 @@ void CheckBinMinotaur(int threadID, std::vector<CBeeRange> bin, std::string dete
             // Hash the bee
             std::stringstream buf;
             buf << deterministicRandString;
-            buf << beeRange.txid;
+            buf << txid;
             buf << i;
             std::string hashString = buf.str();
 
@@ -708,8 +865,28 @@ void CheckBinMinotaur(int threadID, std::vector<CBeeRange> bin, std::string dete
     //yespower_free_local(&local);
 }
 
+// Maza: Hive: Create a worker thread for each bin, and wait for them to find a solution or abort (in which case the others will all stop), or to run out of bees
+bool CheckBeeBins(const std::vector<std::vector<CBeeRange>>& beeBins, const std::string& deterministicRandString, const arith_uint256& beeHashTarget, bool minotaurX) {
+    solutionFound.store(false);
+    firstBeeTime.store(0);
+
+    std::vector<boost::thread> binThreads;
+    int binID = 0;
+    for (const std::vector<CBeeRange>& beeBin : beeBins) {
+        // Maza: MinotaurX+Hive1.2: Use correct inner hash
+        if (!minotaurX)
+            binThreads.push_back(boost::thread(CheckBin, binID++, beeBin, deterministicRandString, beeHashTarget));
+        else
+            binThreads.push_back(boost::thread(CheckBinMinotaur, binID++, beeBin, deterministicRandString, beeHashTarget));
+    }
+    for (auto& t : binThreads)
+        t.join();
+
+    return solutionFound.load();
+}
+
 // Maza: Hive: Attempt to mint the next block
-bool BusyBees(const Consensus::Params& consensusParams, int height) {
+bool BusyBees(const Consensus::Params& consensusParams, int64_t nTipTime) {
     bool verbose = LogAcceptCategory(BCLog::HIVE);
 
     CBlockIndex* pindexPrev = chainActive.Tip();
@@ -735,20 +912,14 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
 
     // Maza: Hive 1.1: Check that there aren't too many consecutive Hive blocks
     if (IsMinotaurXEnabled(pindexPrev, consensusParams)) {
-        int hiveBlocksAtTip = 0;
-        CBlockIndex* pindexTemp = pindexPrev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-            assert(pindexTemp->pprev);
-            pindexTemp = pindexTemp->pprev;
-            hiveBlocksAtTip++;
-        }
+        int hiveBlocksAtTip = pindexPrev->GetHiveRun(consensusParams);
         if (hiveBlocksAtTip >= consensusParams.maxConsecutiveHiveBlocks) {
             LogPrintf("BusyBees: Skipping hive check (max Hive blocks without a POW block reached)\n");
             return false;
         }
     } else {
         // Check previous block wasn't hivemined
-        if (pindexPrev->GetBlockHeader().IsHiveMined(consensusParams)) {
+        if (pindexPrev->IsHiveMined(consensusParams)) {
             LogPrintf("BusyBees: Skipping hive check (Hive block must follow a POW block)\n");
             return false;
         }
@@ -777,23 +948,6 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
     beeHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, consensusParams));
     if (verbose) LogPrintf("BusyBees: beeHashTarget             = %s\n", beeHashTarget.ToString());
 
-    // Find bin size
-    std::vector<CBeeCreationTransactionInfo> potentialBcts = pwallet->GetBCTs(false, false, consensusParams);
-    std::vector<CBeeCreationTransactionInfo> bcts;
-    int totalBees = 0;
-    for (std::vector<CBeeCreationTransactionInfo>::const_iterator it = potentialBcts.begin(); it != potentialBcts.end(); it++) {
-        CBeeCreationTransactionInfo bct = *it;
-        if (bct.beeStatus != "mature")
-            continue;
-        bcts.push_back(bct);
-        totalBees += bct.beeCount;
-    }
-
-    if (totalBees == 0) {
-        LogPrint(BCLog::HIVE, "BusyBees: No mature bees found\n");
-        return false;
-    }
-
     int coreCount = GetNumVirtualCores();
     int threadCount = gArgs.GetArg("-hivecheckthreads", DEFAULT_HIVE_THREADS);
     if (threadCount == -2)
@@ -803,99 +957,44 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
     else if (threadCount == 0)
         threadCount = 1;
 
-    int beesPerBin = ceil(totalBees / (float)threadCount);  // We want to check this many bees per thread
-
-    // Bin the bees according to desired thead count
-    if (verbose) LogPrint(BCLog::HIVE, "BusyBees: Binning %i bees in %i bins (%i bees per bin)\n", totalBees, threadCount, beesPerBin);
-    std::vector<CBeeCreationTransactionInfo>::const_iterator bctIterator = bcts.begin();
-    CBeeCreationTransactionInfo bct = *bctIterator;
+    // Bin the mature bees according to desired thead count
     std::vector<std::vector<CBeeRange>> beeBins;
-    int beeOffset = 0;                                      // Track offset in current BCT
-    while(bctIterator != bcts.end()) {                      // Until we're out of BCTs
-        std::vector<CBeeRange> currentBin;                  // Create a new bin
-        int beesInBin = 0;
-        while (bctIterator != bcts.end()) {                 // Keep filling it until full
-            int spaceLeft = beesPerBin - beesInBin;
-            if (bct.beeCount - beeOffset <= spaceLeft) {    // If there's soom, add all the bees from this BCT...
-                CBeeRange range = {bct.txid, bct.honeyAddress, bct.communityContrib, beeOffset, bct.beeCount - beeOffset};
-                currentBin.push_back(range);
-
-                beesInBin += bct.beeCount - beeOffset;
-                beeOffset = 0;
-
-                do {                                        // ... and iterate to next BCT
-                    bctIterator++;
-                    if (bctIterator == bcts.end())
-                        break;
-                    bct = *bctIterator;
-                } while (bct.beeStatus != "mature");
-            } else {                                        // Can't fit the whole thing to current bin; add what we can fit and let the rest go in next bin
-                CBeeRange range = {bct.txid, bct.honeyAddress, bct.communityContrib, beeOffset, spaceLeft};
-                currentBin.push_back(range);
-                beeOffset += spaceLeft;
-                break;
-            }
-        }
-        beeBins.push_back(currentBin);
+    int totalBees;
+    {
+        LOCK2(cs_main, pwallet->cs_wallet);
+        totalBees = pwallet->GetBeeBins(pindexPrev->nHeight, threadCount, beeBins);
     }
 
-    // Create a worker thread for each bin
-    if (verbose) LogPrintf("BusyBees: Running bins\n");
-    solutionFound.store(false);
-    earlyAbort.store(false);
-    std::vector<std::vector<CBeeRange>>::const_iterator beeBinIterator = beeBins.begin();
-    std::vector<boost::thread> binThreads;
-    int64_t checkTime = GetTimeMillis();
-    int binID = 0;
-    bool minotaurXEnabled = IsMinotaurXEnabled(pindexPrev, consensusParams);    // Maza: MinotaurX+Hive1.2: Check if minotaurX enabled
-    while (beeBinIterator != beeBins.end()) {
-        std::vector<CBeeRange> beeBin = *beeBinIterator;
+    if (totalBees == 0) {
+        LogPrint(BCLog::HIVE, "BusyBees: No mature bees found\n");
+        return false;
+    }
+    if (verbose) LogPrint(BCLog::HIVE, "BusyBees: Binned %i bees in %i bins\n", totalBees, beeBins.size());
 
-        if (verbose) {
+    if (verbose) {
+        LogPrintf("BusyBees: Running bins\n");
+        for (size_t binID = 0; binID < beeBins.size(); binID++) {
             LogPrintf("BusyBees: Bin #%i\n", binID);
-            std::vector<CBeeRange>::const_iterator beeRangeIterator = beeBin.begin();
-            while (beeRangeIterator != beeBin.end()) {
-                CBeeRange beeRange = *beeRangeIterator;
-                LogPrintf("offset = %i, count = %i, txid = %s\n", beeRange.offset, beeRange.count, beeRange.txid);
-                beeRangeIterator++;
-            }
+            for (const CBeeRange& beeRange : beeBins[binID])
+                LogPrintf("offset = %i, count = %i, txid = %s\n", beeRange.offset, beeRange.count, beeRange.txid.GetHex());
         }
-        // Maza: MinotaurX+Hive1.2: Use correct inner hash
-        if (!minotaurXEnabled)
-            binThreads.push_back(boost::thread(CheckBin, binID++, beeBin, deterministicRandString, beeHashTarget));
-        else
-            binThreads.push_back(boost::thread(CheckBinMinotaur, binID++, beeBin, deterministicRandString, beeHashTarget));
-
-        beeBinIterator++;
     }
 
-    // Add an extra thread to watch external abort conditions (eg new incoming block)
-    bool useEarlyAbortThread = gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT);
-    if (verbose && useEarlyAbortThread)
-        LogPrintf("BusyBees: Will use early-abort thread\n");
-
-    boost::thread earlyAbortThread;
-    if (useEarlyAbortThread)
-        earlyAbortThread = boost::thread(AbortWatchThread, height);
-
-    // Wait for bin worker threads to find a solution or abort (in which case the others will all stop), or to run out of bees
-    for(auto& t:binThreads)
-        t.join();
-
-    binThreads.clear();
-
+    int64_t checkTime = GetTimeMillis();
+    int64_t nCheckStart = GetTimeMicros();
+    bool minotaurXEnabled = IsMinotaurXEnabled(pindexPrev, consensusParams);    // Maza: MinotaurX+Hive1.2: Check if minotaurX enabled
+    CheckBeeBins(beeBins, deterministicRandString, beeHashTarget, minotaurXEnabled);
     checkTime = GetTimeMillis() - checkTime;
+    bool fAborted = earlyAbort.load();
+    {
+        LOCK(cs_hive_latency);
+        hiveCheckLatency.AddCheck(nTipTime, firstBeeTime.load(), GetTimeMicros() - nCheckStart, fAborted);
+    }
 
-    // Handle early aborts
-    if (useEarlyAbortThread) {
-        if (earlyAbort.load()) {
-            LogPrintf("BusyBees: Chain state changed (check aborted after %ims)\n", checkTime);
-            return false;
-        } else {
-            // We didn't abort; stop abort thread now
-            earlyAbort.store(true);
-            earlyAbortThread.join();
-        }
+    // Handle early aborts (a new tip came in while checking)
+    if (fAborted) {
+        LogPrintf("BusyBees: Chain state changed (check aborted after %ims)\n", checkTime);
+        return false;
     }
 
     // Check if a solution was found
@@ -903,17 +1002,18 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
         LogPrintf("BusyBees: No bee meets hash target (%i bees checked with %i threads in %ims)\n", totalBees, threadCount, checkTime);
         return false;
     }
-    LogPrintf("BusyBees: Bee meets hash target (check aborted after %ims). Solution with bee #%i from BCT %s. Honey address is %s.\n", checkTime, solvingBee, solvingRange.txid, solvingRange.honeyAddress);
+    LogPrintf("BusyBees: Bee meets hash target (check aborted after %ims). Solution with bee #%i from BCT %s. Honey address is %s.\n", checkTime, solvingBee, solvingRange.txid.GetHex(), EncodeDestination(solvingRange.honeyDestination));
 
     // Assemble the Hive proof script
     std::vector<unsigned char> messageProofVec;
-    std::vector<unsigned char> txidVec(solvingRange.txid.begin(), solvingRange.txid.end());
+    std::string solvingTxid = solvingRange.txid.GetHex();
+    std::vector<unsigned char> txidVec(solvingTxid.begin(), solvingTxid.end());
     CScript hiveProofScript;
     uint32_t bctHeight;
     {   // Don't lock longer than needed
         LOCK2(cs_main, pwallet->cs_wallet);
 
-        CTxDestination dest = DecodeDestination(solvingRange.honeyAddress);
+        const CTxDestination& dest = solvingRange.honeyDestination;
         if (!IsValidDestination(dest)) {
             LogPrintf("BusyBees: Honey destination invalid\n");
             return false;
@@ -940,7 +1040,7 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
         }
         if (verbose) LogPrintf("BusyBees: messageSig                = %s\n", HexStr(&messageProofVec[0], &messageProofVec[messageProofVec.size()]));
 
-        COutPoint out(uint256S(solvingRange.txid), 0);
+        COutPoint out(solvingRange.txid, 0);
         Coin coin;
         if (!pcoinsTip || !pcoinsTip->GetCoin(out, coin)) {
             LogPrintf("BusyBees: Couldn't get the bct utxo!\n");
@@ -961,7 +1061,7 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
     hiveProofScript << OP_RETURN << OP_BEE << beeNonceVec << bctHeightVec << communityContribFlag << txidVec << messageProofVec;
 
     // Create honey script from honey address
-    CScript honeyScript = GetScriptForDestination(DecodeDestination(solvingRange.honeyAddress));
+    CScript honeyScript = GetScriptForDestination(solvingRange.honeyDestination);
 
     // Create a Hive block
     std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(honeyScript, true, &hiveProofScript));
@@ -988,6 +1088,10 @@ bool BusyBees(const Consensus::Params& consensusParams, int height) {
 
     // Commit and propagate the block
     std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
+    {
+        LOCK(cs_hive_latency);
+        hiveCheckLatency.AddSolution(nTipTime, GetTimeMicros());
+    }
     if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr)) {
         LogPrintf("BusyBees: Block wasn't accepted\n");
         return false;
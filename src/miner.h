@@ -8,11 +8,16 @@
 
 #include <primitives/block.h>
 #include <txmempool.h>
+#include <validationinterface.h>                // Maza: Hive: BeeKeeper wakeups
+#include <crypto/sha256.h>                      // Maza: MinotaurX+Hive1.2: Nonce search
+#include <crypto/minotaurx/yespower/yespower.h> // Maza: MinotaurX+Hive1.2: Nonce search
 
 #include <stdint.h>
 #include <memory>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
+#include <boost/thread/condition_variable.hpp>  // Maza: Hive: BeeKeeper wakeups
+#include <boost/thread/mutex.hpp>               // Maza: Hive: BeeKeeper wakeups
 
 class CBlockIndex;
 class CChainParams;
@@ -20,13 +25,13 @@ class CScript;
 
 class arith_uint256;    // Maza: Hive: Mining optimisations
 struct CBeeRange;       // Maza: Hive: Mining optimisations
+class MinotaurHeaderHasher; // Maza: MinotaurX+Hive1.2: Nonce search
 
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
 
 // Maza: Hive: Mining optimisations: Defaults for new hive check parameters
-static const int DEFAULT_HIVE_CHECK_DELAY = 1;
 static const int DEFAULT_HIVE_THREADS = -2;
 static const bool DEFAULT_HIVE_EARLY_OUT = true;
 
@@ -210,10 +215,82 @@ private:
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
+// Maza: MinotaurX+Hive1.2: Gives a header's pow hash for any nonce, keeping what doesn't change from one
+// nonce to the next: the sha256 state after the first 64 bytes of the header, or for MinotaurX a
+// MinotaurHeaderHasher holding the first 76, and the yespower region.
+// Each nonce search thread needs its own. With fThreadRegion, MinotaurX uses yespower's thread-local region,
+// kept from one header to the next, rather than setting up its own; only for long-lived threads, as the
+// thread-local region is never freed.
+class CHeaderNonceHasher
+{
+public:
+    CHeaderNonceHasher(const CBlockHeader& header, const Consensus::Params& consensusParams, bool fThreadRegion = false);
+    ~CHeaderNonceHasher();
+
+    // Same as CBlockHeader::GetPoWHash() with nNonce set to the given nonce
+    uint256 GetPoWHash(uint32_t nNonce);
+
+private:
+    bool fValidType;
+    bool fOwnRegion;
+    unsigned char vchHeader[80];
+    CSHA256 midstate;
+    yespower_local_t local;
+    std::unique_ptr<MinotaurHeaderHasher> minotaurHasher;
+
+    CHeaderNonceHasher(const CHeaderNonceHasher&) = delete;
+    CHeaderNonceHasher& operator=(const CHeaderNonceHasher&) = delete;
+};
+
+/** Maza: MinotaurX+Hive1.2: Search nonces [0, nNonceEnd) for one giving the header a pow hash at or below its nBits
+  * target, on nThreads threads. Each thread searches its own slice of the range, and between them they try at
+  * most nMaxTries nonces; nMaxTries is reduced by the number tried. Returns true and sets the header's nNonce if
+  * one was found. */
+bool SolveBlockNonce(CBlockHeader& header, const Consensus::Params& consensusParams, int nThreads, uint32_t nNonceEnd, uint64_t& nMaxTries);
+
+// Maza: Hive: Timings of the hive checks started by the BeeKeeper, in microseconds
+struct CHiveCheckLatency
+{
+    int nChecks = 0;                    //!< Checks that got as far as hashing bees
+    int nAborted = 0;                   //!< Checks cancelled by a newer tip
+    int nSolutions = 0;                 //!< Hive blocks submitted
+    int nTimedChecks = 0;               //!< Checks that know when their tip arrived and hashed a bee
+    int64_t nLastTipToFirstBee = 0;     //!< From the tip arriving to the first bee hashed, last timed check
+    int64_t nTotalTipToFirstBee = 0;    //!< The same, summed over all timed checks
+    int64_t nLastCheck = 0;             //!< Time spent hashing bees, last check
+    int64_t nLastTipToSubmit = -1;      //!< From the tip arriving to submitting a hive block, last solution
+
+    /** Count a check of the tip that arrived at nTipTime (0 if not known), which hashed its first bee at nFirstBeeTime (0 if none) and took nCheckTime */
+    void AddCheck(int64_t nTipTime, int64_t nFirstBeeTime, int64_t nCheckTime, bool fAborted);
+    /** Count a hive block submitted at nSubmitTime on the tip that arrived at nTipTime (0 if not known) */
+    void AddSolution(int64_t nTipTime, int64_t nSubmitTime);
+};
+
+// Maza: Hive: Wakes the BeeKeeper as soon as a new tip is connected outside initial block download
+class CBeeKeeperNotifier : public CValidationInterface
+{
+private:
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    bool fNewTip = false;       // Protected by mutex
+    int64_t nTipTime = 0;       // Protected by mutex
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override;
+
+public:
+    /** Whether a new tip is waiting to be checked */
+    bool HasNewTip();
+
+    /** Wait for a new tip for up to nTimeoutMillis, or without a limit if negative; true and the time it arrived in nTipTimeOut if one did. Clears the early abort flag for the check of the new tip. */
+    bool WaitForNewTip(int64_t& nTipTimeOut, int64_t nTimeoutMillis = -1);
+};
+
 void BeeKeeper(const CChainParams& chainparams);                        // Maza: Hive: Bee management thread
-bool BusyBees(const Consensus::Params& consensusParams, int height);    // Maza: Hive: Attempt to mint the next block
+bool BusyBees(const Consensus::Params& consensusParams, int64_t nTipTime);  // Maza: Hive: Attempt to mint the next block
+CHiveCheckLatency GetHiveCheckLatency();                                // Maza: Hive: Timings reported by gethiveparams
 void CheckBin(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget); // Maza: Hive: Mining optimisations: Thread to process a bin of beeranges
-void CheckBinMinotaurX(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget); // Maza: MinotaurX+Hive1.2: Use minotaur inner hash for hive
-void AbortWatchThread(int height);                                      // Maza: Hive: Mining optimisations: Thread to watch for abort conditions
+void CheckBinMinotaur(int threadID, std::vector<CBeeRange> bin, std::string deterministicRandString, arith_uint256 beeHashTarget); // Maza: MinotaurX+Hive1.2: Use minotaur inner hash for hive
+bool CheckBeeBins(const std::vector<std::vector<CBeeRange>>& beeBins, const std::string& deterministicRandString, const arith_uint256& beeHashTarget, bool minotaurX); // Maza: Hive: Check each bin on its own thread; true if a bee meets the target
 
 #endif // BITCOIN_MINER_H
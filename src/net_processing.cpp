@@ -58,6 +58,7 @@ void EraseOrphansFor(NodeId peer);
 
 static size_t vExtraTxnForCompactIt GUARDED_BY(g_cs_orphans) = 0;
 static std::vector<std::pair<uint256, CTransactionRef>> vExtraTxnForCompact GUARDED_BY(g_cs_orphans);
+static size_t nExtraTxnForCompactUsage GUARDED_BY(g_cs_orphans) = 0;  // Maza: Memory used by the txn in vExtraTxnForCompact
 
 static const uint64_t RANDOMIZER_ID_ADDRESS_RELAY = 0x3cac0035b5866b90ULL; // SHA256("main address relay")[0:8]
 
@@ -69,6 +70,18 @@ static const int STALE_RELAY_AGE_LIMIT = 30 * 24 * 60 * 60;
 /// limiting block relay. Set to one week, denominated in seconds.
 static const int HISTORICAL_BLOCK_AGE = 7 * 24 * 60 * 60;
 
+/// Bounds of the per-peer block download window. Peers start at
+/// MAX_BLOCKS_IN_TRANSIT_PER_PEER and move within these bounds as their
+/// block deliveries are measured.
+static const int MIN_BLOCK_DOWNLOAD_WINDOW = 2;
+static const int MAX_BLOCK_DOWNLOAD_WINDOW = 64;
+/// How much of a peer's measured block delivery time to keep queued with it,
+/// in microseconds. Fast peers get deep queues, slow ones shallow queues.
+static const int64_t BLOCK_DOWNLOAD_TARGET_QUEUE = 2 * 1000000;
+/// Minimum age, in microseconds, of the request for the block holding back
+/// the download window before it may be moved to a faster peer.
+static const int64_t BLOCK_REREQUEST_MIN_AGE = 1000000;
+
 // Internal stuff
 namespace {
     /** Number of nodes with fSyncStarted. */
@@ -111,7 +124,9 @@ namespace {
         uint256 hash;
         const CBlockIndex* pindex;                               //!< Optional.
         bool fValidatedHeaders;                                  //!< Whether this block has validated headers at the time of request.
+        int64_t nTime;                                           //!< When the block was requested (in microseconds).
         std::unique_ptr<PartiallyDownloadedBlock> partialBlock;  //!< Optional, used for CMPCTBLOCK downloads
+        int64_t nTimeTxnRequested;                               //!< When we sent getblocktxn for partialBlock (in microseconds), or 0.
     };
     std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> > mapBlocksInFlight;
 
@@ -127,6 +142,9 @@ namespace {
     /** Number of outbound peers with m_chain_sync.m_protect. */
     int g_outbound_peers_with_protect_from_disconnect = 0;
 
+    /** Maza: Compact block reconstruction counts for the node, protected by cs_main. */
+    CCompactBlockStats g_cmpct_stats;
+
     /** When our tip was last updated. */
     std::atomic<int64_t> g_last_tip_update(0);
 
@@ -185,6 +203,22 @@ struct CNodeState {
     int64_t nDownloadingSince;
     int nBlocksInFlight;
     int nBlocksInFlightValidHeaders;
+    //! How many blocks we keep in flight from this peer.
+    int nBlockWindow;
+    //! Moving average of the time from requesting a block to receiving it (in microseconds), or 0.
+    int64_t nBlockLatency;
+    //! Moving average of the time this peer takes per block it delivers (in microseconds), or 0.
+    int64_t nBlockInterval;
+    //! Moving average of the block bytes per second this peer delivers.
+    int64_t nBlockBytesPerSec;
+    //! When this peer last delivered a block we requested from it.
+    int64_t nLastBlockDelivery;
+    //! Number of requested blocks this peer delivered.
+    int nBlocksDelivered;
+    //! Number of blocks moved from this peer to a faster one because it lagged.
+    int nBlocksRerequested;
+    //! Maza: Compact blocks from this peer and how they were reconstructed.
+    CCompactBlockStats cmpctStats;
     //! Whether we consider this a preferred download peer.
     bool fPreferredDownload;
     //! Whether this peer wants invs or headers (when possible) for block announcements.
@@ -252,6 +286,13 @@ struct CNodeState {
         nDownloadingSince = 0;
         nBlocksInFlight = 0;
         nBlocksInFlightValidHeaders = 0;
+        nBlockWindow = MAX_BLOCKS_IN_TRANSIT_PER_PEER;
+        nBlockLatency = 0;
+        nBlockInterval = 0;
+        nBlockBytesPerSec = 0;
+        nLastBlockDelivery = 0;
+        nBlocksDelivered = 0;
+        nBlocksRerequested = 0;
         fPreferredDownload = false;
         fPreferHeaders = false;
         fPreferHeaderAndIDs = false;
@@ -352,7 +393,7 @@ bool MarkBlockAsInFlight(NodeId nodeid, const uint256& hash, const CBlockIndex*
     MarkBlockAsReceived(hash);
 
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {hash, pindex, pindex != nullptr, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&mempool) : nullptr)});
+            {hash, pindex, pindex != nullptr, GetTimeMicros(), std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&mempool) : nullptr), 0});
     state->nBlocksInFlight++;
     state->nBlocksInFlightValidHeaders += it->fValidatedHeaders;
     if (state->nBlocksInFlight == 1) {
@@ -368,6 +409,90 @@ bool MarkBlockAsInFlight(NodeId nodeid, const uint256& hash, const CBlockIndex*
     return true;
 }
 
+// Requires cs_main.
+// Measure a block we requested from this peer and resize its download window.
+// Must be called before the block is marked as received.
+void UpdateBlockDownloadStats(NodeId nodeid, const uint256& hash, size_t nBytes)
+{
+    std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> >::iterator itInFlight = mapBlocksInFlight.find(hash);
+    if (itInFlight == mapBlocksInFlight.end() || itInFlight->second.first != nodeid)
+        return;
+    CNodeState *state = State(nodeid);
+    assert(state != nullptr);
+
+    int64_t nNow = GetTimeMicros();
+    int64_t nRequested = itInFlight->second.second->nTime;
+    int64_t nLatency = std::max<int64_t>(nNow - nRequested, 1);
+    // The time this block took on top of the previous delivery, or on top of
+    // its request if the peer had nothing queued in between
+    int64_t nInterval = std::max<int64_t>(nNow - std::max(state->nLastBlockDelivery, nRequested), 1);
+    int64_t nBytesPerSec = (int64_t)nBytes * 1000000 / nInterval;
+    state->nLastBlockDelivery = nNow;
+    if (state->nBlocksDelivered++ == 0) {
+        state->nBlockLatency = nLatency;
+        state->nBlockInterval = nInterval;
+        state->nBlockBytesPerSec = nBytesPerSec;
+    } else {
+        state->nBlockLatency += (nLatency - state->nBlockLatency) / 8;
+        state->nBlockInterval += (nInterval - state->nBlockInterval) / 8;
+        state->nBlockBytesPerSec += (nBytesPerSec - state->nBlockBytesPerSec) / 8;
+    }
+
+    // Queue as many blocks as the peer delivers in BLOCK_DOWNLOAD_TARGET_QUEUE.
+    // Queueing delay is part of the measured interval once the peer's link is
+    // full, so the window settles instead of growing without bound.
+    int nWindow = BLOCK_DOWNLOAD_TARGET_QUEUE / std::max<int64_t>(state->nBlockInterval, 1);
+    nWindow = std::max(std::min(nWindow, state->nBlockWindow * 2), state->nBlockWindow / 2);
+    state->nBlockWindow = std::max(std::min(nWindow, MAX_BLOCK_DOWNLOAD_WINDOW), MIN_BLOCK_DOWNLOAD_WINDOW);
+}
+
+// Requires cs_main.
+// Maza: Count a compact block from this peer that we started to reconstruct, for the peer and for the node.
+void UpdateCompactBlockStats(CNodeState* state, const PartiallyDownloadedBlock& partialBlock, size_t nMissingTxs)
+{
+    for (CCompactBlockStats* stats : {&state->cmpctStats, &g_cmpct_stats}) {
+        stats->nBlocks++;
+        if (nMissingTxs == 0)
+            stats->nReconstructed++;
+        stats->nMissingTxs += nMissingTxs;
+        stats->nExtraTxs += partialBlock.GetExtraTxCount();
+    }
+}
+
+// Requires cs_main.
+// Maza: Measure a getblocktxn round trip to this peer, for the peer and for the node.
+void UpdateCompactBlockRoundTrip(CNodeState* state, int64_t nLatency)
+{
+    for (CCompactBlockStats* stats : {&state->cmpctStats, &g_cmpct_stats}) {
+        if (stats->nRoundTrips++ == 0)
+            stats->nRoundTripLatency = nLatency;
+        else
+            stats->nRoundTripLatency += (nLatency - stats->nRoundTripLatency) / 8;
+    }
+}
+
+// Requires cs_main.
+// Whether to move the in-flight block pindex, which holds back our download
+// window, from the peer it was requested from to nodeid because that peer lags.
+bool ShouldRerequestBlock(NodeId nodeid, const CBlockIndex* pindex, int64_t nNow)
+{
+    std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> >::iterator itInFlight = mapBlocksInFlight.find(pindex->GetBlockHash());
+    if (itInFlight == mapBlocksInFlight.end() || itInFlight->second.first == nodeid)
+        return false;
+    const QueuedBlock& queuedBlock = *itInFlight->second.second;
+    if (queuedBlock.partialBlock)
+        return false;
+    CNodeState *state = State(nodeid);
+    CNodeState *stateHolder = State(itInFlight->second.first);
+    assert(state != nullptr && stateHolder != nullptr);
+
+    // The block must be late by the holder's own average, and this peer must
+    // be expected to deliver it well before it has waited that long again
+    int64_t nAge = nNow - queuedBlock.nTime;
+    return nAge > BLOCK_REREQUEST_MIN_AGE && nAge > 2 * stateHolder->nBlockLatency &&
+        state->nBlockLatency != 0 && state->nBlockLatency < nAge / 2;
+}
+
 /** Check whether the last unknown block a peer advertised is not yet known. */
 void ProcessBlockAvailability(NodeId nodeid) {
     CNodeState *state = State(nodeid);
@@ -461,7 +586,7 @@ bool PeerHasHeader(CNodeState *state, const CBlockIndex *pindex)
 
 /** Update pindexLastCommonBlock and add not-in-flight missing successors to vBlocks, until it has
  *  at most count entries. */
-void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<const CBlockIndex*>& vBlocks, NodeId& nodeStaller, const Consensus::Params& consensusParams) {
+void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<const CBlockIndex*>& vBlocks, NodeId& nodeStaller, const CBlockIndex*& pindexWaitingFor, const Consensus::Params& consensusParams) {
     if (count == 0)
         return;
 
@@ -542,6 +667,7 @@ void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vector<con
             } else if (waitingfor == -1) {
                 // This is the first already-in-flight block.
                 waitingfor = mapBlocksInFlight[pindex->GetBlockHash()].first;
+                pindexWaitingFor = pindex;
             }
         }
     }
@@ -620,6 +746,12 @@ bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats) {
     stats.nMisbehavior = state->nMisbehavior;
     stats.nSyncHeight = state->pindexBestKnownBlock ? state->pindexBestKnownBlock->nHeight : -1;
     stats.nCommonHeight = state->pindexLastCommonBlock ? state->pindexLastCommonBlock->nHeight : -1;
+    stats.nBlockWindow = state->nBlockWindow;
+    stats.nBlockLatency = state->nBlockLatency;
+    stats.nBlockBytesPerSec = state->nBlockBytesPerSec;
+    stats.nBlocksDelivered = state->nBlocksDelivered;
+    stats.nBlocksRerequested = state->nBlocksRerequested;
+    stats.cmpctStats = state->cmpctStats;
     for (const QueuedBlock& queue : state->vBlocksInFlight) {
         if (queue.pindex)
             stats.vHeightInFlight.push_back(queue.pindex->nHeight);
@@ -632,17 +764,52 @@ bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats) {
 // mapOrphanTransactions
 //
 
+// Maza: Empty a slot of vExtraTxnForCompact, keeping its memory usage up to date
+static void EraseCompactExtraTransaction(size_t i) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
+{
+    CTransactionRef& tx = vExtraTxnForCompact[i].second;
+    if (tx) {
+        nExtraTxnForCompactUsage -= RecursiveDynamicUsage(*tx);
+        tx.reset();
+    }
+    vExtraTxnForCompact[i].first.SetNull();
+}
+
 void AddToCompactExtraTransactions(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
 {
     size_t max_extra_txn = gArgs.GetArg("-blockreconstructionextratxn", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN);
     if (max_extra_txn <= 0)
         return;
+    // Maza: Keep the extra txn under -blockreconstructionmaxmem, dropping the oldest first
+    size_t max_extra_usage = std::max<int64_t>(0, gArgs.GetArg("-blockreconstructionmaxmem", DEFAULT_BLOCK_RECONSTRUCTION_MAX_MEM)) * 1000000;
+    size_t tx_usage = RecursiveDynamicUsage(*tx);
+    if (tx_usage > max_extra_usage)
+        return;
     if (!vExtraTxnForCompact.size())
         vExtraTxnForCompact.resize(max_extra_txn);
+    EraseCompactExtraTransaction(vExtraTxnForCompactIt);
+    for (size_t i = 1; i < max_extra_txn && nExtraTxnForCompactUsage + tx_usage > max_extra_usage; i++)
+        EraseCompactExtraTransaction((vExtraTxnForCompactIt + i) % max_extra_txn);
     vExtraTxnForCompact[vExtraTxnForCompactIt] = std::make_pair(tx->GetWitnessHash(), tx);
+    nExtraTxnForCompactUsage += tx_usage;
     vExtraTxnForCompactIt = (vExtraTxnForCompactIt + 1) % max_extra_txn;
 }
 
+void GetCompactBlockStats(CCompactBlockStats& stats, size_t& nExtraTxs, size_t& nExtraTxUsage)
+{
+    {
+        LOCK(cs_main);
+        stats = g_cmpct_stats;
+    }
+    LOCK(g_cs_orphans);
+    nExtraTxs = 0;
+    for (const auto& entry : vExtraTxnForCompact) {
+        if (entry.second)
+            nExtraTxs++;
+    }
+    nExtraTxUsage = nExtraTxnForCompactUsage;
+}
+
 bool AddOrphanTx(const CTransactionRef& tx, NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
 {
     const uint256& hash = tx->GetHash();
@@ -807,6 +974,18 @@ PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, CScheduler &schedu
     scheduler.scheduleEvery(std::bind(&PeerLogicValidation::CheckForStaleTipAndEvictPeers, this, consensusParams), EXTRA_PEER_CHECK_INTERVAL * 1000);
 }
 
+// Maza: Keep txn that expired, were size limited or reorged out of the mempool for compact block
+// reconstruction, as other miners may still include them. Replaced txn are added by the tx handler.
+void PeerLogicValidation::TransactionRemovedFromMempool(const CTransactionRef& ptx, MemPoolRemovalReason reason)
+{
+    if (reason == MemPoolRemovalReason::REPLACED)
+        return;
+    if (RecursiveDynamicUsage(*ptx) >= MAX_BLOCK_RECONSTRUCTION_TX_USAGE)
+        return;
+    LOCK(g_cs_orphans);
+    AddToCompactExtraTransactions(ptx);
+}
+
 void PeerLogicValidation::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted) {
     LOCK(g_cs_orphans);
 
@@ -2250,10 +2429,10 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 // See https://github.com/bitcoin/bitcoin/issues/8279 for details.
                 assert(recentRejects);
                 recentRejects->insert(tx.GetHash());
-                if (RecursiveDynamicUsage(*ptx) < 100000) {
+                if (RecursiveDynamicUsage(*ptx) < MAX_BLOCK_RECONSTRUCTION_TX_USAGE) {
                     AddToCompactExtraTransactions(ptx);
                 }
-            } else if (tx.HasWitness() && RecursiveDynamicUsage(*ptx) < 100000) {
+            } else if (tx.HasWitness() && RecursiveDynamicUsage(*ptx) < MAX_BLOCK_RECONSTRUCTION_TX_USAGE) {
                 AddToCompactExtraTransactions(ptx);
             }
 
@@ -2427,6 +2606,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     if (!partialBlock.IsTxAvailable(i))
                         req.indexes.push_back(i);
                 }
+                UpdateCompactBlockStats(nodestate, partialBlock, req.indexes.size());
                 if (req.indexes.empty()) {
                     // Dirty hack to jump to BLOCKTXN code (TODO: move message handling into their own functions)
                     BlockTransactions txn;
@@ -2435,6 +2615,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     fProcessBLOCKTXN = true;
                 } else {
                     req.blockhash = pindex->GetBlockHash();
+                    (*queuedBlockIt)->nTimeTxnRequested = GetTimeMicros();  // Maza: Time the round trip
                     connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::GETBLOCKTXN, req));
                 }
             } else {
@@ -2449,6 +2630,12 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     // TODO: don't ignore failures
                     return true;
                 }
+                size_t nMissingTxs = 0;
+                for (size_t i = 0; i < cmpctblock.BlockTxCount(); i++) {
+                    if (!tempBlock.IsTxAvailable(i))
+                        nMissingTxs++;
+                }
+                UpdateCompactBlockStats(nodestate, tempBlock, nMissingTxs);
                 std::vector<CTransactionRef> dummy;
                 status = tempBlock.FillBlock(*pblock, dummy);
                 if (status == READ_STATUS_OK) {
@@ -2537,6 +2724,9 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 
             PartiallyDownloadedBlock& partialBlock = *it->second.second->partialBlock;
             ReadStatus status = partialBlock.FillBlock(*pblock, resp.txn);
+            // Maza: Measure the getblocktxn round trip; blocks reconstructed without one come here with nothing requested
+            if (status != READ_STATUS_INVALID && it->second.second->nTimeTxnRequested != 0)
+                UpdateCompactBlockRoundTrip(State(pfrom->GetId()), std::max<int64_t>(GetTimeMicros() - it->second.second->nTimeTxnRequested, 1));
             if (status == READ_STATUS_INVALID) {
                 MarkBlockAsReceived(resp.blockhash); // Reset in-flight state in case of whitelist
                 Misbehaving(pfrom->GetId(), 100);
@@ -2565,6 +2755,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 // though the block was successfully read, and rely on the
                 // handling in ProcessNewBlock to ensure the block index is
                 // updated, reject messages go out, etc.
+                UpdateBlockDownloadStats(pfrom->GetId(), resp.blockhash, ::GetSerializeSize(*pblock, SER_NETWORK, PROTOCOL_VERSION));
                 MarkBlockAsReceived(resp.blockhash); // it is now an empty pointer
                 fBlockRead = true;
                 // mapBlockSource is only used for sending reject messages and DoS scores,
@@ -2622,6 +2813,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
     else if (strCommand == NetMsgType::BLOCK && !fImporting && !fReindex) // Ignore blocks received while importing
     {
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        size_t nBlockBytes = vRecv.size();
         vRecv >> *pblock;
 
         LogPrint(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom->GetId());
@@ -2630,6 +2822,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         const uint256 hash(pblock->GetHash());
         {
             LOCK(cs_main);
+            UpdateBlockDownloadStats(pfrom->GetId(), hash, nBlockBytes);
             // Also always process if we requested the block explicitly, as we may
             // need it even though it is not a candidate for a new best tip.
             forceProcessing |= MarkBlockAsReceived(hash);
@@ -3612,10 +3805,11 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
         // Message: getdata (blocks)
         //
         std::vector<CInv> vGetData;
-        if (!pto->fClient && (fFetch || !IsInitialBlockDownload()) && state.nBlocksInFlight < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
+        if (!pto->fClient && (fFetch || !IsInitialBlockDownload()) && state.nBlocksInFlight < state.nBlockWindow) {
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
-            FindNextBlocksToDownload(pto->GetId(), MAX_BLOCKS_IN_TRANSIT_PER_PEER - state.nBlocksInFlight, vToDownload, staller, consensusParams);
+            const CBlockIndex* pindexWaitingFor = nullptr;
+            FindNextBlocksToDownload(pto->GetId(), state.nBlockWindow - state.nBlocksInFlight, vToDownload, staller, pindexWaitingFor, consensusParams);
             for (const CBlockIndex *pindex : vToDownload) {
                 uint32_t nFetchFlags = GetFetchFlags(pto);
                 vGetData.push_back(CInv(MSG_BLOCK | nFetchFlags, pindex->GetBlockHash()));
@@ -3623,9 +3817,22 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                 LogPrint(BCLog::NET, "Requesting block %s (%d) peer=%d\n", pindex->GetBlockHash().ToString(),
                     pindex->nHeight, pto->GetId());
             }
+            // If the block holding back the window is late from a slower peer,
+            // ask this one for it too and shrink the other peer's window
+            if (state.nBlocksInFlight < state.nBlockWindow && pindexWaitingFor && IsInitialBlockDownload() &&
+                    ShouldRerequestBlock(pto->GetId(), pindexWaitingFor, nNow)) {
+                CNodeState *stateHolder = State(mapBlocksInFlight[pindexWaitingFor->GetBlockHash()].first);
+                stateHolder->nBlocksRerequested++;
+                stateHolder->nBlockWindow = std::max(stateHolder->nBlockWindow / 2, MIN_BLOCK_DOWNLOAD_WINDOW);
+                vGetData.push_back(CInv(MSG_BLOCK | GetFetchFlags(pto), pindexWaitingFor->GetBlockHash()));
+                MarkBlockAsInFlight(pto->GetId(), pindexWaitingFor->GetBlockHash(), pindexWaitingFor);
+                LogPrint(BCLog::NET, "Re-requesting lagging block %s (%d) peer=%d\n", pindexWaitingFor->GetBlockHash().ToString(),
+                    pindexWaitingFor->nHeight, pto->GetId());
+            }
             if (state.nBlocksInFlight == 0 && staller != -1) {
                 if (State(staller)->nStallingSince == 0) {
                     State(staller)->nStallingSince = nNow;
+                    State(staller)->nBlockWindow = std::max(State(staller)->nBlockWindow / 2, MIN_BLOCK_DOWNLOAD_WINDOW);
                     LogPrint(BCLog::NET, "Stall started peer=%d\n", staller);
                 }
             }
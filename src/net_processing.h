@@ -17,7 +17,11 @@ static const int64_t ORPHAN_TX_EXPIRE_TIME = 20 * 60;
 /** Minimum time between orphan transactions expire time checks in seconds */
 static const int64_t ORPHAN_TX_EXPIRE_INTERVAL = 5 * 60;
 /** Default number of orphan+recently-replaced txn to keep around for block reconstruction */
-static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 100;
+static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 1000;
+/** Maza: Default for -blockreconstructionmaxmem, memory cap in megabytes for the extra txn kept for block reconstruction */
+static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_MAX_MEM = 20;
+/** Largest txn (by memory usage) kept around for block reconstruction */
+static const size_t MAX_BLOCK_RECONSTRUCTION_TX_USAGE = 100000;
 /** Headers download timeout expressed in microseconds
  *  Timeout = base + per_header * (expected number of headers) */
 static constexpr int64_t HEADERS_DOWNLOAD_TIMEOUT_BASE = 15 * 60 * 1000000; // 15 minutes
@@ -46,6 +50,7 @@ public:
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
     void BlockChecked(const CBlock& block, const CValidationState& state) override;
     void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) override;
+    void TransactionRemovedFromMempool(const CTransactionRef& ptx, MemPoolRemovalReason reason) override;
 
 
     void InitializeNode(CNode* pnode) override;
@@ -69,15 +74,33 @@ private:
     int64_t m_stale_tip_check_time; //! Next time to check for stale tip
 };
 
+// Maza: Compact block reconstruction counts, kept for each peer and for the node
+struct CCompactBlockStats {
+    int nBlocks = 0;                //!< Compact blocks we started to reconstruct
+    int nReconstructed = 0;         //!< Of those, blocks reconstructed without a getblocktxn round trip
+    int nRoundTrips = 0;            //!< Getblocktxn round trips completed
+    int64_t nMissingTxs = 0;        //!< Transactions missing from our mempool and extra txn
+    int64_t nExtraTxs = 0;          //!< Transactions found in the extra txn rather than the mempool
+    int64_t nRoundTripLatency = 0;  //!< Moving average of the getblocktxn round trip (in microseconds), or 0
+};
+
 struct CNodeStateStats {
     int nMisbehavior;
     int nSyncHeight;
     int nCommonHeight;
     std::vector<int> vHeightInFlight;
+    int nBlockWindow;
+    int64_t nBlockLatency;
+    int64_t nBlockBytesPerSec;
+    int nBlocksDelivered;
+    int nBlocksRerequested;
+    CCompactBlockStats cmpctStats;
 };
 
 /** Get statistics from node state */
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
+/** Maza: Get the node's compact block reconstruction counts, and the size of its extra txn for reconstruction */
+void GetCompactBlockStats(CCompactBlockStats& stats, size_t& nExtraTxs, size_t& nExtraTxUsage);
 /** Increase a node's misbehavior score. */
 void Misbehaving(NodeId nodeid, int howmuch);
 
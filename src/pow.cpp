@@ -58,19 +58,18 @@ unsigned int GetNextWorkRequiredLWMA(const CBlockIndex* pindexLast, const CBlock
     std::vector<const CBlockIndex*> wantedBlocks;
     const CBlockIndex* blockPreviousTimestamp = pindexLast;
     while (blocksFound < N) {
+        // Skip blocks of the wrong type
+        const CBlockIndex* blockWanted = blockPreviousTimestamp->GetLastPoWBlock(powType, params);
+
         // Reached forkpoint before finding N blocks of correct powtype? Return min
-        if (blockPreviousTimestamp->GetBlockHeader().nVersion >= 0x20000000) {
-            if (verbose) LogPrintf("* GetNextWorkRequiredLWMA: Allowing %s pow limit (previousTime calc reached forkpoint at height %i)\n", POW_TYPE_NAMES[powType], blockPreviousTimestamp->nHeight);
+        int legacyHeight = blockPreviousTimestamp->GetLastLegacyHeight();
+        if (legacyHeight >= 0 && legacyHeight >= (blockWanted ? blockWanted->nHeight : 0)) {
+            if (verbose) LogPrintf("* GetNextWorkRequiredLWMA: Allowing %s pow limit (previousTime calc reached forkpoint at height %i)\n", POW_TYPE_NAMES[powType], legacyHeight);
             return powLimit.GetCompact();
         }
 
-        // Wrong block type? Skip
-        if (blockPreviousTimestamp->GetBlockHeader().IsHiveMined(params) || blockPreviousTimestamp->GetBlockHeader().GetPoWType() != powType) {
-            assert (blockPreviousTimestamp->pprev);
-            blockPreviousTimestamp = blockPreviousTimestamp->pprev;
-            continue;
-        }
-    
+        assert (blockWanted);
+        blockPreviousTimestamp = blockWanted;
         wantedBlocks.push_back(blockPreviousTimestamp);
 
         blocksFound++;
@@ -304,13 +303,14 @@ unsigned int GetNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consen
     int totalBlockCount = 0;
 
     // Step back till we have found 24 hive blocks, or we ran out...
-    while (hiveBlockCount < params.hiveDifficultyWindow && pindexLast->pprev && IsMinotaurXEnabled(pindexLast, params)) {        
-        if (pindexLast->GetBlockHeader().IsHiveMined(params)) {
-            beeHashTarget += arith_uint256().SetCompact(pindexLast->nBits);
-            hiveBlockCount++;
-        }
-        totalBlockCount++;
-        pindexLast = pindexLast->pprev;
+    // MinotaurX stays enabled once it is, so hopping from hive block to hive
+    // block stops where walking back through every block would.
+    const CBlockIndex* pindexHive = pindexLast->GetLastHiveBlock(params);
+    while (hiveBlockCount < params.hiveDifficultyWindow && pindexHive && pindexHive->pprev && pindexHive->IsMinotaurXActive(params)) {
+        beeHashTarget += arith_uint256().SetCompact(pindexHive->nBits);
+        hiveBlockCount++;
+        totalBlockCount = pindexLast->nHeight - pindexHive->nHeight + 1;
+        pindexHive = pindexHive->pprev->GetLastHiveBlock(params);
     }
 
     if (hiveBlockCount < params.hiveDifficultyWindow) {          // Should only happen when chain is starting
@@ -369,7 +369,7 @@ bool GetNetworkHiveInfo(int& immatureBees, int& immatureBCTs, int& matureBees, i
             return false;
         }
 
-        if (!pindexPrev->GetBlockHeader().IsHiveMined(consensusParams)) {                          // Don't check Hivemined blocks (no BCTs will be found in them)
+        if (!pindexPrev->IsHiveMined(consensusParams)) {                                           // Don't check Hivemined blocks (no BCTs will be found in them)
             if (!ReadBlockFromDisk(block, pindexPrev, consensusParams)) {
                 LogPrintf("! GetNetworkHiveInfo: Warn: Block not available (not found on disk); can't calculate network bee count.");
                 return false;
@@ -471,19 +471,13 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
 
     // Maza: Hive 1.1: Check that there aren't too many consecutive Hive blocks
     if (IsMinotaurXEnabled(pindexPrev, consensusParams)) {
-        int hiveBlocksAtTip = 0;
-        CBlockIndex* pindexTemp = pindexPrev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-            assert(pindexTemp->pprev);
-            pindexTemp = pindexTemp->pprev;
-            hiveBlocksAtTip++;
-        }
+        int hiveBlocksAtTip = pindexPrev->GetHiveRun(consensusParams);
         if (hiveBlocksAtTip >= consensusParams.maxConsecutiveHiveBlocks) {
             LogPrintf("CheckHiveProof: Too many Hive blocks without a POW block.\n");
             return false;
         }
     } else {
-        if (pindexPrev->GetBlockHeader().IsHiveMined(consensusParams)) {
+        if (pindexPrev->IsHiveMined(consensusParams)) {
             LogPrint(BCLog::HIVE, "CheckHiveProof: Hive block must follow a POW block.\n");
             return false;
         }
@@ -185,7 +185,6 @@ void OptionsDialog::setMapper()
 
     // Maza: Hive: Mining optimisations (int)
     mapper->addMapping(ui->hiveCheckThreads, OptionsModel::HiveCheckThreads);
-    mapper->addMapping(ui->hiveCheckDelay, OptionsModel::HiveCheckDelay);
     mapper->addMapping(ui->hiveCheckEarlyOut, OptionsModel::HiveCheckEarlyOut);
 
     // Maza: MinotaurX+Hive1.2
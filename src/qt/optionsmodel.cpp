@@ -16,7 +16,7 @@
 #include <net.h>
 #include <netbase.h>
 #include <txdb.h> // for -dbcache defaults
-#include <miner.h> // Maza: Hive: Mining optimisations: For -hivecheckthreads, -hivecheckdelay, -hiveearlyout defaults
+#include <miner.h> // Maza: Hive: Mining optimisations: For -hivecheckthreads, -hiveearlyout defaults
 #include <qt/intro.h>
 
 #ifdef ENABLE_WALLET
@@ -118,10 +118,8 @@ void OptionsModel::Init(bool resetSettings)
     if (!gArgs.SoftSetArg("-hivecheckthreads", settings.value("nHiveCheckThreads").toString().toStdString()))
         addOverriddenOption("-hivecheckthreads");
 
-    if (!settings.contains("nHiveCheckDelay"))
-        settings.setValue("nHiveCheckDelay", (qint64)DEFAULT_HIVE_CHECK_DELAY);
-    if (!gArgs.SoftSetArg("-hivecheckdelay", settings.value("nHiveCheckDelay").toString().toStdString()))
-        addOverriddenOption("-hivecheckdelay");
+    // Hive checks start as soon as a new block is connected, without a delay
+    settings.remove("nHiveCheckDelay");
 
     if (!settings.contains("fHiveCheckEarlyOut"))
         settings.setValue("fHiveCheckEarlyOut", DEFAULT_HIVE_EARLY_OUT);
@@ -296,8 +294,6 @@ QVariant OptionsModel::data(const QModelIndex & index, int role) const
         // Maza: Hive: Mining optimisations
         case HiveCheckThreads:
             return settings.value("nHiveCheckThreads");
-        case HiveCheckDelay:
-            return settings.value("nHiveCheckDelay");
         case HiveCheckEarlyOut:
             return settings.value("fHiveCheckEarlyOut");
 
@@ -417,14 +413,6 @@ bool OptionsModel::setData(const QModelIndex & index, const QVariant & value, in
             break;
 
         // Maza: Hive: Mining optimisations
-        case HiveCheckDelay:
-            if (settings.value("nHiveCheckDelay") != value) {
-                settings.setValue("nHiveCheckDelay", value);
-                gArgs.ForceSetArg("-hivecheckdelay", settings.value("nHiveCheckDelay").toString().toStdString());
-            }
-
-            break;
-
         case HiveCheckThreads:
             if (settings.value("nHiveCheckThreads") != value) {
                 settings.setValue("nHiveCheckThreads", value);
@@ -49,7 +49,6 @@ public:
         DatabaseCache,          // int
         SpendZeroConfChange,    // bool
         Listen,                 // bool
-        HiveCheckDelay,         // Maza: Hive: Mining optimisations (int)
         HiveCheckThreads,       // Maza: Hive: Mining optimisations (int)
         HiveCheckEarlyOut,      // Maza: Hive: Mining optimisations (bool)
         HiveContribCF,          // Maza: MinotaurX+Hive1.2
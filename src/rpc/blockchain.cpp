@@ -6,7 +6,10 @@
 #include <primitives/block.h>       // Maza: MinotaurX+Hive1.2: for POW_TYPE
 #include <rpc/blockchain.h>
 
+#include <addressindex.h>
 #include <amount.h>
+#include <base58.h>
+#include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -17,6 +20,8 @@
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
+#include <rpc/mining.h>
 #include <rpc/server.h>
 #include <streams.h>
 #include <sync.h>
@@ -25,6 +30,7 @@
 #include <util.h>
 #include <utilstrencodings.h>
 #include <hash.h>
+#include <index/blockfilterindex.h>
 #include <validationinterface.h>
 #include <warnings.h>
 
@@ -47,6 +53,12 @@ static std::mutex cs_blockchange;
 static std::condition_variable cond_blockchange;
 static CUpdatedBlock latestblock;
 
+/** Maximum number of filter headers returned by getblockfilterheaders, as in a BIP 157 cfheaders message */
+static const int MAX_FILTER_HEADERS_RESULTS = 2000;
+
+/** Default number of outputs returned by getaddresshistory and getaddressutxos */
+static const int DEFAULT_ADDRESS_RESULTS = 1000;
+
 extern void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry);
 
 /* Calculate the difficulty for a given block index,
@@ -69,27 +81,26 @@ double GetDifficulty(const CChain& chain, const CBlockIndex* blockindex, bool ge
     // Maza: Hive: If tip is PoW and we want hivemined, step back until we find a Hive block
     // Maza: Hive 1.1: Allow there to be multiple hive blocks in the way
     if (getHiveDifficulty) {
-        while (!blockindex->GetBlockHeader().IsHiveMined(consensusParams)) {
-            if (!blockindex->pprev || blockindex->nHeight < consensusParams.minHiveCheckBlock) {   // Ran out of blocks without finding a Hive block? Return min target
+        if (!blockindex->IsHiveMined(consensusParams)) {
+            // Ran out of blocks without finding a Hive block? Return min target
+            const CBlockIndex* pindexHive = blockindex->GetLastHiveBlock(consensusParams);
+            if (!pindexHive || pindexHive->nHeight + 1 < consensusParams.minHiveCheckBlock) {
                 LogPrint(BCLog::HIVE, "GetDifficulty: No hivemined blocks found in history\n");
                 return 1.0;
             }
 
-            blockindex = blockindex->pprev;
+            blockindex = pindexHive;
         }
     } else {
-        // Maza: MinotaurX+Hive1.2: Skip over incorrect powTypes
-        
-        while (blockindex->GetBlockHeader().IsHiveMined(consensusParams) || blockindex->GetBlockHeader().GetPoWType() != powType) {
-            assert (blockindex->pprev);
-            blockindex = blockindex->pprev;
-            if (!IsMinotaurXEnabled(blockindex, consensusParams)) {
+        // Maza: MinotaurX+Hive1.2: Skip over incorrect powTypes, as long as MinotaurX was enabled
+        if (blockindex->IsHiveMined(consensusParams) || blockindex->GetPoWType() != powType) {
+            assert(blockindex->pprev);
+            blockindex = blockindex->pprev->GetLastPoWBlock(powType, consensusParams);
+            if (!blockindex || !blockindex->IsMinotaurXActive(consensusParams)) {
                 return 0;
             }
         }
-        
     }
-    
 
     int nShift = (blockindex->nBits >> 24) & 0xff;
     double dDiff =
@@ -127,7 +138,7 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     // Only report confirmations if the block is on the main chain
     if (chainActive.Contains(blockindex))
         confirmations = chainActive.Height() - blockindex->nHeight + 1;
-    bool isHive = blockindex->GetBlockHeader().IsHiveMined(consensusParams);    // Maza: MinotaurX+Hive1.2
+    bool isHive = blockindex->IsHiveMined(consensusParams);    // Maza: MinotaurX+Hive1.2
     result.push_back(Pair("type", isHive ? "hive" : "pow")); // Maza: Hive 1.1: Show block type in JSON
     // Maza: MinotaurX+Hive1.2: Only report powtype for pow blocks
     if (!isHive)
@@ -155,60 +166,76 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     return result;
 }
 
-UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+int ComputeNextBlockAndDepth(const CBlockIndex* blockindex, const CBlockIndex*& next)
 {
     AssertLockHeld(cs_main);
-    UniValue result(UniValue::VOBJ);
-    result.push_back(Pair("hash", blockindex->GetBlockHash().GetHex()));
-    int confirmations = -1;
-    auto consensusParams = Params().GetConsensus();     // Maza: MinotaurX+Hive1.2
-
+    next = chainActive.Next(blockindex);
     // Only report confirmations if the block is on the main chain
     if (chainActive.Contains(blockindex))
-        confirmations = chainActive.Height() - blockindex->nHeight + 1;
-    bool isHive = blockindex->GetBlockHeader().IsHiveMined(consensusParams);    // Maza: MinotaurX+Hive1.2
-    result.push_back(Pair("type", isHive ? "hive" : "pow")); // Maza: Hive 1.1: Show block type in JSON
+        return chainActive.Height() - blockindex->nHeight + 1;
+    return -1;
+}
+
+UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails)
+{
+    const CBlockIndex* pnext;
+    int confirmations = ComputeNextBlockAndDepth(blockindex, pnext);
+    JSONStreamWriter writer;
+    blockToJSON(writer, block, blockindex, confirmations, pnext, txDetails);
+    return writer.GetValue();
+}
+
+void blockToJSON(JSONStreamWriter& writer, const CBlock& block, const CBlockIndex* blockindex, int confirmations, const CBlockIndex* pnext, bool txDetails)
+{
+    writer.BeginObject();
+    writer.KeyValue("hash", blockindex->GetBlockHash().GetHex());
+    auto consensusParams = Params().GetConsensus();     // Maza: MinotaurX+Hive1.2
+
+    bool isHive = blockindex->IsHiveMined(consensusParams);    // Maza: MinotaurX+Hive1.2
+    writer.KeyValue("type", isHive ? "hive" : "pow"); // Maza: Hive 1.1: Show block type in JSON
     // Maza: MinotaurX+Hive1.2: Only report powtype for pow blocks
     if (!isHive)
-        result.push_back(Pair("powtype", blockindex->GetBlockHeader().GetPoWTypeName()));
-    result.push_back(Pair("confirmations", confirmations));
-    result.push_back(Pair("strippedsize", (int)::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS)));
-    result.push_back(Pair("size", (int)::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION)));
-    result.push_back(Pair("weight", (int)::GetBlockWeight(block)));
-    result.push_back(Pair("height", blockindex->nHeight));
-    result.push_back(Pair("version", block.nVersion));
-    result.push_back(Pair("versionHex", strprintf("%08x", block.nVersion)));
-    result.push_back(Pair("merkleroot", block.hashMerkleRoot.GetHex()));
-    UniValue txs(UniValue::VARR);
+        writer.KeyValue("powtype", blockindex->GetBlockHeader().GetPoWTypeName());
+    writer.KeyValue("confirmations", confirmations);
+    writer.KeyValue("strippedsize", (int)::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS));
+    writer.KeyValue("size", (int)::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION));
+    writer.KeyValue("weight", (int)::GetBlockWeight(block));
+    writer.KeyValue("height", blockindex->nHeight);
+    writer.KeyValue("version", block.nVersion);
+    writer.KeyValue("versionHex", strprintf("%08x", block.nVersion));
+    writer.KeyValue("merkleroot", block.hashMerkleRoot.GetHex());
+    // Transactions are written one by one, so when streaming only one
+    // decoded transaction is held at a time
+    writer.Key("tx");
+    writer.BeginArray();
     for(const auto& tx : block.vtx)
     {
         if(txDetails)
         {
             UniValue objTx(UniValue::VOBJ);
             TxToUniv(*tx, uint256(), objTx, true, RPCSerializationFlags());
-            txs.push_back(objTx);
+            writer.Value(objTx);
         }
         else
-            txs.push_back(tx->GetHash().GetHex());
+            writer.Value(tx->GetHash().GetHex());
     }
-    result.push_back(Pair("tx", txs));
-    result.push_back(Pair("time", block.GetBlockTime()));
-    result.push_back(Pair("mediantime", (int64_t)blockindex->GetMedianTimePast()));
-    result.push_back(Pair("nonce", (uint64_t)block.nNonce));
-    result.push_back(Pair("bits", strprintf("%08x", block.nBits)));
-    result.push_back(Pair("difficulty", GetDifficulty(blockindex)));
+    writer.EndArray();
+    writer.KeyValue("time", block.GetBlockTime());
+    writer.KeyValue("mediantime", (int64_t)blockindex->GetMedianTimePast());
+    writer.KeyValue("nonce", (uint64_t)block.nNonce);
+    writer.KeyValue("bits", strprintf("%08x", block.nBits));
+    writer.KeyValue("difficulty", GetDifficulty(blockindex));
     if (IsMinotaurXEnabled(blockindex, consensusParams)) {
-        result.push_back(Pair("minotaurxdifficulty", GetDifficulty(blockindex, false, POW_TYPE_MINOTAURX)));    // Maza: MinotaurX+Hive1.2
+        writer.KeyValue("minotaurxdifficulty", GetDifficulty(blockindex, false, POW_TYPE_MINOTAURX));    // Maza: MinotaurX+Hive1.2
     }
-    result.push_back(Pair("hivedifficulty", GetDifficulty(blockindex, true)));  // Maza: Hive
-    result.push_back(Pair("chainwork", blockindex->nChainWork.GetHex()));
+    writer.KeyValue("hivedifficulty", GetDifficulty(blockindex, true));  // Maza: Hive
+    writer.KeyValue("chainwork", blockindex->nChainWork.GetHex());
 
     if (blockindex->pprev)
-        result.push_back(Pair("previousblockhash", blockindex->pprev->GetBlockHash().GetHex()));
-    CBlockIndex *pnext = chainActive.Next(blockindex);
+        writer.KeyValue("previousblockhash", blockindex->pprev->GetBlockHash().GetHex());
     if (pnext)
-        result.push_back(Pair("nextblockhash", pnext->GetBlockHash().GetHex()));
-    return result;
+        writer.KeyValue("nextblockhash", pnext->GetBlockHash().GetHex());
+    writer.EndObject();
 }
 
 UniValue getblockcount(const JSONRPCRequest& request)
@@ -408,21 +435,7 @@ UniValue getdifficulty(const JSONRPCRequest& request)
             + HelpExampleRpc("getdifficulty", "")
         );
 
-    std::string strAlgo = gArgs.GetArg("-powalgo", DEFAULT_POW_TYPE);
-    if (!request.params[0].isNull())
-        strAlgo = request.params[0].get_str();
-
-    bool algoFound = false;
-    POW_TYPE powType;
-    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++) {
-        if (strAlgo == POW_TYPE_NAMES[i]) {
-            powType = (POW_TYPE)i;
-            algoFound = true;
-            break;
-        }
-    }
-    if (!algoFound)
-        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid pow algorithm requested");
+    POW_TYPE powType = ParsePowTypeArg(request.params[0]);
 
     if (!IsMinotaurXEnabled(chainActive.Tip(), Params().GetConsensus()) && powType != POW_TYPE_SHA256)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Non sha256d algo requested but minotaurx not enabled");
@@ -510,30 +523,43 @@ void entryToJSON(UniValue &info, const CTxMemPoolEntry &e)
 }
 
 UniValue mempoolToJSON(bool fVerbose)
+{
+    JSONStreamWriter writer;
+    mempoolToJSON(writer, fVerbose);
+    return writer.GetValue();
+}
+
+void mempoolToJSON(JSONStreamWriter& writer, bool fVerbose)
 {
     if (fVerbose)
     {
-        LOCK(mempool.cs);
-        UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : mempool.mapTx)
+        // The entries are described under mempool.cs, and written after
+        // releasing it, as writing may wait on the client
+        std::vector<std::pair<std::string, UniValue>> vEntries;
         {
-            const uint256& hash = e.GetTx().GetHash();
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(info, e);
-            o.push_back(Pair(hash.ToString(), info));
+            LOCK(mempool.cs);
+            vEntries.reserve(mempool.mapTx.size());
+            for (const CTxMemPoolEntry& e : mempool.mapTx)
+            {
+                const uint256& hash = e.GetTx().GetHash();
+                vEntries.emplace_back(hash.ToString(), UniValue(UniValue::VOBJ));
+                entryToJSON(vEntries.back().second, e);
+            }
         }
-        return o;
+        writer.BeginObject();
+        for (const std::pair<std::string, UniValue>& entry : vEntries)
+            writer.KeyValue(entry.first, entry.second);
+        writer.EndObject();
     }
     else
     {
         std::vector<uint256> vtxid;
         mempool.queryHashes(vtxid);
 
-        UniValue a(UniValue::VARR);
+        writer.BeginArray();
         for (const uint256& hash : vtxid)
-            a.push_back(hash.ToString());
-
-        return a;
+            writer.Value(hash.ToString());
+        writer.EndArray();
     }
 }
 
@@ -566,7 +592,9 @@ UniValue getrawmempool(const JSONRPCRequest& request)
     if (!request.params[0].isNull())
         fVerbose = request.params[0].get_bool();
 
-    return mempoolToJSON(fVerbose);
+    return StreamRPCResult(request, [fVerbose](JSONStreamWriter& writer) {
+        mempoolToJSON(writer, fVerbose);
+    });
 }
 
 UniValue getmempoolancestors(const JSONRPCRequest& request)
@@ -872,8 +900,6 @@ UniValue getblock(const JSONRPCRequest& request)
             + HelpExampleRpc("getblock", "\"e2acdf2dd19a702e5d12a925f1e984b01e47a933562ca893656d4afb38b44ee3\"")
         );
 
-    LOCK(cs_main);
-
     std::string strHash = request.params[0].get_str();
     uint256 hash(uint256S(strHash));
 
@@ -885,22 +911,31 @@ UniValue getblock(const JSONRPCRequest& request)
             verbosity = request.params[1].get_bool() ? 1 : 0;
     }
 
-    if (mapBlockIndex.count(hash) == 0)
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
-
     CBlock block;
-    CBlockIndex* pblockindex = mapBlockIndex[hash];
+    const CBlockIndex* pblockindex;
+    const CBlockIndex* pnext;
+    int confirmations;
+    {
+        LOCK(cs_main);
 
-    if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
-        throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
+        if (mapBlockIndex.count(hash) == 0)
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
 
-    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
-        // Block not found on disk. This could be because we have the block
-        // header in our index but don't have the block (for example if a
-        // non-whitelisted node sends us an unrequested long chain of valid
-        // blocks, we add the headers to our index, but don't accept the
-        // block).
-        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+        pblockindex = mapBlockIndex[hash];
+
+        if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
+
+        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+            // Block not found on disk. This could be because we have the block
+            // header in our index but don't have the block (for example if a
+            // non-whitelisted node sends us an unrequested long chain of valid
+            // blocks, we add the headers to our index, but don't accept the
+            // block).
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+
+        confirmations = ComputeNextBlockAndDepth(pblockindex, pnext);
+    }
 
     if (verbosity <= 0)
     {
@@ -910,7 +945,12 @@ UniValue getblock(const JSONRPCRequest& request)
         return strHex;
     }
 
-    return blockToJSON(block, pblockindex, verbosity >= 2);
+    // Streaming waits on the client, so it is done without cs_main. Block
+    // index entries are never freed while running, and the header fields
+    // read from them don't change once the entry is added.
+    return StreamRPCResult(request, [&](JSONStreamWriter& writer) {
+        blockToJSON(writer, block, pblockindex, confirmations, pnext, verbosity >= 2);
+    });
 }
 
 struct CCoinsStats
@@ -1033,6 +1073,53 @@ UniValue pruneblockchain(const JSONRPCRequest& request)
     return uint64_t(height);
 }
 
+static UniValue DBStatsToJSON(const CDBWrapper& db)
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("profile", DBProfileName(db.GetProfile())));
+    ret.push_back(Pair("approximate_memory_usage", (uint64_t)db.DynamicMemoryUsage()));
+
+    UniValue files(UniValue::VARR);
+    std::string value;
+    for (int level = 0; db.GetProperty(strprintf("leveldb.num-files-at-level%d", level), value); level++)
+        files.push_back(atoi(value));
+    ret.push_back(Pair("files_per_level", files));
+
+    if (db.GetProperty("leveldb.stats", value))
+        ret.push_back(Pair("stats", value));
+    return ret;
+}
+
+UniValue getdbstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getdbstats\n"
+            "\nReturns LevelDB statistics of the chainstate and block index databases.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"chainstate\": {                  (json object) the chainstate database\n"
+            "    \"profile\": \"name\",             (string) the tuning profile (see -dbprofile)\n"
+            "    \"approximate_memory_usage\": n,  (numeric) bytes held by memtables and the block cache\n"
+            "    \"files_per_level\": [n,...],     (array) the number of table files at each level\n"
+            "    \"stats\": \"...\"                 (string) compaction statistics (leveldb.stats)\n"
+            "  },\n"
+            "  \"blockindex\": {...}              (json object) the block index database, same fields\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getdbstats", "")
+            + HelpExampleRpc("getdbstats", "")
+        );
+
+    LOCK(cs_main);
+    UniValue ret(UniValue::VOBJ);
+    if (pcoinsdbview)
+        ret.push_back(Pair("chainstate", DBStatsToJSON(pcoinsdbview->GetDB())));
+    if (pblocktree)
+        ret.push_back(Pair("blockindex", DBStatsToJSON(*pblocktree)));
+    return ret;
+}
+
 UniValue gettxoutsetinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -1725,6 +1812,325 @@ UniValue savemempool(const JSONRPCRequest& request)
     return NullUniValue;
 }
 
+static BlockFilterIndex& GetBlockFilterIndex(const UniValue& filterTypeName)
+{
+    BlockFilterType filterType = BlockFilterType::BASIC;
+    if (!filterTypeName.isNull() && !BlockFilterTypeByName(filterTypeName.get_str(), filterType)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown filtertype");
+    }
+    if (!g_blockfilterindex || g_blockfilterindex->GetFilterType() != filterType) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Index is not enabled for filtertype " + BlockFilterTypeName(filterType) + " (use -blockfilterindex)");
+    }
+    return *g_blockfilterindex;
+}
+
+static void ThrowFilterNotFound(BlockFilterIndex& index)
+{
+    if (!index.BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Filter not found. Block filters are still in the process of being indexed.");
+    }
+    throw JSONRPCError(RPC_MISC_ERROR, "Filter not found.");
+}
+
+UniValue getblockfilter(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
+        throw std::runtime_error(
+            "getblockfilter \"blockhash\" ( \"filtertype\" )\n"
+            "\nRetrieve a BIP 158 content filter for a particular block.\n"
+            "Requires -blockfilterindex.\n"
+            "\nArguments:\n"
+            "1. \"blockhash\"   (string, required) The hash of the block\n"
+            "2. \"filtertype\"  (string, optional, default=basic) The type name of the filter\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"filter\" : \"hex\",   (string) the hex-encoded filter data\n"
+            "  \"header\" : \"hash\"   (string) the hex-encoded filter header\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getblockfilter", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\" \"basic\"")
+            + HelpExampleRpc("getblockfilter", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\", \"basic\"")
+        );
+
+    uint256 hash = ParseHashV(request.params[0], "blockhash");
+    BlockFilterIndex& index = GetBlockFilterIndex(request.params[1]);
+
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(hash);
+        if (it == mapBlockIndex.end()) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+        }
+        pindex = it->second;
+    }
+
+    BlockFilter filter;
+    uint256 header;
+    if (!index.LookupFilter(pindex, filter) || !index.LookupFilterHeader(pindex, header)) {
+        ThrowFilterNotFound(index);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("filter", HexStr(filter.GetEncodedFilter())));
+    ret.push_back(Pair("header", header.GetHex()));
+    return ret;
+}
+
+UniValue getblockfilterheaders(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
+        throw std::runtime_error(
+            "getblockfilterheaders start_height ( count \"filtertype\" )\n"
+            "\nRetrieve the BIP 158 filter headers of a range of blocks of the active chain,\n"
+            "so a light client can check the filters it downloads against them.\n"
+            "Requires -blockfilterindex.\n"
+            "\nArguments:\n"
+            "1. start_height  (numeric, required) The height of the first block\n"
+            "2. count         (numeric, optional, default=" + std::to_string(MAX_FILTER_HEADERS_RESULTS) + ") The number of headers, at most " + std::to_string(MAX_FILTER_HEADERS_RESULTS) + "\n"
+            "3. \"filtertype\"  (string, optional, default=basic) The type name of the filter\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"start_height\" : n,            (numeric) the height of the first block\n"
+            "  \"stop_hash\" : \"hash\",          (string) the hash of the last block returned\n"
+            "  \"previous_header\" : \"hash\",    (string) the filter header of the block before start_height\n"
+            "  \"headers\" : [ \"hash\", ... ]    (array) the filter headers, in block order\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getblockfilterheaders", "1000 100")
+            + HelpExampleRpc("getblockfilterheaders", "1000, 100")
+        );
+
+    int nStartHeight = request.params[0].get_int();
+    int nCount = MAX_FILTER_HEADERS_RESULTS;
+    if (!request.params[1].isNull()) {
+        nCount = request.params[1].get_int();
+        if (nCount < 1 || nCount > MAX_FILTER_HEADERS_RESULTS) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid count: should be between 1 and %d", MAX_FILTER_HEADERS_RESULTS));
+        }
+    }
+    BlockFilterIndex& index = GetBlockFilterIndex(request.params[2]);
+
+    std::vector<const CBlockIndex*> vIndex;
+    {
+        LOCK(cs_main);
+        if (nStartHeight < 0 || nStartHeight > chainActive.Height()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Block height out of range");
+        }
+        for (const CBlockIndex* pindex = chainActive[nStartHeight]; pindex && (int)vIndex.size() < nCount; pindex = chainActive.Next(pindex)) {
+            vIndex.push_back(pindex);
+        }
+    }
+
+    uint256 prevHeader;
+    if (vIndex.front()->pprev && !index.LookupFilterHeader(vIndex.front()->pprev, prevHeader)) {
+        ThrowFilterNotFound(index);
+    }
+
+    UniValue headers(UniValue::VARR);
+    for (const CBlockIndex* pindex : vIndex) {
+        uint256 header;
+        if (!index.LookupFilterHeader(pindex, header)) {
+            ThrowFilterNotFound(index);
+        }
+        headers.push_back(header.GetHex());
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("start_height", nStartHeight));
+    ret.push_back(Pair("stop_hash", vIndex.back()->GetBlockHash().GetHex()));
+    ret.push_back(Pair("previous_header", prevHeader.GetHex()));
+    ret.push_back(Pair("headers", headers));
+    return ret;
+}
+
+/** Output script hash of an address argument, throwing if the address index is disabled */
+static uint256 GetAddressIndexScriptHash(const UniValue& address)
+{
+    if (!paddressindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled (use -addressindex)");
+    }
+    CTxDestination dest = DecodeDestination(address.get_str());
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+    return AddressIndexScriptHash(GetScriptForDestination(dest));
+}
+
+static void ParseAddressPaging(const JSONRPCRequest& request, int& nCount, int& nSkip)
+{
+    nCount = request.params[1].isNull() ? DEFAULT_ADDRESS_RESULTS : request.params[1].get_int();
+    nSkip = request.params[2].isNull() ? 0 : request.params[2].get_int();
+    if (nCount < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+    }
+    if (nSkip < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative skip");
+    }
+}
+
+static UniValue AddressOutputToJSON(const CAddressIndexKey& key, const CAddressIndexValue& value)
+{
+    UniValue entry(UniValue::VOBJ);
+    entry.push_back(Pair("height", (int)key.nHeight));
+    entry.push_back(Pair("txid", key.txid.GetHex()));
+    entry.push_back(Pair("vout", (int)key.nOut));
+    entry.push_back(Pair("value", ValueFromAmount(value.nValue)));
+    if (value.IsSpent()) {
+        UniValue spent(UniValue::VOBJ);
+        spent.push_back(Pair("txid", value.spentTxid.GetHex()));
+        spent.push_back(Pair("vin", (int)value.nSpentIndex));
+        spent.push_back(Pair("height", (int)value.nSpentHeight));
+        entry.push_back(Pair("spent", spent));
+    }
+    return entry;
+}
+
+UniValue getaddresshistory(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
+        throw std::runtime_error(
+            "getaddresshistory \"address\" ( count skip )\n"
+            "\nList the outputs paying an address in the active chain, oldest first, with the inputs spending them.\n"
+            "Requires -addressindex.\n"
+            "\nArguments:\n"
+            "1. \"address\"   (string, required) The address\n"
+            "2. count       (numeric, optional, default=" + std::to_string(DEFAULT_ADDRESS_RESULTS) + ") The number of outputs to return\n"
+            "3. skip        (numeric, optional, default=0) The number of outputs to skip\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"height\" : n,          (numeric) the height of the block creating the output\n"
+            "    \"txid\" : \"hash\",       (string) the transaction id\n"
+            "    \"vout\" : n,            (numeric) the output number\n"
+            "    \"value\" : x.xxx,       (numeric) the output value in " + CURRENCY_UNIT + "\n"
+            "    \"spent\" : {            (json object, only if spent)\n"
+            "      \"txid\" : \"hash\",     (string) the spending transaction id\n"
+            "      \"vin\" : n,           (numeric) the input number\n"
+            "      \"height\" : n         (numeric) the height of the block spending the output\n"
+            "    }\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getaddresshistory", "\"MAZAaddress\" 100 200")
+            + HelpExampleRpc("getaddresshistory", "\"MAZAaddress\", 100, 200")
+        );
+
+    uint256 scriptHash = GetAddressIndexScriptHash(request.params[0]);
+    int nCount, nSkip;
+    ParseAddressPaging(request, nCount, nSkip);
+
+    UniValue ret(UniValue::VARR);
+    LOCK(cs_main);
+    paddressindex->ForEachOutput(scriptHash, [&](const CAddressIndexKey& key, const CAddressIndexValue& value) {
+        if (nSkip > 0) {
+            nSkip--;
+            return true;
+        }
+        if ((int)ret.size() >= nCount)
+            return false;
+        ret.push_back(AddressOutputToJSON(key, value));
+        return true;
+    });
+    return ret;
+}
+
+UniValue getaddressbalance(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "getaddressbalance \"address\"\n"
+            "\nReturn the balance of an address in the active chain.\n"
+            "Requires -addressindex.\n"
+            "\nArguments:\n"
+            "1. \"address\"   (string, required) The address\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"scripthash\" : \"hash\",    (string) the SHA256 of the output script, as used by the index\n"
+            "  \"balance\" : x.xxx,        (numeric) the value of the unspent outputs in " + CURRENCY_UNIT + "\n"
+            "  \"received\" : x.xxx,       (numeric) the value of all outputs in " + CURRENCY_UNIT + "\n"
+            "  \"outputs\" : n,            (numeric) the number of outputs\n"
+            "  \"unspent_outputs\" : n     (numeric) the number of unspent outputs\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getaddressbalance", "\"MAZAaddress\"")
+            + HelpExampleRpc("getaddressbalance", "\"MAZAaddress\"")
+        );
+
+    uint256 scriptHash = GetAddressIndexScriptHash(request.params[0]);
+
+    CAmount nBalance = 0;
+    CAmount nReceived = 0;
+    int nOutputs = 0;
+    int nUnspent = 0;
+    {
+        LOCK(cs_main);
+        paddressindex->ForEachOutput(scriptHash, [&](const CAddressIndexKey& key, const CAddressIndexValue& value) {
+            nReceived += value.nValue;
+            nOutputs++;
+            if (!value.IsSpent()) {
+                nBalance += value.nValue;
+                nUnspent++;
+            }
+            return true;
+        });
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("scripthash", scriptHash.GetHex()));
+    ret.push_back(Pair("balance", ValueFromAmount(nBalance)));
+    ret.push_back(Pair("received", ValueFromAmount(nReceived)));
+    ret.push_back(Pair("outputs", nOutputs));
+    ret.push_back(Pair("unspent_outputs", nUnspent));
+    return ret;
+}
+
+UniValue getaddressutxos(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
+        throw std::runtime_error(
+            "getaddressutxos \"address\" ( count skip )\n"
+            "\nList the unspent outputs paying an address in the active chain, oldest first.\n"
+            "Requires -addressindex.\n"
+            "\nArguments:\n"
+            "1. \"address\"   (string, required) The address\n"
+            "2. count       (numeric, optional, default=" + std::to_string(DEFAULT_ADDRESS_RESULTS) + ") The number of outputs to return\n"
+            "3. skip        (numeric, optional, default=0) The number of unspent outputs to skip\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"height\" : n,          (numeric) the height of the block creating the output\n"
+            "    \"txid\" : \"hash\",       (string) the transaction id\n"
+            "    \"vout\" : n,            (numeric) the output number\n"
+            "    \"value\" : x.xxx        (numeric) the output value in " + CURRENCY_UNIT + "\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getaddressutxos", "\"MAZAaddress\"")
+            + HelpExampleRpc("getaddressutxos", "\"MAZAaddress\", 100, 0")
+        );
+
+    uint256 scriptHash = GetAddressIndexScriptHash(request.params[0]);
+    int nCount, nSkip;
+    ParseAddressPaging(request, nCount, nSkip);
+
+    UniValue ret(UniValue::VARR);
+    LOCK(cs_main);
+    paddressindex->ForEachOutput(scriptHash, [&](const CAddressIndexKey& key, const CAddressIndexValue& value) {
+        if (value.IsSpent())
+            return true;
+        if (nSkip > 0) {
+            nSkip--;
+            return true;
+        }
+        if ((int)ret.size() >= nCount)
+            return false;
+        ret.push_back(AddressOutputToJSON(key, value));
+        return true;
+    });
+    return ret;
+}
+
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
@@ -1735,7 +2141,13 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getblock",               &getblock,               {"blockhash","verbosity|verbose"} },
     { "blockchain",         "getblockhash",           &getblockhash,           {"height"} },
     { "blockchain",         "getblockheader",         &getblockheader,         {"blockhash","verbose"} },
+    { "blockchain",         "getblockfilter",         &getblockfilter,         {"blockhash","filtertype"} },
+    { "blockchain",         "getblockfilterheaders",  &getblockfilterheaders,  {"start_height","count","filtertype"} },
+    { "blockchain",         "getaddresshistory",      &getaddresshistory,      {"address","count","skip"} },
+    { "blockchain",         "getaddressbalance",      &getaddressbalance,      {"address"} },
+    { "blockchain",         "getaddressutxos",        &getaddressutxos,        {"address","count","skip"} },
     { "blockchain",         "getchaintips",           &getchaintips,           {} },
+    { "blockchain",         "getdbstats",             &getdbstats,             {} },
     { "blockchain",         "getdifficulty",          &getdifficulty,          {} },
     { "blockchain",         "gethivedifficulty",      &gethivedifficulty,      {} },        // Maza: Get Hive difficulty
     { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    {"txid","verbose"} },
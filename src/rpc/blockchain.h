@@ -7,6 +7,7 @@
 
 class CBlock;
 class CBlockIndex;
+class JSONStreamWriter;
 class UniValue;
 
 /**
@@ -24,14 +25,20 @@ double GetDifficulty(const CBlockIndex* blockindex = nullptr, bool getHiveDiffic
 /** Callback for when block tip changed. */
 void RPCNotifyBlockChange(bool ibd, const CBlockIndex *);
 
+/** The block after blockindex on the active chain, and its number of confirmations (-1 if not on it) */
+int ComputeNextBlockAndDepth(const CBlockIndex* blockindex, const CBlockIndex*& next);
+
 /** Block description to JSON */
 UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false);
+/** Streams the description. The chain dependent fields are passed in, so cs_main needn't be held while writing */
+void blockToJSON(JSONStreamWriter& writer, const CBlock& block, const CBlockIndex* blockindex, int confirmations, const CBlockIndex* pnext, bool txDetails = false);
 
 /** Mempool information to JSON */
 UniValue mempoolInfoToJSON();
 
 /** Mempool to JSON */
 UniValue mempoolToJSON(bool fVerbose = false);
+void mempoolToJSON(JSONStreamWriter& writer, bool fVerbose = false);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* blockindex);
@@ -29,8 +29,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "setmocktime", 0, "timestamp" },
     { "generate", 0, "nblocks" },
     { "generate", 1, "maxtries" },
+    { "generate", 3, "threads" },
     { "generatetoaddress", 0, "nblocks" },
     { "generatetoaddress", 2, "maxtries" },
+    { "generatetoaddress", 4, "threads" },
     { "getnetworkhashps", 0, "nblocks" },
     { "getnetworkhashps", 1, "height" },
     { "sendtoaddress", 1, "amount" },
@@ -84,6 +86,12 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getblock", 1, "verbosity" },
     { "getblock", 1, "verbose" },
     { "getblockheader", 1, "verbose" },
+    { "getblockfilterheaders", 0, "start_height" },
+    { "getblockfilterheaders", 1, "count" },
+    { "getaddresshistory", 1, "count" },
+    { "getaddresshistory", 2, "skip" },
+    { "getaddressutxos", 1, "count" },
+    { "getaddressutxos", 2, "skip" },
     { "getchaintxstats", 0, "nblocks" },
     { "gettransaction", 1, "include_watchonly" },
     { "getrawtransaction", 1, "verbose" },
@@ -102,6 +110,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "gethiveinfo", 1, "min_honey_confirms" },     // Maza: Hive: Get hive info
     { "getbctinfo", 1, "min_honey_confirms" },      // Maza: Hive: Get single BCT info
     { "getnetworkhiveinfo", 0, "include_graph" },   // Maza: Hive: Get network hive info
+    { "sethoneyconsolidation", 0, "enabled" },      // Maza: Hive: Configure honey consolidation
+    { "sethoneyconsolidation", 1, "max_feerate" },  // Maza: Hive: Configure honey consolidation
+    { "sethoneyconsolidation", 2, "batch_size" },   // Maza: Hive: Configure honey consolidation
+    { "sethoneyconsolidation", 3, "min_inputs" },   // Maza: Hive: Configure honey consolidation
     { "sethiveparams", 0, "hivecheckdelay"},        // Maza: Hive: Mining optimisations: Set hive mining params
     { "sethiveparams", 1, "hivecheckthreads"},      // Maza: Hive: Mining optimisations: Set hive mining params
     { "sethiveparams", 2, "hiveearlyabort"},        // Maza: Hive: Mining optimisations: Set hive mining params
@@ -0,0 +1,140 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/jsonstream.h>
+
+#include <rpc/server.h>
+
+#include <assert.h>
+
+JSONStreamWriter::JSONStreamWriter() : nChunkSize(0), fAfterKey(false)
+{
+}
+
+JSONStreamWriter::JSONStreamWriter(const ChunkFunc& sinkIn, size_t nChunkSizeIn) : sink(sinkIn), nChunkSize(nChunkSizeIn), fAfterKey(false)
+{
+    assert(sink);
+}
+
+void JSONStreamWriter::Separator()
+{
+    if (fAfterKey) {
+        fAfterKey = false;
+        return;
+    }
+    if (!vNonEmpty.empty()) {
+        if (vNonEmpty.back())
+            buffer += ',';
+        vNonEmpty.back() = true;
+    }
+}
+
+void JSONStreamWriter::Append(const UniValue& value)
+{
+    if (vOpen.empty()) {
+        root = value;
+    } else if (vOpen.back()->isObject()) {
+        vOpen.back()->__pushKV(pendingKey, value);
+    } else {
+        vOpen.back()->push_back(value);
+    }
+}
+
+void JSONStreamWriter::Begin(UniValue::VType type, char open)
+{
+    if (!sink) {
+        if (vOpen.empty()) {
+            root = UniValue(type);
+            vOpen.push_back(&root);
+            return;
+        }
+        // UniValue only hands out const references to its elements, but
+        // the one just appended is ours to fill in
+        Append(UniValue(type));
+        const UniValue& parent = *vOpen.back();
+        vOpen.push_back(&const_cast<UniValue&>(parent[parent.size() - 1]));
+        return;
+    }
+    Separator();
+    buffer += open;
+    vNonEmpty.push_back(false);
+}
+
+void JSONStreamWriter::End(UniValue::VType type, char close)
+{
+    if (!sink) {
+        assert(!vOpen.empty() && vOpen.back()->getType() == type);
+        vOpen.pop_back();
+        return;
+    }
+    assert(!vNonEmpty.empty() && !fAfterKey);
+    vNonEmpty.pop_back();
+    buffer += close;
+    if (buffer.size() >= nChunkSize)
+        Flush();
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    Begin(UniValue::VOBJ, '{');
+}
+
+void JSONStreamWriter::EndObject()
+{
+    End(UniValue::VOBJ, '}');
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    Begin(UniValue::VARR, '[');
+}
+
+void JSONStreamWriter::EndArray()
+{
+    End(UniValue::VARR, ']');
+}
+
+void JSONStreamWriter::Key(const std::string& key)
+{
+    if (!sink) {
+        assert(!vOpen.empty() && vOpen.back()->isObject());
+        pendingKey = key;
+        return;
+    }
+    Separator();
+    buffer += UniValue(key).write();
+    buffer += ':';
+    fAfterKey = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    if (!sink) {
+        Append(value);
+        return;
+    }
+    Separator();
+    buffer += value.write();
+    if (buffer.size() >= nChunkSize)
+        Flush();
+}
+
+void JSONStreamWriter::Flush()
+{
+    if (sink && !buffer.empty()) {
+        sink(buffer);
+        buffer.clear();
+    }
+}
+
+UniValue StreamRPCResult(const JSONRPCRequest& request, const std::function<void(JSONStreamWriter&)>& fn)
+{
+    if (request.stream) {
+        fn(request.stream->Begin());
+        return NullUniValue;
+    }
+    JSONStreamWriter writer;
+    fn(writer);
+    return writer.GetValue();
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_JSONSTREAM_H
+#define BITCOIN_RPC_JSONSTREAM_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <univalue.h>
+
+class JSONRPCRequest;
+
+/** Default number of bytes of JSON text collected before it is handed on */
+static const size_t DEFAULT_JSON_STREAM_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Incremental JSON encoder.
+ *
+ * Values are written one at a time, so a large result (a block with all its
+ * transactions, the verbose mempool) never has to exist as one UniValue tree
+ * and one std::string at the same time. The writer either renders compact
+ * JSON text and hands it to a sink in chunks, or, when constructed without a
+ * sink, assembles the equivalent UniValue for callers that need one. Both
+ * produce exactly the text UniValue::write() would.
+ *
+ * Keys written into an object are not checked for duplicates.
+ */
+class JSONStreamWriter
+{
+public:
+    typedef std::function<void(const std::string&)> ChunkFunc;
+
+    /** Assemble the result as a UniValue, retrieved with GetValue() */
+    JSONStreamWriter();
+    /** Render JSON text, passed to sink roughly nChunkSize bytes at a time */
+    explicit JSONStreamWriter(const ChunkFunc& sink, size_t nChunkSize = DEFAULT_JSON_STREAM_CHUNK_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Write the key of the next member of the enclosing object */
+    void Key(const std::string& key);
+    /** Write a complete value: an array element, an object member after Key(), or the top-level value */
+    void Value(const UniValue& value);
+
+    void KeyValue(const std::string& key, const UniValue& value)
+    {
+        Key(key);
+        Value(value);
+    }
+
+    /** Pass any buffered text on to the sink */
+    void Flush();
+
+    /** The assembled value; only valid for a writer without sink once the top-level value is complete */
+    const UniValue& GetValue() const { return root; }
+
+private:
+    ChunkFunc sink;
+    size_t nChunkSize;
+    std::string buffer;
+
+    /** Per open container: whether it already holds an element (text mode) */
+    std::vector<bool> vNonEmpty;
+    bool fAfterKey;
+
+    /**
+     * Open containers, innermost last (tree mode). Each is built in place in
+     * its parent, so finished containers are never copied; only the
+     * innermost one grows, which keeps the pointers to the others valid.
+     */
+    std::vector<UniValue*> vOpen;
+    std::string pendingKey;
+    UniValue root;
+
+    void Separator();
+    void Begin(UniValue::VType type, char open);
+    void End(UniValue::VType type, char close);
+    void Append(const UniValue& value);
+};
+
+/**
+ * Lets an RPC method write its result straight into the reply of the
+ * transport the call came in on (a chunked HTTP reply), instead of
+ * returning a UniValue. See StreamRPCResult().
+ */
+class RPCResultStream
+{
+public:
+    virtual ~RPCResultStream() {}
+
+    /**
+     * Start the reply. The returned writer must receive exactly one value,
+     * the result. Once called, errors can no longer be reported to the
+     * client, so validate the request before.
+     */
+    virtual JSONStreamWriter& Begin() = 0;
+};
+
+/**
+ * Produce the result of an RPC call with fn. If the request can be streamed
+ * the result is written to the client as it is generated and NullUniValue is
+ * returned (the transport knows the reply was sent), otherwise the result
+ * is returned as usual.
+ */
+UniValue StreamRPCResult(const JSONRPCRequest& request, const std::function<void(JSONStreamWriter&)>& fn);
+
+#endif // BITCOIN_RPC_JSONSTREAM_H
@@ -64,13 +64,13 @@ UniValue GetNetworkHashPS(int lookup, int height, POW_TYPE powType) {
         lookup = pb->nHeight;
 
     // Maza: MinotaurX+Hive1.2: Skip incorrect powType
-    while(IsMinotaurXEnabled(pb, Params().GetConsensus()) && pb->GetBlockHeader().GetPoWType() != powType) {
+    while(pb->IsMinotaurXActive(Params().GetConsensus()) && pb->GetPoWType() != powType) {
         assert (pb->pprev);
         pb = pb->pprev;
     }
     // We have either stepped back to before minotaurx fork, or the requested powType block
     // If we have stepped back to (or started looking up from) pre minotaur, but requested minotaurx pow type, then there are no hashes
-    if (!IsMinotaurXEnabled(pb, Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX) {
+    if (!pb->IsMinotaurXActive(Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX) {
         return 0;
     }
     // We are either post-fork and with correct powType, or pre-fork and with correct powType!
@@ -90,11 +90,11 @@ UniValue GetNetworkHashPS(int lookup, int height, POW_TYPE powType) {
         // hive blocks almost immediately follow pow blocks, the contribution to timing
         // inaccuracies are most likely fairly insignificant.
 
-        while(IsMinotaurXEnabled(pb, Params().GetConsensus()) && pb->GetBlockHeader().GetPoWType() != powType) {
+        while(pb->IsMinotaurXActive(Params().GetConsensus()) && pb->GetPoWType() != powType) {
             assert (pb->pprev);
             pb = pb->pprev;
         }
-        if(!IsMinotaurXEnabled(pb, Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX) {
+        if(!pb->IsMinotaurXActive(Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX) {
             break;
         }
 
@@ -121,7 +121,7 @@ UniValue sethiveparams(const JSONRPCRequest& request)
             "sethiveparams ( hivecheckdelay, hivecheckthreads, hiveearlyout )\n"
             "\nSet hivemining optimisation parameters.\n"
             "\nArguments:\n"
-            "1. hivecheckdelay     (numeric, required, default=1) Time between Hive checks in ms. This should be left at default unless performance degradation is observed.\n"
+            "1. hivecheckdelay     (numeric, required) Ignored: Hive checks start as soon as a new block is connected. Kept for compatibility.\n"
             "2. hivecheckthreads   (numeric, required, default=-2) Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores.\n"
             "3. hiveearlyout       (boolean, required, default=true) Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed.\n"
             "\nExamples:\n"
@@ -129,7 +129,6 @@ UniValue sethiveparams(const JSONRPCRequest& request)
             + HelpExampleRpc("sethiveparams", "2000 8 true")
        );
 
-    gArgs.ForceSetArg("-hivecheckdelay", std::to_string(request.params[0].get_int()));
     gArgs.ForceSetArg("-hivecheckthreads", std::to_string(request.params[1].get_int()));
     gArgs.ForceSetArg("-hiveearlyout", std::to_string(request.params[2].get_bool()));
 
@@ -145,9 +144,17 @@ UniValue gethiveparams(const JSONRPCRequest& request)
             "\nGet hivemining optimisation parameters.\n"
             "\nResult:\n"
             "{\n"
-            "  \"hivecheckdelay\" : n,             (numeric) Time between Hive checks in ms. This should be left at default unless performance degradation is observed.\n"
             "  \"hivecheckthreads\" : n,           (numeric) Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores.\n"
             "  \"hiveearlyout\" : true|false,      (boolean) Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed.\n"
+            "  \"hivechecks\" : {                  (json object) Timings of the Hive checks since startup\n"
+            "    \"checks\" : n,                   (numeric) Checks that hashed bees\n"
+            "    \"aborted\" : n,                  (numeric) Checks cancelled by a newer block\n"
+            "    \"submitted\" : n,                (numeric) Hive blocks submitted\n"
+            "    \"last_tip_to_first_bee_ms\" : n, (numeric) From the last block arriving to the first bee hashed\n"
+            "    \"avg_tip_to_first_bee_ms\" : n,  (numeric) The same, averaged over all checks\n"
+            "    \"last_check_ms\" : n,            (numeric) Time the last check spent hashing bees\n"
+            "    \"last_tip_to_submit_ms\" : n,    (numeric, optional) From the block arriving to submitting a Hive block on it, for the last Hive block submitted\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("gethiveparams", "")
@@ -155,10 +162,21 @@ UniValue gethiveparams(const JSONRPCRequest& request)
        );
 
     UniValue obj(UniValue::VOBJ);
-    obj.push_back(Pair("hivecheckdelay", gArgs.GetArg("-hivecheckdelay", DEFAULT_HIVE_CHECK_DELAY)));
     obj.push_back(Pair("hivecheckthreads", gArgs.GetArg("-hivecheckthreads", DEFAULT_HIVE_THREADS)));
     obj.push_back(Pair("hiveearlyout", gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT) ? "true" : "false"));
 
+    CHiveCheckLatency latency = GetHiveCheckLatency();
+    UniValue checks(UniValue::VOBJ);
+    checks.push_back(Pair("checks", latency.nChecks));
+    checks.push_back(Pair("aborted", latency.nAborted));
+    checks.push_back(Pair("submitted", latency.nSolutions));
+    checks.push_back(Pair("last_tip_to_first_bee_ms", latency.nLastTipToFirstBee / 1000.0));
+    checks.push_back(Pair("avg_tip_to_first_bee_ms", latency.nTimedChecks ? latency.nTotalTipToFirstBee / 1000.0 / latency.nTimedChecks : 0.0));
+    checks.push_back(Pair("last_check_ms", latency.nLastCheck / 1000.0));
+    if (latency.nLastTipToSubmit >= 0)
+        checks.push_back(Pair("last_tip_to_submit_ms", latency.nLastTipToSubmit / 1000.0));
+    obj.push_back(Pair("hivechecks", checks));
+
     return obj;
 }
 
@@ -182,28 +200,45 @@ UniValue getnetworkhashps(const JSONRPCRequest& request)
             + HelpExampleRpc("getnetworkhashps", "")
        );
 
-    // Maza: MinotaurX+Hive1.2
-    std::string strAlgo = gArgs.GetArg("-powalgo", DEFAULT_POW_TYPE);
-    if (!request.params[2].isNull())
-        strAlgo = request.params[2].get_str();
-
-    bool algoFound = false;
-    POW_TYPE powType;
-    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++) {
-        if (strAlgo == POW_TYPE_NAMES[i]) {
-            powType = (POW_TYPE)i;
-            algoFound = true;
-            break;
-        }
-    }
-    if (!algoFound)
-        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid pow algorithm requested");
+    POW_TYPE powType = ParsePowTypeArg(request.params[2]);    // Maza: MinotaurX+Hive1.2
 
     LOCK(cs_main);
     return GetNetworkHashPS(!request.params[0].isNull() ? request.params[0].get_int() : 120, !request.params[1].isNull() ? request.params[1].get_int() : -1, powType);
 }
 
-UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript)
+// Maza: MinotaurX+Hive1.2: Look up a pow type by name
+POW_TYPE ParsePowType(const std::string& strAlgo)
+{
+    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++)
+        if (strAlgo == POW_TYPE_NAMES[i])
+            return (POW_TYPE)i;
+
+    throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid pow algorithm requested");
+}
+
+// Maza: MinotaurX+Hive1.2: Pow type argument of an RPC; defaults to -powalgo
+POW_TYPE ParsePowTypeArg(const UniValue& value)
+{
+    if (value.isNull())
+        return ParsePowType(gArgs.GetArg("-powalgo", DEFAULT_POW_TYPE));
+    return ParsePowType(value.get_str());
+}
+
+// Maza: MinotaurX+Hive1.2: Nonce search threads to generate with; -1 for one per core
+int ParseGenerateThreads(const UniValue& value)
+{
+    if (value.isNull())
+        return 1;
+
+    int nThreads = value.get_int();
+    if (nThreads == -1)
+        return std::max(GetNumCores(), 1);
+    if (nThreads < 1)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid number of threads, must be positive or -1");
+    return nThreads;
+}
+
+UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript, POW_TYPE powType, int nThreads)
 {
     static const int nInnerLoopCount = 0x10000;
     int nHeightEnd = 0;
@@ -218,7 +253,7 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
     UniValue blockHashes(UniValue::VARR);
     while (nHeight < nHeightEnd)
     {
-        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(coinbaseScript->reserveScript));
+        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(coinbaseScript->reserveScript, true, nullptr, powType));
         if (!pblocktemplate.get())
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Couldn't create new block");
         CBlock *pblock = &pblocktemplate->block;
@@ -226,14 +261,11 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(), pblock->nBits, Params().GetConsensus())) {
-            ++pblock->nNonce;
-            --nMaxTries;
-        }
-        if (nMaxTries == 0) {
-            break;
-        }
-        if (pblock->nNonce == nInnerLoopCount) {
+        // Maza: MinotaurX+Hive1.2: Search the nonces on nThreads threads
+        if (!SolveBlockNonce(*pblock, Params().GetConsensus(), nThreads, nInnerLoopCount, nMaxTries)) {
+            if (nMaxTries == 0) {
+                break;
+            }
             continue;
         }
         std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
@@ -253,19 +285,23 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
 
 UniValue generatetoaddress(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
+    if (request.fHelp || request.params.size() < 2 || request.params.size() > 5)
         throw std::runtime_error(
-            "generatetoaddress nblocks address (maxtries)\n"
+            "generatetoaddress nblocks address (maxtries \"powalgo\" threads)\n"
             "\nMine blocks immediately to a specified address (before the RPC call returns)\n"
             "\nArguments:\n"
             "1. nblocks      (numeric, required) How many blocks are generated immediately.\n"
             "2. address      (string, required) The address to send the newly generated maza to.\n"
             "3. maxtries     (numeric, optional) How many iterations to try (default = 1000000).\n"
+            "4. \"powalgo\"    (string, optional) Pow algorithm to mine with (sha256d or minotaurx; default from -powalgo).\n"
+            "5. threads      (numeric, optional) Threads to search nonces on, -1 for one per core (default = 1).\n"
             "\nResult:\n"
             "[ blockhashes ]     (array) hashes of blocks generated\n"
             "\nExamples:\n"
             "\nGenerate 11 blocks to myaddress\n"
             + HelpExampleCli("generatetoaddress", "11 \"myaddress\"")
+            + "\nGenerate 11 MinotaurX blocks to myaddress on every core\n"
+            + HelpExampleCli("generatetoaddress", "11 \"myaddress\" 1000000 \"minotaurx\" -1")
         );
 
     int nGenerate = request.params[0].get_int();
@@ -282,7 +318,7 @@ UniValue generatetoaddress(const JSONRPCRequest& request)
     std::shared_ptr<CReserveScript> coinbaseScript = std::make_shared<CReserveScript>();
     coinbaseScript->reserveScript = GetScriptForDestination(destination);
 
-    return generateBlocks(coinbaseScript, nGenerate, nMaxTries, false);
+    return generateBlocks(coinbaseScript, nGenerate, nMaxTries, false, ParsePowTypeArg(request.params[3]), ParseGenerateThreads(request.params[4]));
 }
 
 UniValue getmininginfo(const JSONRPCRequest& request)
@@ -547,17 +583,7 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     }
 
     // Maza: MinotaurX+Hive1.2: Check for a valid pow type
-    bool algoFound = false;
-    POW_TYPE powType;
-    for (unsigned int i = 0; i < NUM_BLOCK_TYPES; i++) {
-        if (strAlgo == POW_TYPE_NAMES[i]) {
-            powType = (POW_TYPE)i;
-            algoFound = true;
-            break;
-        }
-    }
-    if (!algoFound)
-        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid pow algorithm requested");
+    POW_TYPE powType = ParsePowType(strAlgo);
 
     if (strMode != "template")
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode");
@@ -1111,7 +1137,7 @@ static const CRPCCommand commands[] =
     { "mining",             "submitblock",            &submitblock,            {"hexdata","dummy"} },
 
 
-    { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
+    { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries","powalgo","threads"} },
 
     { "util",               "estimatefee",            &estimatefee,            {"nblocks"} },
     { "util",               "estimatesmartfee",       &estimatesmartfee,       {"conf_target", "estimate_mode"} },
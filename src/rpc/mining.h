@@ -5,12 +5,20 @@
 #ifndef BITCOIN_RPC_MINING_H
 #define BITCOIN_RPC_MINING_H
 
+#include <primitives/block.h>
 #include <script/script.h>
 
 #include <univalue.h>
 
 /** Generate blocks (mine) */
-UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript);
+UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript, POW_TYPE powType = POW_TYPE_SHA256, int nThreads = 1);
+
+/** Maza: MinotaurX+Hive1.2: Look up a pow type by name, or by the powalgo argument of an RPC defaulting to -powalgo */
+POW_TYPE ParsePowType(const std::string& strAlgo);
+POW_TYPE ParsePowTypeArg(const UniValue& value);
+
+/** Maza: MinotaurX+Hive1.2: Parse the threads argument of generate and generatetoaddress */
+int ParseGenerateThreads(const UniValue& value);
 
 /** Check bounds on a command line confirm target */
 unsigned int ParseConfirmTarget(const UniValue& value);
@@ -101,6 +101,11 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
             "       n,                        (numeric) The heights of blocks we're currently asking from this peer\n"
             "       ...\n"
             "    ],\n"
+            "    \"download_window\": n,      (numeric) How many blocks we keep in flight from this peer, adapted to its measured speed\n"
+            "    \"download_latency\": n,     (numeric) Average time in seconds from requesting a block to receiving it (0 if none yet)\n"
+            "    \"download_bytes_per_sec\": n, (numeric) Average block download speed from this peer\n"
+            "    \"blocks_delivered\": n,     (numeric) Number of requested blocks this peer delivered\n"
+            "    \"blocks_rerequested\": n,   (numeric) Number of blocks requested from another peer instead because this one lagged\n"
             "    \"whitelisted\": true|false, (boolean) Whether the peer is whitelisted\n"
             "    \"bytessent_per_msg\": {\n"
             "       \"addr\": n,              (numeric) The total bytes sent aggregated by message type\n"
@@ -167,6 +172,11 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
                 heights.push_back(height);
             }
             obj.push_back(Pair("inflight", heights));
+            obj.push_back(Pair("download_window", statestats.nBlockWindow));
+            obj.push_back(Pair("download_latency", statestats.nBlockLatency * 0.000001));
+            obj.push_back(Pair("download_bytes_per_sec", statestats.nBlockBytesPerSec));
+            obj.push_back(Pair("blocks_delivered", statestats.nBlocksDelivered));
+            obj.push_back(Pair("blocks_rerequested", statestats.nBlocksRerequested));
         }
         obj.push_back(Pair("whitelisted", stats.fWhitelisted));
 
@@ -190,6 +200,89 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
     return ret;
 }
 
+// Maza: Compact block reconstruction counts as reported by getcompactblockstats
+static UniValue CompactBlockStatsToJSON(const CCompactBlockStats& stats)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("blocks", stats.nBlocks));
+    obj.push_back(Pair("reconstructed", stats.nReconstructed));
+    obj.push_back(Pair("reconstruction_rate", stats.nBlocks ? (double)stats.nReconstructed / stats.nBlocks : 0.0));
+    obj.push_back(Pair("roundtrips", stats.nRoundTrips));
+    obj.push_back(Pair("roundtrip_latency", stats.nRoundTripLatency * 0.000001));
+    obj.push_back(Pair("missing_txs", stats.nMissingTxs));
+    obj.push_back(Pair("extra_txs", stats.nExtraTxs));
+    return obj;
+}
+
+UniValue getcompactblockstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getcompactblockstats\n"
+            "\nReturns how well compact blocks have been reconstructed from the mempool and the extra transactions\n"
+            "kept for reconstruction, for the node since startup and for each connected peer that sent any.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"blocks\": n,                (numeric) Compact blocks we started to reconstruct\n"
+            "  \"reconstructed\": n,         (numeric) Of those, blocks reconstructed without a getblocktxn round trip\n"
+            "  \"reconstruction_rate\": x.x, (numeric) Share of blocks reconstructed without a round trip\n"
+            "  \"roundtrips\": n,            (numeric) Getblocktxn round trips completed\n"
+            "  \"roundtrip_latency\": x.x,   (numeric) Average getblocktxn round trip in seconds (0 if none yet)\n"
+            "  \"missing_txs\": n,           (numeric) Transactions we had neither in the mempool nor the extra transactions\n"
+            "  \"extra_txs\": n,             (numeric) Transactions found in the extra transactions rather than the mempool\n"
+            "  \"extra_pool\": {\n"
+            "    \"txs\": n,                 (numeric) Extra transactions kept for reconstruction\n"
+            "    \"usage\": n,               (numeric) Their memory usage in bytes\n"
+            "    \"max_txs\": n,             (numeric) Limit set by -blockreconstructionextratxn\n"
+            "    \"max_usage\": n            (numeric) Limit in bytes set by -blockreconstructionmaxmem\n"
+            "  },\n"
+            "  \"peers\": [\n"
+            "    {\n"
+            "      \"id\": n,                (numeric) Peer index\n"
+            "      \"addr\": \"host:port\",    (string) The IP address and port of the peer\n"
+            "      ...                     The same counts as above, for compact blocks from this peer\n"
+            "    }\n"
+            "    ,...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getcompactblockstats", "")
+            + HelpExampleRpc("getcompactblockstats", "")
+        );
+
+    if(!g_connman)
+        throw JSONRPCError(RPC_CLIENT_P2P_DISABLED, "Error: Peer-to-peer functionality missing or disabled");
+
+    CCompactBlockStats cmpctStats;
+    size_t nExtraTxs, nExtraTxUsage;
+    GetCompactBlockStats(cmpctStats, nExtraTxs, nExtraTxUsage);
+    UniValue ret = CompactBlockStatsToJSON(cmpctStats);
+
+    UniValue extraPool(UniValue::VOBJ);
+    extraPool.push_back(Pair("txs", (uint64_t)nExtraTxs));
+    extraPool.push_back(Pair("usage", (uint64_t)nExtraTxUsage));
+    extraPool.push_back(Pair("max_txs", gArgs.GetArg("-blockreconstructionextratxn", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN)));
+    extraPool.push_back(Pair("max_usage", gArgs.GetArg("-blockreconstructionmaxmem", DEFAULT_BLOCK_RECONSTRUCTION_MAX_MEM) * 1000000));
+    ret.push_back(Pair("extra_pool", extraPool));
+
+    std::vector<CNodeStats> vstats;
+    g_connman->GetNodeStats(vstats);
+    UniValue peers(UniValue::VARR);
+    for (const CNodeStats& stats : vstats) {
+        CNodeStateStats statestats;
+        if (!GetNodeStateStats(stats.nodeid, statestats) || statestats.cmpctStats.nBlocks == 0)
+            continue;
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("id", stats.nodeid));
+        obj.push_back(Pair("addr", stats.addrName));
+        obj.pushKVs(CompactBlockStatsToJSON(statestats.cmpctStats));
+        peers.push_back(obj);
+    }
+    ret.push_back(Pair("peers", peers));
+
+    return ret;
+}
+
 UniValue addnode(const JSONRPCRequest& request)
 {
     std::string strCommand;
@@ -630,6 +723,7 @@ static const CRPCCommand commands[] =
     { "network",            "getconnectioncount",     &getconnectioncount,     {} },
     { "network",            "ping",                   &ping,                   {} },
     { "network",            "getpeerinfo",            &getpeerinfo,            {} },
+    { "network",            "getcompactblockstats",   &getcompactblockstats,   {} },
     { "network",            "addnode",                &addnode,                {"node","command"} },
     { "network",            "disconnectnode",         &disconnectnode,         {"address", "nodeid"} },
     { "network",            "getaddednodeinfo",       &getaddednodeinfo,       {"node"} },
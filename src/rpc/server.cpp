@@ -20,7 +20,10 @@
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <atomic>
+#include <condition_variable>
 #include <memory> // for unique_ptr
+#include <mutex>
 #include <unordered_map>
 
 static bool fRPCRunning = false;
@@ -410,13 +413,92 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
     return rpc_result;
 }
 
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
+/**
+ * Shared state of a JSON-RPC batch whose entries may be executed by several
+ * threads. Entries are claimed in order through nNext and their serialized
+ * replies stored by index, so the assembled response keeps request order.
+ * Helpers hold a reference of their own because they can start running after
+ * the thread that owns the request has already finished the whole batch.
+ */
+class JSONRPCBatch
 {
-    UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+public:
+    JSONRPCBatch(const JSONRPCRequest& jreqIn, const UniValue& vReqIn, size_t nMaxReplyBytesIn) :
+        jreq(jreqIn), vReq(vReqIn), vReply(vReqIn.size()), nMaxReplyBytes(nMaxReplyBytesIn), nNext(0), nReplyBytes(0), nDone(0)
+    {
+    }
+
+    /** Execute entries until none are left to claim */
+    void Work()
+    {
+        for (size_t i = nNext++; i < vReq.size(); i = nNext++) {
+            std::string strReply;
+            if (nReplyBytes.load() > nMaxReplyBytes) {
+                // Stop producing results once the batch has used up its
+                // allowance; further entries get an error each.
+                UniValue id = vReq[i].isObject() ? find_value(vReq[i].get_obj(), "id") : NullUniValue;
+                strReply = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_OUT_OF_MEMORY, "Batch response size limit exceeded"), id).write();
+            } else {
+                strReply = JSONRPCExecOne(jreq, vReq[i]).write();
+            }
+            nReplyBytes += strReply.size();
+            vReply[i] = std::move(strReply);
 
-    return ret.write() + "\n";
+            std::lock_guard<std::mutex> lock(cs);
+            if (++nDone == vReq.size())
+                cond.notify_all();
+        }
+    }
+
+    /** Wait for all entries, including those claimed by helpers, and return the response */
+    std::string Finish()
+    {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            cond.wait(lock, [this] { return nDone == vReq.size(); });
+        }
+        std::string strRet;
+        strRet.reserve(nReplyBytes.load() + vReply.size() + 3);
+        strRet += '[';
+        for (size_t i = 0; i < vReply.size(); i++) {
+            if (i > 0)
+                strRet += ',';
+            strRet += vReply[i];
+            std::string().swap(vReply[i]);
+        }
+        strRet += "]\n";
+        return strRet;
+    }
+
+    size_t size() const { return vReq.size(); }
+
+private:
+    const JSONRPCRequest jreq;
+    const UniValue vReq;
+    std::vector<std::string> vReply;
+    const size_t nMaxReplyBytes;
+    std::atomic<size_t> nNext;
+    std::atomic<size_t> nReplyBytes;
+
+    std::mutex cs;
+    std::condition_variable cond;
+    size_t nDone;
+};
+
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, size_t nMaxReplyBytes, int nMaxThreads, const RPCBatchSpawner& spawn)
+{
+    std::shared_ptr<JSONRPCBatch> batch = std::make_shared<JSONRPCBatch>(jreq, vReq, nMaxReplyBytes);
+
+    // Offer the batch to other threads; this one works on it too, so the
+    // batch completes even if no helper gets to run.
+    if (spawn) {
+        for (int i = 1; i < nMaxThreads && (size_t)i < batch->size(); i++) {
+            if (!spawn([batch] { batch->Work(); }))
+                break;
+        }
+    }
+    batch->Work();
+    return batch->Finish();
 }
 
 /**
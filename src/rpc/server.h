@@ -10,6 +10,8 @@
 #include <rpc/protocol.h>
 #include <uint256.h>
 
+#include <functional>
+#include <limits>
 #include <list>
 #include <map>
 #include <stdint.h>
@@ -20,6 +22,7 @@
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
 
 class CRPCCommand;
+class RPCResultStream;
 
 namespace RPCServer
 {
@@ -45,8 +48,10 @@ public:
     bool fHelp;
     std::string URI;
     std::string authUser;
+    /** Set when the transport can take the result incrementally, see StreamRPCResult() */
+    RPCResultStream* stream;
 
-    JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false) {}
+    JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false), stream(nullptr) {}
     void parse(const UniValue& valRequest);
 };
 
@@ -191,7 +196,19 @@ extern std::string HelpExampleRpc(const std::string& methodname, const std::stri
 bool StartRPC();
 void InterruptRPC();
 void StopRPC();
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq);
+
+/** Hands a task to another thread. Returns false if it could not be queued. */
+typedef std::function<bool(const std::function<void()>&)> RPCBatchSpawner;
+
+/**
+ * Execute a JSON-RPC batch and return the serialized array of replies, in
+ * request order. Up to nMaxThreads - 1 helper tasks are offered to spawn to
+ * execute entries concurrently with the calling thread. Once the replies
+ * produced so far exceed nMaxReplyBytes, remaining entries fail with
+ * RPC_OUT_OF_MEMORY instead of being executed.
+ */
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, size_t nMaxReplyBytes = std::numeric_limits<size_t>::max(),
+                             int nMaxThreads = 1, const RPCBatchSpawner& spawn = nullptr);
 
 // Retrieves any serialization flags requested in command line argument
 int RPCSerializationFlags();
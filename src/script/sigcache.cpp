@@ -57,6 +57,21 @@ public:
     {
         return setValid.setup_bytes(n);
     }
+
+    void GetEntries(uint256& nonceOut, std::vector<uint256>& vEntries)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
+        nonceOut = nonce;
+        setValid.get_entries(vEntries);
+    }
+
+    void Restore(const uint256& nonceIn, const std::vector<uint256>& vEntries)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
+        nonce = nonceIn;
+        for (const uint256& entry : vEntries)
+            setValid.insert(entry);
+    }
 };
 
 /* In previous versions of this code, signatureCache was a local static variable
@@ -80,6 +95,16 @@ void InitSignatureCache()
             (nElems*sizeof(uint256)) >>20, (nMaxCacheSize*2)>>20, nElems);
 }
 
+void GetSignatureCacheEntries(uint256& nonce, std::vector<uint256>& vEntries)
+{
+    signatureCache.GetEntries(nonce, vEntries);
+}
+
+void RestoreSignatureCache(const uint256& nonce, const std::vector<uint256>& vEntries)
+{
+    signatureCache.Restore(nonce, vEntries);
+}
+
 bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
 {
     uint256 entry;
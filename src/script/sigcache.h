@@ -18,6 +18,7 @@ static const unsigned int DEFAULT_MAX_SIG_CACHE_SIZE = 32;
 static const int64_t MAX_MAX_SIG_CACHE_SIZE = 16384;
 
 class CPubKey;
+class uint256;
 
 /**
  * We're hashing a nonce into the entries themselves, so we don't need extra
@@ -53,4 +54,13 @@ public:
 
 void InitSignatureCache();
 
+/** Get the salt of the signature cache and the entries it holds, to save them. */
+void GetSignatureCacheEntries(uint256& nonce, std::vector<uint256>& vEntries);
+/**
+ * Replace the salt of the signature cache and add saved entries. Entries
+ * already in the cache no longer match after this, so it is only meant to be
+ * called at startup, before any signature has been checked.
+ */
+void RestoreSignatureCache(const uint256& nonce, const std::vector<uint256>& vEntries);
+
 #endif // BITCOIN_SCRIPT_SIGCACHE_H
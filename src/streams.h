@@ -15,6 +15,7 @@
 #include <limits>
 #include <map>
 #include <set>
+#include <stdexcept>
 #include <stdint.h>
 #include <stdio.h>
 #include <string>
@@ -138,6 +139,146 @@ private:
     size_t nPos;
 };
 
+/* Minimal stream for reading from an existing byte vector by reference
+ */
+class CVectorReader
+{
+ public:
+
+/*
+ * @param[in]  nTypeIn Serialization Type
+ * @param[in]  nVersionIn Serialization Version (including any flags)
+ * @param[in]  vchDataIn  Referenced byte vector to read from
+ * @param[in]  nPosIn Starting position. Vector index where reads should start.
+*/
+    CVectorReader(int nTypeIn, int nVersionIn, const std::vector<unsigned char>& vchDataIn, size_t nPosIn) : nType(nTypeIn), nVersion(nVersionIn), vchData(vchDataIn), nPos(nPosIn)
+    {
+        if (nPos > vchData.size())
+            throw std::ios_base::failure("CVectorReader(...): end of data (nPos > vchData.size())");
+    }
+    void read(char* pch, size_t nSize)
+    {
+        if (nSize == 0)
+            return;
+        if (nPos + nSize > vchData.size())
+            throw std::ios_base::failure("CVectorReader::read(): end of data");
+        memcpy(pch, vchData.data() + nPos, nSize);
+        nPos += nSize;
+    }
+    void ignore(size_t nSize)
+    {
+        if (nPos + nSize > vchData.size())
+            throw std::ios_base::failure("CVectorReader::ignore(): end of data");
+        nPos += nSize;
+    }
+    template<typename T>
+    CVectorReader& operator>>(T& obj)
+    {
+        // Unserialize from this stream
+        ::Unserialize(*this, obj);
+        return (*this);
+    }
+    int GetVersion() const
+    {
+        return nVersion;
+    }
+    int GetType() const
+    {
+        return nType;
+    }
+    size_t size() const { return vchData.size() - nPos; }
+    bool empty() const { return vchData.size() == nPos; }
+private:
+    const int nType;
+    const int nVersion;
+    const std::vector<unsigned char>& vchData;
+    size_t nPos;
+};
+
+/* Reads bit by bit from a byte stream, most significant bit of each byte first
+ */
+template <typename IStream>
+class CBitStreamReader
+{
+private:
+    IStream& istream;
+    /** Byte read from the stream; a new one is read once nOffset reaches 8 */
+    uint8_t nBuffer;
+    /** Number of high bits of nBuffer already returned */
+    int nOffset;
+
+public:
+    explicit CBitStreamReader(IStream& istreamIn) : istream(istreamIn), nBuffer(0), nOffset(8) {}
+
+    /** Read nBits bits, returned in the low bits of the result */
+    uint64_t Read(int nBits)
+    {
+        if (nBits < 0 || nBits > 64)
+            throw std::out_of_range("nBits must be between 0 and 64");
+
+        uint64_t data = 0;
+        while (nBits > 0) {
+            if (nOffset == 8) {
+                istream >> nBuffer;
+                nOffset = 0;
+            }
+            int bits = std::min(8 - nOffset, nBits);
+            data <<= bits;
+            data |= static_cast<uint8_t>(nBuffer << nOffset) >> (8 - bits);
+            nOffset += bits;
+            nBits -= bits;
+        }
+        return data;
+    }
+};
+
+/* Writes bit by bit to a byte stream, most significant bit of each byte first
+ */
+template <typename OStream>
+class CBitStreamWriter
+{
+private:
+    OStream& ostream;
+    /** Byte being filled; written out once nOffset reaches 8 or on Flush() */
+    uint8_t nBuffer;
+    /** Number of high bits of nBuffer already filled */
+    int nOffset;
+
+public:
+    explicit CBitStreamWriter(OStream& ostreamIn) : ostream(ostreamIn), nBuffer(0), nOffset(0) {}
+
+    ~CBitStreamWriter()
+    {
+        Flush();
+    }
+
+    /** Write the low nBits bits of data */
+    void Write(uint64_t data, int nBits)
+    {
+        if (nBits < 0 || nBits > 64)
+            throw std::out_of_range("nBits must be between 0 and 64");
+
+        while (nBits > 0) {
+            int bits = std::min(8 - nOffset, nBits);
+            nBuffer |= (data << (64 - nBits)) >> (64 - 8 + nOffset);
+            nOffset += bits;
+            nBits -= bits;
+            if (nOffset == 8)
+                Flush();
+        }
+    }
+
+    /** Write out any buffered bits, padding the last byte with zeros */
+    void Flush()
+    {
+        if (nOffset == 0)
+            return;
+        ostream << nBuffer;
+        nBuffer = 0;
+        nOffset = 0;
+    }
+};
+
 /** Double ended buffer combining vector and stream-like interfaces.
  *
  * >> and << read and write unformatted data using the above serialization templates.
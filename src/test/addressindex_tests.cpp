@@ -0,0 +1,92 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addressindex.h>
+#include <primitives/block.h>
+#include <pubkey.h>
+#include <script/standard.h>
+#include <test/test_bitcoin.h>
+#include <undo.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(addressindex_tests, TestingSetup)
+
+static std::vector<std::pair<CAddressIndexKey, CAddressIndexValue>> GetOutputs(const CAddressIndex& index, const CScript& script)
+{
+    std::vector<std::pair<CAddressIndexKey, CAddressIndexValue>> vOutputs;
+    index.ForEachOutput(AddressIndexScriptHash(script), [&](const CAddressIndexKey& key, const CAddressIndexValue& value) {
+        vOutputs.emplace_back(key, value);
+        return true;
+    });
+    return vOutputs;
+}
+
+BOOST_AUTO_TEST_CASE(addressindex_connect_disconnect)
+{
+    CScript scriptA = GetScriptForDestination(CKeyID(uint160(ParseHex("0101010101010101010101010101010101010101"))));
+    CScript scriptB = GetScriptForDestination(CKeyID(uint160(ParseHex("0202020202020202020202020202020202020202"))));
+
+    // Block 1 pays 50 to A
+    CMutableTransaction coinbase1;
+    coinbase1.vin.resize(1);
+    coinbase1.vin[0].scriptSig = CScript() << 1;
+    coinbase1.vout.emplace_back(50 * COIN, scriptA);
+    CBlock block1;
+    block1.vtx.push_back(MakeTransactionRef(coinbase1));
+    CBlockUndo undo1;
+
+    // Block 2 moves 30 of it to B and 20 back to A
+    CMutableTransaction coinbase2;
+    coinbase2.vin.resize(1);
+    coinbase2.vin[0].scriptSig = CScript() << 2;
+    coinbase2.vout.emplace_back(0, CScript() << OP_RETURN);
+    CMutableTransaction spend;
+    spend.vin.emplace_back(COutPoint(coinbase1.GetHash(), 0));
+    spend.vout.emplace_back(30 * COIN, scriptB);
+    spend.vout.emplace_back(20 * COIN, scriptA);
+    CBlock block2;
+    block2.vtx.push_back(MakeTransactionRef(coinbase2));
+    block2.vtx.push_back(MakeTransactionRef(spend));
+    CBlockUndo undo2;
+    undo2.vtxundo.resize(1);
+    undo2.vtxundo[0].vprevout.emplace_back(coinbase1.vout[0], 1, true);
+
+    CAddressIndex index(1 << 20, true);
+    index.ConnectBlock(block1, undo1, 1);
+    BOOST_CHECK(index.Flush());
+    index.ConnectBlock(block2, undo2, 2);
+
+    // Database and pending entries are merged
+    auto vA = GetOutputs(index, scriptA);
+    BOOST_REQUIRE_EQUAL(vA.size(), 2U);
+    BOOST_CHECK_EQUAL(vA[0].first.nHeight, 1U);
+    BOOST_CHECK_EQUAL(vA[0].second.nValue, 50 * COIN);
+    BOOST_CHECK(vA[0].second.spentTxid == spend.GetHash());
+    BOOST_CHECK_EQUAL(vA[0].second.nSpentHeight, 2U);
+    BOOST_CHECK_EQUAL(vA[1].first.nHeight, 2U);
+    BOOST_CHECK_EQUAL(vA[1].first.nOut, 1U);
+    BOOST_CHECK(!vA[1].second.IsSpent());
+    auto vB = GetOutputs(index, scriptB);
+    BOOST_REQUIRE_EQUAL(vB.size(), 1U);
+    BOOST_CHECK_EQUAL(vB[0].second.nValue, 30 * COIN);
+
+    // Same result once flushed
+    BOOST_CHECK(index.Flush());
+    BOOST_CHECK_EQUAL(GetOutputs(index, scriptA).size(), 2U);
+    BOOST_CHECK_EQUAL(GetOutputs(index, scriptB).size(), 1U);
+
+    // Disconnecting block 2 restores the state after block 1, before and after flushing
+    index.DisconnectBlock(block2, undo2, 2);
+    for (int i = 0; i < 2; i++) {
+        vA = GetOutputs(index, scriptA);
+        BOOST_REQUIRE_EQUAL(vA.size(), 1U);
+        BOOST_CHECK_EQUAL(vA[0].first.nHeight, 1U);
+        BOOST_CHECK(!vA[0].second.IsSpent());
+        BOOST_CHECK(GetOutputs(index, scriptB).empty());
+        BOOST_CHECK(index.Flush());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
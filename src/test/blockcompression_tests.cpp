@@ -0,0 +1,195 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <base58.h>
+#include <blockcompression.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <primitives/block.h>
+#include <pubkey.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+#include <undo.h>
+#include <utilstrencodings.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockcompression_tests, BasicTestingSetup)
+
+static std::vector<unsigned char> Serialize(const CBlock& block)
+{
+    std::vector<unsigned char> vch;
+    CVectorWriter(SER_DISK, CLIENT_VERSION, vch, 0, block);
+    return vch;
+}
+
+// Maza: Hive: A coinbase paying a hive proof in its first output, laid out as BusyBees writes it
+static CMutableTransaction HiveCoinbase(const uint256& bctTxid, const CScript& honeyScript)
+{
+    std::vector<unsigned char> beeNonce(4, 0x07), bctHeight(4, 0x2a), messageSig(65, 0x1f);
+    std::string strTxid = bctTxid.GetHex();
+    std::vector<unsigned char> txidVec(strTxid.begin(), strTxid.end());
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].scriptSig = CScript() << 878439 << OP_0;
+    coinbase.vout.emplace_back(0, CScript() << OP_RETURN << OP_BEE << beeNonce << bctHeight << OP_TRUE << txidVec << messageSig);
+    coinbase.vout.emplace_back(1000 * COIN, honeyScript);
+    return coinbase;
+}
+
+static CBlock BuildBlock()
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CScript beeCreationScript = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));
+    CScript communityScript = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
+    CScript scriptA = GetScriptForDestination(CKeyID(uint160(ParseHex("0101010101010101010101010101010101010101"))));
+    CScript scriptB = GetScriptForDestination(WitnessV0KeyHash(uint160(ParseHex("0202020202020202020202020202020202020202"))));
+
+    CBlock block;
+    block.nVersion = 0x20000000;
+    block.hashPrevBlock = uint256S("0babe680f55a55d54339511226755f0837261da89a4e78eba4d6436a63026df8");
+    block.nTime = 1530000000;
+    block.nBits = 0x1d00ffff;
+    block.nNonce = consensusParams.hiveNonceMarker;
+    block.vtx.push_back(MakeTransactionRef(HiveCoinbase(uint256S("00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff"), scriptA)));
+
+    // A BCT with a community contribution
+    CMutableTransaction bct;
+    bct.vin.emplace_back(COutPoint(uint256S("1111111111111111111111111111111111111111111111111111111111111111"), 3), CScript() << std::vector<unsigned char>(72, 0x30));
+    bct.vout.emplace_back(10 * COIN, beeCreationScript);
+    bct.vout.emplace_back(1 * COIN, communityScript);
+    bct.vout.emplace_back(123456789, scriptA);
+    block.vtx.push_back(MakeTransactionRef(bct));
+
+    // A segwit spend of the BCT change, with odd version, sequence and lock time
+    CMutableTransaction spend;
+    spend.nVersion = 3;
+    spend.nLockTime = 878438;
+    spend.vin.emplace_back(COutPoint(block.vtx[1]->GetHash(), 2), CScript(), 0xfffffffd);
+    spend.vin[0].scriptWitness.stack.push_back(std::vector<unsigned char>(71, 0x30));
+    spend.vin[0].scriptWitness.stack.push_back(std::vector<unsigned char>(33, 0x02));
+    spend.vout.emplace_back(123400000, scriptB);
+    spend.vout.emplace_back(0, CScript() << OP_RETURN << std::vector<unsigned char>(20, 0xab));
+    block.vtx.push_back(MakeTransactionRef(spend));
+
+    // Another BCT, repeating the bee creation output
+    CMutableTransaction bct2;
+    bct2.nVersion = 1;
+    bct2.vin.emplace_back(COutPoint(uint256S("2222222222222222222222222222222222222222222222222222222222222222"), 0), CScript() << OP_1, 0);
+    bct2.vout.emplace_back(20 * COIN, beeCreationScript);
+    bct2.vout.emplace_back(5 * COIN, scriptB);
+    block.vtx.push_back(MakeTransactionRef(bct2));
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(blockcompression_roundtrip)
+{
+    std::vector<CScript> vDictionary = GetBlockScriptDictionary(Params().GetConsensus());
+    CBlock block = BuildBlock();
+
+    std::vector<unsigned char> vch;
+    BOOST_CHECK(CompressBlock(block, vDictionary, vch));
+    BOOST_CHECK(vch.size() < Serialize(block).size());
+
+    CBlock decoded;
+    DecompressBlock(vch, vDictionary, decoded);
+    BOOST_CHECK(decoded.GetHash() == block.GetHash());
+    BOOST_CHECK(Serialize(decoded) == Serialize(block));
+    BOOST_CHECK_EQUAL(decoded.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++)
+        BOOST_CHECK(decoded.vtx[i]->GetWitnessHash() == block.vtx[i]->GetWitnessHash());
+
+    // Truncated and extended records are rejected
+    CBlock wrong;
+    std::vector<unsigned char> vchShort(vch.begin(), vch.end() - 1);
+    BOOST_CHECK_THROW(DecompressBlock(vchShort, vDictionary, wrong), std::ios_base::failure);
+    std::vector<unsigned char> vchLong(vch);
+    vchLong.push_back(0);
+    BOOST_CHECK_THROW(DecompressBlock(vchLong, vDictionary, wrong), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(blockcompression_uppercase_hive_proof)
+{
+    // A txid the packed form can't reproduce is stored as part of the script
+    std::vector<CScript> vDictionary = GetBlockScriptDictionary(Params().GetConsensus());
+    CBlock block = BuildBlock();
+    CMutableTransaction coinbase(*block.vtx[0]);
+    coinbase.vout[0].scriptPubKey[20] = 'F';
+    block.vtx[0] = MakeTransactionRef(coinbase);
+
+    std::vector<unsigned char> vch;
+    BOOST_CHECK(CompressBlock(block, vDictionary, vch));
+    CBlock decoded;
+    DecompressBlock(vch, vDictionary, decoded);
+    BOOST_CHECK(Serialize(decoded) == Serialize(block));
+}
+
+BOOST_AUTO_TEST_CASE(blockcompression_unrepresentable)
+{
+    std::vector<CScript> vDictionary = GetBlockScriptDictionary(Params().GetConsensus());
+    std::vector<unsigned char> vch;
+
+    // Scripts the script compressor would truncate
+    CBlock block = BuildBlock();
+    CMutableTransaction tx(*block.vtx[1]);
+    tx.vout[2].scriptPubKey = CScript() << std::vector<unsigned char>(MAX_SCRIPT_SIZE, 0x00);
+    block.vtx[1] = MakeTransactionRef(tx);
+    BOOST_CHECK(!CompressBlock(block, vDictionary, vch));
+    BOOST_CHECK(vch.empty());
+
+    // Amounts out of range
+    block = BuildBlock();
+    tx = CMutableTransaction(*block.vtx[1]);
+    tx.vout[2].nValue = -1;
+    block.vtx[1] = MakeTransactionRef(tx);
+    BOOST_CHECK(!CompressBlock(block, vDictionary, vch));
+}
+
+BOOST_AUTO_TEST_CASE(blockcompression_undo_roundtrip)
+{
+    std::vector<CScript> vDictionary = GetBlockScriptDictionary(Params().GetConsensus());
+    CBlock block = BuildBlock();
+    const int nHeight = 878439;
+
+    CBlockUndo blockundo;
+    for (size_t i = 1; i < block.vtx.size(); i++) {
+        CTxUndo txundo;
+        txundo.vprevout.emplace_back(CTxOut(i * COIN, vDictionary[0]), nHeight - i, false);
+        txundo.vprevout.emplace_back(block.vtx[i]->vout[0], 1, true);
+        txundo.vprevout.emplace_back(block.vtx[i]->vout[0], nHeight, i % 2);
+        blockundo.vtxundo.push_back(txundo);
+    }
+
+    std::vector<unsigned char> vch;
+    BOOST_CHECK(CompressBlockUndo(blockundo, nHeight, vDictionary, vch));
+    BOOST_CHECK(vch.size() < ::GetSerializeSize(blockundo, SER_DISK, CLIENT_VERSION));
+
+    CBlockUndo decoded;
+    DecompressBlockUndo(vch, nHeight, vDictionary, decoded);
+    BOOST_CHECK_EQUAL(decoded.vtxundo.size(), blockundo.vtxundo.size());
+    for (size_t i = 0; i < blockundo.vtxundo.size(); i++) {
+        BOOST_CHECK_EQUAL(decoded.vtxundo[i].vprevout.size(), blockundo.vtxundo[i].vprevout.size());
+        for (size_t j = 0; j < blockundo.vtxundo[i].vprevout.size(); j++) {
+            const Coin& a = decoded.vtxundo[i].vprevout[j];
+            const Coin& b = blockundo.vtxundo[i].vprevout[j];
+            BOOST_CHECK_EQUAL(a.nHeight, b.nHeight);
+            BOOST_CHECK_EQUAL(a.fCoinBase, b.fCoinBase);
+            BOOST_CHECK(a.out == b.out);
+        }
+    }
+
+    // Heights are relative, so decoding at another height gives other coins
+    CBlockUndo shifted;
+    DecompressBlockUndo(vch, nHeight + 1, vDictionary, shifted);
+    BOOST_CHECK_EQUAL(shifted.vtxundo[0].vprevout[0].nHeight, blockundo.vtxundo[0].vprevout[0].nHeight + 1);
+    BOOST_CHECK_THROW(DecompressBlockUndo(vch, 0, vDictionary, shifted), std::ios_base::failure);
+
+    // Coins from after the spending block can't be represented
+    blockundo.vtxundo[0].vprevout[0].nHeight = nHeight + 1;
+    BOOST_CHECK(!CompressBlockUndo(blockundo, nHeight, vDictionary, vch));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
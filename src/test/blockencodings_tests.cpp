@@ -317,6 +317,36 @@ BOOST_AUTO_TEST_CASE(EmptyBlockRoundTripTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ExtraTxnNullSlotsTest)
+{
+    CTxMemPool pool;
+    CBlock block(BuildBlockTestCase());
+
+    // Maza: The extra txn kept by the node have empty slots, not yet filled or
+    // emptied to stay under -blockreconstructionmaxmem, between the txn
+    std::vector<std::pair<uint256, CTransactionRef>> extra_txn_slots;
+    extra_txn_slots.emplace_back(uint256(), nullptr);
+    extra_txn_slots.emplace_back(block.vtx[1]->GetWitnessHash(), block.vtx[1]);
+    extra_txn_slots.emplace_back(block.vtx[2]->GetWitnessHash(), nullptr);
+
+    {
+        CBlockHeaderAndShortTxIDs shortIDs(block, true);
+
+        PartiallyDownloadedBlock partialBlock(&pool);
+        BOOST_CHECK(partialBlock.InitData(shortIDs, extra_txn_slots) == READ_STATUS_OK);
+        BOOST_CHECK( partialBlock.IsTxAvailable(0));
+        BOOST_CHECK( partialBlock.IsTxAvailable(1));
+        BOOST_CHECK(!partialBlock.IsTxAvailable(2));
+        BOOST_CHECK_EQUAL(partialBlock.GetExtraTxCount(), 1U);
+
+        CBlock block2;
+        BOOST_CHECK(partialBlock.FillBlock(block2, {block.vtx[2]}) == READ_STATUS_OK);
+        bool mutated;
+        BOOST_CHECK_EQUAL(block.hashMerkleRoot.ToString(), BlockMerkleRoot(block2, &mutated).ToString());
+        BOOST_CHECK(!mutated);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(TransactionsRequestSerializationTest) {
     BlockTransactionsRequest req1;
     req1.blockhash = InsecureRand256();
@@ -0,0 +1,115 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <clientversion.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockimport_tests, TestChain100Setup)
+
+/** A block with just a coinbase on top of prev, which is not yet known to the chain */
+static CBlock MakeChild(const CBlock& prev, int nHeight)
+{
+    CBlock block(prev);
+    block.hashPrevBlock = prev.GetHash();
+    block.nTime = prev.nTime + 1;
+    block.fChecked = false;
+    CMutableTransaction coinbase(*block.vtx[0]);
+    coinbase.vin[0].scriptSig = CScript() << nHeight << OP_0;
+    block.vtx[0] = MakeTransactionRef(std::move(coinbase));
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, Params().GetConsensus())) ++block.nNonce;
+    return block;
+}
+
+/** Three blocks extending the active chain */
+static std::vector<CBlock> MakeChain()
+{
+    CBlock tip;
+    int nHeight;
+    {
+        LOCK(cs_main);
+        BOOST_REQUIRE(ReadBlockFromDisk(tip, chainActive.Tip(), Params().GetConsensus()));
+        nHeight = chainActive.Height();
+    }
+    std::vector<CBlock> blocks;
+    for (int i = 1; i <= 3; i++)
+        blocks.push_back(MakeChild(blocks.empty() ? tip : blocks.back(), nHeight + i));
+    return blocks;
+}
+
+/** The disk record of a block, as WriteBlockToDisk lays it out */
+static std::vector<unsigned char> Record(const CBlock& block)
+{
+    std::vector<unsigned char> vch;
+    unsigned int nSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+    CVectorWriter(SER_DISK, CLIENT_VERSION, vch, 0, FLATDATA(Params().MessageStart()), nSize, block);
+    return vch;
+}
+
+/** Write the records to a block file of their own and import it as a reindex would */
+static bool Import(const std::vector<std::vector<unsigned char>>& records)
+{
+    CDiskBlockPos pos(1, 0);
+    {
+        CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!fileout.IsNull());
+        for (const std::vector<unsigned char>& vch : records)
+            fileout.write((const char*)vch.data(), vch.size());
+    }
+    FILE* file = OpenBlockFile(pos, true);
+    BOOST_REQUIRE(file);
+    bool fLoaded = LoadExternalBlockFile(Params(), file, &pos);
+    CValidationState state;
+    BOOST_CHECK(ActivateBestChain(state, Params()));
+    return fLoaded;
+}
+
+BOOST_AUTO_TEST_CASE(import_corrupt_record_before_block)
+{
+    std::vector<CBlock> blocks = MakeChain();
+
+    // A record whose size runs over the header of the next one, with contents
+    // that fail to deserialise: an 80 byte header and an impossible number of
+    // transactions
+    std::vector<unsigned char> vchBody(80, 0);
+    vchBody.insert(vchBody.end(), 9, 0xff);
+    std::vector<unsigned char> vchNext = Record(blocks[0]);
+    vchBody.insert(vchBody.end(), vchNext.begin(), vchNext.end());
+    std::vector<unsigned char> vchCorrupt;
+    CVectorWriter(SER_DISK, CLIENT_VERSION, vchCorrupt, 0, FLATDATA(Params().MessageStart()), (unsigned int)vchBody.size());
+    vchCorrupt.insert(vchCorrupt.end(), vchBody.begin(), vchBody.end());
+
+    // The block inside the corrupt record is found again, and so are the
+    // blocks after it that were read ahead before the record failed
+    BOOST_CHECK(Import({vchCorrupt, Record(blocks[1]), Record(blocks[2])}));
+    LOCK(cs_main);
+    BOOST_CHECK(chainActive.Tip()->GetBlockHash() == blocks[2].GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(import_out_of_order_blocks)
+{
+    std::vector<CBlock> blocks = MakeChain();
+
+    // Children ahead of their parents wait until the parent is imported, and
+    // then are read back from the file in order
+    BOOST_CHECK(Import({Record(blocks[2]), Record(blocks[1]), Record(blocks[0])}));
+    LOCK(cs_main);
+    BOOST_CHECK(chainActive.Tip()->GetBlockHash() == blocks[2].GetHash());
+    for (const CBlock& block : blocks) {
+        CBlockIndex* pindex = mapBlockIndex[block.GetHash()];
+        BOOST_CHECK(pindex->nStatus & BLOCK_HAVE_DATA);
+        BOOST_CHECK_EQUAL(pindex->GetBlockPos().nFile, 1);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <test/test_bitcoin.h>
+#include <txdb.h>
+
+#include <map>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockindex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(blockindex_arena)
+{
+    CBlockIndexArena arena;
+    std::vector<CBlockIndex*> vEntries;
+    for (int i = 0; i < 40000; i++) {
+        vEntries.push_back(arena.Allocate());
+        BOOST_CHECK(vEntries.back()->phashBlock == nullptr && vEntries.back()->nProofK == 0);
+        vEntries.back()->nHeight = i;
+    }
+    BOOST_CHECK_EQUAL(arena.size(), 40000U);
+    for (int i = 0; i < 40000; i++) {
+        BOOST_CHECK(arena.Owns(vEntries[i]));
+        BOOST_CHECK_EQUAL(vEntries[i]->nHeight, i);
+    }
+
+    std::unique_ptr<CBlockIndex> pforeign(new CBlockIndex());
+    BOOST_CHECK(!arena.Owns(pforeign.get()));
+
+    arena.Clear();
+    BOOST_CHECK_EQUAL(arena.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(blockindex_chainwork_records)
+{
+    // A short chain, with chain work and bonus factors set as AddToBlockIndex does
+    const int nBlocks = 5;
+    std::vector<CBlockIndex> vBlocks(nBlocks);
+    std::vector<uint256> vHashes(nBlocks);
+    for (int i = 0; i < nBlocks; i++) {
+        CBlockIndex& block = vBlocks[i];
+        block.pprev = i ? &vBlocks[i - 1] : nullptr;
+        block.nHeight = i;
+        block.nVersion = 0x20000000;
+        block.nTime = 1530000000 + i * 150;
+        block.nBits = 0x1e0ffff0;
+        block.nNonce = i;
+        block.nStatus = BLOCK_VALID_TREE;
+        vHashes[i] = block.GetBlockHeader().GetHash();
+        block.phashBlock = &vHashes[i];
+        block.nProofK = i + 1;
+        block.nChainWork = (i ? vBlocks[i - 1].nChainWork : 0) + GetBlockProof(block);
+    }
+    // Entries written by older versions have no chain work record
+    vBlocks[3].nProofK = 0;
+
+    CBlockTreeDB db(1 << 20, true, false);
+    std::vector<const CBlockIndex*> vInfo;
+    for (const CBlockIndex& block : vBlocks)
+        vInfo.push_back(&block);
+    BOOST_CHECK(db.WriteBatchSync({}, 0, vInfo));
+
+    // Entries are created as CChainState::InsertBlockIndex does
+    std::map<uint256, std::unique_ptr<CBlockIndex>> mapLoaded;
+    auto insertBlockIndex = [&mapLoaded](const uint256& hash) -> CBlockIndex* {
+        if (hash.IsNull())
+            return nullptr;
+        auto it = mapLoaded.emplace(hash, nullptr).first;
+        if (!it->second) {
+            it->second.reset(new CBlockIndex());
+            it->second->phashBlock = &it->first;
+        }
+        return it->second.get();
+    };
+    BOOST_CHECK(db.LoadBlockIndexGuts(Params().GetConsensus(), insertBlockIndex));
+    BOOST_CHECK_EQUAL(mapLoaded.size(), (size_t)nBlocks);
+
+    for (int i = 0; i < nBlocks; i++) {
+        const CBlockIndex* pindex = mapLoaded[vHashes[i]].get();
+        BOOST_CHECK_EQUAL(pindex->nHeight, i);
+        BOOST_CHECK(pindex->pprev == (i ? mapLoaded[vHashes[i - 1]].get() : nullptr));
+        if (i == 3) {
+            BOOST_CHECK_EQUAL(pindex->nProofK, 0U);
+            BOOST_CHECK(pindex->nChainWork == 0);
+        } else {
+            BOOST_CHECK_EQUAL(pindex->nProofK, (unsigned int)(i + 1));
+            BOOST_CHECK(pindex->nChainWork == vBlocks[i].nChainWork);
+        }
+    }
+
+    // An entry stored under another block's hash is refused
+    CDBBatch batch(db);
+    batch.Write(std::make_pair('b', vHashes[0]), CDiskBlockIndex(&vBlocks[1]));
+    BOOST_CHECK(db.WriteBatch(batch));
+    mapLoaded.clear();
+    BOOST_CHECK(!db.LoadBlockIndexGuts(Params().GetConsensus(), insertBlockIndex));
+}
+
+BOOST_AUTO_TEST_CASE(blockindex_block_types)
+{
+    // The same chain twice, with and without the packed block types built.
+    // Lookups must give the same answers either way.
+    const Consensus::Params& params = Params().GetConsensus();
+    const int nBlocks = 400;
+    std::vector<CBlockIndex> vBuilt(nBlocks), vPlain(nBlocks);
+    std::vector<uint256> vHashes(nBlocks);
+    for (int i = 0; i < nBlocks; i++) {
+        vHashes[i] = ArithToUint256(arith_uint256(i + 1));
+        CBlockIndex& block = vBuilt[i];
+        block.phashBlock = &vHashes[i];
+        block.pprev = i ? &vBuilt[i - 1] : nullptr;
+        block.nHeight = i;
+        // Legacy blocks first, some legacy-looking ones later, and runs of hive blocks
+        int nSlot = InsecureRandRange(7);
+        block.nVersion = (i < 50 || nSlot == 0) ? 0x20000000 : 0x10000000 | ((nSlot % 2) << 16);
+        block.nNonce = (i >= 50 && nSlot >= 5) ? params.hiveNonceMarker : i;
+        vPlain[i] = block;
+        vPlain[i].pprev = i ? &vPlain[i - 1] : nullptr;
+        vBuilt[i].BuildBlockType(params);
+    }
+
+    auto height = [](const CBlockIndex* pindex) { return pindex ? pindex->nHeight : -1; };
+    for (int i = 0; i < nBlocks; i++) {
+        const CBlockIndex& built = vBuilt[i];
+        const CBlockIndex& plain = vPlain[i];
+        BOOST_CHECK(built.nBlockType & BLOCK_TYPE_KNOWN);
+        BOOST_CHECK(!(plain.nBlockType & BLOCK_TYPE_KNOWN));
+        BOOST_CHECK_EQUAL(built.IsHiveMined(params), plain.IsHiveMined(params));
+        BOOST_CHECK_EQUAL(built.GetPoWType(), plain.GetPoWType());
+        BOOST_CHECK_EQUAL(height(built.GetLastHiveBlock(params)), height(plain.GetLastHiveBlock(params)));
+        BOOST_CHECK_EQUAL(height(built.GetLastPoWBlock(POW_TYPE_SHA256, params)), height(plain.GetLastPoWBlock(POW_TYPE_SHA256, params)));
+        BOOST_CHECK_EQUAL(height(built.GetLastPoWBlock(POW_TYPE_MINOTAURX, params)), height(plain.GetLastPoWBlock(POW_TYPE_MINOTAURX, params)));
+        BOOST_CHECK_EQUAL(built.GetLastLegacyHeight(), plain.GetLastLegacyHeight());
+        BOOST_CHECK_EQUAL(built.GetHiveRun(params), plain.GetHiveRun(params));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
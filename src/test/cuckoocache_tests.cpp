@@ -58,6 +58,33 @@ BOOST_AUTO_TEST_CASE(test_cuckoocache_no_fakes)
     }
 };
 
+/* Test that get_entries returns what is still wanted in the cache: inserted
+ * entries until they are marked for erasure.
+ */
+BOOST_AUTO_TEST_CASE(cuckoocache_get_entries)
+{
+    local_rand_ctx = FastRandomContext(true);
+    CuckooCache::cache<uint256, SignatureCacheHasher> cc{};
+    cc.setup_bytes(1 << 20);
+    std::vector<uint256> entries;
+    cc.get_entries(entries);
+    BOOST_CHECK(entries.empty());
+
+    std::vector<uint256> inserted(1000);
+    for (uint256& v : inserted) {
+        insecure_GetRandHash(v);
+        cc.insert(v);
+    }
+    for (size_t i = 0; i < inserted.size(); i += 2)
+        BOOST_CHECK(cc.contains(inserted[i], true));
+
+    cc.get_entries(entries);
+    BOOST_CHECK_EQUAL(entries.size(), inserted.size() / 2);
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < inserted.size(); i++)
+        BOOST_CHECK_EQUAL(std::binary_search(entries.begin(), entries.end(), inserted[i]), i % 2 == 1);
+}
+
 /** This helper returns the hit rate when megabytes*load worth of entries are
  * inserted into a megabytes sized cache
  */
@@ -40,6 +40,35 @@ BOOST_AUTO_TEST_CASE(dbwrapper)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_profiles)
+{
+    for (DBProfile profile : {DBProfile::STEADY, DBProfile::IBD, DBProfile::LOW_MEMORY}) {
+        DBProfile parsed;
+        BOOST_CHECK(DBProfileFromName(DBProfileName(profile), parsed));
+        BOOST_CHECK(parsed == profile);
+
+        fs::path ph = fs::temp_directory_path() / fs::unique_path();
+        CDBWrapper dbw(ph, (1 << 20), true, false, false, profile);
+        BOOST_CHECK(dbw.GetProfile() == profile);
+
+        CDBBatch batch(dbw);
+        for (uint32_t i = 0; i < 1000; i++)
+            batch.Write(std::make_pair('k', i), InsecureRand256());
+        BOOST_CHECK(dbw.WriteBatch(batch));
+        dbw.CompactFull();
+
+        uint256 res;
+        BOOST_CHECK(dbw.Read(std::make_pair('k', (uint32_t)999), res));
+        BOOST_CHECK(dbw.DynamicMemoryUsage() > 0);
+        std::string stats;
+        BOOST_CHECK(dbw.GetProperty("leveldb.stats", stats));
+        BOOST_CHECK(!dbw.GetProperty("leveldb.nonexistent", stats));
+    }
+
+    DBProfile parsed;
+    BOOST_CHECK(!DBProfileFromName("fast", parsed));
+}
+
 // Test batch operations
 BOOST_AUTO_TEST_CASE(dbwrapper_batch)
 {
@@ -0,0 +1,86 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <miner.h>
+#include <test/test_bitcoin.h>
+#include <utiltime.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(hive_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(beekeeper_notifier)
+{
+    CBeeKeeperNotifier notifier;
+    RegisterValidationInterface(&notifier);
+    int64_t nTipTime = 0;
+
+    // Nothing to check before a tip arrives
+    BOOST_CHECK(!notifier.HasNewTip());
+    BOOST_CHECK(!notifier.WaitForNewTip(nTipTime, 10));
+
+    // Tips connected during initial block download don't wake the BeeKeeper
+    GetMainSignals().UpdatedBlockTip(chainActive.Tip(), nullptr, true);
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(!notifier.HasNewTip());
+
+    // A new tip wakes it once, with the time the tip arrived
+    int64_t nBefore = GetTimeMicros();
+    GetMainSignals().UpdatedBlockTip(chainActive.Tip(), nullptr, false);
+    BOOST_CHECK(notifier.WaitForNewTip(nTipTime, 10000));
+    BOOST_CHECK(nTipTime >= nBefore && nTipTime <= GetTimeMicros());
+    BOOST_CHECK(!notifier.HasNewTip());
+    BOOST_CHECK(!notifier.WaitForNewTip(nTipTime, 10));
+
+    // Tips arriving during a check make a single check of the latest one
+    GetMainSignals().UpdatedBlockTip(chainActive.Tip(), nullptr, false);
+    SyncWithValidationInterfaceQueue();
+    int64_t nFirstTipTime = 0;
+    BOOST_CHECK(notifier.WaitForNewTip(nFirstTipTime, 0));
+    MilliSleep(1);
+    GetMainSignals().UpdatedBlockTip(chainActive.Tip(), nullptr, false);
+    GetMainSignals().UpdatedBlockTip(chainActive.Tip(), nullptr, false);
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(notifier.WaitForNewTip(nTipTime, 0));
+    BOOST_CHECK(nTipTime > nFirstTipTime);
+    BOOST_CHECK(!notifier.HasNewTip());
+
+    UnregisterValidationInterface(&notifier);
+}
+
+BOOST_AUTO_TEST_CASE(hive_check_latency)
+{
+    CHiveCheckLatency latency;
+    BOOST_CHECK_EQUAL(latency.nLastTipToSubmit, -1);
+
+    latency.AddCheck(1000, 1500, 300, false);
+    latency.AddCheck(2000, 2700, 400, true);
+    BOOST_CHECK_EQUAL(latency.nChecks, 2);
+    BOOST_CHECK_EQUAL(latency.nAborted, 1);
+    BOOST_CHECK_EQUAL(latency.nTimedChecks, 2);
+    BOOST_CHECK_EQUAL(latency.nLastTipToFirstBee, 700);
+    BOOST_CHECK_EQUAL(latency.nTotalTipToFirstBee, 1200);
+    BOOST_CHECK_EQUAL(latency.nLastCheck, 400);
+
+    // Checks without a tip time or without a bee hashed count, but aren't timed
+    latency.AddCheck(0, 3500, 100, false);
+    latency.AddCheck(4000, 0, 50, true);
+    BOOST_CHECK_EQUAL(latency.nChecks, 4);
+    BOOST_CHECK_EQUAL(latency.nAborted, 2);
+    BOOST_CHECK_EQUAL(latency.nTimedChecks, 2);
+    BOOST_CHECK_EQUAL(latency.nLastTipToFirstBee, 700);
+    BOOST_CHECK_EQUAL(latency.nTotalTipToFirstBee, 1200);
+    BOOST_CHECK_EQUAL(latency.nLastCheck, 50);
+
+    latency.AddSolution(5000, 5900);
+    BOOST_CHECK_EQUAL(latency.nSolutions, 1);
+    BOOST_CHECK_EQUAL(latency.nLastTipToSubmit, 900);
+    latency.AddSolution(0, 7000);
+    BOOST_CHECK_EQUAL(latency.nSolutions, 2);
+    BOOST_CHECK_EQUAL(latency.nLastTipToSubmit, 900);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <crypto/minotaurx/minotaur.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+#include <version.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(minotaur_tests, BasicTestingSetup)
+
+// A random MinotaurX header past the pow fork, so that GetPoWHash() gives its MinotaurX hash
+static CBlockHeader GetTestHeader()
+{
+    CBlockHeader header;
+    header.nVersion = 0x10000000 | (POW_TYPE_MINOTAURX << 16) | InsecureRandBits(16);
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nTime = Params().GetConsensus().powForkTime + 1 + InsecureRandBits(24);
+    header.nBits = InsecureRand32();
+    header.nNonce = InsecureRand32();
+    return header;
+}
+
+static std::vector<unsigned char> GetPrefix(const CBlockHeader& header)
+{
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << header;
+    BOOST_REQUIRE_EQUAL(ss.size(), 80U);
+    return std::vector<unsigned char>(ss.begin(), ss.begin() + MinotaurHeaderHasher::PREFIX_SIZE);
+}
+
+BOOST_AUTO_TEST_CASE(minotaur_header_hasher_pow_hash)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    for (int i = 0; i < 4; i++) {
+        CBlockHeader header = GetTestHeader();
+        MinotaurHeaderHasher hasher(GetPrefix(header).data(), true);
+        // The nonce the header came with, the ends of the range, and a run from it
+        std::vector<uint32_t> vNonces = {header.nNonce, 0, 0xffffffff};
+        for (uint32_t n = 1; n < 4; n++)
+            vNonces.push_back(header.nNonce + n);
+        for (uint32_t nNonce : vNonces) {
+            header.nNonce = nNonce;
+            BOOST_CHECK_EQUAL(hasher.Hash(nNonce).GetHex(), header.GetPoWHash().GetHex());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(minotaur_header_hasher_range)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    CBlockHeader header = GetTestHeader();
+    std::vector<unsigned char> vPrefix = GetPrefix(header);
+
+    // A range over the nonce wraparound, hashed in the caller's yespower region
+    yespower_local_t local;
+    yespower_init_local(&local);
+    {
+        MinotaurHeaderHasher hasher(vPrefix.data(), true, &local);
+        const uint32_t nBegin = 0xfffffffe, nCount = 4;
+        uint256 hashes[nCount];
+        hasher.HashRange(nBegin, nCount, hashes);
+        for (uint32_t i = 0; i < nCount; i++) {
+            header.nNonce = nBegin + i;
+            BOOST_CHECK_EQUAL(hashes[i].GetHex(), header.GetPoWHash().GetHex());
+        }
+    }
+    yespower_free_local(&local);
+
+    // Plain Minotaur, as used for hive hashes, and the stats counts
+    MinotaurStats stats = {};
+    MinotaurHeaderHasher hasher(vPrefix.data(), false);
+    for (uint32_t nNonce = 0; nNonce < 8; nNonce++) {
+        header.nNonce = nNonce;
+        BOOST_CHECK(hasher.Hash(nNonce, &stats) == Minotaur(BEGIN(header.nVersion), END(header.nNonce), false));
+    }
+    BOOST_CHECK_EQUAL(stats.hashes, 8U);
+    BOOST_CHECK_EQUAL(stats.algoRuns[MINOTAUR_ALGO_COUNT], 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <miner.h>
 #include <pow.h>
 #include <random.h>
 #include <util.h>
@@ -83,4 +84,64 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+static CBlockHeader GetNonceTestHeader(POW_TYPE powType, bool fForked)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    CBlockHeader header;
+    header.nVersion = 0x10000000 | (powType << 16);
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nTime = fForked ? params.powForkTime + 1 : params.powForkTime;
+    header.nBits = 0x207fffff;
+    return header;
+}
+
+BOOST_AUTO_TEST_CASE(header_nonce_hasher)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& params = Params().GetConsensus();
+    // Before the fork everything is sha256d; after it, by pow type, with unknown types never meeting a target
+    for (POW_TYPE powType : {POW_TYPE_SHA256, POW_TYPE_MINOTAURX, (POW_TYPE)NUM_BLOCK_TYPES}) {
+        for (bool fForked : {false, true}) {
+            CBlockHeader header = GetNonceTestHeader(powType, fForked);
+            CHeaderNonceHasher hasher(header, params);
+            CHeaderNonceHasher hasherThreadRegion(header, params, true);
+            for (uint32_t nNonce : {0U, 1U, 0x12345678U, 0xffffffffU, 2U}) {
+                header.nNonce = nNonce;
+                BOOST_CHECK(hasher.GetPoWHash(nNonce) == header.GetPoWHash());
+                BOOST_CHECK(hasherThreadRegion.GetPoWHash(nNonce) == header.GetPoWHash());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(solve_block_nonce)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& params = Params().GetConsensus();
+    for (POW_TYPE powType : {POW_TYPE_SHA256, POW_TYPE_MINOTAURX}) {
+        for (int nThreads : {1, 3}) {
+            CBlockHeader header = GetNonceTestHeader(powType, true);
+            uint64_t nMaxTries = 1000;
+            BOOST_CHECK(SolveBlockNonce(header, params, nThreads, 0x10000, nMaxTries));
+            BOOST_CHECK(UintToArith256(header.GetPoWHash()) <= arith_uint256().SetCompact(header.nBits));
+            BOOST_CHECK(nMaxTries < 1000);
+        }
+    }
+
+    // Out of tries, or an unsolvable target
+    CBlockHeader header = GetNonceTestHeader(POW_TYPE_SHA256, true);
+    uint64_t nMaxTries = 0;
+    BOOST_CHECK(!SolveBlockNonce(header, params, 2, 0x10000, nMaxTries));
+    header.nBits = 0x01010000;
+    nMaxTries = 1000;
+    BOOST_CHECK(!SolveBlockNonce(header, params, 4, 500, nMaxTries));
+    BOOST_CHECK_EQUAL(nMaxTries, 500U);
+    header.nBits = 0x1d00ffff;
+    header.nVersion = 0x10000000 | (NUM_BLOCK_TYPES << 16);
+    nMaxTries = 100;
+    BOOST_CHECK(!SolveBlockNonce(header, params, 1, 0x10000, nMaxTries));
+    BOOST_CHECK_EQUAL(nMaxTries, 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
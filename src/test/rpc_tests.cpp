@@ -4,16 +4,22 @@
 
 #include <rpc/server.h>
 #include <rpc/client.h>
+#include <rpc/jsonstream.h>
 
 #include <base58.h>
+#include <chainparams.h>
 #include <core_io.h>
 #include <netbase.h>
+#include <txmempool.h>
+#include <validation.h>
 
 #include <test/test_bitcoin.h>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <thread>
+
 #include <univalue.h>
 
 UniValue CallRPC(std::string args)
@@ -351,4 +357,156 @@ BOOST_AUTO_TEST_CASE(rpc_convert_values_generatetoaddress)
     BOOST_CHECK_EQUAL(result[2].get_int(), 9);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_batch)
+{
+    if (RPCIsInWarmup(nullptr))
+        SetRPCWarmupFinished();
+
+    UniValue batch(UniValue::VARR);
+    for (int i = 0; i < 50; i++) {
+        UniValue params(UniValue::VARR);
+        params.push_back(std::string(100, 'a' + i % 26));
+        batch.push_back(JSONRPCRequestObj("echo", params, i));
+    }
+    batch.push_back(JSONRPCRequestObj("nosuchmethod", NullUniValue, 50));
+    JSONRPCRequest jreq;
+
+    // Replies keep request order whether or not helpers run
+    RPCBatchSpawner spawn = [](const std::function<void()>& func) { std::thread(func).detach(); return true; };
+    for (int nThreads : {1, 4}) {
+        UniValue ret;
+        BOOST_CHECK(ret.read(JSONRPCExecBatch(jreq, batch, std::numeric_limits<size_t>::max(), nThreads, spawn)));
+        BOOST_CHECK_EQUAL(ret.size(), 51U);
+        for (int i = 0; i < 50; i++) {
+            BOOST_CHECK_EQUAL(find_value(ret[i].get_obj(), "id").get_int(), i);
+            BOOST_CHECK_EQUAL(find_value(ret[i].get_obj(), "result")[0].get_str(), std::string(100, 'a' + i % 26));
+        }
+        BOOST_CHECK_EQUAL(find_value(find_value(ret[50].get_obj(), "error").get_obj(), "code").get_int(), (int)RPC_METHOD_NOT_FOUND);
+    }
+
+    // Once the reply limit is used up, remaining entries fail without running
+    UniValue ret;
+    BOOST_CHECK(ret.read(JSONRPCExecBatch(jreq, batch, 1000)));
+    BOOST_CHECK_EQUAL(ret.size(), 51U);
+    BOOST_CHECK(find_value(ret[0].get_obj(), "error").isNull());
+    BOOST_CHECK_EQUAL(find_value(find_value(ret[49].get_obj(), "error").get_obj(), "code").get_int(), (int)RPC_OUT_OF_MEMORY);
+    BOOST_CHECK_EQUAL(find_value(ret[49].get_obj(), "id").get_int(), 49);
+}
+
+
+static void WriteStreamTestValue(JSONStreamWriter& writer)
+{
+    writer.BeginObject();
+    writer.KeyValue("a", 1);
+    writer.Key("empty");
+    writer.BeginArray();
+    writer.EndArray();
+    writer.Key("list");
+    writer.BeginArray();
+    for (int i = 0; i < 100; i++) {
+        writer.BeginObject();
+        writer.KeyValue("n", i);
+        writer.KeyValue("quoted \"key\"", std::string("value\n") + std::to_string(i));
+        writer.EndObject();
+    }
+    writer.Value(NullUniValue);
+    writer.Value(1.5);
+    writer.EndArray();
+    writer.KeyValue("obj", UniValue(UniValue::VOBJ));
+    writer.EndObject();
+}
+
+BOOST_AUTO_TEST_CASE(json_stream_writer)
+{
+    JSONStreamWriter tree;
+    WriteStreamTestValue(tree);
+    const UniValue& value = tree.GetValue();
+    BOOST_CHECK_EQUAL(value["list"].size(), 102U);
+    BOOST_CHECK_EQUAL(value["list"][7]["n"].get_int(), 7);
+    BOOST_CHECK_EQUAL(value["list"][7]["quoted \"key\""].get_str(), "value\n7");
+
+    // Text output matches UniValue::write, however it is chunked
+    for (size_t nChunkSize : {1, 50, 1000000}) {
+        std::vector<std::string> vChunks;
+        JSONStreamWriter text([&vChunks](const std::string& chunk) { vChunks.push_back(chunk); }, nChunkSize);
+        WriteStreamTestValue(text);
+        text.Flush();
+        BOOST_CHECK_EQUAL(boost::algorithm::join(vChunks, ""), value.write());
+        if (nChunkSize == 1000000)
+            BOOST_CHECK_EQUAL(vChunks.size(), 1U);
+        else
+            BOOST_CHECK(vChunks.size() > 10);
+    }
+
+    // Without a stream the result comes back as a UniValue
+    JSONRPCRequest request;
+    UniValue result = StreamRPCResult(request, WriteStreamTestValue);
+    BOOST_CHECK_EQUAL(result.write(), value.write());
+}
+
+/**
+ * Stands in for a client that has stopped reading: every chunk handed to it
+ * waits until another thread has tried to take cs_main and mempool.cs, as
+ * validation would meanwhile.
+ */
+class StalledResultStream : public RPCResultStream
+{
+public:
+    std::string strText;
+    int nChunks = 0;
+    int nBlocked = 0;
+    std::unique_ptr<JSONStreamWriter> writer;
+
+    JSONStreamWriter& Begin() override
+    {
+        writer.reset(new JSONStreamWriter([this](const std::string& chunk) {
+            strText += chunk;
+            nChunks++;
+            std::thread([this] {
+                TRY_LOCK(cs_main, lockMain);
+                TRY_LOCK(mempool.cs, lockMempool);
+                if (!lockMain || !lockMempool)
+                    nBlocked++;
+            }).join();
+        }, 16));
+        return *writer;
+    }
+};
+
+static void CheckStreamedWithoutLocks(const std::string& strMethod, const UniValue& params)
+{
+    JSONRPCRequest request;
+    request.strMethod = strMethod;
+    request.params = params;
+    UniValue expected = tableRPC[strMethod]->actor(request);
+
+    StalledResultStream stream;
+    request.stream = &stream;
+    BOOST_CHECK(tableRPC[strMethod]->actor(request).isNull());
+    stream.writer->Flush();
+    BOOST_CHECK_EQUAL(stream.strText, expected.write());
+    BOOST_CHECK(stream.nChunks > 1);
+    BOOST_CHECK_EQUAL(stream.nBlocked, 0);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_stream_without_locks)
+{
+    UniValue params(UniValue::VARR);
+    params.push_back(Params().GenesisBlock().GetHash().GetHex());
+    params.push_back(2);
+    CheckStreamedWithoutLocks("getblock", params);
+
+    TestMemPoolEntryHelper entry;
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 10 * COIN;
+    mempool.addUnchecked(tx.GetHash(), entry.FromTx(tx));
+    params.setArray();
+    params.push_back(UniValue(true));
+    CheckStreamedWithoutLocks("getrawmempool", params);
+    mempool.clear();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
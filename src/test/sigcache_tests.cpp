@@ -0,0 +1,100 @@
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <clientversion.h>
+#include <hash.h>
+#include <key.h>
+#include <policy/policy.h>
+#include <primitives/transaction.h>
+#include <script/sigcache.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+#include <util.h>
+#include <validation.h>
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(sigcache_tests, TestingSetup)
+
+static bool Contains(const std::vector<uint256>& v, const uint256& entry)
+{
+    return std::find(v.begin(), v.end(), entry) != v.end();
+}
+
+BOOST_AUTO_TEST_CASE(sigcache_persist)
+{
+    // Verify a signature so the cache holds an entry for it
+    CKey key;
+    key.MakeNewKey(true);
+    uint256 hash = InsecureRand256();
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.Sign(hash, vchSig));
+    CTransaction tx;
+    PrecomputedTransactionData txdata(tx);
+    CachingTransactionSignatureChecker checker(&tx, 0, 0, true, txdata);
+    BOOST_CHECK(checker.VerifySignature(vchSig, key.GetPubKey(), hash));
+
+    uint256 nonce;
+    std::vector<uint256> vEntries;
+    GetSignatureCacheEntries(nonce, vEntries);
+    BOOST_CHECK(!vEntries.empty());
+    BOOST_CHECK(DumpScriptCaches());
+
+    // A restarted node has another salt and none of the entries
+    InitSignatureCache();
+    RestoreSignatureCache(InsecureRand256(), std::vector<uint256>());
+    uint256 nonceAfter;
+    std::vector<uint256> vEntriesAfter;
+    GetSignatureCacheEntries(nonceAfter, vEntriesAfter);
+    BOOST_CHECK(nonceAfter != nonce);
+    BOOST_CHECK(vEntriesAfter.empty());
+
+    // Loading brings back the salt with the entries
+    BOOST_CHECK(LoadScriptCaches());
+    vEntriesAfter.clear();
+    GetSignatureCacheEntries(nonceAfter, vEntriesAfter);
+    BOOST_CHECK(nonceAfter == nonce);
+    for (const uint256& entry : vEntries)
+        BOOST_CHECK(Contains(vEntriesAfter, entry));
+
+    // A damaged file is ignored
+    fs::path path = GetDataDir() / "scriptcache.dat";
+    FILE* file = fsbridge::fopen(path, "rb+");
+    BOOST_CHECK(file != nullptr);
+    fseek(file, 20, SEEK_SET);
+    int c = fgetc(file);
+    fseek(file, 20, SEEK_SET);
+    fputc(c ^ 0xff, file);
+    fclose(file);
+    RestoreSignatureCache(InsecureRand256(), std::vector<uint256>());
+    BOOST_CHECK(!LoadScriptCaches());
+    GetSignatureCacheEntries(nonceAfter, vEntriesAfter);
+    BOOST_CHECK(nonceAfter != nonce);
+}
+
+BOOST_AUTO_TEST_CASE(sigcache_other_version)
+{
+    // An intact file written by another client version is discarded
+    uint256 nonce = InsecureRand256();
+    std::vector<uint256> vEntries(1, InsecureRand256());
+    uint64_t version = 2;
+    int clientVersion = CLIENT_VERSION - 1;
+    unsigned int flags = STANDARD_SCRIPT_VERIFY_FLAGS;
+    CAutoFile file(fsbridge::fopen(GetDataDir() / "scriptcache.dat", "wb"), SER_DISK, CLIENT_VERSION);
+    CHashWriter hasher(SER_DISK, CLIENT_VERSION);
+    file << version << clientVersion << flags << nonce << vEntries << nonce << vEntries;
+    hasher << version << clientVersion << flags << nonce << vEntries << nonce << vEntries;
+    file << hasher.GetHash();
+    file.fclose();
+
+    BOOST_CHECK(!LoadScriptCaches());
+    uint256 nonceAfter;
+    std::vector<uint256> vEntriesAfter;
+    GetSignatureCacheEntries(nonceAfter, vEntriesAfter);
+    BOOST_CHECK(nonceAfter != nonce);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
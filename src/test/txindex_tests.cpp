@@ -0,0 +1,141 @@
+// Copyright (c) 2018 The Bitcoin Core developers
+// Copyright (c) 2026 The Maza developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/txindex.h>
+#include <script/standard.h>
+#include <test/test_bitcoin.h>
+#include <txdb.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(txindex_tests)
+
+/** Wait for the index to catch up with the block index */
+static void WaitForSync(TxIndex& txindex)
+{
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!txindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+}
+
+/** Write the entries of the active chain to the block tree database, like older versions did */
+static void WriteLegacyTxIndex(CBlockTreeDB& blockTreeDB)
+{
+    CDBBatch batch(blockTreeDB);
+    LOCK(cs_main);
+    for (CBlockIndex* pindex = chainActive.Genesis(); pindex; pindex = chainActive.Next(pindex)) {
+        CBlock block;
+        BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+        CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
+        for (const CTransactionRef& tx : block.vtx) {
+            batch.Write(std::make_pair('t', tx->GetHash()), pos);
+            pos.nTxOffset += ::GetSerializeSize(*tx, SER_DISK, CLIENT_VERSION);
+        }
+    }
+    BOOST_REQUIRE(blockTreeDB.WriteBatch(batch));
+    BOOST_REQUIRE(blockTreeDB.WriteFlag("txindex", true));
+}
+
+/** Whether any legacy entries are left in the block tree database */
+static bool HasLegacyTxIndex(CBlockTreeDB& blockTreeDB)
+{
+    std::unique_ptr<CDBIterator> pcursor(blockTreeDB.NewIterator());
+    pcursor->Seek(std::make_pair('t', uint256()));
+    std::pair<char, uint256> key;
+    return pcursor->Valid() && pcursor->GetKey(key) && key.first == 't';
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
+{
+    TxIndex txindex(1 << 20, true);
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+
+    // Transaction should not be found in the index before it is started.
+    for (const auto& txn : coinbaseTxns) {
+        BOOST_CHECK(!txindex.FindTx(txn.GetHash(), block_hash, tx_disk));
+    }
+
+    // BlockUntilSyncedToCurrentChain should return false before txindex is started.
+    BOOST_CHECK(!txindex.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(txindex.Start());
+    WaitForSync(txindex);
+
+    // Check that txindex has all txs that were in the chain before it started.
+    for (const auto& txn : coinbaseTxns) {
+        BOOST_REQUIRE(txindex.FindTx(txn.GetHash(), block_hash, tx_disk));
+        BOOST_CHECK(tx_disk->GetHash() == txn.GetHash());
+    }
+
+    // Check that new transactions in new blocks make it into the index.
+    CScript scriptPubKey = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+    for (int i = 0; i < 10; i++) {
+        std::vector<CMutableTransaction> noTxns;
+        const CBlock block = CreateAndProcessBlock(noTxns, scriptPubKey);
+        const CTransaction& txn = *block.vtx[0];
+
+        BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+        BOOST_REQUIRE(txindex.FindTx(txn.GetHash(), block_hash, tx_disk));
+        BOOST_CHECK(tx_disk->GetHash() == txn.GetHash());
+        BOOST_CHECK(block_hash == block.GetHash());
+    }
+
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_migrate_legacy, TestChain100Setup)
+{
+    WriteLegacyTxIndex(*pblocktree);
+    BOOST_CHECK(HasLegacyTxIndex(*pblocktree));
+
+    TxIndex txindex(1 << 20, true);
+    BOOST_REQUIRE(txindex.Start());
+    WaitForSync(txindex);
+
+    // The entries moved over and the old index is gone
+    bool fLegacyIndex = true;
+    BOOST_CHECK(pblocktree->ReadFlag("txindex", fLegacyIndex) && !fLegacyIndex);
+    BOOST_CHECK(!HasLegacyTxIndex(*pblocktree));
+
+    // The migrated index covers the chain without a sync
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    BOOST_CHECK(txindex.GetBestBlockIndex() == chainActive.Tip());
+    for (const auto& txn : coinbaseTxns) {
+        BOOST_REQUIRE(txindex.FindTx(txn.GetHash(), block_hash, tx_disk));
+        BOOST_CHECK(tx_disk->GetHash() == txn.GetHash());
+    }
+
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_erase_legacy, TestChain100Setup)
+{
+    WriteLegacyTxIndex(*pblocktree);
+
+    BOOST_CHECK(EraseLegacyTxIndex(*pblocktree));
+    bool fLegacyIndex = true;
+    BOOST_CHECK(pblocktree->ReadFlag("txindex", fLegacyIndex) && !fLegacyIndex);
+    BOOST_CHECK(!HasLegacyTxIndex(*pblocktree));
+
+    // Nothing is left for a later TxIndex to take over
+    TxIndex txindex(1 << 20, true);
+    BOOST_REQUIRE(txindex.Start());
+    WaitForSync(txindex);
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    BOOST_CHECK(txindex.FindTx(coinbaseTxns[0].GetHash(), block_hash, tx_disk));
+    txindex.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
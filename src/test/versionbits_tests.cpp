@@ -9,6 +9,8 @@
 #include <validation.h>
 #include <consensus/params.h>
 
+#include <memory>
+
 #include <boost/test/unit_test.hpp>
 
 /* Define a virtual block time, one block per 10 minutes after Nov 14 2014, 0:55:36am */
@@ -350,5 +352,63 @@ BOOST_AUTO_TEST_CASE(versionbits_computeblockversion)
     //BOOST_CHECK_EQUAL(ComputeBlockVersion(lastBlock, mainnetParams) & VERSIONBITS_TOP_MASK, VERSIONBITS_TOP_BITS);
 }
 
+BOOST_AUTO_TEST_CASE(versionbits_activation_cache)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const Consensus::Params &mainnetParams = chainParams->GetConsensus();
+    const Consensus::DeploymentPos pos = Consensus::DEPLOYMENT_TESTDUMMY;
+    const int nPeriod = mainnetParams.nMinerConfirmationWindow;
+    const int32_t nSignal = VERSIONBITS_TOP_BITS | (1 << mainnetParams.vDeployments[pos].bit);
+    const int32_t nTime = mainnetParams.vDeployments[pos].nStartTime;
+
+    // Started after the first period, locked in after the second, active
+    // from the start of the fourth. A fork branches off in the third.
+    std::vector<std::unique_ptr<CBlockIndex>> vChain, vFork;
+    auto mine = [nTime](std::vector<std::unique_ptr<CBlockIndex>>& vBlocks, CBlockIndex* pindexPrev, int nBlocks, int32_t nVersion) {
+        for (int i = 0; i < nBlocks; i++) {
+            CBlockIndex* pindex = new CBlockIndex();
+            pindex->pprev = vBlocks.empty() ? pindexPrev : vBlocks.back().get();
+            pindex->nHeight = pindex->pprev ? pindex->pprev->nHeight + 1 : 0;
+            pindex->nTime = nTime;
+            pindex->nVersion = nVersion;
+            pindex->BuildSkip();
+            vBlocks.emplace_back(pindex);
+        }
+    };
+    mine(vChain, nullptr, nPeriod, VERSIONBITS_LAST_OLD_BLOCK_VERSION);
+    mine(vChain, nullptr, nPeriod, nSignal);
+    mine(vChain, nullptr, nPeriod * 2, VERSIONBITS_LAST_OLD_BLOCK_VERSION);
+    mine(vFork, vChain[nPeriod * 2 + 10].get(), nPeriod * 2, VERSIONBITS_LAST_OLD_BLOCK_VERSION);
+
+    VersionBitsCache cache;
+    VersionBitsActivationCache activation;
+    bool fActive = false;
+    BOOST_CHECK(!activation.GetActive(vChain.back().get(), mainnetParams, pos, fActive));
+
+    // Nothing is cached before activation
+    activation.UpdateTip(vChain[nPeriod * 3 - 2].get(), mainnetParams, cache);
+    BOOST_CHECK(!activation.GetActive(vChain[nPeriod * 3 - 2].get(), mainnetParams, pos, fActive));
+
+    // The cache agrees with VersionBitsState along the best chain, and leaves
+    // the fork to it
+    activation.UpdateTip(vChain.back().get(), mainnetParams, cache);
+    for (int i = 0; i < (int)vChain.size(); i += 97) {
+        BOOST_CHECK(activation.GetActive(vChain[i].get(), mainnetParams, pos, fActive));
+        BOOST_CHECK_EQUAL(fActive, VersionBitsState(vChain[i].get(), mainnetParams, pos, cache) == THRESHOLD_ACTIVE);
+    }
+    BOOST_CHECK(activation.GetActive(vChain[nPeriod * 3 - 2].get(), mainnetParams, pos, fActive) && !fActive);
+    BOOST_CHECK(activation.GetActive(vChain[nPeriod * 3 - 1].get(), mainnetParams, pos, fActive) && fActive);
+    BOOST_CHECK(!activation.GetActive(vFork.back().get(), mainnetParams, pos, fActive));
+    BOOST_CHECK(!activation.GetActive(nullptr, mainnetParams, pos, fActive));
+
+    // Reorganising past the activation point forgets it
+    activation.UpdateTip(vFork.back().get(), mainnetParams, cache);
+    BOOST_CHECK(!activation.GetActive(vChain.back().get(), mainnetParams, pos, fActive));
+    BOOST_CHECK(VersionBitsState(vFork.back().get(), mainnetParams, pos, cache) == THRESHOLD_ACTIVE);
+    activation.UpdateTip(vChain.back().get(), mainnetParams, cache);
+    BOOST_CHECK(activation.GetActive(vChain.back().get(), mainnetParams, pos, fActive) && fActive);
+    activation.Clear();
+    BOOST_CHECK(!activation.GetActive(vChain.back().get(), mainnetParams, pos, fActive));
+}
 
 BOOST_AUTO_TEST_SUITE_END()
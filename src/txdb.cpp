@@ -14,15 +14,17 @@
 #include <ui_interface.h>
 #include <init.h>
 
+#include <atomic>
 #include <stdint.h>
+#include <thread>
 
 #include <boost/thread.hpp>
 
 static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
 static const char DB_BLOCK_FILES = 'f';
-static const char DB_TXINDEX = 't';
 static const char DB_BLOCK_INDEX = 'b';
+static const char DB_BLOCK_WORK = 'w';
 
 static const char DB_BEST_BLOCK = 'B';
 static const char DB_HEAD_BLOCKS = 'H';
@@ -54,7 +56,7 @@ struct CoinEntry {
 
 }
 
-CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true) 
+CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe, DBProfile profile) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, profile)
 {
 }
 
@@ -147,6 +149,32 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
+bool CCoinsViewDB::Compact(const std::function<bool()>& fnInterrupted)
+{
+    // Coin keys are spread evenly by the first byte of the txid. Chunks are
+    // small enough for fnInterrupted() to be honoured within seconds.
+    static const int COMPACT_CHUNKS = 256;
+    int64_t nStart = GetTimeMillis();
+    for (int i = 0; i < COMPACT_CHUNKS; i++) {
+        if (fnInterrupted())
+            return false;
+        uint256 begin, end;
+        *begin.begin() = i * 256 / COMPACT_CHUNKS;
+        if (i + 1 < COMPACT_CHUNKS)
+            *end.begin() = (i + 1) * 256 / COMPACT_CHUNKS;
+        else
+            memset(end.begin(), 0xff, end.size());
+        db.CompactRange(std::make_pair(DB_COIN, begin), std::make_pair(DB_COIN, end));
+        LogPrint(BCLog::LEVELDB, "Compacted chainstate range %d/%d\n", i + 1, COMPACT_CHUNKS);
+    }
+    if (fnInterrupted())
+        return false;
+    // Whatever is left (other records, coins on the range boundaries) is small
+    db.CompactFull();
+    LogPrintf("Compacted chainstate database in %dms\n", GetTimeMillis() - nStart);
+    return true;
+}
+
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
 }
 
@@ -232,21 +260,12 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
+        if ((*it)->nProofK)
+            batch.Write(std::make_pair(DB_BLOCK_WORK, (*it)->GetBlockHash()), CDiskBlockWork(*it));
     }
     return WriteBatch(batch, true);
 }
 
-bool CBlockTreeDB::ReadTxIndex(const uint256 &txid, CDiskTxPos &pos) {
-    return Read(std::make_pair(DB_TXINDEX, txid), pos);
-}
-
-bool CBlockTreeDB::WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> >&vect) {
-    CDBBatch batch(*this);
-    for (std::vector<std::pair<uint256,CDiskTxPos> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
-        batch.Write(std::make_pair(DB_TXINDEX, it->first), it->second);
-    return WriteBatch(batch);
-}
-
 bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
 }
@@ -265,44 +284,101 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // Entries are read in batches. While this thread links a batch into
+    // mapBlockIndex, helper threads check that every entry's header hashes
+    // to the key it is stored under.
+    const int nThreads = std::max(1, std::min(GetNumCores(), MAX_BLOCK_INDEX_LOAD_THREADS));
+    std::vector<std::pair<uint256, CDiskBlockIndex>> vBatch;
+    vBatch.reserve(BLOCK_INDEX_LOAD_BATCH);
+    std::vector<CBlockIndex*> vLoaded;
+    std::atomic<bool> fMismatch(false);
+
+    auto checkHashes = [&vBatch, &fMismatch](size_t nBegin, size_t nEnd) {
+        for (size_t i = nBegin; i < nEnd && !fMismatch; i++) {
+            if (vBatch[i].second.GetBlockHash() != vBatch[i].first)
+                fMismatch = true;
+        }
+    };
+
     // Load mapBlockIndex
+    bool fDone = false;
+    while (!fDone) {
+        boost::this_thread::interruption_point();
+        vBatch.clear();
+        while (vBatch.size() < BLOCK_INDEX_LOAD_BATCH) {
+            std::pair<char, uint256> key;
+            if (!pcursor->Valid() || !pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX) {
+                fDone = true;
+                break;
+            }
+            vBatch.emplace_back(key.second, CDiskBlockIndex());
+            if (!pcursor->GetValue(vBatch.back().second))
+                return error("%s: failed to read value", __func__);
+            pcursor->Next();
+        }
+
+        std::vector<std::thread> vCheckers;
+        size_t nSlice = (vBatch.size() + nThreads - 1) / nThreads;
+        for (int t = 1; t < nThreads && t * nSlice < vBatch.size(); t++) {
+            vCheckers.emplace_back(checkHashes, t * nSlice, std::min(vBatch.size(), (t + 1) * nSlice));
+        }
+
+        for (const std::pair<uint256, CDiskBlockIndex>& entry : vBatch) {
+            const CDiskBlockIndex& diskindex = entry.second;
+            // Construct block index object
+            CBlockIndex* pindexNew = insertBlockIndex(entry.first);
+            pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+            pindexNew->nHeight        = diskindex.nHeight;
+            pindexNew->nFile          = diskindex.nFile;
+            pindexNew->nDataPos       = diskindex.nDataPos;
+            pindexNew->nUndoPos       = diskindex.nUndoPos;
+            pindexNew->nVersion       = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime          = diskindex.nTime;
+            pindexNew->nBits          = diskindex.nBits;
+            pindexNew->nNonce         = diskindex.nNonce;
+            pindexNew->nStatus        = diskindex.nStatus;
+            pindexNew->nTx            = diskindex.nTx;
+            vLoaded.push_back(pindexNew);
+
+            // Maza: Disable PoW Sanity check while loading block index from disk.
+            // We use the sha256 hash for the block index for performance reasons, which is recorded for later use.
+            // CheckProofOfWork() uses the scrypt hash which is discarded after a block is accepted.
+            // While it is technically feasible to verify the PoW, doing so takes several minutes as it
+            // requires recomputing every PoW hash during every Maza startup.
+            // We opt instead to simply trust the data that is on your local disk.
+            //if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
+            //    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+        }
+
+        checkHashes(0, std::min(vBatch.size(), nSlice));
+        for (std::thread& checker : vCheckers)
+            checker.join();
+        if (fMismatch)
+            return error("%s: block index entry does not match its key", __func__);
+    }
+
+    // Chain work records are keyed by block hash like the entries themselves,
+    // so both come out of the database in the same order
+    pcursor->Seek(std::make_pair(DB_BLOCK_WORK, uint256()));
+    std::vector<CBlockIndex*>::const_iterator itLoaded = vLoaded.begin();
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
         std::pair<char, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-
-                // Maza: Disable PoW Sanity check while loading block index from disk.
-                // We use the sha256 hash for the block index for performance reasons, which is recorded for later use.
-                // CheckProofOfWork() uses the scrypt hash which is discarded after a block is accepted.
-                // While it is technically feasible to verify the PoW, doing so takes several minutes as it
-                // requires recomputing every PoW hash during every Maza startup.
-                // We opt instead to simply trust the data that is on your local disk.
-                //if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
-                //    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
-
-                pcursor->Next();
-            } else {
-                return error("%s: failed to read value", __func__);
-            }
-        } else {
+        if (!pcursor->GetKey(key) || key.first != DB_BLOCK_WORK)
             break;
+        while (itLoaded != vLoaded.end() && (*itLoaded)->GetBlockHash() < key.second)
+            itLoaded++;
+        if (itLoaded != vLoaded.end() && (*itLoaded)->GetBlockHash() == key.second) {
+            CDiskBlockWork work;
+            if (!pcursor->GetValue(work))
+                return error("%s: failed to read chain work", __func__);
+            if (work.nVersion == CDiskBlockWork::CURRENT_VERSION && work.nProofK != 0) {
+                (*itLoaded)->nChainWork = work.nChainWork;
+                (*itLoaded)->nProofK = work.nProofK;
+            }
         }
+        pcursor->Next();
     }
 
     return true;
@@ -5,7 +5,9 @@
 
 #include <validation.h>
 
+#include <addressindex.h>
 #include <arith_uint256.h>
+#include <blockcompression.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -14,8 +16,10 @@
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <cuckoocache.h>
 #include <hash.h>
+#include <index/txindex.h>
 #include <init.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
@@ -40,8 +44,10 @@
 #include <validationinterface.h>
 #include <warnings.h>
 
+#include <condition_variable>
 #include <future>
 #include <sstream>
+#include <thread>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -150,6 +156,8 @@ private:
 public:
     CChain chainActive;
     BlockMap mapBlockIndex;
+    /** Storage for the entries of mapBlockIndex */
+    CBlockIndexArena blockIndexArena;
     std::multimap<CBlockIndex*, CBlockIndex*> mapBlocksUnlinked;
     CBlockIndex *pindexBestInvalid = nullptr;
 
@@ -157,11 +165,11 @@ public:
 
     bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams, std::shared_ptr<const CBlock> pblock);
 
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex);
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true);
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock);
 
     // Block (dis)connection on a given view:
-    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view);
+    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, bool fUpdateIndexes = false);
     bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
                     CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false);
 
@@ -210,8 +218,10 @@ CConditionVariable cvBlockChange;
 int nScriptCheckThreads = 0;
 std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
-bool fTxIndex = false;
+bool fAddressIndex = false;
+bool fBlockCompression = DEFAULT_BLOCK_COMPRESSION;
 bool fHavePruned = false;
+bool fHaveCompressedBlocks = false;
 bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
@@ -1015,28 +1025,16 @@ bool GetTransaction(const uint256& hash, CTransactionRef& txOut, const Consensus
             return true;
         }
 
-        if (fTxIndex) {
-            CDiskTxPos postx;
-            if (pblocktree->ReadTxIndex(hash, postx)) {
-                CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-                if (file.IsNull())
-                    return error("%s: OpenBlockFile failed", __func__);
-                CBlockHeader header;
-                try {
-                    file >> header;
-                    fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
-                    file >> txOut;
-                } catch (const std::exception& e) {
-                    return error("%s: Deserialize or I/O error - %s", __func__, e.what());
-                }
-                hashBlock = header.GetHash();
-                if (txOut->GetHash() != hash)
-                    return error("%s: txid mismatch", __func__);
+        if (g_txindex) {
+            if (g_txindex->FindTx(hash, hashBlock, txOut)) {
                 return true;
             }
 
-            // transaction not found in index, nothing more can be done
-            return false;
+            // transaction not found in a synced index, nothing more can be done;
+            // while it is still being built, fall back to the slow lookup
+            if (g_txindex->IsSynced()) {
+                return false;
+            }
         }
 
         if (fAllowSlow) { // use coin database to locate block that contains transaction, and scan it
@@ -1068,7 +1066,24 @@ bool GetTransaction(const uint256& hash, CTransactionRef& txOut, const Consensus
 // CBlock and CBlockIndex
 //
 
-static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+/**
+ * Note that the block files hold compressed records, which versions without
+ * block compression can't read, before the first one is written. Requires
+ * cs_main.
+ */
+static void SetHaveCompressedBlocks()
+{
+    if (!fHaveCompressedBlocks) {
+        pblocktree->WriteFlag("blockcompression", true);
+        fHaveCompressedBlocks = true;
+    }
+}
+
+/**
+ * Write a block to the block file, compressed if vchCompressed holds its
+ * compressed encoding. The record header flags compressed records.
+ */
+static bool WriteBlockToDisk(const CBlock& block, const std::vector<unsigned char>& vchCompressed, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
 {
     // Open history file to append
     CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
@@ -1076,7 +1091,7 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
         return error("WriteBlockToDisk: OpenBlockFile failed");
 
     // Write index header
-    unsigned int nSize = GetSerializeSize(fileout, block);
+    unsigned int nSize = vchCompressed.empty() ? GetSerializeSize(fileout, block) : (vchCompressed.size() | DISK_RECORD_COMPRESSED);
     fileout << FLATDATA(messageStart) << nSize;
 
     // Write block
@@ -1084,23 +1099,55 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
     if (fileOutPos < 0)
         return error("WriteBlockToDisk: ftell failed");
     pos.nPos = (unsigned int)fileOutPos;
-    fileout << block;
+    if (vchCompressed.empty())
+        fileout << block;
+    else
+        fileout.write((const char*)vchCompressed.data(), vchCompressed.size());
 
     return true;
 }
 
+/** Open a block or undo file at the index header of the record starting at pos */
+static FILE* OpenRecordHeader(const CDiskBlockPos& pos, bool fUndo)
+{
+    if (pos.nPos < 8)
+        return nullptr;
+    CDiskBlockPos hpos = pos;
+    hpos.nPos -= 8;
+    return fUndo ? OpenUndoFile(hpos, true) : OpenBlockFile(hpos, true);
+}
+
+/** Read the payload of a compressed record, given the size field of its index header */
+static void ReadCompressedRecord(CAutoFile& filein, unsigned int nSize, std::vector<unsigned char>& vch)
+{
+    nSize &= ~DISK_RECORD_COMPRESSED;
+    if (nSize > MAX_SIZE)
+        throw std::ios_base::failure("Compressed record larger than maximum deserialization size");
+    vch.resize(nSize);
+    filein.read((char*)vch.data(), nSize);
+}
+
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams)
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+    // Open history file to read, at the index header telling whether the block is compressed
+    CAutoFile filein(OpenRecordHeader(pos, false), SER_DISK, CLIENT_VERSION);
     if (filein.IsNull())
         return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
 
     // Read block
     try {
-        filein >> block;
+        CMessageHeader::MessageStartChars blkStart;
+        unsigned int nSize;
+        filein >> FLATDATA(blkStart) >> nSize;
+        if (nSize & DISK_RECORD_COMPRESSED) {
+            std::vector<unsigned char> vch;
+            ReadCompressedRecord(filein, nSize, vch);
+            DecompressBlock(vch, GetBlockScriptDictionary(consensusParams), block);
+        } else {
+            filein >> block;
+        }
     }
     catch (const std::exception& e) {
         return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
@@ -1134,6 +1181,51 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    // The block is preceded by the index header written by WriteBlockToDisk
+    CAutoFile filein(OpenRecordHeader(pos, false), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    try {
+        CMessageHeader::MessageStartChars blkStart;
+        unsigned int nSize;
+        filein >> FLATDATA(blkStart) >> nSize;
+        if (memcmp(blkStart, messageStart, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block magic mismatch at %s", __func__, pos.ToString());
+        if (nSize & DISK_RECORD_COMPRESSED) {
+            // Compressed blocks have to be decoded to give the serialized block
+            std::vector<unsigned char> vch;
+            ReadCompressedRecord(filein, nSize, vch);
+            CBlock decoded;
+            DecompressBlock(vch, GetBlockScriptDictionary(Params().GetConsensus()), decoded);
+            block.clear();
+            CVectorWriter(SER_DISK, CLIENT_VERSION, block, 0, decoded);
+            return true;
+        }
+        if (nSize > MAX_SIZE)
+            return error("%s: Block data larger than maximum deserialization size at %s", __func__, pos.ToString());
+        block.resize(nSize);
+        filein.read((char*)block.data(), nSize);
+    } catch (const std::exception& e) {
+        return error("%s: Read from block file failed: %s at %s", __func__, e.what(), pos.ToString());
+    }
+
+    return true;
+}
+
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& messageStart)
+{
+    CDiskBlockPos blockPos;
+    {
+        LOCK(cs_main);
+        blockPos = pindex->GetBlockPos();
+    }
+
+    return ReadRawBlockFromDisk(block, blockPos, messageStart);
+}
+
 CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
 {
 	CAmount nMinSubsidy = 1 * COIN;
@@ -1458,7 +1550,11 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
 
 namespace {
 
-bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
+/**
+ * Write undo data to the undo file, in the compact format if vchCompressed
+ * holds its compact encoding. The checksum covers the bytes as written.
+ */
+bool UndoWriteToDisk(const CBlockUndo& blockundo, const std::vector<unsigned char>& vchCompressed, CDiskBlockPos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
 {
     // Open history file to append
     CAutoFile fileout(OpenUndoFile(pos), SER_DISK, CLIENT_VERSION);
@@ -1466,7 +1562,7 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
         return error("%s: OpenUndoFile failed", __func__);
 
     // Write index header
-    unsigned int nSize = GetSerializeSize(fileout, blockundo);
+    unsigned int nSize = vchCompressed.empty() ? GetSerializeSize(fileout, blockundo) : (vchCompressed.size() | DISK_RECORD_COMPRESSED);
     fileout << FLATDATA(messageStart) << nSize;
 
     // Write undo data
@@ -1474,26 +1570,33 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     if (fileOutPos < 0)
         return error("%s: ftell failed", __func__);
     pos.nPos = (unsigned int)fileOutPos;
-    fileout << blockundo;
 
     // calculate & write checksum
     CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
     hasher << hashBlock;
-    hasher << blockundo;
+    if (vchCompressed.empty()) {
+        fileout << blockundo;
+        hasher << blockundo;
+    } else {
+        fileout.write((const char*)vchCompressed.data(), vchCompressed.size());
+        hasher.write((const char*)vchCompressed.data(), vchCompressed.size());
+    }
     fileout << hasher.GetHash();
 
     return true;
 }
 
-static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
+} // namespace
+
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
 {
     CDiskBlockPos pos = pindex->GetUndoPos();
     if (pos.IsNull()) {
         return error("%s: no undo data available", __func__);
     }
 
-    // Open history file to read
-    CAutoFile filein(OpenUndoFile(pos, true), SER_DISK, CLIENT_VERSION);
+    // Open history file to read, at the index header telling whether the data is compact
+    CAutoFile filein(OpenRecordHeader(pos, true), SER_DISK, CLIENT_VERSION);
     if (filein.IsNull())
         return error("%s: OpenUndoFile failed", __func__);
 
@@ -1501,6 +1604,23 @@ static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
     uint256 hashChecksum;
     CHashVerifier<CAutoFile> verifier(&filein); // We need a CHashVerifier as reserializing may lose data
     try {
+        CMessageHeader::MessageStartChars undoStart;
+        unsigned int nSize;
+        filein >> FLATDATA(undoStart) >> nSize;
+        if (nSize & DISK_RECORD_COMPRESSED) {
+            std::vector<unsigned char> vch;
+            ReadCompressedRecord(filein, nSize, vch);
+            filein >> hashChecksum;
+
+            CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
+            hasher << pindex->pprev->GetBlockHash();
+            hasher.write((const char*)vch.data(), vch.size());
+            if (hashChecksum != hasher.GetHash())
+                return error("%s: Checksum mismatch", __func__);
+
+            DecompressBlockUndo(vch, pindex->nHeight, GetBlockScriptDictionary(Params().GetConsensus()), blockundo);
+            return true;
+        }
         verifier << pindex->pprev->GetBlockHash();
         verifier >> blockundo;
         filein >> hashChecksum;
@@ -1516,6 +1636,8 @@ static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
     return true;
 }
 
+namespace {
+
 /** Abort with a message */
 bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
 {
@@ -1571,8 +1693,10 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 }
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
- *  When FAILED is returned, view is left in an indeterminate state. */
-DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+ *  When FAILED is returned, view is left in an indeterminate state.
+ *  fUpdateIndexes also reverts the block in the address index; it is only set when
+ *  disconnecting the tip, as the index is always flushed ahead of the coins. */
+DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, bool fUpdateIndexes)
 {
     bool fClean = true;
 
@@ -1587,6 +1711,11 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
+    // The spent coins are moved out of blockUndo below
+    std::unique_ptr<CBlockUndo> pblockUndoIndex;
+    if (fUpdateIndexes && paddressindex)
+        pblockUndoIndex.reset(new CBlockUndo(blockUndo));
+
     // undo transactions in reverse order
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
@@ -1626,6 +1755,9 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
+    if (pblockUndoIndex)
+        paddressindex->DisconnectBlock(block, *pblockUndoIndex, pindex->nHeight);
+
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
@@ -1658,10 +1790,16 @@ static bool WriteUndoDataForBlock(const CBlockUndo& blockundo, CValidationState&
 {
     // Write undo information to disk
     if (pindex->GetUndoPos().IsNull()) {
+        // Undo data that can't be compressed is stored as is
+        std::vector<unsigned char> vchCompressed;
+        if (fBlockCompression && CompressBlockUndo(blockundo, pindex->nHeight, GetBlockScriptDictionary(chainparams.GetConsensus()), vchCompressed))
+            SetHaveCompressedBlocks();
+        unsigned int nUndoSize = vchCompressed.empty() ? ::GetSerializeSize(blockundo, SER_DISK, CLIENT_VERSION) : vchCompressed.size();
+
         CDiskBlockPos _pos;
-        if (!FindUndoPos(state, pindex->nFile, _pos, ::GetSerializeSize(blockundo, SER_DISK, CLIENT_VERSION) + 40))
+        if (!FindUndoPos(state, pindex->nFile, _pos, nUndoSize + 40))
             return error("ConnectBlock(): FindUndoPos failed");
-        if (!UndoWriteToDisk(blockundo, _pos, pindex->pprev->GetBlockHash(), chainparams.MessageStart()))
+        if (!UndoWriteToDisk(blockundo, vchCompressed, _pos, pindex->pprev->GetBlockHash(), chainparams.MessageStart()))
             return AbortNode(state, "Failed to write undo data");
 
         // update nUndoPos in block index
@@ -1673,26 +1811,6 @@ static bool WriteUndoDataForBlock(const CBlockUndo& blockundo, CValidationState&
     return true;
 }
 
-static bool WriteTxIndexDataForBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex)
-{
-    if (!fTxIndex) return true;
-
-    CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
-    std::vector<std::pair<uint256, CDiskTxPos> > vPos;
-    vPos.reserve(block.vtx.size());
-    for (const CTransactionRef& tx : block.vtx)
-    {
-        vPos.push_back(std::make_pair(tx->GetHash(), pos));
-        pos.nTxOffset += ::GetSerializeSize(*tx, SER_DISK, CLIENT_VERSION);
-    }
-
-    if (!pblocktree->WriteTxIndex(vPos)) {
-        return AbortNode(state, "Failed to write transaction index");
-    }
-
-    return true;
-}
-
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
 
 void ThreadScriptCheck() {
@@ -1702,6 +1820,8 @@ void ThreadScriptCheck() {
 
 // Protected by cs_main
 VersionBitsCache versionbitscache;
+// Maza: Written under cs_main, read without it
+static VersionBitsActivationCache versionbitsactivation;
 
 int32_t ComputeBlockVersion(const CBlockIndex* pindexPrev, const Consensus::Params& params)
 {
@@ -2034,8 +2154,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         setDirtyBlockIndex.insert(pindex);
     }
 
-    if (!WriteTxIndexDataForBlock(block, state, pindex))
-        return false;
+    if (paddressindex)
+        paddressindex->ConnectBlock(block, blockundo, pindex->nHeight);
 
     assert(pindex->phashBlock);
     // add this block to the view's block chain
@@ -2097,6 +2217,9 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
         }
         int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
         int64_t cacheSize = pcoinsTip->DynamicMemoryUsage();
+        // Pending address index changes are flushed along with the coins, so count them against the same limit
+        if (paddressindex)
+            cacheSize += paddressindex->DynamicMemoryUsage();
         int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
         // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
         bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
@@ -2147,6 +2270,10 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             // overwrite one. Still, use a conservative safety factor of 2.
             if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
+            // Flush the address index first: after a crash in between, the
+            // blocks replayed on top of the older chainstate rewrite the same entries.
+            if (paddressindex && !paddressindex->Flush())
+                return AbortNode(state, "Failed to write to address index database");
             // Flush the chainstate (which may refer to block index entries).
             if (!pcoinsTip->Flush())
                 return AbortNode(state, "Failed to write to coin database");
@@ -2191,6 +2318,7 @@ static void DoWarning(const std::string& strWarning)
 void static UpdateTip(const CBlockIndex *pindexNew, const CChainParams& chainParams) {
     // New best block
     mempool.AddTransactionsUpdated(1);
+    versionbitsactivation.UpdateTip(pindexNew, chainParams.GetConsensus(), versionbitscache);
 
     cvBlockChange.notify_all();
 
@@ -2217,11 +2345,11 @@ void static UpdateTip(const CBlockIndex *pindexNew, const CChainParams& chainPar
             int32_t nExpectedVersion = ComputeBlockVersion(pindex->pprev, chainParams.GetConsensus());
             // Maza: MinotaurX+Hive1.2: Mask out blocktype before checking for possible unknown upgrade
             if (IsMinotaurXEnabled(pindex, chainParams.GetConsensus())) {
-                if ((pindex->nVersion & 0xFF00FFFF) != nExpectedVersion && !pindex->GetBlockHeader().IsHiveMined(chainParams.GetConsensus()))
+                if ((pindex->nVersion & 0xFF00FFFF) != nExpectedVersion && !pindex->IsHiveMined(chainParams.GetConsensus()))
                     ++nUpgraded;
             } else {
                 // Maza: Hive: Don't warn about unexpected version in Hivemined blocks
-                if (pindex->nVersion > VERSIONBITS_LAST_OLD_BLOCK_VERSION && (pindex->nVersion & ~nExpectedVersion) != 0 && !pindex->GetBlockHeader().IsHiveMined(chainParams.GetConsensus()))
+                if (pindex->nVersion > VERSIONBITS_LAST_OLD_BLOCK_VERSION && (pindex->nVersion & ~nExpectedVersion) != 0 && !pindex->IsHiveMined(chainParams.GetConsensus()))
                     ++nUpgraded;
             }
             pindex = pindex->pprev;
@@ -2269,7 +2397,7 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
     {
         CCoinsViewCache view(pcoinsTip.get());
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
-        if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK)
+        if (DisconnectBlock(block, pindexDelete, view, true) != DISCONNECT_OK)
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
         bool flushed = view.Flush();
         assert(flushed);
@@ -2842,7 +2970,8 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         return it->second;
 
     // Construct new block index object
-    CBlockIndex* pindexNew = new CBlockIndex(block);
+    CBlockIndex* pindexNew = blockIndexArena.Allocate();
+    *pindexNew = CBlockIndex(block);
     // We assign the sequence id to blocks only when the full data is available,
     // to avoid miners withholding blocks but broadcasting headers, to get a
     // competitive advantage.
@@ -2856,7 +2985,9 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->nHeight = pindexNew->pprev->nHeight + 1;
         pindexNew->BuildSkip();
     }
+    pindexNew->BuildBlockType(Params().GetConsensus());
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
+    pindexNew->nProofK = GetBlockProofK(*pindexNew);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
     if (pindexBestHeader == nullptr || pindexBestHeader->nChainWork < pindexNew->nChainWork)
@@ -3015,23 +3146,9 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
     return true;
 }
 
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot)
+/** The checks of CheckBlock below the header and hive proof; they only look at the block itself */
+static bool CheckBlockContents(const CBlock& block, CValidationState& state, bool fCheckMerkleRoot)
 {
-    // These are checks that are independent of context.
-
-    if (block.fChecked)
-        return true;
-
-    // Check that the header is valid (particularly PoW).  This is mostly
-    // redundant with the call in AcceptBlockHeader.
-    if (!CheckBlockHeader(block, state, consensusParams, fCheckPOW))
-        return false;
-
-    // Maza: Hive: Check Hive proof
-    if (block.IsHiveMined(consensusParams))
-        if (!CheckHiveProof(&block, consensusParams))
-            return state.DoS(100, false, REJECT_INVALID, "bad-hive-proof", false, "proof of hive failed");
-
     // Check the merkle root.
     if (fCheckMerkleRoot) {
         bool mutated;
@@ -3077,6 +3194,29 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
     if (nSigOps * WITNESS_SCALE_FACTOR > MAX_BLOCK_SIGOPS_COST)
         return state.DoS(100, false, REJECT_INVALID, "bad-blk-sigops", false, "out-of-bounds SigOpCount");
 
+    return true;
+}
+
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot)
+{
+    // These are checks that are independent of context.
+
+    if (block.fChecked)
+        return true;
+
+    // Check that the header is valid (particularly PoW).  This is mostly
+    // redundant with the call in AcceptBlockHeader.
+    if (!CheckBlockHeader(block, state, consensusParams, fCheckPOW))
+        return false;
+
+    // Maza: Hive: Check Hive proof
+    if (block.IsHiveMined(consensusParams))
+        if (!CheckHiveProof(&block, consensusParams))
+            return state.DoS(100, false, REJECT_INVALID, "bad-hive-proof", false, "proof of hive failed");
+
+    if (!CheckBlockContents(block, state, fCheckMerkleRoot))
+        return false;
+
     if (fCheckPOW && fCheckMerkleRoot)
         block.fChecked = true;
 
@@ -3085,6 +3225,10 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
 
 bool IsWitnessEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& params)
 {
+    bool fActive;
+    if (versionbitsactivation.GetActive(pindexPrev, params, Consensus::DEPLOYMENT_SEGWIT, fActive))
+        return fActive;
+
     LOCK(cs_main);
     return (VersionBitsState(pindexPrev, params, Consensus::DEPLOYMENT_SEGWIT, versionbitscache) == THRESHOLD_ACTIVE);
 }
@@ -3096,6 +3240,14 @@ bool IsWitnessEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& pa
 // Maza: MinotaurX+Hive1.2: Check if MinotaurX is activated at given point
 bool IsMinotaurXEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& params)
 {
+    // Entries in the block index are flagged once MinotaurX is enabled after them
+    if (pindexPrev && (pindexPrev->nBlockType & BLOCK_TYPE_MINOTAURX))
+        return true;
+
+    bool fActive;
+    if (versionbitsactivation.GetActive(pindexPrev, params, Consensus::DEPLOYMENT_MINOTAURX, fActive))
+        return fActive;
+
     LOCK(cs_main);
     return (VersionBitsState(pindexPrev, params, Consensus::DEPLOYMENT_MINOTAURX, versionbitscache) == THRESHOLD_ACTIVE);
 }
@@ -3381,7 +3533,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3400,7 +3552,7 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPOW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3463,7 +3615,13 @@ bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidatio
 
 /** Store block on disk. If dbp is non-nullptr, the file is known to already reside on disk */
 static CDiskBlockPos SaveBlockToDisk(const CBlock& block, int nHeight, const CChainParams& chainparams, const CDiskBlockPos* dbp) {
-    unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+    // A block that can't be compressed is stored as is. Blocks already on
+    // disk (reindex) are accounted at their uncompressed size, which is at
+    // least the size of their record.
+    std::vector<unsigned char> vchCompressed;
+    if (fBlockCompression && dbp == nullptr && CompressBlock(block, GetBlockScriptDictionary(chainparams.GetConsensus()), vchCompressed))
+        SetHaveCompressedBlocks();
+    unsigned int nBlockSize = vchCompressed.empty() ? ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION) : vchCompressed.size();
     CDiskBlockPos blockPos;
     if (dbp != nullptr)
         blockPos = *dbp;
@@ -3472,7 +3630,7 @@ static CDiskBlockPos SaveBlockToDisk(const CBlock& block, int nHeight, const CCh
         return CDiskBlockPos();
     }
     if (dbp == nullptr) {
-        if (!WriteBlockToDisk(block, blockPos, chainparams.MessageStart())) {
+        if (!WriteBlockToDisk(block, vchCompressed, blockPos, chainparams.MessageStart())) {
             AbortNode("Failed to write block");
             return CDiskBlockPos();
         }
@@ -3491,7 +3649,9 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
     CBlockIndex *pindexDummy = nullptr;
     CBlockIndex *&pindex = ppindex ? *ppindex : pindexDummy;
 
-    if (!AcceptBlockHeader(block, state, chainparams, &pindex))
+    // A block that passed CheckBlock already had its proof of work checked,
+    // which is the expensive part for MinotaurX blocks
+    if (!AcceptBlockHeader(block, state, chainparams, &pindex, !block.fChecked))
         return false;
 
     // Try to process all requested blocks that we don't have, but only
@@ -3830,7 +3990,7 @@ CBlockIndex * CChainState::InsertBlockIndex(const uint256& hash)
         return (*mi).second;
 
     // Create new
-    CBlockIndex* pindexNew = new CBlockIndex();
+    CBlockIndex* pindexNew = blockIndexArena.Allocate();
     mi = mapBlockIndex.insert(std::make_pair(hash, pindexNew)).first;
     pindexNew->phashBlock = &((*mi).first);
 
@@ -3839,8 +3999,10 @@ CBlockIndex * CChainState::InsertBlockIndex(const uint256& hash)
 
 bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlockTreeDB& blocktree)
 {
+    int64_t nStart = GetTimeMillis();
     if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash){ return this->InsertBlockIndex(hash); }))
         return false;
+    int64_t nLoaded = GetTimeMillis();
 
     boost::this_thread::interruption_point();
 
@@ -3853,10 +4015,26 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
         vSortedByHeight.push_back(std::make_pair(pindex->nHeight, pindex));
     }
     sort(vSortedByHeight.begin(), vSortedByHeight.end());
+    unsigned int nComputed = 0;
     for (const std::pair<int, CBlockIndex*>& item : vSortedByHeight)
     {
         CBlockIndex* pindex = item.second;
-        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
+        pindex->BuildBlockType(consensus_params);
+        // Maza: Hive 1.1: Chain work and the bonus factor are kept in the block
+        // tree DB. Compute them for entries written by older versions, and
+        // check the stored values with -checkblockindex.
+        if (pindex->nProofK == 0 || fCheckBlockIndex) {
+            const arith_uint256 nStoredWork = pindex->nChainWork;
+            const unsigned int nStoredK = pindex->nProofK;
+            pindex->nProofK = GetBlockProofK(*pindex);
+            pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
+            if (nStoredK != 0 && (nStoredK != pindex->nProofK || nStoredWork != pindex->nChainWork))
+                LogPrintf("%s: stored chain work of block %s does not match, replacing it\n", __func__, pindex->GetBlockHash().ToString());
+            if (nStoredK != pindex->nProofK || nStoredWork != pindex->nChainWork) {
+                setDirtyBlockIndex.insert(pindex);
+                nComputed++;
+            }
+        }
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
         // We can link the chain of blocks for which we've received transactions at some point.
         // Pruned nodes may have deleted the block.
@@ -3886,6 +4064,9 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
             pindexBestHeader = pindex;
     }
 
+    LogPrintf("%s: %u entries read in %dms and linked in %dms, chain work computed for %u of them\n", __func__,
+        mapBlockIndex.size(), nLoaded - nStart, GetTimeMillis() - nLoaded, nComputed);
+
     return true;
 }
 
@@ -3934,14 +4115,19 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     if (fHavePruned)
         LogPrintf("LoadBlockIndexDB(): Block files have previously been pruned\n");
 
+    // Check whether we have ever written compressed records
+    pblocktree->ReadFlag("blockcompression", fHaveCompressedBlocks);
+    if (fHaveCompressedBlocks)
+        LogPrintf("LoadBlockIndexDB(): Block files hold compressed records\n");
+
     // Check whether we need to continue reindexing
     bool fReindexing = false;
     pblocktree->ReadReindexing(fReindexing);
     if(fReindexing) fReindex = true;
 
-    // Check whether we have a transaction index
-    pblocktree->ReadFlag("txindex", fTxIndex);
-    LogPrintf("%s: transaction index %s\n", __func__, fTxIndex ? "enabled" : "disabled");
+    // Check whether we have an address index
+    pblocktree->ReadFlag("addressindex", fAddressIndex);
+    LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
 
     return true;
 }
@@ -3965,6 +4151,7 @@ bool LoadChainTip(const CChainParams& chainparams)
     if (it == mapBlockIndex.end())
         return false;
     chainActive.SetTip(it->second);
+    versionbitsactivation.UpdateTip(chainActive.Tip(), chainparams.GetConsensus(), versionbitscache);
 
     g_chainstate.PruneBlockIndexCandidates();
 
@@ -4295,15 +4482,19 @@ void UnloadBlockIndex()
     setDirtyBlockIndex.clear();
     setDirtyFileInfo.clear();
     versionbitscache.Clear();
+    versionbitsactivation.Clear();
     for (int b = 0; b < VERSIONBITS_NUM_BITS; b++) {
         warningcache[b].clear();
     }
 
     for (BlockMap::value_type& entry : mapBlockIndex) {
-        delete entry.second;
+        if (!g_chainstate.blockIndexArena.Owns(entry.second))
+            delete entry.second;
     }
     mapBlockIndex.clear();
+    g_chainstate.blockIndexArena.Clear();
     fHavePruned = false;
+    fHaveCompressedBlocks = false;
 
     g_chainstate.UnloadBlockIndex();
 }
@@ -4326,9 +4517,9 @@ bool LoadBlockIndex(const CChainParams& chainparams)
         // needs_init.
 
         LogPrintf("Initializing databases...\n");
-        // Use the provided setting for -txindex in the new database
-        fTxIndex = gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX);
-        pblocktree->WriteFlag("txindex", fTxIndex);
+        // Use the provided setting for -addressindex in the new database
+        fAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
+        pblocktree->WriteFlag("addressindex", fAddressIndex);
     }
     return true;
 }
@@ -4365,52 +4556,363 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     return g_chainstate.LoadGenesisBlock(chainparams);
 }
 
-bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
+namespace {
+
+/**
+ * Pipeline behind LoadExternalBlockFile. A scanner thread locates block
+ * records in the file and reads their bytes, a pool of check threads
+ * deserialises them and runs the checks that need no chain context
+ * (proof of work, merkle root and the rest of CheckBlock), and the
+ * importing thread takes the blocks back in file order to accept them.
+ *
+ * Hive blocks can only be fully checked against the chain, so for them the
+ * check threads stop short of the hive proof and the importing thread
+ * finishes the job with CheckHiveProof.
+ *
+ * A record that fails to deserialise may have hidden the headers of the
+ * records after it, so like the serial scan the importing thread has the
+ * scanner search again from just past its header, dropping whatever was
+ * read ahead since.
+ */
+class CBlockImportPipeline
 {
-    // Map of disk positions for blocks with unknown parent (only used for reindex)
-    static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
-    int64_t nStart = GetTimeMillis();
+public:
+    struct Record {
+        unsigned int nPos;
+        uint64_t nRescanPos;
+        bool fCompressed;
+        uint64_t nGeneration;
+        std::vector<unsigned char> vch;
+        size_t nUsage;
+        std::shared_ptr<CBlock> pblock;
+        bool fContentsChecked = false;
+        std::string strError;
+    };
 
-    int nLoaded = 0;
-    try {
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE+8, SER_DISK, CLIENT_VERSION);
-        uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
+    CBlockImportPipeline(const CChainParams& chainparamsIn, FILE* fileIn, int nThreads) :
+        chainparams(chainparamsIn), vDictionary(GetBlockScriptDictionary(chainparamsIn.GetConsensus())),
+        blkdat(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE+8, SER_DISK, CLIENT_VERSION)
+    {
+        nCheckThreads = nThreads;
+        threadScan = std::thread(&CBlockImportPipeline::ThreadScan, this);
+        for (int i = 0; i < nThreads; i++)
+            vThreadCheck.emplace_back(&CBlockImportPipeline::ThreadCheck, this);
+    }
+
+    ~CBlockImportPipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            fStop = true;
+        }
+        cvScan.notify_all();
+        cvCheck.notify_all();
+        threadScan.join();
+        for (std::thread& thread : vThreadCheck)
+            thread.join();
+    }
+
+    /** Wait for the next record in file order. Returns false once the file is exhausted */
+    bool Next(std::unique_ptr<Record>& record)
+    {
+        int64_t nWaitStart = GetTimeMicros();
+        std::unique_lock<std::mutex> lock(cs);
+        while (true) {
+            auto it = mapChecked.find(nNextSeq);
+            if (it != mapChecked.end()) {
+                record = std::move(it->second);
+                mapChecked.erase(it);
+                nNextSeq++;
+                nBytesInFlight -= record->nUsage;
+                nWaitMicros += GetTimeMicros() - nWaitStart;
+                cvScan.notify_one();
+                return true;
+            }
+            if (fScanDone && nNextSeq == nScanned)
+                return false;
+            cvAccept.wait_for(lock, std::chrono::milliseconds(100));
+            lock.unlock();
             boost::this_thread::interruption_point();
+            lock.lock();
+        }
+    }
+
+    /**
+     * Drop every record after the given one and scan again from just past its
+     * header, for a record that turned out not to hold a block
+     */
+    void Rewind(const Record& record)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            if (!strFatalError.empty())
+                return;
+            nGeneration++;
+            for (const auto& item : queueCheck)
+                nBytesInFlight -= item.second->nUsage;
+            queueCheck.clear();
+            for (const auto& item : mapChecked)
+                nBytesInFlight -= item.second->nUsage;
+            mapChecked.clear();
+            nScanned = nNextSeq;
+            nRewindPos = record.nRescanPos;
+            fRewind = true;
+            fScanDone = false;
+        }
+        cvScan.notify_one();
+    }
+
+    /** Set if the scanner hit an error the import should abort the node for */
+    std::string GetFatalError()
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        return strFatalError;
+    }
+
+    /** Log the throughput of each stage, given how long the importing thread took overall */
+    void LogStats(int64_t nImportMicros, unsigned int nAccepted)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (nScanned == 0)
+            return;
+        int64_t nAcceptMicros = nImportMicros - nWaitMicros;
+        LogPrintf("Import pipeline: scanned %u records (%.1fMB) at %.1fMB/s, checked at %.1f blocks/s on %d threads, accepted %u at %.1f blocks/s, waited %dms for checks\n",
+            nScanned, nBytesScanned / 1048576.0, nBytesScanned / 1048576.0 / std::max<double>(nScanMicros * 0.000001, 0.000001),
+            nScanned * nCheckThreads / std::max<double>(nCheckMicros * 0.000001, 0.000001), nCheckThreads,
+            nAccepted, nScanned / std::max<double>(nAcceptMicros * 0.000001, 0.000001), nWaitMicros / 1000);
+    }
+
+private:
+    /** Cap on the memory used by records read ahead of the importing thread */
+    static const size_t MAX_BYTES_IN_FLIGHT = 64 << 20;
+
+    const CChainParams& chainparams;
+    const std::vector<CScript>& vDictionary;
+    CBufferedFile blkdat;
+    int nCheckThreads;
+
+    std::thread threadScan;
+    std::vector<std::thread> vThreadCheck;
+
+    std::mutex cs;
+    std::condition_variable cvScan;
+    std::condition_variable cvCheck;
+    std::condition_variable cvAccept;
+    bool fStop = false;
+    bool fScanDone = false;
+    bool fRewind = false;
+    uint64_t nRewindPos = 0;
+    uint64_t nGeneration = 0;
+    std::string strFatalError;
+    std::deque<std::pair<uint64_t, std::unique_ptr<Record>>> queueCheck;
+    std::map<uint64_t, std::unique_ptr<Record>> mapChecked;
+    uint64_t nScanned = 0;
+    uint64_t nNextSeq = 0;
+    size_t nBytesInFlight = 0;
+
+    // Per stage statistics: busy time of the scanner and the check threads, and
+    // the time the importing thread spent waiting for them
+    uint64_t nBytesScanned = 0;
+    int64_t nScanMicros = 0;
+    int64_t nCheckMicros = 0;
+    int64_t nWaitMicros = 0;
+
+    void ThreadScan()
+    {
+        RenameThread("maza-loadscan");
+        try {
+            ScanRecords();
+        } catch (const std::runtime_error& e) {
+            std::lock_guard<std::mutex> lock(cs);
+            strFatalError = e.what();
+            fScanDone = true;
+        }
+        cvAccept.notify_all();
+    }
+
+    /** Record that the file is exhausted, unless a rewind made the scan stale */
+    void SetScanDone(uint64_t nScanGeneration)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            if (nScanGeneration != nGeneration)
+                return;
+            fScanDone = true;
+        }
+        cvAccept.notify_all();
+    }
+
+    void ScanRecords()
+    {
+        uint64_t nRewind = blkdat.GetPos();
+        uint64_t nScanGeneration = 0;
+        while (true) {
+            bool fSeek = false;
+            {
+                // Once the file is exhausted, stay around in case the importing
+                // thread asks for a rescan
+                std::unique_lock<std::mutex> lock(cs);
+                while (!fStop && !fRewind && (fScanDone || nBytesInFlight > MAX_BYTES_IN_FLIGHT))
+                    cvScan.wait(lock);
+                if (fStop)
+                    return;
+                if (fRewind) {
+                    fRewind = false;
+                    fSeek = true;
+                    nRewind = nRewindPos;
+                    nScanGeneration = nGeneration;
+                }
+            }
+            // The position may be further back than the buffer reaches
+            if (fSeek && !blkdat.Seek(nRewind))
+                throw std::runtime_error("LoadExternalBlockFile: seek failed");
+            if (blkdat.eof()) {
+                SetScanDone(nScanGeneration);
+                continue;
+            }
+            int64_t nStart = GetTimeMicros();
 
             blkdat.SetPos(nRewind);
             nRewind++; // start one byte further next time, in case of failure
             blkdat.SetLimit(); // remove former limit
             unsigned int nSize = 0;
+            bool fCompressed = false;
+            uint64_t nRescanPos = 0;
             try {
                 // locate a header
                 unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
                 blkdat.FindByte(chainparams.MessageStart()[0]);
                 nRewind = blkdat.GetPos()+1;
+                nRescanPos = nRewind;
                 blkdat >> FLATDATA(buf);
                 if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
                     continue;
                 // read size
                 blkdat >> nSize;
+                fCompressed = nSize & DISK_RECORD_COMPRESSED;
+                nSize &= ~DISK_RECORD_COMPRESSED;
                 if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
                     continue;
             } catch (const std::exception&) {
                 // no valid block header found; don't complain
-                break;
+                SetScanDone(nScanGeneration);
+                continue;
             }
+            std::unique_ptr<Record> record(new Record());
             try {
-                // read block
                 uint64_t nBlockPos = blkdat.GetPos();
-                if (dbp)
-                    dbp->nPos = nBlockPos;
+                record->nPos = nBlockPos;
+                record->nRescanPos = nRescanPos;
+                record->fCompressed = fCompressed;
+                record->vch.resize(nSize);
+                record->nUsage = nSize;
                 blkdat.SetLimit(nBlockPos + nSize);
                 blkdat.SetPos(nBlockPos);
-                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-                CBlock& block = *pblock;
-                blkdat >> block;
+                blkdat.read((char*)record->vch.data(), nSize);
                 nRewind = blkdat.GetPos();
+            } catch (const std::exception& e) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", "LoadExternalBlockFile", e.what());
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(cs);
+                nScanMicros += GetTimeMicros() - nStart;
+                nBytesScanned += nSize;
+                if (nScanGeneration != nGeneration)
+                    continue;
+                record->nGeneration = nScanGeneration;
+                nBytesInFlight += nSize;
+                queueCheck.emplace_back(nScanned++, std::move(record));
+            }
+            cvCheck.notify_one();
+        }
+    }
+
+    void ThreadCheck()
+    {
+        RenameThread("maza-loadchk");
+        const Consensus::Params& consensusParams = chainparams.GetConsensus();
+        while (true) {
+            std::pair<uint64_t, std::unique_ptr<Record>> item;
+            {
+                std::unique_lock<std::mutex> lock(cs);
+                while (!fStop && queueCheck.empty())
+                    cvCheck.wait(lock);
+                if (fStop)
+                    return;
+                item = std::move(queueCheck.front());
+                queueCheck.pop_front();
+            }
+            int64_t nStart = GetTimeMicros();
+
+            Record& record = *item.second;
+            record.pblock = std::make_shared<CBlock>();
+            CBlock& block = *record.pblock;
+            try {
+                if (record.fCompressed)
+                    DecompressBlock(record.vch, vDictionary, block);
+                else
+                    CVectorReader(SER_DISK, CLIENT_VERSION, record.vch, 0) >> block;
+                // A block that passes CheckBlock here is marked checked, so its
+                // proof of work and merkle root are not computed again when it
+                // is accepted
+                CValidationState state;
+                if (block.IsHiveMined(consensusParams))
+                    record.fContentsChecked = CheckBlockContents(block, state, true);
+                else
+                    CheckBlock(block, state, consensusParams);
+            } catch (const std::exception& e) {
+                record.pblock.reset();
+                record.strError = e.what();
+            }
+            // The raw bytes are no longer needed once decoded; what stays in
+            // flight is the decoded block
+            size_t nRawSize = record.nUsage;
+            record.vch.clear();
+            record.vch.shrink_to_fit();
+            size_t nUsage = record.pblock ? RecursiveDynamicUsage(*record.pblock) : 0;
+
+            {
+                std::lock_guard<std::mutex> lock(cs);
+                nCheckMicros += GetTimeMicros() - nStart;
+                // Records read before a rewind are dropped
+                nBytesInFlight -= nRawSize;
+                if (record.nGeneration != nGeneration)
+                    continue;
+                record.nUsage = nUsage;
+                nBytesInFlight += nUsage;
+                mapChecked.emplace(item.first, std::move(item.second));
+            }
+            cvAccept.notify_one();
+        }
+    }
+};
+
+} // namespace
 
+bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
+{
+    // Map of disk positions for blocks with unknown parent (only used for reindex)
+    static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
+    int64_t nStart = GetTimeMillis();
+
+    int nLoaded = 0;
+    {
+        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
+        CBlockImportPipeline pipeline(chainparams, fileIn, std::max(nScriptCheckThreads, 1));
+        std::unique_ptr<CBlockImportPipeline::Record> record;
+        while (pipeline.Next(record)) {
+            if (!record->pblock) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, record->strError);
+                pipeline.Rewind(*record);
+                continue;
+            }
+            if (dbp)
+                dbp->nPos = record->nPos;
+            std::shared_ptr<CBlock> pblock = record->pblock;
+            CBlock& block = *pblock;
+            try {
                 // detect out of order blocks, and store them for later
                 uint256 hash = block.GetHash();
                 if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
@@ -4424,6 +4926,12 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                 // process in case the block isn't known yet
                 if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
                     LOCK(cs_main);
+                    // Maza: Hive: Finish the checks of a hive block now that its parent is known
+                    if (record->fContentsChecked && CheckHiveProof(&block, chainparams.GetConsensus()))
+                        block.fChecked = true;
+                    // Records found on disk while reindexing stay as they are
+                    if (record->fCompressed && dbp)
+                        SetHaveCompressedBlocks();
                     CValidationState state;
                     if (g_chainstate.AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr))
                         nLoaded++;
@@ -4474,8 +4982,11 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                 LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
             }
         }
-    } catch (const std::runtime_error& e) {
-        AbortNode(std::string("System error: ") + e.what());
+
+        std::string strFatalError = pipeline.GetFatalError();
+        if (!strFatalError.empty())
+            AbortNode(std::string("System error: ") + strFatalError);
+        pipeline.LogStats((GetTimeMillis() - nStart) * 1000, nLoaded);
     }
     if (nLoaded > 0)
         LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, GetTimeMillis() - nStart);
@@ -4823,6 +5334,98 @@ bool DumpMempool(void)
     return true;
 }
 
+static const uint64_t SCRIPT_CACHE_DUMP_VERSION = 2;
+
+// The file holds the client version and script verification flags it was
+// written with, then for the signature cache and the script execution cache
+// the salt and the salted entries, followed by a hash of everything before
+// it. Entries are only meaningful under their own salt, so each cache takes
+// over the salt it is loaded with. A file from another version or flag set
+// is discarded, as script checks may have changed meaning in between.
+bool DumpScriptCaches()
+{
+    int64_t start = GetTimeMicros();
+
+    uint256 sigNonce;
+    std::vector<uint256> vSigEntries;
+    GetSignatureCacheEntries(sigNonce, vSigEntries);
+    std::vector<uint256> vScriptEntries;
+    scriptExecutionCache.get_entries(vScriptEntries);
+
+    try {
+        FILE* filestr = fsbridge::fopen(GetDataDir() / "scriptcache.dat.new", "wb");
+        if (!filestr) {
+            return false;
+        }
+
+        CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+        CHashWriter hasher(SER_DISK, CLIENT_VERSION);
+
+        uint64_t version = SCRIPT_CACHE_DUMP_VERSION;
+        int clientVersion = CLIENT_VERSION;
+        unsigned int flags = STANDARD_SCRIPT_VERIFY_FLAGS;
+        file << version << clientVersion << flags << sigNonce << vSigEntries << scriptExecutionCacheNonce << vScriptEntries;
+        hasher << version << clientVersion << flags << sigNonce << vSigEntries << scriptExecutionCacheNonce << vScriptEntries;
+        file << hasher.GetHash();
+        FileCommit(file.Get());
+        file.fclose();
+        RenameOver(GetDataDir() / "scriptcache.dat.new", GetDataDir() / "scriptcache.dat");
+        LogPrintf("Dumped %u signature and %u script execution cache entries in %gs\n", vSigEntries.size(), vScriptEntries.size(), (GetTimeMicros() - start) * MICRO);
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to dump script caches: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool LoadScriptCaches()
+{
+    int64_t start = GetTimeMicros();
+
+    FILE* filestr = fsbridge::fopen(GetDataDir() / "scriptcache.dat", "rb");
+    CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        LogPrintf("Failed to open script cache file from disk. Continuing anyway.\n");
+        return false;
+    }
+
+    uint256 sigNonce, scriptNonce;
+    std::vector<uint256> vSigEntries, vScriptEntries;
+    try {
+        CHashVerifier<CAutoFile> verifier(&file);
+        uint64_t version;
+        verifier >> version;
+        if (version != SCRIPT_CACHE_DUMP_VERSION) {
+            LogPrintf("Unknown script cache file version %u. Continuing anyway.\n", version);
+            return false;
+        }
+        int clientVersion;
+        unsigned int flags;
+        verifier >> clientVersion >> flags;
+        if (clientVersion != CLIENT_VERSION || flags != STANDARD_SCRIPT_VERIFY_FLAGS) {
+            LogPrintf("Script cache file was written by client version %d with script flags %08x, discarding it.\n", clientVersion, flags);
+            return false;
+        }
+        verifier >> sigNonce >> vSigEntries >> scriptNonce >> vScriptEntries;
+        uint256 hash;
+        file >> hash;
+        if (hash != verifier.GetHash()) {
+            LogPrintf("Script cache file checksum mismatch. Continuing anyway.\n");
+            return false;
+        }
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to deserialize script cache data on disk: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+
+    RestoreSignatureCache(sigNonce, vSigEntries);
+    scriptExecutionCacheNonce = scriptNonce;
+    for (const uint256& entry : vScriptEntries)
+        scriptExecutionCache.insert(entry);
+    LogPrintf("Loaded %u signature and %u script execution cache entries in %gs\n", vSigEntries.size(), vScriptEntries.size(), (GetTimeMicros() - start) * MICRO);
+    return true;
+}
+
 //! Guess how far we are in the verification process at the given block index
 double GuessVerificationProgress(const ChainTxData& data, const CBlockIndex *pindex) {
     if (pindex == nullptr)
@@ -4849,7 +5452,8 @@ public:
         // block headers
         BlockMap::iterator it1 = mapBlockIndex.begin();
         for (; it1 != mapBlockIndex.end(); it1++)
-            delete (*it1).second;
+            if (!g_chainstate.blockIndexArena.Owns((*it1).second))
+                delete (*it1).second;
         mapBlockIndex.clear();
     }
 } instance_of_cmaincleanup;
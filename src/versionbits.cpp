@@ -238,3 +238,57 @@ void VersionBitsCache::Clear()
         caches[d].clear();
     }
 }
+
+bool VersionBitsActivationCache::GetActive(const CBlockIndex* pindexPrev, const Consensus::Params& params, Consensus::DeploymentPos pos, bool& fActive) const
+{
+    if (params.vDeployments[pos].nStartTime == Consensus::BIP9Deployment::ALWAYS_ACTIVE) {
+        fActive = true;
+        return true;
+    }
+
+    const CBlockIndex* pindexActivation = activationParent[pos].load();
+    if (pindexPrev == nullptr || pindexActivation == nullptr)
+        return false;
+
+    // ACTIVE is final, so every descendant of the activation parent is past
+    // activation and every ancestor of it is not
+    if (pindexPrev->nHeight >= pindexActivation->nHeight) {
+        if (pindexPrev->GetAncestor(pindexActivation->nHeight) != pindexActivation)
+            return false;
+        fActive = true;
+    } else {
+        if (pindexActivation->GetAncestor(pindexPrev->nHeight) != pindexPrev)
+            return false;
+        fActive = false;
+    }
+    return true;
+}
+
+void VersionBitsActivationCache::UpdateTip(const CBlockIndex* pindexTip, const Consensus::Params& params, VersionBitsCache& cache)
+{
+    for (unsigned int d = 0; d < Consensus::MAX_VERSION_BITS_DEPLOYMENTS; d++) {
+        Consensus::DeploymentPos pos = (Consensus::DeploymentPos)d;
+        const CBlockIndex* pindexActivation = activationParent[d].load();
+        if (pindexActivation) {
+            if (pindexTip && pindexTip->GetAncestor(pindexActivation->nHeight) == pindexActivation)
+                continue;
+            // Reorganised past the activation point
+            activationParent[d] = nullptr;
+        }
+
+        if (pindexTip == nullptr || params.vDeployments[d].nStartTime == Consensus::BIP9Deployment::ALWAYS_ACTIVE)
+            continue;
+        if (VersionBitsState(pindexTip, params, pos, cache) == THRESHOLD_ACTIVE) {
+            int nActivationHeight = VersionBitsStateSinceHeight(pindexTip, params, pos, cache);
+            if (nActivationHeight > 0)
+                activationParent[d] = pindexTip->GetAncestor(nActivationHeight - 1);
+        }
+    }
+}
+
+void VersionBitsActivationCache::Clear()
+{
+    for (unsigned int d = 0; d < Consensus::MAX_VERSION_BITS_DEPLOYMENTS; d++) {
+        activationParent[d] = nullptr;
+    }
+}
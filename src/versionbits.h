@@ -6,6 +6,8 @@
 #define BITCOIN_CONSENSUS_VERSIONBITS
 
 #include <chain.h>
+
+#include <atomic>
 #include <map>
 
 /** What block version to use for new blocks (pre versionbits) */
@@ -72,6 +74,28 @@ struct VersionBitsCache
     void Clear();
 };
 
+/**
+ * Maza: Remembers, for each deployment active on the best chain, the last
+ * block before it became active. Whether a deployment applies to the block
+ * after pindexPrev can then be answered without cs_main for any pindexPrev
+ * that descends from that block or is one of its ancestors; blocks on forks
+ * below it are left to VersionBitsState.
+ */
+class VersionBitsActivationCache
+{
+private:
+    std::atomic<const CBlockIndex*> activationParent[Consensus::MAX_VERSION_BITS_DEPLOYMENTS];
+
+public:
+    VersionBitsActivationCache() { Clear(); }
+
+    /** Sets fActive and returns true if the cache can tell whether the deployment is active after pindexPrev */
+    bool GetActive(const CBlockIndex* pindexPrev, const Consensus::Params& params, Consensus::DeploymentPos pos, bool& fActive) const;
+    /** Follows the best chain to a new tip, forgetting activations it no longer contains. Requires cs_main. */
+    void UpdateTip(const CBlockIndex* pindexTip, const Consensus::Params& params, VersionBitsCache& cache);
+    void Clear();
+};
+
 ThresholdState VersionBitsState(const CBlockIndex* pindexPrev, const Consensus::Params& params, Consensus::DeploymentPos pos, VersionBitsCache& cache);
 BIP9Stats VersionBitsStatistics(const CBlockIndex* pindexPrev, const Consensus::Params& params, Consensus::DeploymentPos pos);
 int VersionBitsStateSinceHeight(const CBlockIndex* pindexPrev, const Consensus::Params& params, Consensus::DeploymentPos pos, VersionBitsCache& cache);
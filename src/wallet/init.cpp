@@ -19,6 +19,11 @@ std::string GetWalletHelpString(bool showDebug)
     strUsage += HelpMessageOpt("-addresstype", strprintf("What type of addresses to use (\"legacy\", \"p2sh-segwit\", or \"bech32\", default: \"%s\")", FormatOutputType(OUTPUT_TYPE_DEFAULT)));
     strUsage += HelpMessageOpt("-changetype", "What type of change to use (\"legacy\", \"p2sh-segwit\", or \"bech32\"). Default is same as -addresstype, except when -addresstype=p2sh-segwit a native segwit output is used when sending to a native segwit address)");
     strUsage += HelpMessageOpt("-disablewallet", _("Do not load the wallet and disable wallet RPC calls"));
+    strUsage += HelpMessageOpt("-honeyconsolidate", strprintf(_("Periodically sweep mature honey outputs into a single output while fees are low (default: %u)"), DEFAULT_HONEY_CONSOLIDATE));
+    strUsage += HelpMessageOpt("-honeyconsolidatebatch=<n>", strprintf(_("Maximum number of honey outputs swept by one consolidation transaction, up to %u (default: %u)"), MAX_HONEY_CONSOLIDATE_BATCH, DEFAULT_HONEY_CONSOLIDATE_BATCH));
+    strUsage += HelpMessageOpt("-honeyconsolidatefeerate=<amt>", strprintf(_("Only consolidate honey while the estimated fee rate (in %s/kB) is at or below this (default: %s)"),
+                                                                          CURRENCY_UNIT, FormatMoney(DEFAULT_CONSOLIDATE_FEERATE)));
+    strUsage += HelpMessageOpt("-honeyconsolidatemin=<n>", strprintf(_("Minimum number of mature honey outputs before consolidating (default: %u)"), DEFAULT_HONEY_CONSOLIDATE_MIN));
     strUsage += HelpMessageOpt("-keypool=<n>", strprintf(_("Set key pool size to <n> (default: %u)"), DEFAULT_KEYPOOL_SIZE));
     strUsage += HelpMessageOpt("-fallbackfee=<amt>", strprintf(_("A fee rate (in %s/kB) that will be used when fee estimation has insufficient data (default: %s)"),
                                                                CURRENCY_UNIT, FormatMoney(DEFAULT_FALLBACK_FEE)));
@@ -30,6 +35,7 @@ std::string GetWalletHelpString(bool showDebug)
     strUsage += HelpMessageOpt("-paytxfee=<amt>", strprintf(_("Fee (in %s/kB) to add to transactions you send (default: %s)"),
                                                             CURRENCY_UNIT, FormatMoney(payTxFee.GetFeePerK())));
     strUsage += HelpMessageOpt("-rescan", _("Rescan the block chain for missing wallet transactions on startup"));
+    strUsage += HelpMessageOpt("-rescanthreads=<n>", strprintf(_("Number of threads reading blocks during a wallet rescan (0 = one per core, up to %d, default: %d)"), MAX_RESCAN_THREADS, DEFAULT_RESCAN_THREADS));
     strUsage += HelpMessageOpt("-salvagewallet", _("Attempt to recover private keys from a corrupt wallet on startup"));
     strUsage += HelpMessageOpt("-spendzeroconfchange", strprintf(_("Spend unconfirmed change when sending transactions (default: %u)"), DEFAULT_SPEND_ZEROCONF_CHANGE));
     strUsage += HelpMessageOpt("-txconfirmtarget=<n>", strprintf(_("If paytxfee is not set, include enough fee so transactions begin confirmation on average within n blocks (default: %u)"), DEFAULT_TX_CONFIRM_TARGET));
@@ -177,6 +183,13 @@ bool WalletParameterInteraction()
     bSpendZeroConfChange = gArgs.GetBoolArg("-spendzeroconfchange", DEFAULT_SPEND_ZEROCONF_CHANGE);
     fWalletRbf = gArgs.GetBoolArg("-walletrbf", DEFAULT_WALLET_RBF);
 
+    if (gArgs.IsArgSet("-honeyconsolidatefeerate"))
+    {
+        CAmount nFeePerK = 0;
+        if (!ParseMoney(gArgs.GetArg("-honeyconsolidatefeerate", ""), nFeePerK))
+            return InitError(strprintf(_("Invalid amount for -honeyconsolidatefeerate=<amount>: '%s'"), gArgs.GetArg("-honeyconsolidatefeerate", "")));
+    }
+
     g_address_type = ParseOutputType(gArgs.GetArg("-addresstype", ""));
     if (g_address_type == OUTPUT_TYPE_NONE) {
         return InitError(strprintf("Unknown address type '%s'", gArgs.GetArg("-addresstype", "")));
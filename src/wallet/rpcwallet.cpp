@@ -15,6 +15,7 @@
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <policy/rbf.h>
+#include <rpc/jsonstream.h>
 #include <rpc/mining.h>
 #include <rpc/safemode.h>
 #include <rpc/server.h>
@@ -837,6 +838,145 @@ UniValue getbctinfo(const JSONRPCRequest& request)
     return jsonResults;
 }
 
+// Maza: Hive: Report automatic honey consolidation settings and progress
+static UniValue HoneyConsolidationToJSON(CWallet* const pwallet)
+{
+    std::vector<CInputCoin> vHoney = pwallet->GetMatureHoney();
+    CAmount nHoney = 0;
+    for (const CInputCoin& coin : vHoney)
+        nHoney += coin.txout.nValue;
+
+    const CHoneyConsolidationState& state = pwallet->honeyConsolidation;
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("enabled", state.fEnabled));
+    obj.push_back(Pair("max_feerate", ValueFromAmount(state.maxFeeRate.GetFeePerK())));
+    obj.push_back(Pair("batch_size", (uint64_t)state.nBatchSize));
+    obj.push_back(Pair("min_inputs", (uint64_t)state.nMinInputs));
+    CTxDestination dest;
+    if (!state.scriptDest.empty() && ExtractDestination(state.scriptDest, dest))
+        obj.push_back(Pair("address", EncodeDestination(dest)));
+    obj.push_back(Pair("mature_honey_outputs", (uint64_t)vHoney.size()));
+    obj.push_back(Pair("mature_honey_amount", ValueFromAmount(nHoney)));
+    if (state.nLastCheck) {
+        obj.push_back(Pair("last_check", state.nLastCheck));
+        obj.push_back(Pair("last_feerate", ValueFromAmount(state.lastFeeRate.GetFeePerK())));
+        obj.push_back(Pair("last_result", state.strLastResult));
+    }
+    obj.push_back(Pair("transactions", (uint64_t)state.nTransactions));
+    obj.push_back(Pair("inputs_consolidated", (uint64_t)state.nInputs));
+    obj.push_back(Pair("amount_consolidated", ValueFromAmount(state.nAmount)));
+    obj.push_back(Pair("fees_paid", ValueFromAmount(state.nFees)));
+    if (!state.lastTxid.IsNull())
+        obj.push_back(Pair("last_txid", state.lastTxid.GetHex()));
+    return obj;
+}
+
+static const std::string HONEY_CONSOLIDATION_RESULT_HELP =
+    "{\n"
+    "  \"enabled\": true|false,       (boolean) Whether honey is consolidated automatically\n"
+    "  \"max_feerate\": x.xxxx,       (numeric) Consolidate only while the estimated fee rate (in " + CURRENCY_UNIT + "/kB) is at or below this\n"
+    "  \"batch_size\": n,             (numeric) Maximum number of honey outputs swept per transaction\n"
+    "  \"min_inputs\": n,             (numeric) Minimum number of mature honey outputs before consolidating\n"
+    "  \"address\": \"address\",        (string, optional) Destination for consolidated honey, if not paying back to the honey address\n"
+    "  \"mature_honey_outputs\": n,   (numeric) Number of spendable mature honey outputs in the wallet\n"
+    "  \"mature_honey_amount\": x.xxx, (numeric) Their total value (in " + CURRENCY_UNIT + ")\n"
+    "  \"last_check\": xxx,           (numeric, optional) Time of the last consolidation check\n"
+    "  \"last_feerate\": x.xxxx,      (numeric, optional) Fee rate estimate seen at the last check (in " + CURRENCY_UNIT + "/kB)\n"
+    "  \"last_result\": \"...\",        (string, optional) Outcome of the last check\n"
+    "  \"transactions\": n,           (numeric) Consolidation transactions sent since startup\n"
+    "  \"inputs_consolidated\": n,    (numeric) Honey outputs swept since startup\n"
+    "  \"amount_consolidated\": x.xxx, (numeric) Value swept since startup (in " + CURRENCY_UNIT + ")\n"
+    "  \"fees_paid\": x.xxxx,         (numeric) Fees paid for consolidation since startup (in " + CURRENCY_UNIT + ")\n"
+    "  \"last_txid\": \"hex\"           (string, optional) The most recent consolidation transaction\n"
+    "}\n";
+
+// Maza: Hive: Get automatic honey consolidation status
+UniValue gethoneyconsolidationinfo(const JSONRPCRequest& request)
+{
+    CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(pwallet, request.fHelp))
+        return NullUniValue;
+
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "gethoneyconsolidationinfo\n"
+            "\nReturns the settings and progress of automatic honey consolidation.\n"
+            "\nResult:\n"
+            + HONEY_CONSOLIDATION_RESULT_HELP +
+            "\nExamples:\n"
+            + HelpExampleCli("gethoneyconsolidationinfo", "")
+            + HelpExampleRpc("gethoneyconsolidationinfo", "")
+        );
+
+    LOCK2(cs_main, pwallet->cs_wallet);
+    return HoneyConsolidationToJSON(pwallet);
+}
+
+// Maza: Hive: Configure automatic honey consolidation
+UniValue sethoneyconsolidation(const JSONRPCRequest& request)
+{
+    CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(pwallet, request.fHelp))
+        return NullUniValue;
+
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 5)
+        throw std::runtime_error(
+            "sethoneyconsolidation enabled ( max_feerate batch_size min_inputs \"address\" )\n"
+            "\nConfigure automatic consolidation of mature honey outputs. While enabled, the wallet periodically sweeps up to\n"
+            "batch_size of its smallest mature honey outputs into one output whenever the estimated fee rate is low enough.\n"
+            "Settings last until restart; use the -honeyconsolidate* options to make them permanent.\n"
+            + HelpRequiringPassphrase(pwallet) +
+            "\nArguments:\n"
+            "1. enabled          (boolean, required) Whether to consolidate honey automatically\n"
+            "2. max_feerate      (numeric or string, optional) Only consolidate while the estimated fee rate (in " + CURRENCY_UNIT + "/kB) is at or below this\n"
+            "3. batch_size       (numeric, optional) Maximum number of honey outputs swept per transaction, up to " + std::to_string(MAX_HONEY_CONSOLIDATE_BATCH) + "\n"
+            "4. min_inputs       (numeric, optional) Minimum number of mature honey outputs before consolidating\n"
+            "5. \"address\"        (string, optional) Send consolidated honey here instead of back to the honey address. Empty string to reset\n"
+            "\nResult:\n"
+            + HONEY_CONSOLIDATION_RESULT_HELP +
+            "\nExamples:\n"
+            + HelpExampleCli("sethoneyconsolidation", "true")
+            + HelpExampleCli("sethoneyconsolidation", "true 0.0001 200 50")
+            + HelpExampleRpc("sethoneyconsolidation", "true, 0.0001")
+        );
+
+    RPCTypeCheckArgument(request.params[0], UniValue::VBOOL);
+
+    LOCK2(cs_main, pwallet->cs_wallet);
+    CHoneyConsolidationState& state = pwallet->honeyConsolidation;
+
+    CHoneyConsolidationState newState = state;
+    newState.fEnabled = request.params[0].get_bool();
+    if (!request.params[1].isNull())
+        newState.maxFeeRate = CFeeRate(AmountFromValue(request.params[1]));
+    if (!request.params[2].isNull()) {
+        int nBatchSize = request.params[2].get_int();
+        if (nBatchSize < 2 || nBatchSize > (int)MAX_HONEY_CONSOLIDATE_BATCH)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("batch_size must be between 2 and %u", MAX_HONEY_CONSOLIDATE_BATCH));
+        newState.nBatchSize = nBatchSize;
+    }
+    if (!request.params[3].isNull()) {
+        int nMinInputs = request.params[3].get_int();
+        if (nMinInputs < 2)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "min_inputs must be at least 2");
+        newState.nMinInputs = nMinInputs;
+    }
+    if (!request.params[4].isNull()) {
+        const std::string& strAddress = request.params[4].get_str();
+        if (strAddress.empty()) {
+            newState.scriptDest.clear();
+        } else {
+            CTxDestination dest = DecodeDestination(strAddress);
+            if (!IsValidDestination(dest))
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+            newState.scriptDest = GetScriptForDestination(dest);
+        }
+    }
+
+    state = newState;
+    return HoneyConsolidationToJSON(pwallet);
+}
+
 // Maza: Hive: Get wallet's own hive info
 UniValue gethiveinfo(const JSONRPCRequest& request)
 {
@@ -905,63 +1045,71 @@ UniValue gethiveinfo(const JSONRPCRequest& request)
         minHoneyConfirms = request.params[1].get_int();
     }
 
-    LOCK2(cs_main, pwallet->cs_wallet);
-
-    // Iterate wallet txs looking for bee creation txs (BCTs)
-    std::vector<CBeeCreationTransactionInfo> bcts = pwallet->GetBCTs(includeDead, true, consensusParams, minHoneyConfirms);
-    UniValue bctList(UniValue::VARR);
-
-    int totalBees = 0;
-    int totalImmature = 0;
-    int totalMature = 0;
-    int totalBlocksFound = 0;
-    CAmount totalBeeFee = 0;
-    CAmount totalRewards = 0;
-    for (std::vector<CBeeCreationTransactionInfo>::const_iterator it = bcts.begin(); it != bcts.end(); it++) {
-        CBeeCreationTransactionInfo bct = *it;
-
-        if (bct.txid!="") {
-            UniValue entry(UniValue::VOBJ);
-            entry.push_back(Pair("txid", bct.txid));
-            entry.push_back(Pair("time", bct.time));
-            entry.push_back(Pair("bee_count", bct.beeCount));
-            entry.push_back(Pair("community_contrib", bct.communityContrib));
-            entry.push_back(Pair("bee_status", bct.beeStatus));
-            entry.push_back(Pair("honey_address", bct.honeyAddress));
-            entry.push_back(Pair("bee_fee_paid", ValueFromAmount(bct.beeFeePaid)));
-            entry.push_back(Pair("rewards_paid", ValueFromAmount(bct.rewardsPaid)));
-            entry.push_back(Pair("profit", ValueFromAmount(bct.profit)));
-            entry.push_back(Pair("blocks_found", bct.blocksFound));
-            entry.push_back(Pair("blocks_left", bct.blocksLeft));
-
-            totalBlocksFound += bct.blocksFound;
-            totalBeeFee += bct.beeFeePaid;
-            totalRewards += bct.rewardsPaid;
-            totalBees += bct.beeCount;
-            if (bct.beeStatus == "immature")
-                totalImmature += bct.beeCount;
-            else if (bct.beeStatus == "mature")
-                totalMature += bct.beeCount;
-
-            bctList.push_back(entry);
-        }
-    }
-
+    // The bees are collected under the locks, and written after releasing
+    // them, as writing may wait on the client
+    std::vector<CBeeCreationTransactionInfo> bcts;
     UniValue summary(UniValue::VOBJ);
-    summary.push_back(Pair("bee_count", totalBees));
-    summary.push_back(Pair("mature_bees", totalMature));
-    summary.push_back(Pair("immature_bees", totalImmature));
-    summary.push_back(Pair("blocks_found", totalBlocksFound));
-    summary.push_back(Pair("bee_fee_paid", ValueFromAmount(totalBeeFee)));
-    summary.push_back(Pair("rewards_paid", ValueFromAmount(totalRewards)));
-    summary.push_back(Pair("profit", ValueFromAmount(totalRewards-totalBeeFee)));
-    summary.push_back(Pair("warnings", pwallet->IsLocked()? "Wallet is locked and must be unlocked to mine" : ""));
-            
-    UniValue jsonResults(UniValue::VOBJ);
-    jsonResults.push_back(Pair("summary", summary));
-    jsonResults.push_back(Pair("bees", bctList));
+    {
+        LOCK2(cs_main, pwallet->cs_wallet);
+
+        // Iterate wallet txs looking for bee creation txs (BCTs)
+        bcts = pwallet->GetBCTs(includeDead, true, consensusParams, minHoneyConfirms);
+
+        // The summary comes first in the result, so total up before writing the bees
+        int totalBees = 0;
+        int totalImmature = 0;
+        int totalMature = 0;
+        int totalBlocksFound = 0;
+        CAmount totalBeeFee = 0;
+        CAmount totalRewards = 0;
+        for (const CBeeCreationTransactionInfo& bct : bcts) {
+            if (bct.txid!="") {
+                totalBlocksFound += bct.blocksFound;
+                totalBeeFee += bct.beeFeePaid;
+                totalRewards += bct.rewardsPaid;
+                totalBees += bct.beeCount;
+                if (bct.beeStatus == "immature")
+                    totalImmature += bct.beeCount;
+                else if (bct.beeStatus == "mature")
+                    totalMature += bct.beeCount;
+            }
+        }
 
-    return jsonResults;
+        summary.push_back(Pair("bee_count", totalBees));
+        summary.push_back(Pair("mature_bees", totalMature));
+        summary.push_back(Pair("immature_bees", totalImmature));
+        summary.push_back(Pair("blocks_found", totalBlocksFound));
+        summary.push_back(Pair("bee_fee_paid", ValueFromAmount(totalBeeFee)));
+        summary.push_back(Pair("rewards_paid", ValueFromAmount(totalRewards)));
+        summary.push_back(Pair("profit", ValueFromAmount(totalRewards-totalBeeFee)));
+        summary.push_back(Pair("warnings", pwallet->IsLocked()? "Wallet is locked and must be unlocked to mine" : ""));
+    }
+
+    return StreamRPCResult(request, [&](JSONStreamWriter& writer) {
+        writer.BeginObject();
+        writer.KeyValue("summary", summary);
+        writer.Key("bees");
+        writer.BeginArray();
+        for (const CBeeCreationTransactionInfo& bct : bcts) {
+            if (bct.txid!="") {
+                UniValue entry(UniValue::VOBJ);
+                entry.push_back(Pair("txid", bct.txid));
+                entry.push_back(Pair("time", bct.time));
+                entry.push_back(Pair("bee_count", bct.beeCount));
+                entry.push_back(Pair("community_contrib", bct.communityContrib));
+                entry.push_back(Pair("bee_status", bct.beeStatus));
+                entry.push_back(Pair("honey_address", bct.honeyAddress));
+                entry.push_back(Pair("bee_fee_paid", ValueFromAmount(bct.beeFeePaid)));
+                entry.push_back(Pair("rewards_paid", ValueFromAmount(bct.rewardsPaid)));
+                entry.push_back(Pair("profit", ValueFromAmount(bct.profit)));
+                entry.push_back(Pair("blocks_found", bct.blocksFound));
+                entry.push_back(Pair("blocks_left", bct.blocksLeft));
+                writer.Value(entry);
+            }
+        }
+        writer.EndArray();
+        writer.EndObject();
+    });
 }
 
 UniValue listaddressgroupings(const JSONRPCRequest& request)
@@ -3292,6 +3440,18 @@ UniValue getwalletinfo(const JSONRPCRequest& request)
             "  \"unlocked_until\": ttt,           (numeric) the timestamp in seconds since epoch (midnight Jan 1 1970 GMT) that the wallet is unlocked for transfers, or 0 if the wallet is locked\n"
             "  \"paytxfee\": x.xxxx,              (numeric) the transaction fee configuration, set in " + CURRENCY_UNIT + "/kB\n"
             "  \"hdmasterkeyid\": \"<hash160>\"     (string, optional) the Hash160 of the HD master pubkey (only present when HD is enabled)\n"
+            "  \"rescan\": {                     (object, optional) the running or last finished rescan (only present once the wallet has been rescanned)\n"
+            "    \"in_progress\": true|false,    (boolean) whether the rescan is still running\n"
+            "    \"start_height\": xxxx,         (numeric) the height the rescan started at\n"
+            "    \"stop_height\": xxxx,          (numeric) the height the rescan runs up to\n"
+            "    \"height\": xxxx,               (numeric) the last block added to the wallet\n"
+            "    \"blocks\": xxxx,               (numeric) the number of blocks scanned\n"
+            "    \"filtered_blocks\": xxxx,      (numeric) the number of blocks skipped as their block filter matched none of the wallet's scripts (-blockfilterindex)\n"
+            "    \"matched_transactions\": xxxx, (numeric) the number of transactions that matched the wallet's keys and scripts\n"
+            "    \"threads\": xxxx,              (numeric) the number of threads reading and matching blocks\n"
+            "    \"duration\": xxxx,             (numeric) seconds spent so far\n"
+            "    \"blocks_per_second\": x.xx     (numeric) scan throughput\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getwalletinfo", "")
@@ -3327,6 +3487,21 @@ UniValue getwalletinfo(const JSONRPCRequest& request)
     obj.push_back(Pair("paytxfee",      ValueFromAmount(payTxFee.GetFeePerK())));
     if (!masterKeyID.IsNull())
          obj.push_back(Pair("hdmasterkeyid", masterKeyID.GetHex()));
+    CWalletRescanStats rescanStats = pwallet->GetRescanStats();
+    if (rescanStats.nStartHeight >= 0) {
+        UniValue rescan(UniValue::VOBJ);
+        rescan.push_back(Pair("in_progress", rescanStats.fInProgress));
+        rescan.push_back(Pair("start_height", rescanStats.nStartHeight));
+        rescan.push_back(Pair("stop_height", rescanStats.nStopHeight));
+        rescan.push_back(Pair("height", rescanStats.nHeight));
+        rescan.push_back(Pair("blocks", rescanStats.nBlocks));
+        rescan.push_back(Pair("filtered_blocks", rescanStats.nFiltered));
+        rescan.push_back(Pair("matched_transactions", rescanStats.nMatched));
+        rescan.push_back(Pair("threads", rescanStats.nThreads));
+        rescan.push_back(Pair("duration", rescanStats.nDuration / 1000000));
+        rescan.push_back(Pair("blocks_per_second", rescanStats.nDuration > 0 ? rescanStats.nBlocks * 1000000.0 / rescanStats.nDuration : 0.0));
+        obj.push_back(Pair("rescan", rescan));
+    }
     return obj;
 }
 
@@ -3921,18 +4096,22 @@ UniValue generate(const JSONRPCRequest& request)
         return NullUniValue;
     }
 
-    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2) {
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 4) {
         throw std::runtime_error(
-            "generate nblocks ( maxtries )\n"
+            "generate nblocks ( maxtries \"powalgo\" threads )\n"
             "\nMine up to nblocks blocks immediately (before the RPC call returns) to an address in the wallet.\n"
             "\nArguments:\n"
             "1. nblocks      (numeric, required) How many blocks are generated immediately.\n"
             "2. maxtries     (numeric, optional) How many iterations to try (default = 1000000).\n"
+            "3. \"powalgo\"    (string, optional) Pow algorithm to mine with (sha256d or minotaurx; default from -powalgo).\n"
+            "4. threads      (numeric, optional) Threads to search nonces on, -1 for one per core (default = 1).\n"
             "\nResult:\n"
             "[ blockhashes ]     (array) hashes of blocks generated\n"
             "\nExamples:\n"
             "\nGenerate 11 blocks\n"
             + HelpExampleCli("generate", "11")
+            + "\nGenerate 11 MinotaurX blocks on 4 threads\n"
+            + HelpExampleCli("generate", "11 1000000 \"minotaurx\" 4")
         );
     }
 
@@ -3941,6 +4120,8 @@ UniValue generate(const JSONRPCRequest& request)
     if (!request.params[1].isNull()) {
         max_tries = request.params[1].get_int();
     }
+    POW_TYPE pow_type = ParsePowTypeArg(request.params[2]);
+    int num_threads = ParseGenerateThreads(request.params[3]);
 
     std::shared_ptr<CReserveScript> coinbase_script;
     pwallet->GetScriptForMining(coinbase_script);
@@ -3955,7 +4136,7 @@ UniValue generate(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "No coinbase script available");
     }
 
-    return generateBlocks(coinbase_script, num_generate, max_tries, true);
+    return generateBlocks(coinbase_script, num_generate, max_tries, true, pow_type, num_threads);
 }
 
 UniValue rescanblockchain(const JSONRPCRequest& request)
@@ -4064,6 +4245,8 @@ static const CRPCCommand commands[] =
     { "wallet",             "getnetworkhiveinfo",       &getnetworkhiveinfo,       {"include_graph"} },                                     // Maza: Hive: Get current bee populations across whole network
     { "wallet",             "getbeecreationtxid",       &getbeecreationtxid,       {"honey_txid"} },                                        // Maza: Hive: Return BCT tx id for a honey transaction in this wallet
     { "wallet",             "getbctinfo",               &getbctinfo,               {"bct_txid","min_honey_confirms"} },                     // Maza: Hive: Return hive info for a single BCT
+    { "wallet",             "gethoneyconsolidationinfo", &gethoneyconsolidationinfo, {} },                                                  // Maza: Hive: Get automatic honey consolidation status
+    { "wallet",             "sethoneyconsolidation",    &sethoneyconsolidation,    {"enabled","max_feerate","batch_size","min_inputs","address"} }, // Maza: Hive: Configure automatic honey consolidation
     { "rawtransactions",    "fundrawtransaction",       &fundrawtransaction,       {"hexstring","options","iswitness"} },
     { "hidden",             "resendwallettransactions", &resendwallettransactions, {} },
     { "wallet",             "abandontransaction",       &abandontransaction,       {"txid"} },
@@ -4117,7 +4300,7 @@ static const CRPCCommand commands[] =
     { "wallet",             "removeprunedfunds",        &removeprunedfunds,        {"txid"} },
     { "wallet",             "rescanblockchain",         &rescanblockchain,         {"start_height", "stop_height"} },
 
-    { "generating",         "generate",                 &generate,                 {"nblocks","maxtries"} },
+    { "generating",         "generate",                 &generate,                 {"nblocks","maxtries","powalgo","threads"} },
 };
 
 void RegisterWalletRPCCommands(CRPCTable &t)
@@ -14,6 +14,7 @@
 #include <test/test_bitcoin.h>
 #include <validation.h>
 #include <wallet/coincontrol.h>
+#include <wallet/fees.h>
 #include <wallet/test/wallet_test_fixture.h>
 
 #include <boost/test/unit_test.hpp>
@@ -341,6 +342,71 @@ BOOST_AUTO_TEST_CASE(coin_selection_tests)
     empty_wallet();
 }
 
+static std::vector<CInputCoin> input_coins(void)
+{
+    std::vector<CInputCoin> vInputs;
+    for (const COutput& output : vCoins)
+        vInputs.emplace_back(output.tx, output.i);
+    return vInputs;
+}
+
+BOOST_AUTO_TEST_CASE(bnb_search_test)
+{
+    CoinSet setCoinsRet;
+    CAmount nValueRet;
+    std::vector<CInputCoin> vPool;
+
+    LOCK(testWallet.cs_wallet);
+
+    empty_wallet();
+    add_coin(1 * CENT);
+    add_coin(2 * CENT);
+    add_coin(3 * CENT);
+    add_coin(4 * CENT);
+
+    // exact matches, using one and several coins
+    vPool = input_coins();
+    BOOST_CHECK(SelectCoinsBnB(vPool, 4 * CENT, 0, setCoinsRet, nValueRet));
+    BOOST_CHECK_EQUAL(nValueRet, 4 * CENT);
+    vPool = input_coins();
+    BOOST_CHECK(SelectCoinsBnB(vPool, 10 * CENT, 0, setCoinsRet, nValueRet));
+    BOOST_CHECK_EQUAL(nValueRet, 10 * CENT);
+    BOOST_CHECK_EQUAL(setCoinsRet.size(), 4U);
+
+    // more than we have
+    vPool = input_coins();
+    BOOST_CHECK(!SelectCoinsBnB(vPool, 11 * CENT, 0, setCoinsRet, nValueRet));
+
+    // the cost of change window allows a small excess, but no more
+    empty_wallet();
+    add_coin(4 * CENT);
+    add_coin(4 * CENT);
+    add_coin(4 * CENT);
+    vPool = input_coins();
+    BOOST_CHECK(!SelectCoinsBnB(vPool, 5 * CENT, 1 * CENT, setCoinsRet, nValueRet));
+    vPool = input_coins();
+    BOOST_CHECK(SelectCoinsBnB(vPool, 7 * CENT, 1 * CENT, setCoinsRet, nValueRet));
+    BOOST_CHECK_EQUAL(nValueRet, 8 * CENT);
+
+    // long runs of identical coins are pruned rather than enumerated
+    empty_wallet();
+    for (int i = 0; i < 10000; i++)
+        add_coin(1 * CENT);
+    vPool = input_coins();
+    BOOST_CHECK(SelectCoinsBnB(vPool, 50 * CENT, 0, setCoinsRet, nValueRet));
+    BOOST_CHECK_EQUAL(setCoinsRet.size(), 50U);
+
+    // SelectCoinsMinConf reports when the changeless solution was taken
+    CoinSelectionParams params;
+    params.use_bnb = true;
+    bool fBnBUsed = false;
+    BOOST_CHECK(testWallet.SelectCoinsMinConf(75 * CENT, 1, 6, 0, vCoins, setCoinsRet, nValueRet, &params, &fBnBUsed));
+    BOOST_CHECK(fBnBUsed);
+    BOOST_CHECK_EQUAL(nValueRet, 75 * CENT);
+
+    empty_wallet();
+}
+
 BOOST_AUTO_TEST_CASE(ApproximateBestSubset)
 {
     CoinSet setCoinsRet;
@@ -362,6 +428,157 @@ BOOST_AUTO_TEST_CASE(ApproximateBestSubset)
     empty_wallet();
 }
 
+BOOST_AUTO_TEST_CASE(scan_filter)
+{
+    CWallet& wallet = *pwalletMain;
+    LOCK(wallet.cs_wallet);
+
+    CKey key, otherKey;
+    key.MakeNewKey(true);
+    otherKey.MakeNewKey(true);
+    CPubKey pubkey = key.GetPubKey();
+    CScript p2pkh = GetScriptForDestination(pubkey.GetID());
+    CScript multisig = GetScriptForMultisig(1, {pubkey});
+    CScript p2wpkh = GetScriptForWitness(p2pkh);
+    CScript watched = CScript() << OP_TRUE;
+    BOOST_CHECK(wallet.AddKeyPubKey(key, pubkey));
+    BOOST_CHECK(wallet.AddCScript(multisig));
+    BOOST_CHECK(wallet.AddCScript(p2wpkh));
+    BOOST_CHECK(wallet.AddCScript(GetScriptForWitness(multisig)));
+    BOOST_CHECK(wallet.AddWatchOnly(watched, 0));
+
+    CWalletScanFilter filter;
+    wallet.FillScanFilter(filter);
+
+    std::vector<CScript> vMine = {
+        GetScriptForRawPubKey(pubkey), p2pkh, p2wpkh, multisig,
+        GetScriptForDestination(CScriptID(multisig)), GetScriptForWitness(multisig),
+        GetScriptForDestination(CScriptID(p2wpkh)), watched,
+    };
+    for (const CScript& script : vMine) {
+        BOOST_CHECK(IsMine(wallet, script) != ISMINE_NO);
+        BOOST_CHECK(filter.MatchesOutput(script));
+    }
+
+    CScript otherP2PKH = GetScriptForDestination(otherKey.GetPubKey().GetID());
+    BOOST_CHECK(!filter.MatchesOutput(otherP2PKH));
+    BOOST_CHECK(!filter.MatchesOutput(GetScriptForWitness(otherP2PKH)));
+    BOOST_CHECK(!filter.MatchesOutput(CScript() << OP_RETURN << std::vector<unsigned char>(20, 0)));
+
+    // Keys added later, like keypool top-ups, show in the next snapshot
+    size_t nSize = filter.nKeyStoreSize;
+    BOOST_CHECK(wallet.AddKeyPubKey(otherKey, otherKey.GetPubKey()));
+    wallet.FillScanFilter(filter);
+    BOOST_CHECK(filter.nKeyStoreSize > nSize);
+    BOOST_CHECK(filter.MatchesOutput(otherP2PKH));
+}
+
+BOOST_AUTO_TEST_CASE(bee_table)
+{
+    // BCTs in random order, several to a block, each with bees able to
+    // mine from 10 to 59 blocks after its own
+    CBeeTable table;
+    std::vector<CBeeTableEntry> vEntries;
+    for (int i = 0; i < 300; i++) {
+        CBeeTableEntry entry;
+        entry.txid = InsecureRand256();
+        entry.honeyDestination = CKeyID(uint160(insecure_rand_ctx.randbytes(20)));
+        entry.communityContrib = InsecureRandBool();
+        entry.beeCount = InsecureRandRange(100);
+        entry.nHeight = InsecureRandRange(100);
+        entry.nMatureHeight = entry.nHeight + 10;
+        entry.nExpiryHeight = entry.nHeight + 59;
+        table.Add(entry);
+        vEntries.push_back(entry);
+    }
+    table.Add(vEntries[0]);
+    table.Remove(vEntries[1].txid);
+    vEntries.erase(vEntries.begin() + 1);
+    BOOST_CHECK_EQUAL(table.size(), vEntries.size());
+
+    for (int nTipHeight = 0; nTipHeight < 180; nTipHeight += 7) {
+        std::map<uint256, int> mapExpected;
+        int nExpected = 0;
+        for (const CBeeTableEntry& entry : vEntries) {
+            if (nTipHeight >= entry.nMatureHeight && nTipHeight <= entry.nExpiryHeight && entry.beeCount > 0) {
+                mapExpected[entry.txid] = entry.beeCount;
+                nExpected += entry.beeCount;
+            }
+        }
+
+        std::vector<std::vector<CBeeRange>> vBins;
+        int nBees = table.GetBins(nTipHeight, 3, vBins);
+        BOOST_CHECK_EQUAL(nBees, nExpected);
+        BOOST_CHECK(vBins.size() <= 3);
+
+        // Every bee once, each BCT's bees in order
+        std::map<uint256, int> mapSeen;
+        for (const std::vector<CBeeRange>& bin : vBins) {
+            int nInBin = 0;
+            for (const CBeeRange& range : bin) {
+                BOOST_CHECK_EQUAL(range.offset, mapSeen[range.txid]);
+                BOOST_CHECK(range.count > 0);
+                mapSeen[range.txid] += range.count;
+                nInBin += range.count;
+            }
+            BOOST_CHECK(nInBin <= (nExpected + 2) / 3);
+        }
+        BOOST_CHECK(mapSeen == mapExpected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(honey_batch)
+{
+    // Honey outputs of a single transaction, sorted smallest first like
+    // GetMatureHoney() returns them
+    CMutableTransaction tx;
+    for (int i = 0; i < 1000; i++)
+        tx.vout.emplace_back((i + 1) * COIN, CScript());
+    CWalletTx wtx(&testWallet, MakeTransactionRef(std::move(tx)));
+    std::vector<CInputCoin> vHoney;
+    for (unsigned int i = 0; i < 1000; i++)
+        vHoney.emplace_back(&wtx, i);
+
+    // The smallest outputs, up to the batch size
+    std::vector<CInputCoin> vBatch = SelectHoneyBatch(vHoney, 10);
+    BOOST_CHECK_EQUAL(vBatch.size(), 10U);
+    for (unsigned int i = 0; i < vBatch.size(); i++)
+        BOOST_CHECK(vBatch[i].outpoint == vHoney[i].outpoint);
+
+    // All of them when fewer are mature
+    vBatch = SelectHoneyBatch(std::vector<CInputCoin>(vHoney.begin(), vHoney.begin() + 5), 10);
+    BOOST_CHECK_EQUAL(vBatch.size(), 5U);
+
+    // Never more than fit in a standard transaction
+    vBatch = SelectHoneyBatch(vHoney, 1000);
+    BOOST_CHECK_EQUAL(vBatch.size(), MAX_HONEY_CONSOLIDATE_BATCH);
+    BOOST_CHECK(vBatch.back().outpoint == vHoney[MAX_HONEY_CONSOLIDATE_BATCH - 1].outpoint);
+}
+
+BOOST_AUTO_TEST_CASE(honey_fee_rate)
+{
+    const CFeeRate fallbackFee = CWallet::fallbackFee;
+    const CFeeRate requiredFee(GetRequiredFee(1000));
+    const CFeeRate maxFeeRate(DEFAULT_CONSOLIDATE_FEERATE);
+
+    // An estimate is used as is, raised to the required fee
+    BOOST_CHECK(GetHoneyConsolidationFeeRate(CFeeRate(5000)) == std::max(CFeeRate(5000), requiredFee));
+    BOOST_CHECK(GetHoneyConsolidationFeeRate(CFeeRate(1)) == requiredFee);
+    BOOST_CHECK(GetHoneyConsolidationFeeRate(CFeeRate(50000)) > maxFeeRate);
+
+    // Without an estimate, fees are not assumed to be low: the fallback fee
+    // is used, and an expensive one keeps consolidation off
+    CWallet::fallbackFee = CFeeRate(20000);
+    BOOST_CHECK(GetHoneyConsolidationFeeRate(CFeeRate(0)) == CFeeRate(20000));
+    BOOST_CHECK(GetHoneyConsolidationFeeRate(CFeeRate(0)) > maxFeeRate);
+
+    // Unknown when the fallback fee is disabled too
+    CWallet::fallbackFee = CFeeRate(0);
+    BOOST_CHECK(GetHoneyConsolidationFeeRate(CFeeRate(0)) == CFeeRate(0));
+
+    CWallet::fallbackFee = fallbackFee;
+}
+
 static void AddKey(CWallet& wallet, const CKey& key)
 {
     LOCK(wallet.cs_wallet);
@@ -699,4 +916,36 @@ BOOST_FIXTURE_TEST_CASE(ListCoins, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2);
 }
 
+// Check that the balances served from the wallet's unspent output index match
+// the ones obtained by walking every wallet transaction, as transactions are
+// added and the tip moves.
+BOOST_FIXTURE_TEST_CASE(CachedBalances, ListCoinsTestingSetup)
+{
+    auto check_balances = [this]() {
+        CAmount trusted = 0;
+        CAmount immature = 0;
+        {
+            LOCK2(cs_main, wallet->cs_wallet);
+            for (const auto& entry : wallet->mapWallet) {
+                const CWalletTx& wtx = entry.second;
+                if (wtx.IsTrusted())
+                    trusted += wtx.GetAvailableCredit(false);
+                immature += wtx.GetImmatureCredit(false);
+            }
+        }
+        BOOST_CHECK_EQUAL(wallet->GetBalance(), trusted);
+        BOOST_CHECK_EQUAL(wallet->GetImmatureBalance(), immature);
+        BOOST_CHECK_EQUAL(wallet->GetAvailableBalance(), trusted);
+    };
+
+    check_balances();
+    BOOST_CHECK_EQUAL(wallet->GetBalance(), 50 * COIN);
+
+    AddTx(CRecipient{GetScriptForRawPubKey({}), 1 * COIN, false /* subtract fee */});
+    check_balances();
+
+    CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    check_balances();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,7 +11,9 @@
 #include <wallet/coincontrol.h>
 #include <consensus/consensus.h>
 #include <consensus/validation.h>
+#include <crypto/ripemd160.h>
 #include <fs.h>
+#include <index/blockfilterindex.h>
 #include <wallet/init.h>
 #include <key.h>
 #include <keystore.h>
@@ -31,7 +33,9 @@
 #include <wallet/fees.h>
 
 #include <assert.h>
+#include <condition_variable>
 #include <future>
+#include <thread>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/thread.hpp>
@@ -589,6 +593,7 @@ bool CWallet::IsSpent(const uint256& hash, unsigned int n) const
 void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, wtxid));
+    MarkUnspentDirty(outpoint.hash);
 
     std::pair<TxSpends::iterator, TxSpends::iterator> range;
     range = mapTxSpends.equal_range(outpoint);
@@ -866,6 +871,8 @@ void CWallet::MarkDirty()
 {
     {
         LOCK(cs_wallet);
+        fUnspentValid = false;
+        fBeeTableValid = false;
         for (std::pair<const uint256, CWalletTx>& item : mapWallet)
             item.second.MarkDirty();
     }
@@ -1232,7 +1239,7 @@ void CWallet::TransactionAddedToMempool(const CTransactionRef& ptx) {
     }
 }
 
-void CWallet::TransactionRemovedFromMempool(const CTransactionRef &ptx) {
+void CWallet::TransactionRemovedFromMempool(const CTransactionRef &ptx, MemPoolRemovalReason reason) {
     LOCK(cs_wallet);
     auto it = mapWallet.find(ptx->GetHash());
     if (it != mapWallet.end()) {
@@ -1252,11 +1259,12 @@ void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const
 
     for (const CTransactionRef& ptx : vtxConflicted) {
         SyncTransaction(ptx);
-        TransactionRemovedFromMempool(ptx);
+        TransactionRemovedFromMempool(ptx, MemPoolRemovalReason::CONFLICT);
     }
     for (size_t i = 0; i < pblock->vtx.size(); i++) {
         SyncTransaction(pblock->vtx[i], pindex, i);
-        TransactionRemovedFromMempool(pblock->vtx[i]);
+        TransactionRemovedFromMempool(pblock->vtx[i], MemPoolRemovalReason::BLOCK);
+        MarkBeeTableDirty(pblock->vtx[i]->GetHash());
     }
 
     m_last_block_processed = pindex;
@@ -1265,8 +1273,12 @@ void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const
 void CWallet::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) {
     LOCK2(cs_main, cs_wallet);
 
+    // Depths and conflicts of any transaction may change across a reorg
+    fUnspentValid = false;
+
     for (const CTransactionRef& ptx : pblock->vtx) {
         SyncTransaction(ptx);
+        MarkBeeTableDirty(ptx->GetHash());
     }
 }
 
@@ -1630,6 +1642,244 @@ int64_t CWallet::RescanFromTime(int64_t startTime, const WalletRescanReserver& r
     return startTime;
 }
 
+bool CWalletScanFilter::Contains(const uint160& hash) const
+{
+    return std::binary_search(vHashes.begin(), vHashes.end(), hash);
+}
+
+bool CWalletScanFilter::MatchesOutput(const CScript& scriptPubKey) const
+{
+    if (!setScripts.empty() && setScripts.count(scriptPubKey))
+        return true;
+
+    std::vector<std::vector<unsigned char>> vSolutions;
+    txnouttype whichType;
+    if (!Solver(scriptPubKey, whichType, vSolutions))
+        return false;
+    switch (whichType) {
+    case TX_PUBKEY:
+        return Contains(CPubKey(vSolutions[0]).GetID());
+    case TX_PUBKEYHASH:
+    case TX_SCRIPTHASH:
+    case TX_WITNESS_V0_KEYHASH:
+        return Contains(uint160(vSolutions[0]));
+    case TX_WITNESS_V0_SCRIPTHASH: {
+        // The wallet knows the witness script by its CScriptID, which is
+        // RIPEMD160 of the SHA256 the output commits to
+        uint160 hash;
+        CRIPEMD160().Write(&vSolutions[0][0], vSolutions[0].size()).Finalize(hash.begin());
+        return Contains(hash);
+    }
+    case TX_MULTISIG:
+        for (size_t i = 1; i + 1 < vSolutions.size(); i++) {
+            if (Contains(CPubKey(vSolutions[i]).GetID()))
+                return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+bool CWalletScanFilter::MatchesTransaction(const CTransaction& tx) const
+{
+    for (const CTxOut& txout : tx.vout) {
+        if (MatchesOutput(txout.scriptPubKey))
+            return true;
+    }
+    return false;
+}
+
+size_t CWallet::KeyStoreSize() const
+{
+    LOCK(cs_KeyStore);
+    return mapKeys.size() + mapCryptedKeys.size() + mapWatchKeys.size() + mapScripts.size() + setWatchOnly.size();
+}
+
+static void AddScanFilterElement(CWalletScanFilter& filter, const CScript& script)
+{
+    filter.setElements.emplace(script.begin(), script.end());
+}
+
+static void AddScanFilterKey(CWalletScanFilter& filter, const CPubKey& pubkey)
+{
+    AddScanFilterElement(filter, GetScriptForRawPubKey(pubkey));
+    AddScanFilterElement(filter, GetScriptForDestination(pubkey.GetID()));
+    if (pubkey.IsCompressed()) {
+        CScript witprog = GetScriptForDestination(WitnessV0KeyHash(pubkey.GetID()));
+        AddScanFilterElement(filter, witprog);
+        AddScanFilterElement(filter, GetScriptForDestination(CScriptID(witprog)));
+    }
+}
+
+void CWallet::FillScanFilter(CWalletScanFilter& filter) const
+{
+    LOCK(cs_KeyStore);
+    filter.nKeyStoreSize = mapKeys.size() + mapCryptedKeys.size() + mapWatchKeys.size() + mapScripts.size() + setWatchOnly.size();
+    filter.vHashes.clear();
+    filter.vHashes.reserve(filter.nKeyStoreSize);
+    for (const auto& entry : mapKeys)
+        filter.vHashes.push_back(entry.first);
+    for (const auto& entry : mapCryptedKeys)
+        filter.vHashes.push_back(entry.first);
+    for (const auto& entry : mapWatchKeys)
+        filter.vHashes.push_back(entry.first);
+    for (const auto& entry : mapScripts)
+        filter.vHashes.push_back(entry.first);
+    std::sort(filter.vHashes.begin(), filter.vHashes.end());
+    filter.setScripts = setWatchOnly;
+
+    // The scripts block filters are queried for: every standard form an
+    // output to one of our keys or scripts takes, as IsMine() accepts them.
+    filter.setElements.clear();
+    for (const auto& entry : mapKeys)
+        AddScanFilterKey(filter, entry.second.GetPubKey());
+    for (const auto& entry : mapCryptedKeys)
+        AddScanFilterKey(filter, entry.second.first);
+    for (const auto& entry : mapWatchKeys)
+        AddScanFilterKey(filter, entry.second);
+    for (const auto& entry : mapScripts) {
+        AddScanFilterElement(filter, entry.second);
+        AddScanFilterElement(filter, GetScriptForDestination(entry.first));
+        AddScanFilterElement(filter, GetScriptForWitness(entry.second));
+    }
+    for (const CScript& script : setWatchOnly)
+        AddScanFilterElement(filter, script);
+}
+
+CWalletRescanStats CWallet::GetRescanStats() const
+{
+    LOCK(cs_rescanStats);
+    CWalletRescanStats stats = rescanStats;
+    if (stats.fInProgress)
+        stats.nDuration = GetTimeMicros() - stats.nStartTime;
+    return stats;
+}
+
+namespace {
+/** A block on its way from the rescan readers to the thread adding its transactions to the wallet */
+struct CRescanBlock
+{
+    bool fDone = false;
+    //! the block filter index showed the block involves none of the wallet's scripts; not read
+    bool fSkipped = false;
+    bool fRead = false;
+    CBlock block;
+    //! per transaction: whether an output matched the filter
+    std::vector<bool> vMatch;
+    //! the filter used for vMatch
+    size_t nKeyStoreSize = 0;
+
+    void Match(const CWalletScanFilter& filter)
+    {
+        vMatch.resize(block.vtx.size());
+        for (size_t i = 0; i < block.vtx.size(); i++)
+            vMatch[i] = filter.MatchesTransaction(*block.vtx[i]);
+        nKeyStoreSize = filter.nKeyStoreSize;
+    }
+
+    void Read(const CBlockIndex* pindex, const CWalletScanFilter& filter)
+    {
+        fSkipped = false;
+        fRead = ReadBlockFromDisk(block, pindex, Params().GetConsensus());
+        if (fRead)
+            Match(filter);
+    }
+};
+
+/**
+ * Reads and matches a run of blocks on worker threads, up to
+ * WALLET_RESCAN_PREFETCH blocks ahead of the block being committed, so disk
+ * access and proof of work checks no longer stall the scan. Blocks are
+ * handed out in chain order by Next().
+ */
+class CRescanPipeline
+{
+public:
+    CRescanPipeline(const std::vector<CBlockIndex*>& vIndexIn, std::shared_ptr<const CWalletScanFilter> filterIn, int nThreads)
+        : vIndex(vIndexIn), vSlots(std::min<size_t>(vIndexIn.size(), WALLET_RESCAN_PREFETCH)), filter(filterIn)
+    {
+        for (int i = 0; i < nThreads && i < (int)vIndex.size(); i++)
+            threads.emplace_back(&TraceThread<std::function<void()>>, "rescan", std::function<void()>(std::bind(&CRescanPipeline::ThreadRead, this)));
+    }
+
+    ~CRescanPipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fStop = true;
+        }
+        cond.notify_all();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    /** Wait for the next block in chain order */
+    void Next(CRescanBlock& ret)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        CRescanBlock& slot = vSlots[nCommitted % vSlots.size()];
+        cond.wait(lock, [&slot] { return slot.fDone; });
+        ret = std::move(slot);
+        slot = CRescanBlock();
+        nCommitted++;
+        cond.notify_all();
+    }
+
+    /** Match blocks read from now on against an updated filter */
+    void SetFilter(std::shared_ptr<const CWalletScanFilter> filterIn)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        filter = filterIn;
+    }
+
+private:
+    const std::vector<CBlockIndex*>& vIndex;
+    std::vector<CRescanBlock> vSlots;
+    std::shared_ptr<const CWalletScanFilter> filter;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t nNextRead = 0;
+    size_t nCommitted = 0;
+    bool fStop = false;
+
+    void ThreadRead()
+    {
+        while (true) {
+            size_t nPos;
+            std::shared_ptr<const CWalletScanFilter> filterRead;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this] { return fStop || nNextRead >= vIndex.size() || nNextRead < nCommitted + vSlots.size(); });
+                if (fStop || nNextRead >= vIndex.size())
+                    return;
+                nPos = nNextRead++;
+                filterRead = filter;
+            }
+
+            CRescanBlock result;
+            BlockFilter blockFilter;
+            if (g_blockfilterindex && g_blockfilterindex->LookupFilter(vIndex[nPos], blockFilter) &&
+                !blockFilter.GetFilter().MatchAny(filterRead->setElements)) {
+                result.fSkipped = true;
+                result.nKeyStoreSize = filterRead->nKeyStoreSize;
+            } else {
+                result.Read(vIndex[nPos], *filterRead);
+            }
+            result.fDone = true;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                vSlots[nPos % vSlots.size()] = std::move(result);
+            }
+            cond.notify_all();
+        }
+    }
+};
+} // namespace
+
 /**
  * Scan the block chain (starting in pindexStart) for transactions
  * from or to us. If fUpdate is true, found transactions that already
@@ -1645,6 +1895,16 @@ int64_t CWallet::RescanFromTime(int64_t startTime, const WalletRescanReserver& r
  * Caller needs to make sure pindexStop (and the optional pindexStart) are on
  * the main chain after to the addition of any new keys you want to detect
  * transactions for.
+ *
+ * Blocks are read and matched against a snapshot of the wallet's keys and
+ * scripts by -rescanthreads worker threads, while this thread adds the
+ * transactions of interest to the wallet in chain order. Whenever that tops
+ * up the keypool the snapshot is refreshed, and blocks matched against the
+ * old one are matched again. With -blockfilterindex, blocks whose filter
+ * matches none of the wallet's scripts are not read at all; as the filter
+ * covers spent scripts too, this only misses transactions that neither pay
+ * nor spend the wallet, like conflicts on other inputs of a wallet spend
+ * confirmed in such a block.
  */
 CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlockIndex* pindexStop, const WalletRescanReserver &reserver, bool fUpdate)
 {
@@ -1656,6 +1916,14 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
         assert(pindexStop->nHeight >= pindexStart->nHeight);
     }
 
+    int nThreads = gArgs.GetArg("-rescanthreads", DEFAULT_RESCAN_THREADS);
+    if (nThreads <= 0)
+        nThreads = GetNumCores();
+    nThreads = std::max(1, std::min(nThreads, MAX_RESCAN_THREADS));
+
+    auto filter = std::make_shared<CWalletScanFilter>();
+    FillScanFilter(*filter);
+
     CBlockIndex* pindex = pindexStart;
     CBlockIndex* ret = nullptr;
     {
@@ -1670,40 +1938,109 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
             dProgressStart = GuessVerificationProgress(chainParams.TxData(), pindex);
             dProgressTip = GuessVerificationProgress(chainParams.TxData(), tip);
         }
-        while (pindex && !fAbortRescan)
         {
-            if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0) {
-                double gvp = 0;
-                {
-                    LOCK(cs_main);
-                    gvp = GuessVerificationProgress(chainParams.TxData(), pindex);
-                }
-                ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((gvp - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
-            }
-            if (GetTime() >= nNow + 60) {
-                nNow = GetTime();
+            LOCK(cs_rescanStats);
+            rescanStats = CWalletRescanStats();
+            rescanStats.fInProgress = true;
+            rescanStats.nStartHeight = pindexStart->nHeight;
+            rescanStats.nStopHeight = pindexStop ? pindexStop->nHeight : (tip ? tip->nHeight : -1);
+            rescanStats.nThreads = nThreads;
+            rescanStats.nStartTime = GetTimeMicros();
+        }
+        bool fFinished = false;
+        while (pindex && !fFinished && !fAbortRescan)
+        {
+            // Hand the blocks from pindex up to the stop block or the current
+            // tip to the pipeline; blocks connected meanwhile are picked up by
+            // the next round.
+            std::vector<CBlockIndex*> vIndex;
+            {
                 LOCK(cs_main);
-                LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
+                for (CBlockIndex* pindexNext = pindex; pindexNext; pindexNext = chainActive.Next(pindexNext)) {
+                    vIndex.push_back(pindexNext);
+                    if (pindexNext == pindexStop)
+                        break;
+                }
             }
 
-            CBlock block;
-            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                LOCK2(cs_main, cs_wallet);
-                if (pindex && !chainActive.Contains(pindex)) {
-                    // Abort scan if current block is no longer active, to prevent
-                    // marking transactions as coming from the wrong block.
+            CRescanPipeline pipeline(vIndex, filter, nThreads);
+            for (size_t nPos = 0; nPos < vIndex.size() && !fAbortRescan; nPos++)
+            {
+                pindex = vIndex[nPos];
+                if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0) {
+                    double gvp = 0;
+                    {
+                        LOCK(cs_main);
+                        gvp = GuessVerificationProgress(chainParams.TxData(), pindex);
+                    }
+                    ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((gvp - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
+                }
+                if (GetTime() >= nNow + 60) {
+                    nNow = GetTime();
+                    LOCK(cs_main);
+                    LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
+                }
+
+                CRescanBlock scanned;
+                pipeline.Next(scanned);
+                if (scanned.fSkipped && scanned.nKeyStoreSize != KeyStoreSize()) {
+                    // The keypool grew since the block filter was checked
+                    // against the wallet's scripts: look at the block after all
+                    scanned.Read(pindex, *filter);
+                }
+                if (scanned.fSkipped) {
+                    LOCK(cs_rescanStats);
+                    rescanStats.nHeight = pindex->nHeight;
+                    rescanStats.nBlocks++;
+                    rescanStats.nFiltered++;
+                } else if (scanned.fRead) {
+                    LOCK2(cs_main, cs_wallet);
+                    if (!chainActive.Contains(pindex)) {
+                        // Abort scan if current block is no longer active, to prevent
+                        // marking transactions as coming from the wrong block.
+                        ret = pindex;
+                        fFinished = true;
+                        break;
+                    }
+                    if (KeyStoreSize() != filter->nKeyStoreSize) {
+                        filter = std::make_shared<CWalletScanFilter>();
+                        FillScanFilter(*filter);
+                        pipeline.SetFilter(filter);
+                    }
+                    if (scanned.nKeyStoreSize != filter->nKeyStoreSize) {
+                        scanned.Match(*filter);
+                    }
+                    int64_t nMatched = 0;
+                    for (size_t posInBlock = 0; posInBlock < scanned.block.vtx.size(); ++posInBlock) {
+                        // Besides outputs paying us, AddToWalletIfInvolvingMe
+                        // only acts on transactions already in the wallet,
+                        // spending wallet transactions or conflicting with them
+                        const CTransactionRef& ptx = scanned.block.vtx[posInBlock];
+                        bool fInvolved = scanned.vMatch[posInBlock] || mapWallet.count(ptx->GetHash());
+                        for (size_t i = 0; !fInvolved && i < ptx->vin.size(); i++) {
+                            const COutPoint& prevout = ptx->vin[i].prevout;
+                            fInvolved = mapWallet.count(prevout.hash) || mapTxSpends.count(prevout);
+                        }
+                        if (fInvolved) {
+                            nMatched++;
+                            AddToWalletIfInvolvingMe(ptx, pindex, posInBlock, fUpdate);
+                            MarkBeeTableDirty(ptx->GetHash());
+                        }
+                    }
+                    LOCK(cs_rescanStats);
+                    rescanStats.nHeight = pindex->nHeight;
+                    rescanStats.nBlocks++;
+                    rescanStats.nMatched += nMatched;
+                } else {
                     ret = pindex;
-                    break;
                 }
-                for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    AddToWalletIfInvolvingMe(block.vtx[posInBlock], pindex, posInBlock, fUpdate);
+                if (pindex == pindexStop) {
+                    fFinished = true;
+                    break;
                 }
-            } else {
-                ret = pindex;
             }
-            if (pindex == pindexStop) {
+            if (fFinished || fAbortRescan)
                 break;
-            }
             {
                 LOCK(cs_main);
                 pindex = chainActive.Next(pindex);
@@ -1711,12 +2048,21 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, CBlock
                     tip = chainActive.Tip();
                     // in case the tip has changed, update progress max
                     dProgressTip = GuessVerificationProgress(chainParams.TxData(), tip);
+                    LOCK(cs_rescanStats);
+                    if (!pindexStop)
+                        rescanStats.nStopHeight = tip->nHeight;
                 }
             }
         }
         if (pindex && fAbortRescan) {
             LogPrintf("Rescan aborted at block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
         }
+        {
+            LOCK(cs_rescanStats);
+            rescanStats.fInProgress = false;
+            rescanStats.nDuration = GetTimeMicros() - rescanStats.nStartTime;
+            LogPrintf("Rescan of %d blocks took %.2fs using %d threads, %d blocks skipped by block filter, %d transactions matched\n", rescanStats.nBlocks, rescanStats.nDuration * 0.000001, rescanStats.nThreads, rescanStats.nFiltered, rescanStats.nMatched);
+        }
         ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
     }
     return ret;
@@ -1786,6 +2132,22 @@ std::set<uint256> CWalletTx::GetConflicts() const
     return result;
 }
 
+void CWalletTx::MarkDirty()
+{
+    fCreditCached = false;
+    fAvailableCreditCached = false;
+    fImmatureCreditCached = false;
+    fWatchDebitCached = false;
+    fWatchCreditCached = false;
+    fAvailableWatchCreditCached = false;
+    fImmatureWatchCreditCached = false;
+    fDebitCached = false;
+    fChangeCached = false;
+
+    if (pwallet != nullptr)
+        pwallet->MarkUnspentDirty(GetHash());
+}
+
 CAmount CWalletTx::GetDebit(const isminefilter& filter) const
 {
     if (tx->vin.empty())
@@ -2050,94 +2412,162 @@ void CWallet::ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman
  */
 
 
-CAmount CWallet::GetBalance() const
+void CWallet::MarkUnspentDirty(const uint256& hash) const
 {
-    CAmount nTotal = 0;
-    {
-        LOCK2(cs_main, cs_wallet);
-        for (const auto& entry : mapWallet)
-        {
-            const CWalletTx* pcoin = &entry.second;
-            if (pcoin->IsTrusted())
-                nTotal += pcoin->GetAvailableCredit();
-        }
+    LOCK(cs_wallet);
+    if (fUnspentValid)
+        setUnspentDirty.insert(hash);
+}
+
+void CWallet::IndexUnspent(const uint256& hash) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    auto it = mapWalletUnspent.lower_bound(COutPoint(hash, 0));
+    while (it != mapWalletUnspent.end() && it->first.hash == hash) {
+        setUnspentPending.erase(it->first);
+        it = mapWalletUnspent.erase(it);
     }
 
-    return nTotal;
+    auto mi = mapWallet.find(hash);
+    if (mi == mapWallet.end())
+        return;
+    const CWalletTx& wtx = mi->second;
+
+    // Conflicted transactions pay nothing; only a reorg (which rebuilds the
+    // whole index) can bring them back
+    const CBlockIndex* pindex = nullptr;
+    int nDepth = wtx.GetDepthInMainChain(pindex);
+    if (nDepth < 0)
+        return;
+
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+        const CTxOut& txout = wtx.tx->vout[i];
+        isminetype mine = IsMine(txout);
+        if (mine == ISMINE_NO || IsSpent(hash, i))
+            continue;
+
+        COutPoint outpoint(hash, i);
+        mapWalletUnspent.emplace(outpoint, CWalletUnspent(&wtx, txout.nValue, mine, nDepth > 0 ? pindex->nHeight : -1, wtx.IsCoinBase(), wtx.IsHiveCoinBase()));
+        if (nDepth == 0)
+            setUnspentPending.insert(outpoint);
+    }
 }
 
-CAmount CWallet::GetUnconfirmedBalance() const
+void CWallet::RefreshUnspent() const
 {
-    CAmount nTotal = 0;
-    {
-        LOCK2(cs_main, cs_wallet);
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    if (!fUnspentValid) {
+        mapWalletUnspent.clear();
+        setUnspentPending.clear();
         for (const auto& entry : mapWallet)
-        {
-            const CWalletTx* pcoin = &entry.second;
-            if (!pcoin->IsTrusted() && pcoin->GetDepthInMainChain() == 0 && pcoin->InMempool())
-                nTotal += pcoin->GetAvailableCredit();
-        }
+            IndexUnspent(entry.first);
+        fUnspentValid = true;
+    } else if (!setUnspentDirty.empty()) {
+        for (const uint256& hash : setUnspentDirty)
+            IndexUnspent(hash);
+    } else {
+        return;
     }
-    return nTotal;
+
+    setUnspentDirty.clear();
+    pindexBalances = nullptr;
 }
 
-CAmount CWallet::GetImmatureBalance() const
+/** Credit an unspent output at the given depth to its balance categories. */
+static void AddToBalances(CWalletBalances& balances, const CWalletUnspent& out, int nDepth, bool fTrusted)
 {
-    CAmount nTotal = 0;
-    {
-        LOCK2(cs_main, cs_wallet);
-        for (const auto& entry : mapWallet)
-        {
-            const CWalletTx* pcoin = &entry.second;
-            nTotal += pcoin->GetImmatureCredit();
+    const bool fSpendable = (out.mine & ISMINE_SPENDABLE) != ISMINE_NO;
+    const bool fWatchOnly = (out.mine & ISMINE_WATCH_ONLY) != ISMINE_NO;
+
+    if (nDepth < 0)
+        return;
+
+    // Must wait until coinbase is safely deep enough in the chain before valuing it
+    if (out.fCoinBase && (COINBASE_MATURITY + 1) - nDepth > 0) {
+        if (nDepth > 0) {
+            if (fSpendable) balances.nImmature += out.nValue;
+            if (fWatchOnly) balances.nWatchImmature += out.nValue;
         }
+        return;
+    }
+
+    if (fTrusted) {
+        if (fSpendable) balances.nTrusted += out.nValue;
+        if (fWatchOnly) balances.nWatchTrusted += out.nValue;
+    } else if (nDepth == 0 && out.wtx->InMempool()) {
+        if (fSpendable) balances.nUntrustedPending += out.nValue;
+        if (fWatchOnly) balances.nWatchUntrustedPending += out.nValue;
     }
-    return nTotal;
 }
 
-CAmount CWallet::GetWatchOnlyBalance() const
+CWalletBalances CWallet::GetBalances() const
 {
-    CAmount nTotal = 0;
-    {
-        LOCK2(cs_main, cs_wallet);
-        for (const auto& entry : mapWallet)
-        {
-            const CWalletTx* pcoin = &entry.second;
-            if (pcoin->IsTrusted())
-                nTotal += pcoin->GetAvailableWatchOnlyCredit();
+    LOCK2(cs_main, cs_wallet);
+    RefreshUnspent();
+
+    // Confirmed entries only change category as the tip moves
+    const int nTipHeight = chainActive.Height();
+    if (pindexBalances != chainActive.Tip()) {
+        cachedBalances = CWalletBalances();
+        for (const auto& entry : mapWalletUnspent) {
+            const CWalletUnspent& out = entry.second;
+            if (out.nHeight >= 0)
+                AddToBalances(cachedBalances, out, nTipHeight - out.nHeight + 1, true);
         }
+        pindexBalances = chainActive.Tip();
     }
 
-    return nTotal;
+    // Unconfirmed entries are few, and their mempool and trust state can
+    // change without a wallet notification, so classify them afresh
+    CWalletBalances balances = cachedBalances;
+    const CWalletTx* pcoin = nullptr;
+    int nDepth = 0;
+    bool fTrusted = false;
+    for (const COutPoint& outpoint : setUnspentPending) {
+        const CWalletUnspent& out = mapWalletUnspent.at(outpoint);
+        if (out.wtx != pcoin) {
+            pcoin = out.wtx;
+            nDepth = pcoin->GetDepthInMainChain();
+            fTrusted = pcoin->IsTrusted();
+        }
+        AddToBalances(balances, out, nDepth, fTrusted);
+    }
+
+    return balances;
+}
+
+CAmount CWallet::GetBalance() const
+{
+    return GetBalances().nTrusted;
+}
+
+CAmount CWallet::GetUnconfirmedBalance() const
+{
+    return GetBalances().nUntrustedPending;
+}
+
+CAmount CWallet::GetImmatureBalance() const
+{
+    return GetBalances().nImmature;
+}
+
+CAmount CWallet::GetWatchOnlyBalance() const
+{
+    return GetBalances().nWatchTrusted;
 }
 
 CAmount CWallet::GetUnconfirmedWatchOnlyBalance() const
 {
-    CAmount nTotal = 0;
-    {
-        LOCK2(cs_main, cs_wallet);
-        for (const auto& entry : mapWallet)
-        {
-            const CWalletTx* pcoin = &entry.second;
-            if (!pcoin->IsTrusted() && pcoin->GetDepthInMainChain() == 0 && pcoin->InMempool())
-                nTotal += pcoin->GetAvailableWatchOnlyCredit();
-        }
-    }
-    return nTotal;
+    return GetBalances().nWatchUntrustedPending;
 }
 
 CAmount CWallet::GetImmatureWatchOnlyBalance() const
 {
-    CAmount nTotal = 0;
-    {
-        LOCK2(cs_main, cs_wallet);
-        for (const auto& entry : mapWallet)
-        {
-            const CWalletTx* pcoin = &entry.second;
-            nTotal += pcoin->GetImmatureWatchOnlyCredit();
-        }
-    }
-    return nTotal;
+    return GetBalances().nWatchImmature;
 }
 
 // Calculate total balance in a different way from GetBalance. The biggest
@@ -2207,104 +2637,115 @@ void CWallet::AvailableCoins(std::vector<COutput> &vCoins, bool fOnlySafe, const
 
         CAmount nTotal = 0;
 
-        for (const auto& entry : mapWallet)
+        RefreshUnspent();
+        const int nTipHeight = chainActive.Height();
+
+        // Entries are ordered by outpoint, so the outputs of each transaction
+        // are adjacent and the per-transaction checks run once per transaction
+        const CWalletTx* pcoin = nullptr;
+        int nDepth = 0;
+        bool safeTx = false;
+        bool fSkipTx = true;
+
+        for (const auto& entry : mapWalletUnspent)
         {
-            const uint256& wtxid = entry.first;
-            const CWalletTx* pcoin = &entry.second;
+            const COutPoint& outpoint = entry.first;
+            const CWalletUnspent& out = entry.second;
 
-            if (!CheckFinalTx(*pcoin->tx))
-                continue;
+            if (out.wtx != pcoin) {
+                pcoin = out.wtx;
+                nDepth = out.nHeight >= 0 ? nTipHeight - out.nHeight + 1 : pcoin->GetDepthInMainChain();
+                fSkipTx = true;
 
-            if (pcoin->IsCoinBase() && pcoin->GetBlocksToMaturity() > 0)
-                continue;
+                // Transactions already in a block are final
+                if (nDepth == 0 && !CheckFinalTx(*pcoin->tx))
+                    continue;
 
-            int nDepth = pcoin->GetDepthInMainChain();
-            if (nDepth < 0)
-                continue;
+                if (pcoin->IsCoinBase() && (COINBASE_MATURITY + 1) - nDepth > 0)
+                    continue;
 
-            // We should not consider coins which aren't at least in our mempool
-            // It's possible for these to be conflicted via ancestors which we may never be able to detect
-            if (nDepth == 0 && !pcoin->InMempool())
-                continue;
+                if (nDepth < 0)
+                    continue;
 
-            bool safeTx = pcoin->IsTrusted();
-
-            // We should not consider coins from transactions that are replacing
-            // other transactions.
-            //
-            // Example: There is a transaction A which is replaced by bumpfee
-            // transaction B. In this case, we want to prevent creation of
-            // a transaction B' which spends an output of B.
-            //
-            // Reason: If transaction A were initially confirmed, transactions B
-            // and B' would no longer be valid, so the user would have to create
-            // a new transaction C to replace B'. However, in the case of a
-            // one-block reorg, transactions B' and C might BOTH be accepted,
-            // when the user only wanted one of them. Specifically, there could
-            // be a 1-block reorg away from the chain where transactions A and C
-            // were accepted to another chain where B, B', and C were all
-            // accepted.
-            if (nDepth == 0 && pcoin->mapValue.count("replaces_txid")) {
-                safeTx = false;
-            }
+                // We should not consider coins which aren't at least in our mempool
+                // It's possible for these to be conflicted via ancestors which we may never be able to detect
+                if (nDepth == 0 && !pcoin->InMempool())
+                    continue;
 
-            // Similarly, we should not consider coins from transactions that
-            // have been replaced. In the example above, we would want to prevent
-            // creation of a transaction A' spending an output of A, because if
-            // transaction B were initially confirmed, conflicting with A and
-            // A', we wouldn't want to the user to create a transaction D
-            // intending to replace A', but potentially resulting in a scenario
-            // where A, A', and D could all be accepted (instead of just B and
-            // D, or just A and A' like the user would want).
-            if (nDepth == 0 && pcoin->mapValue.count("replaced_by_txid")) {
-                safeTx = false;
-            }
+                safeTx = pcoin->IsTrusted();
 
-            if (fOnlySafe && !safeTx) {
-                continue;
-            }
+                // We should not consider coins from transactions that are replacing
+                // other transactions.
+                //
+                // Example: There is a transaction A which is replaced by bumpfee
+                // transaction B. In this case, we want to prevent creation of
+                // a transaction B' which spends an output of B.
+                //
+                // Reason: If transaction A were initially confirmed, transactions B
+                // and B' would no longer be valid, so the user would have to create
+                // a new transaction C to replace B'. However, in the case of a
+                // one-block reorg, transactions B' and C might BOTH be accepted,
+                // when the user only wanted one of them. Specifically, there could
+                // be a 1-block reorg away from the chain where transactions A and C
+                // were accepted to another chain where B, B', and C were all
+                // accepted.
+                if (nDepth == 0 && pcoin->mapValue.count("replaces_txid")) {
+                    safeTx = false;
+                }
 
-            if (nDepth < nMinDepth || nDepth > nMaxDepth)
-                continue;
+                // Similarly, we should not consider coins from transactions that
+                // have been replaced. In the example above, we would want to prevent
+                // creation of a transaction A' spending an output of A, because if
+                // transaction B were initially confirmed, conflicting with A and
+                // A', we wouldn't want to the user to create a transaction D
+                // intending to replace A', but potentially resulting in a scenario
+                // where A, A', and D could all be accepted (instead of just B and
+                // D, or just A and A' like the user would want).
+                if (nDepth == 0 && pcoin->mapValue.count("replaced_by_txid")) {
+                    safeTx = false;
+                }
 
-            for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
-                if (pcoin->tx->vout[i].nValue < nMinimumAmount || pcoin->tx->vout[i].nValue > nMaximumAmount)
+                if (fOnlySafe && !safeTx) {
                     continue;
+                }
 
-                if (coinControl && coinControl->HasSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsSelected(COutPoint(entry.first, i)))
+                if (nDepth < nMinDepth || nDepth > nMaxDepth)
                     continue;
 
-                if (IsLockedCoin(entry.first, i))
-                    continue;
+                fSkipTx = false;
+            }
 
-                if (IsSpent(wtxid, i))
-                    continue;
+            if (fSkipTx)
+                continue;
 
-                isminetype mine = IsMine(pcoin->tx->vout[i]);
+            if (out.nValue < nMinimumAmount || out.nValue > nMaximumAmount)
+                continue;
 
-                if (mine == ISMINE_NO) {
-                    continue;
-                }
+            if (coinControl && coinControl->HasSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsSelected(outpoint))
+                continue;
 
-                bool fSpendableIn = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) || (coinControl && coinControl->fAllowWatchOnly && (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO);
-                bool fSolvableIn = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO;
+            if (IsLockedCoin(outpoint.hash, outpoint.n))
+                continue;
 
-                vCoins.push_back(COutput(pcoin, i, nDepth, fSpendableIn, fSolvableIn, safeTx));
+            const isminetype mine = out.mine;
+            bool fSpendableIn = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) || (coinControl && coinControl->fAllowWatchOnly && (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO);
+            bool fSolvableIn = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO;
 
-                // Checks the sum amount of all UTXO's.
-                if (nMinimumSumAmount != MAX_MONEY) {
-                    nTotal += pcoin->tx->vout[i].nValue;
+            vCoins.push_back(COutput(pcoin, outpoint.n, nDepth, fSpendableIn, fSolvableIn, safeTx));
 
-                    if (nTotal >= nMinimumSumAmount) {
-                        return;
-                    }
-                }
+            // Checks the sum amount of all UTXO's.
+            if (nMinimumSumAmount != MAX_MONEY) {
+                nTotal += out.nValue;
 
-                // Checks the maximum number of UTXO's.
-                if (nMaximumCount > 0 && vCoins.size() >= nMaximumCount) {
+                if (nTotal >= nMinimumSumAmount) {
                     return;
                 }
             }
+
+            // Checks the maximum number of UTXO's.
+            if (nMaximumCount > 0 && vCoins.size() >= nMaximumCount) {
+                return;
+            }
         }
     }
 }
@@ -2418,19 +2859,120 @@ static void ApproximateBestSubset(const std::vector<CInputCoin>& vValue, const C
     }
 }
 
-bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, std::vector<COutput> vCoins,
-                                 std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const
+struct CompareEffectiveValueDescending
+{
+    bool operator()(const CInputCoin& t1,
+                    const CInputCoin& t2) const
+    {
+        return t1.effective_value > t2.effective_value;
+    }
+};
+
+//! maximum number of nodes visited by the branch-and-bound search
+static const size_t BNB_TOTAL_TRIES = 100000;
+
+bool SelectCoinsBnB(std::vector<CInputCoin>& vUtxoPool, const CAmount& nTargetValue, const CAmount& nCostOfChange,
+                    std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet)
 {
     setCoinsRet.clear();
     nValueRet = 0;
 
-    // List of values less than target
-    boost::optional<CInputCoin> coinLowestLarger;
-    std::vector<CInputCoin> vValue;
-    CAmount nTotalLower = 0;
+    CAmount nAvailable = 0;
+    for (const CInputCoin& coin : vUtxoPool) {
+        assert(coin.effective_value > 0);
+        nAvailable += coin.effective_value;
+    }
+    if (nAvailable < nTargetValue)
+        return false;
+
+    // Exploring the largest coins first reaches the target quickly and lets
+    // the search prune on overshoot early.
+    std::sort(vUtxoPool.begin(), vUtxoPool.end(), CompareEffectiveValueDescending());
+
+    std::vector<bool> vfSelected;
+    vfSelected.reserve(vUtxoPool.size());
+    std::vector<bool> vfBest;
+    CAmount nSelected = 0;
+    CAmount nBestExcess = MAX_MONEY;
 
-    random_shuffle(vCoins.begin(), vCoins.end(), GetRandInt);
+    for (size_t nTries = 0; nTries < BNB_TOTAL_TRIES; nTries++)
+    {
+        bool fBacktrack = false;
+        if (nSelected + nAvailable < nTargetValue || nSelected > nTargetValue + nCostOfChange) {
+            // Either the target can no longer be reached down this branch or we overshot it
+            fBacktrack = true;
+        } else if (nSelected >= nTargetValue) {
+            if (nSelected - nTargetValue < nBestExcess) {
+                nBestExcess = nSelected - nTargetValue;
+                vfBest = vfSelected;
+                vfBest.resize(vUtxoPool.size());
+                if (nBestExcess == 0)
+                    break;
+            }
+            fBacktrack = true;
+        }
+
+        if (fBacktrack) {
+            // Walk back to the last included coin and try the branch without it
+            while (!vfSelected.empty() && !vfSelected.back()) {
+                vfSelected.pop_back();
+                nAvailable += vUtxoPool[vfSelected.size()].effective_value;
+            }
+            if (vfSelected.empty())
+                break; // whole tree explored
+            vfSelected.back() = false;
+            nSelected -= vUtxoPool[vfSelected.size() - 1].effective_value;
+        } else {
+            const CInputCoin& coin = vUtxoPool[vfSelected.size()];
+            nAvailable -= coin.effective_value;
+            // Including a coin equal in value to one we just excluded can only
+            // repeat an already explored subtree; honey-heavy wallets hold
+            // long runs of identical outputs, so this prunes most of the tree.
+            if (!vfSelected.empty() && !vfSelected.back() &&
+                coin.effective_value == vUtxoPool[vfSelected.size() - 1].effective_value) {
+                vfSelected.push_back(false);
+            } else {
+                vfSelected.push_back(true);
+                nSelected += coin.effective_value;
+            }
+        }
+    }
+
+    if (vfBest.empty())
+        return false;
 
+    for (size_t i = 0; i < vfBest.size(); i++) {
+        if (vfBest[i]) {
+            setCoinsRet.insert(vUtxoPool[i]);
+            nValueRet += vUtxoPool[i].txout.nValue;
+        }
+    }
+    return true;
+}
+
+/** Virtual size of the input spending coin once signed, or -1 if we cannot produce a signature for it. */
+static int CalculateMaximumSignedInputSize(const CWallet* pwallet, const CInputCoin& coin)
+{
+    CMutableTransaction txn;
+    txn.vin.push_back(CTxIn(coin.outpoint));
+    if (!pwallet->DummySignTx(txn, std::vector<CInputCoin>{coin}))
+        return -1;
+    int64_t nBaseSize = ::GetSerializeSize(txn.vin[0], SER_NETWORK, PROTOCOL_VERSION);
+    int64_t nWitnessSize = txn.vin[0].scriptWitness.IsNull() ? 0 : ::GetSerializeSize(txn.vin[0].scriptWitness.stack, SER_NETWORK, PROTOCOL_VERSION);
+    return (nBaseSize * WITNESS_SCALE_FACTOR + nWitnessSize + WITNESS_SCALE_FACTOR - 1) / WITNESS_SCALE_FACTOR;
+}
+
+bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, const int nConfMine, const int nConfTheirs, const uint64_t nMaxAncestors, const std::vector<COutput>& vCoins,
+                                 std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet, const CoinSelectionParams* params, bool* pfBnBUsed) const
+{
+    setCoinsRet.clear();
+    nValueRet = 0;
+    if (pfBnBUsed)
+        *pfBnBUsed = false;
+
+    // Filter once, then shuffle only the eligible coins
+    std::vector<CInputCoin> vEligible;
+    vEligible.reserve(vCoins.size());
     for (const COutput &output : vCoins)
     {
         if (!output.fSpendable)
@@ -2441,13 +2983,49 @@ bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, const int nConfMin
         if (output.nDepth < (pcoin->IsFromMe(ISMINE_ALL) ? nConfMine : nConfTheirs))
             continue;
 
-        if (!mempool.TransactionWithinChainLimit(pcoin->GetHash(), nMaxAncestors))
+        // Confirmed coins have no in-mempool ancestors to count
+        if (output.nDepth == 0 && !mempool.TransactionWithinChainLimit(pcoin->GetHash(), nMaxAncestors))
             continue;
 
-        int i = output.i;
+        vEligible.emplace_back(pcoin, output.i);
+    }
 
-        CInputCoin coin = CInputCoin(pcoin, i);
+    random_shuffle(vEligible.begin(), vEligible.end(), GetRandInt);
 
+    if (params && params->effective_fee.GetFeePerK() > 0) {
+        // Drop coins that cost more to spend than they are worth; input sizes
+        // only depend on the script, so sign each distinct script once.
+        std::map<CScript, int> mapInputSize;
+        std::vector<CInputCoin> vPositive;
+        vPositive.reserve(vEligible.size());
+        for (CInputCoin& coin : vEligible) {
+            auto it = mapInputSize.find(coin.txout.scriptPubKey);
+            if (it == mapInputSize.end())
+                it = mapInputSize.emplace(coin.txout.scriptPubKey, CalculateMaximumSignedInputSize(this, coin)).first;
+            if (it->second > 0)
+                coin.effective_value = coin.txout.nValue - params->effective_fee.GetFee(it->second);
+            if (coin.effective_value > 0)
+                vPositive.push_back(std::move(coin));
+        }
+        vEligible.swap(vPositive);
+    }
+
+    if (params && params->use_bnb) {
+        std::vector<CInputCoin> vPool(vEligible);
+        if (SelectCoinsBnB(vPool, nTargetValue + params->nFeeNoInputs, params->nCostOfChange, setCoinsRet, nValueRet)) {
+            if (pfBnBUsed)
+                *pfBnBUsed = true;
+            return true;
+        }
+    }
+
+    // List of values less than target
+    boost::optional<CInputCoin> coinLowestLarger;
+    std::vector<CInputCoin> vValue;
+    CAmount nTotalLower = 0;
+
+    for (const CInputCoin& coin : vEligible)
+    {
         if (coin.txout.nValue == nTargetValue)
         {
             setCoinsRet.insert(coin);
@@ -2484,15 +3062,28 @@ bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, const int nConfMin
         return true;
     }
 
-    // Solve subset sum by stochastic approximation
     std::sort(vValue.begin(), vValue.end(), CompareValueOnly());
     std::reverse(vValue.begin(), vValue.end());
     std::vector<char> vfBest;
     CAmount nBest;
 
-    ApproximateBestSubset(vValue, nTotalLower, nTargetValue, vfBest, nBest);
-    if (nBest != nTargetValue && nTotalLower >= nTargetValue + MIN_CHANGE)
-        ApproximateBestSubset(vValue, nTotalLower, nTargetValue + MIN_CHANGE, vfBest, nBest);
+    if (params && params->effective_fee > params->consolidate_fee) {
+        // Fees are high: take the fewest inputs that cover the target
+        // (largest first) rather than sweeping small outputs now.
+        vfBest.assign(vValue.size(), false);
+        nBest = 0;
+        for (unsigned int i = 0; i < vValue.size() && nBest < nTargetValue + MIN_CHANGE; i++) {
+            vfBest[i] = true;
+            nBest += vValue[i].txout.nValue;
+        }
+    } else {
+        // Solve subset sum by stochastic approximation, with the number of
+        // passes bounded so that huge wallets do a fixed amount of work.
+        int nIterations = std::max<int>(1, std::min<size_t>(1000, MAX_APPROXIMATE_BEST_SUBSET_VISITS / vValue.size()));
+        ApproximateBestSubset(vValue, nTotalLower, nTargetValue, vfBest, nBest, nIterations);
+        if (nBest != nTargetValue && nTotalLower >= nTargetValue + MIN_CHANGE)
+            ApproximateBestSubset(vValue, nTotalLower, nTargetValue + MIN_CHANGE, vfBest, nBest, nIterations);
+    }
 
     // If we have a bigger coin and (either the stochastic approximation didn't find a good solution,
     //                                   or the next bigger coin is closer), return the bigger coin
@@ -2524,14 +3115,16 @@ bool CWallet::SelectCoinsMinConf(const CAmount& nTargetValue, const int nConfMin
     return true;
 }
 
-bool CWallet::SelectCoins(const std::vector<COutput>& vAvailableCoins, const CAmount& nTargetValue, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet, const CCoinControl* coinControl) const
+bool CWallet::SelectCoins(const std::vector<COutput>& vAvailableCoins, const CAmount& nTargetValue, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet, const CCoinControl* coinControl,
+                          const CoinSelectionParams* params, bool* pfBnBUsed) const
 {
-    std::vector<COutput> vCoins(vAvailableCoins);
+    if (pfBnBUsed)
+        *pfBnBUsed = false;
 
     // coin control -> return all selected outputs (we want all selected to go into the transaction for sure)
     if (coinControl && coinControl->HasSelected() && !coinControl->fAllowOtherInputs)
     {
-        for (const COutput& out : vCoins)
+        for (const COutput& out : vAvailableCoins)
         {
             if (!out.fSpendable)
                  continue;
@@ -2563,26 +3156,28 @@ bool CWallet::SelectCoins(const std::vector<COutput>& vAvailableCoins, const CAm
             return false; // TODO: Allow non-wallet inputs
     }
 
-    // remove preset inputs from vCoins
-    for (std::vector<COutput>::iterator it = vCoins.begin(); it != vCoins.end() && coinControl && coinControl->HasSelected();)
-    {
-        if (setPresetCoins.count(CInputCoin(it->tx, it->i)))
-            it = vCoins.erase(it);
-        else
-            ++it;
+    // remove preset inputs from the candidates; only copy the list when there is something to remove
+    std::vector<COutput> vFiltered;
+    if (!setPresetCoins.empty()) {
+        vFiltered.reserve(vAvailableCoins.size());
+        for (const COutput& out : vAvailableCoins) {
+            if (!setPresetCoins.count(CInputCoin(out.tx, out.i)))
+                vFiltered.push_back(out);
+        }
     }
+    const std::vector<COutput>& vCoins = setPresetCoins.empty() ? vAvailableCoins : vFiltered;
 
     size_t nMaxChainLength = std::min(gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT), gArgs.GetArg("-limitdescendantcount", DEFAULT_DESCENDANT_LIMIT));
     bool fRejectLongChains = gArgs.GetBoolArg("-walletrejectlongchains", DEFAULT_WALLET_REJECT_LONG_CHAINS);
 
     bool res = nTargetValue <= nValueFromPresetInputs ||
-        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 6, 0, vCoins, setCoinsRet, nValueRet) ||
-        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 1, 0, vCoins, setCoinsRet, nValueRet) ||
-        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, 2, vCoins, setCoinsRet, nValueRet)) ||
-        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, std::min((size_t)4, nMaxChainLength/3), vCoins, setCoinsRet, nValueRet)) ||
-        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, nMaxChainLength/2, vCoins, setCoinsRet, nValueRet)) ||
-        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, nMaxChainLength, vCoins, setCoinsRet, nValueRet)) ||
-        (bSpendZeroConfChange && !fRejectLongChains && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, std::numeric_limits<uint64_t>::max(), vCoins, setCoinsRet, nValueRet));
+        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 6, 0, vCoins, setCoinsRet, nValueRet, params, pfBnBUsed) ||
+        SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 1, 1, 0, vCoins, setCoinsRet, nValueRet, params, pfBnBUsed) ||
+        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, 2, vCoins, setCoinsRet, nValueRet, params, pfBnBUsed)) ||
+        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, std::min((size_t)4, nMaxChainLength/3), vCoins, setCoinsRet, nValueRet, params, pfBnBUsed)) ||
+        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, nMaxChainLength/2, vCoins, setCoinsRet, nValueRet, params, pfBnBUsed)) ||
+        (bSpendZeroConfChange && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, nMaxChainLength, vCoins, setCoinsRet, nValueRet, params, pfBnBUsed)) ||
+        (bSpendZeroConfChange && !fRejectLongChains && SelectCoinsMinConf(nTargetValue - nValueFromPresetInputs, 0, 1, std::numeric_limits<uint64_t>::max(), vCoins, setCoinsRet, nValueRet, params, pfBnBUsed));
 
     // because SelectCoinsMinConf clears the setCoinsRet, we now add the possible inputs to the coinset
     setCoinsRet.insert(setPresetCoins.begin(), setPresetCoins.end());
@@ -2838,6 +3433,286 @@ std::vector<CBeeCreationTransactionInfo> CWallet::GetBCTs(bool includeDead, bool
     return bcts;
 }
 
+void CBeeTable::Add(const CBeeTableEntry& entry)
+{
+    Remove(entry.txid);
+    auto it = std::upper_bound(vEntries.begin(), vEntries.end(), entry, [](const CBeeTableEntry& a, const CBeeTableEntry& b) {
+        return a.nHeight < b.nHeight || (a.nHeight == b.nHeight && a.txid < b.txid);
+    });
+    vEntries.insert(it, entry);
+    mapHeights[entry.txid] = entry.nHeight;
+}
+
+void CBeeTable::Remove(const uint256& txid)
+{
+    auto mi = mapHeights.find(txid);
+    if (mi == mapHeights.end())
+        return;
+    auto it = std::lower_bound(vEntries.begin(), vEntries.end(), mi->second, [](const CBeeTableEntry& entry, int nHeight) {
+        return entry.nHeight < nHeight;
+    });
+    while (it->txid != txid)
+        ++it;
+    vEntries.erase(it);
+    mapHeights.erase(mi);
+}
+
+void CBeeTable::Clear()
+{
+    vEntries.clear();
+    mapHeights.clear();
+}
+
+int CBeeTable::GetBins(int nTipHeight, int nBins, std::vector<std::vector<CBeeRange>>& vBins) const
+{
+    vBins.clear();
+
+    // Maturity and expiry heights rise with the block height, like the table
+    auto itBegin = std::lower_bound(vEntries.begin(), vEntries.end(), nTipHeight, [](const CBeeTableEntry& entry, int nHeight) {
+        return entry.nExpiryHeight < nHeight;
+    });
+    auto itEnd = std::upper_bound(itBegin, vEntries.end(), nTipHeight, [](int nHeight, const CBeeTableEntry& entry) {
+        return nHeight < entry.nMatureHeight;
+    });
+
+    int nTotalBees = 0;
+    for (auto it = itBegin; it != itEnd; ++it)
+        nTotalBees += it->beeCount;
+    if (nTotalBees == 0)
+        return 0;
+
+    int nBeesPerBin = (nTotalBees + std::max(nBins, 1) - 1) / std::max(nBins, 1);
+    int nBeesInBin = nBeesPerBin;
+    for (auto it = itBegin; it != itEnd; ++it) {
+        int nOffset = 0;
+        while (nOffset < it->beeCount) {
+            if (nBeesInBin == nBeesPerBin) {
+                vBins.emplace_back();
+                nBeesInBin = 0;
+            }
+            int nCount = std::min(it->beeCount - nOffset, nBeesPerBin - nBeesInBin);
+            vBins.back().push_back({it->txid, it->honeyDestination, it->communityContrib, nOffset, nCount});
+            nOffset += nCount;
+            nBeesInBin += nCount;
+        }
+    }
+    return nTotalBees;
+}
+
+// Maza: Hive: Re-index one transaction in the BCT table, reading it as GetBCT() does
+void CWallet::IndexBeeTable(const uint256& hash, const CScript& scriptPubKeyBCF, const CScript& scriptPubKeyCF) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    beeTable.Remove(hash);
+
+    auto mi = mapWallet.find(hash);
+    if (mi == mapWallet.end())
+        return;
+    const CWalletTx& wtx = mi->second;
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CAmount beeFeePaid;
+    CScript scriptPubKeyHoney;
+    if (wtx.IsCoinBase() || !wtx.tx->IsBCT(consensusParams, scriptPubKeyBCF, &beeFeePaid, &scriptPubKeyHoney))
+        return;
+    const CBlockIndex* pindex = nullptr;
+    if (wtx.GetDepthInMainChain(pindex) < 1 || !IsAllFromMe(*wtx.tx, ISMINE_SPENDABLE))
+        return;
+
+    CBeeTableEntry entry;
+    if (!ExtractDestination(scriptPubKeyHoney, entry.honeyDestination))
+        return;
+    entry.txid = hash;
+    entry.communityContrib = false;
+    if (wtx.tx->vout.size() > 1 && wtx.tx->vout[1].scriptPubKey == scriptPubKeyCF) {
+        beeFeePaid += wtx.tx->vout[1].nValue;
+        entry.communityContrib = true;
+    }
+    // GetBCT prices bees as of the block before the BCT's
+    entry.beeCount = beeFeePaid / GetBeeCost(pindex->nHeight - 1, consensusParams);
+    entry.nHeight = pindex->nHeight;
+    entry.nMatureHeight = pindex->nHeight + consensusParams.beeGestationBlocks;
+    entry.nExpiryHeight = pindex->nHeight + consensusParams.beeGestationBlocks + consensusParams.beeLifespanBlocks - 1;
+    beeTable.Add(entry);
+}
+
+// Maza: Hive: Note a wallet transaction for RefreshBeeTable() to re-index. Nothing
+// refreshes the table without hive mining, so past a limit the list is dropped
+// for a full rebuild on next use.
+void CWallet::MarkBeeTableDirty(const uint256& hash)
+{
+    AssertLockHeld(cs_wallet);
+
+    if (!fBeeTableValid || !mapWallet.count(hash))
+        return;
+    if (setBeeTableDirty.size() >= MAX_BEE_TABLE_DIRTY) {
+        fBeeTableValid = false;
+        setBeeTableDirty.clear();
+        return;
+    }
+    setBeeTableDirty.insert(hash);
+}
+
+void CWallet::RefreshBeeTable() const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    if (fBeeTableValid && setBeeTableDirty.empty())
+        return;
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.beeCreationAddress));
+    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
+    if (!fBeeTableValid) {
+        beeTable.Clear();
+        for (const auto& entry : mapWallet)
+            IndexBeeTable(entry.first, scriptPubKeyBCF, scriptPubKeyCF);
+        fBeeTableValid = true;
+    } else {
+        for (const uint256& hash : setBeeTableDirty)
+            IndexBeeTable(hash, scriptPubKeyBCF, scriptPubKeyCF);
+    }
+    setBeeTableDirty.clear();
+}
+
+int CWallet::GetBeeBins(int nTipHeight, int nBins, std::vector<std::vector<CBeeRange>>& vBins) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    RefreshBeeTable();
+    return beeTable.GetBins(nTipHeight, nBins, vBins);
+}
+
+// Maza: Hive: Return spendable mature honey outputs, smallest first
+std::vector<CInputCoin> CWallet::GetMatureHoney() const
+{
+    std::vector<CInputCoin> vHoney;
+
+    LOCK2(cs_main, cs_wallet);
+    RefreshUnspent();
+    const int nTipHeight = chainActive.Height();
+    for (const auto& entry : mapWalletUnspent) {
+        const CWalletUnspent& out = entry.second;
+        if (!out.fHoney || out.nHeight < 0)
+            continue;
+        if ((COINBASE_MATURITY + 1) - (nTipHeight - out.nHeight + 1) > 0)
+            continue;
+        if ((out.mine & ISMINE_SPENDABLE) == ISMINE_NO || IsLockedCoin(entry.first.hash, entry.first.n))
+            continue;
+        vHoney.emplace_back(out.wtx, entry.first.n);
+    }
+    std::sort(vHoney.begin(), vHoney.end(), CompareValueOnly());
+    return vHoney;
+}
+
+static_assert(MAX_HONEY_CONSOLIDATE_BATCH * 148 * WITNESS_SCALE_FACTOR < MAX_STANDARD_TX_WEIGHT, "honey consolidation batch must fit in a standard transaction");
+
+std::vector<CInputCoin> SelectHoneyBatch(const std::vector<CInputCoin>& vHoney, unsigned int nBatchSize)
+{
+    // Sweep the smallest outputs first: they are the ones that cost the most
+    // to spend later relative to their value
+    size_t nCount = std::min<size_t>(vHoney.size(), std::min(nBatchSize, MAX_HONEY_CONSOLIDATE_BATCH));
+    return std::vector<CInputCoin>(vHoney.begin(), vHoney.begin() + nCount);
+}
+
+CFeeRate GetHoneyConsolidationFeeRate(const CFeeRate& estimate)
+{
+    // Without estimator data the fee level is unknown, not low
+    CFeeRate feeRate = estimate == CFeeRate(0) ? CWallet::fallbackFee : estimate;
+    if (feeRate == CFeeRate(0))
+        return feeRate;
+    return std::max(feeRate, CFeeRate(GetRequiredFee(1000)));
+}
+
+// Maza: Hive: Sweep a batch of mature honey into one output if enabled and fees are low enough
+bool CWallet::ConsolidateHoney()
+{
+    LOCK2(cs_main, cs_wallet);
+    CHoneyConsolidationState& state = honeyConsolidation;
+    if (!state.fEnabled)
+        return false;
+
+    state.nLastCheck = GetTime();
+    if (IsInitialBlockDownload()) {
+        state.strLastResult = "waiting for initial block download";
+        return false;
+    }
+    if (IsLocked() || fWalletUnlockHiveMiningOnly) {
+        state.strLastResult = "wallet is locked";
+        return false;
+    }
+
+    // Consolidation is never urgent, so ask for an economical long-horizon
+    // estimate
+    FeeCalculation feeCalc;
+    CFeeRate feeRate = GetHoneyConsolidationFeeRate(::feeEstimator.estimateSmartFee(HONEY_CONSOLIDATE_CONF_TARGET, &feeCalc, false /* conservative */));
+    state.lastFeeRate = feeRate;
+    if (feeRate == CFeeRate(0)) {
+        state.strLastResult = "no fee estimate available and -fallbackfee is disabled";
+        return false;
+    }
+    if (feeRate > state.maxFeeRate) {
+        state.strLastResult = strprintf("estimated feerate %s is above the limit of %s", feeRate.ToString(), state.maxFeeRate.ToString());
+        return false;
+    }
+
+    std::vector<CInputCoin> vHoney = GetMatureHoney();
+    if (vHoney.size() < state.nMinInputs || vHoney.size() < 2) {
+        state.strLastResult = strprintf("%u mature honey outputs, waiting for %u", vHoney.size(), std::max(state.nMinInputs, 2u));
+        return false;
+    }
+    vHoney = SelectHoneyBatch(vHoney, state.nBatchSize);
+
+    CCoinControl coin_control;
+    coin_control.m_feerate = feeRate;
+    CAmount nAmount = 0;
+    for (const CInputCoin& coin : vHoney) {
+        coin_control.Select(coin.outpoint);
+        nAmount += coin.txout.nValue;
+    }
+
+    CScript scriptDest = state.scriptDest.empty() ? vHoney.front().txout.scriptPubKey : state.scriptDest;
+    std::vector<CRecipient> vecSend = {{scriptDest, nAmount, true /* fSubtractFeeFromAmount */}};
+
+    CWalletTx wtx;
+    CReserveKey reservekey(this);
+    CAmount nFeeRequired;
+    int nChangePos = -1;
+    std::string strError;
+    if (!CreateTransaction(vecSend, wtx, reservekey, nFeeRequired, nChangePos, strError, coin_control)) {
+        state.strLastResult = "failed to create transaction: " + strError;
+        LogPrintf("%s: %s\n", __func__, state.strLastResult);
+        return false;
+    }
+    CValidationState validationState;
+    if (!CommitTransaction(wtx, reservekey, g_connman.get(), validationState)) {
+        state.strLastResult = "transaction was rejected: " + FormatStateMessage(validationState);
+        LogPrintf("%s: %s\n", __func__, state.strLastResult);
+        return false;
+    }
+
+    state.nTransactions++;
+    state.nInputs += vHoney.size();
+    state.nAmount += nAmount;
+    state.nFees += nFeeRequired;
+    state.lastTxid = wtx.GetHash();
+    state.strLastResult = strprintf("consolidated %u honey outputs in %s", vHoney.size(), wtx.GetHash().ToString());
+    LogPrintf("%s: %s (%s, fee %s)\n", __func__, state.strLastResult, FormatMoney(nAmount), FormatMoney(nFeeRequired));
+    return true;
+}
+
+// Maza: Hive: Scheduler task giving each wallet a chance to consolidate its honey
+static void MaybeConsolidateHoney()
+{
+    for (CWallet* pwallet : vpwallets) {
+        pwallet->ConsolidateHoney();
+    }
+}
+
 // Maza: Hive: Create a BCT to gestate given number of bees
 bool CWallet::CreateBeeTransaction(int beeCount, CWalletTx& wtxNew, CReserveKey& reservekeyChange, CReserveKey& reservekeyHoney, std::string honeyAddress, std::string changeAddress, bool communityContrib, std::string& strFailReason, const Consensus::Params& consensusParams) {
     CBlockIndex* pindexPrev = chainActive.Tip();
@@ -3089,6 +3964,34 @@ bool CWallet::CreateTransaction(const std::vector<CRecipient>& vecSend, CWalletT
             size_t change_prototype_size = GetSerializeSize(change_prototype_txout, SER_DISK, 0);
 
             CFeeRate discard_rate = GetDiscardRate(::feeEstimator);
+
+            // Changeless branch-and-bound selection needs the fee for
+            // everything but the inputs up front. It only makes sense on the
+            // first selection, while the fee is still unknown, and is skipped
+            // for preset inputs and fee-subtracting sends.
+            CoinSelectionParams coin_selection_params;
+            coin_selection_params.use_bnb = nSubtractFeeFromAmount == 0 && !coin_control.HasSelected();
+            coin_selection_params.effective_fee = CFeeRate(GetMinimumFee(1000, coin_control, ::mempool, ::feeEstimator, nullptr));
+            {
+                size_t nNoInputsSize = 4 + 4 + 1 + GetSizeOfCompactSize(vecSend.size()); // version, locktime, vin count, vout count
+                for (const auto& recipient : vecSend)
+                    nNoInputsSize += GetSerializeSize(CTxOut(recipient.nAmount, recipient.scriptPubKey), SER_NETWORK, PROTOCOL_VERSION);
+                coin_selection_params.nFeeNoInputs = coin_selection_params.effective_fee.GetFee(nNoInputsSize);
+
+                // A change output is roughly as expensive to spend later as a
+                // legacy input; use that when we cannot sign for the script.
+                int nChangeSpendSize = 148;
+                CMutableTransaction txDummy;
+                txDummy.vin.emplace_back();
+                SignatureData sigdata;
+                if (ProduceSignature(DummySignatureCreator(this), scriptChange, sigdata)) {
+                    UpdateTransaction(txDummy, 0, sigdata);
+                    nChangeSpendSize = GetVirtualTransactionSize(txDummy) - GetVirtualTransactionSize(CMutableTransaction());
+                }
+                coin_selection_params.nCostOfChange = coin_selection_params.effective_fee.GetFee(change_prototype_size) + discard_rate.GetFee(nChangeSpendSize);
+            }
+            bool fBnBUsed = false;
+
             nFeeRet = 0;
             bool pick_new_inputs = true;
             CAmount nValueIn = 0;
@@ -3142,16 +4045,24 @@ bool CWallet::CreateTransaction(const std::vector<CRecipient>& vecSend, CWalletT
                 if (pick_new_inputs) {
                     nValueIn = 0;
                     setCoins.clear();
-                    if (!SelectCoins(vAvailableCoins, nValueToSelect, setCoins, nValueIn, &coin_control))
+                    if (!SelectCoins(vAvailableCoins, nValueToSelect, setCoins, nValueIn, &coin_control, &coin_selection_params, &fBnBUsed))
                     {
                         strFailReason = _("Insufficient funds");
                         return false;
                     }
+                    coin_selection_params.use_bnb = false;
                 }
 
                 const CAmount nChange = nValueIn - nValueToSelect;
 
-                if (nChange > 0)
+                if (nChange > 0 && fBnBUsed)
+                {
+                    // The selection was built to leave no change; the excess
+                    // is at most the cost of a change output and goes to fees.
+                    nChangePosInOut = -1;
+                    nFeeRet += nChange;
+                }
+                else if (nChange > 0)
                 {
                     // Fill a vout to ourself
                     CTxOut newTxOut(nChange, scriptChange);
@@ -3233,7 +4144,7 @@ bool CWallet::CreateTransaction(const std::vector<CRecipient>& vecSend, CWalletT
                     // new inputs. We now know we only need the smaller fee
                     // (because of reduced tx size) and so we should add a
                     // change output. Only try this once.
-                    if (nChangePosInOut == -1 && nSubtractFeeFromAmount == 0 && pick_new_inputs) {
+                    if (nChangePosInOut == -1 && nSubtractFeeFromAmount == 0 && pick_new_inputs && !fBnBUsed) {
                         unsigned int tx_size_with_change = nBytes + change_prototype_size + 2; // Add 2 as a buffer in case increasing # of outputs changes compact size
                         CAmount fee_needed_with_change = GetMinimumFee(tx_size_with_change, coin_control, ::mempool, ::feeEstimator, nullptr);
                         CAmount minimum_value_for_change = GetDustThreshold(change_prototype_txout, discard_rate);
@@ -3454,6 +4365,8 @@ DBErrors CWallet::ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256
     DBErrors nZapSelectTxRet = CWalletDB(*dbw,"cr+").ZapSelectTx(vHashIn, vHashOut);
     for (uint256 hash : vHashOut)
         mapWallet.erase(hash);
+    fUnspentValid = false;
+    fBeeTableValid = false;
 
     if (nZapSelectTxRet == DB_NEED_REWRITE)
     {
@@ -4395,6 +5308,7 @@ CWallet* CWallet::CreateWalletFromFile(const std::string walletFile)
 }
 
 std::atomic<bool> CWallet::fFlushScheduled(false);
+std::atomic<bool> CWallet::fHoneyConsolidateScheduled(false);
 
 void CWallet::postInitProcess(CScheduler& scheduler)
 {
@@ -4406,6 +5320,17 @@ void CWallet::postInitProcess(CScheduler& scheduler)
     if (!CWallet::fFlushScheduled.exchange(true)) {
         scheduler.scheduleEvery(MaybeCompactWalletDB, 500);
     }
+
+    // Maza: Hive: Periodically sweep mature honey into fewer outputs
+    honeyConsolidation.fEnabled = gArgs.GetBoolArg("-honeyconsolidate", DEFAULT_HONEY_CONSOLIDATE);
+    CAmount nMaxFeeRate;
+    if (gArgs.IsArgSet("-honeyconsolidatefeerate") && ParseMoney(gArgs.GetArg("-honeyconsolidatefeerate", ""), nMaxFeeRate))
+        honeyConsolidation.maxFeeRate = CFeeRate(nMaxFeeRate);
+    honeyConsolidation.nBatchSize = std::min<int64_t>(MAX_HONEY_CONSOLIDATE_BATCH, std::max<int64_t>(2, gArgs.GetArg("-honeyconsolidatebatch", DEFAULT_HONEY_CONSOLIDATE_BATCH)));
+    honeyConsolidation.nMinInputs = std::max<int64_t>(2, gArgs.GetArg("-honeyconsolidatemin", DEFAULT_HONEY_CONSOLIDATE_MIN));
+    if (!CWallet::fHoneyConsolidateScheduled.exchange(true)) {
+        scheduler.scheduleEvery(MaybeConsolidateHoney, HONEY_CONSOLIDATE_INTERVAL);
+    }
 }
 
 bool CWallet::BackupWallet(const std::string& strDest)
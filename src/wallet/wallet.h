@@ -7,6 +7,7 @@
 #define BITCOIN_WALLET_WALLET_H
 
 #include <amount.h>
+#include <blockfilter.h>
 #include <policy/feerate.h>
 #include <streams.h>
 #include <tinyformat.h>
@@ -57,6 +58,30 @@ static const CAmount WALLET_INCREMENTAL_RELAY_FEE = 5000;
 static const CAmount MIN_CHANGE = CENT;
 //! final minimum change amount after paying for fees
 static const CAmount MIN_FINAL_CHANGE = MIN_CHANGE/2;
+//! feerate (per kB) above which the knapsack fallback stops sweeping small inputs
+static const CAmount DEFAULT_CONSOLIDATE_FEERATE = 10000;
+//! upper bound on coin visits made by the stochastic subset solver per pass
+static const unsigned int MAX_APPROXIMATE_BEST_SUBSET_VISITS = 1000000;
+//! -honeyconsolidate default
+static const bool DEFAULT_HONEY_CONSOLIDATE = false;
+//! -honeyconsolidatebatch default: most honey outputs swept by one consolidation transaction
+static const unsigned int DEFAULT_HONEY_CONSOLIDATE_BATCH = 500;
+//! most honey outputs one consolidation transaction can sweep: P2PKH inputs of up to 148 bytes under MAX_STANDARD_TX_WEIGHT
+static const unsigned int MAX_HONEY_CONSOLIDATE_BATCH = 650;
+//! -honeyconsolidatemin default: fewest mature honey outputs worth consolidating
+static const unsigned int DEFAULT_HONEY_CONSOLIDATE_MIN = 100;
+//! how often the scheduler considers consolidating honey, in milliseconds
+static const int64_t HONEY_CONSOLIDATE_INTERVAL = 10 * 60 * 1000;
+//! confirmation target used to ask the fee estimator about consolidation fees
+static const unsigned int HONEY_CONSOLIDATE_CONF_TARGET = 144;
+//! most transactions waiting to be re-indexed in the BCT table before it is rebuilt from scratch instead
+static const unsigned int MAX_BEE_TABLE_DIRTY = 10000;
+//! -rescanthreads default: 0 means one thread per core, up to MAX_RESCAN_THREADS
+static const int DEFAULT_RESCAN_THREADS = 0;
+//! most threads reading and matching blocks during a rescan
+static const int MAX_RESCAN_THREADS = 16;
+//! blocks a rescan reads ahead of the one it is adding to the wallet
+static const int WALLET_RESCAN_PREFETCH = 64;
 //! Default for -spendzeroconfchange
 static const bool DEFAULT_SPEND_ZEROCONF_CHANGE = true;
 //! Default for -walletrejectlongchains
@@ -442,18 +467,7 @@ public:
     }
 
     //! make sure balances are recalculated
-    void MarkDirty()
-    {
-        fCreditCached = false;
-        fAvailableCreditCached = false;
-        fImmatureCreditCached = false;
-        fWatchDebitCached = false;
-        fWatchCreditCached = false;
-        fAvailableWatchCreditCached = false;
-        fImmatureWatchCreditCached = false;
-        fDebitCached = false;
-        fChangeCached = false;
-    }
+    void MarkDirty();
 
     void BindWallet(CWallet *pwalletIn)
     {
@@ -508,10 +522,13 @@ public:
 
         outpoint = COutPoint(walletTx->GetHash(), i);
         txout = walletTx->tx->vout[i];
+        effective_value = txout.nValue;
     }
 
     COutPoint outpoint;
     CTxOut txout;
+    //! value of the output net of the fee needed to spend it
+    CAmount effective_value;
 
     bool operator<(const CInputCoin& rhs) const {
         return outpoint < rhs.outpoint;
@@ -526,6 +543,30 @@ public:
     }
 };
 
+/** Fee parameters used to turn coin values into effective values during selection. */
+struct CoinSelectionParams
+{
+    bool use_bnb;
+    //! fee paid for the transaction's fixed overhead and recipient outputs
+    CAmount nFeeNoInputs;
+    //! fee for creating a change output now plus spending it later
+    CAmount nCostOfChange;
+    CFeeRate effective_fee;
+    CFeeRate consolidate_fee;
+
+    CoinSelectionParams() : use_bnb(false), nFeeNoInputs(0), nCostOfChange(0), consolidate_fee(DEFAULT_CONSOLIDATE_FEERATE) {}
+};
+
+/**
+ * Depth-first branch-and-bound search for an input set whose effective value
+ * lands in [nTargetValue, nTargetValue + nCostOfChange], so that no change
+ * output is needed. vUtxoPool must only hold coins with a positive effective
+ * value and is sorted in place. Returns false when no such set was found
+ * within the search budget.
+ */
+bool SelectCoinsBnB(std::vector<CInputCoin>& vUtxoPool, const CAmount& nTargetValue, const CAmount& nCostOfChange,
+                    std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet);
+
 class COutput
 {
 public:
@@ -685,13 +726,149 @@ struct CBeeCreationTransactionInfo
 // Maza: Hive: Mining optimisations: Bee range structure
 struct CBeeRange
 {
-    std::string txid;
-    std::string honeyAddress;
+    uint256 txid;
+    CTxDestination honeyDestination;
     bool communityContrib;
     int offset;
     int count;
 };
 
+// Maza: Hive: A BCT of this wallet as the hive miner sees it, see CBeeTable
+struct CBeeTableEntry
+{
+    uint256 txid;
+    CTxDestination honeyDestination;
+    bool communityContrib;
+    int beeCount;
+    int nHeight;            //!< height of the block containing the BCT
+    int nMatureHeight;      //!< first tip height on which its bees can mine
+    int nExpiryHeight;      //!< last tip height on which its bees can mine
+};
+
+/**
+ * Maza: Hive: BCTs ordered by the height of their block. Every BCT matures
+ * and expires the same number of blocks after its own, so the bees able to
+ * mine on a tip are a contiguous slice of the table.
+ */
+class CBeeTable
+{
+private:
+    std::vector<CBeeTableEntry> vEntries;   //!< ordered by nHeight, then txid
+    std::map<uint256, int> mapHeights;
+
+public:
+    //! Add an entry, replacing any entry for the same BCT
+    void Add(const CBeeTableEntry& entry);
+    void Remove(const uint256& txid);
+    void Clear();
+    size_t size() const { return vEntries.size(); }
+
+    /**
+     * Split the bees that can mine on a tip at nTipHeight into at most nBins
+     * bins of the same size, in table order. Returns the number of bees.
+     */
+    int GetBins(int nTipHeight, int nBins, std::vector<std::vector<CBeeRange>>& vBins) const;
+};
+
+/**
+ * An unspent output paying to this wallet, as held in CWallet::mapWalletUnspent.
+ * The depth class is derived from nHeight and the current tip, so an entry
+ * only has to be refreshed when its transaction (or a spend of it) changes.
+ */
+struct CWalletUnspent
+{
+    const CWalletTx* wtx;
+    CAmount nValue;
+    isminetype mine;
+    int nHeight;        //!< height of the block containing wtx, or -1 if it was unconfirmed when indexed
+    bool fCoinBase;     //!< subject to COINBASE_MATURITY
+    bool fHoney;        //!< Maza: Hive: output of a hive coinbase (honey)
+
+    CWalletUnspent(const CWalletTx* wtxIn, CAmount nValueIn, isminetype mineIn, int nHeightIn, bool fCoinBaseIn, bool fHoneyIn) :
+        wtx(wtxIn), nValue(nValueIn), mine(mineIn), nHeight(nHeightIn), fCoinBase(fCoinBaseIn), fHoney(fHoneyIn) {}
+};
+
+/** Per-category wallet balances, see CWallet::GetBalances(). */
+struct CWalletBalances
+{
+    CAmount nTrusted = 0;
+    CAmount nUntrustedPending = 0;
+    CAmount nImmature = 0;
+    CAmount nWatchTrusted = 0;
+    CAmount nWatchUntrustedPending = 0;
+    CAmount nWatchImmature = 0;
+};
+
+/** Maza: Hive: Settings and progress of automatic honey consolidation, see CWallet::ConsolidateHoney(). */
+struct CHoneyConsolidationState
+{
+    bool fEnabled = DEFAULT_HONEY_CONSOLIDATE;
+    //! only consolidate while the estimated feerate is at or below this
+    CFeeRate maxFeeRate = CFeeRate(DEFAULT_CONSOLIDATE_FEERATE);
+    unsigned int nBatchSize = DEFAULT_HONEY_CONSOLIDATE_BATCH;
+    unsigned int nMinInputs = DEFAULT_HONEY_CONSOLIDATE_MIN;
+    //! where consolidated honey goes; empty to pay back to the honey script
+    CScript scriptDest;
+
+    int64_t nLastCheck = 0;
+    CFeeRate lastFeeRate;
+    std::string strLastResult;
+    unsigned int nTransactions = 0;
+    unsigned int nInputs = 0;
+    CAmount nAmount = 0;
+    CAmount nFees = 0;
+    uint256 lastTxid;
+};
+
+/** Maza: Hive: The honey outputs to sweep next, from vHoney sorted smallest first; at most nBatchSize of them, capped at MAX_HONEY_CONSOLIDATE_BATCH */
+std::vector<CInputCoin> SelectHoneyBatch(const std::vector<CInputCoin>& vHoney, unsigned int nBatchSize);
+
+/** Maza: Hive: Fee rate to consolidate honey at given the fee estimate, falling back to -fallbackfee without one; zero if unknown */
+CFeeRate GetHoneyConsolidationFeeRate(const CFeeRate& estimate);
+
+/** Progress and throughput of the running or last finished rescan, see CWallet::ScanForWalletTransactions(). */
+struct CWalletRescanStats
+{
+    bool fInProgress = false;
+    int nStartHeight = -1;
+    int nStopHeight = -1;
+    //! last block added to the wallet
+    int nHeight = -1;
+    int nThreads = 0;
+    int64_t nBlocks = 0;
+    //! blocks skipped because their BIP 158 filter matched none of the wallet's scripts
+    int64_t nFiltered = 0;
+    //! transactions that matched the wallet's keys and scripts
+    int64_t nMatched = 0;
+    //! in microseconds
+    int64_t nStartTime = 0;
+    int64_t nDuration = 0;
+};
+
+/**
+ * Keys and scripts of a wallet that a rescan matches block outputs against,
+ * without taking any wallet lock. Matching errs on the side of caution: an
+ * output IsMine() accepts always matches, while the few false positives (like
+ * a multisig output with only some of its keys ours) are weeded out by
+ * AddToWalletIfInvolvingMe.
+ */
+class CWalletScanFilter
+{
+public:
+    //! sorted key ids and script ids
+    std::vector<uint160> vHashes;
+    //! watch-only scripts, matched as a whole
+    std::set<CScript> setScripts;
+    //! output scripts the wallet's keys and scripts can appear as, queried against block filters
+    GCSFilter::ElementSet setElements;
+    //! CWallet::KeyStoreSize() when the filter was filled
+    size_t nKeyStoreSize = 0;
+
+    bool Contains(const uint160& hash) const;
+    bool MatchesOutput(const CScript& scriptPubKey) const;
+    bool MatchesTransaction(const CTransaction& tx) const;
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet is an extension of a keystore, which also maintains a set of transactions and balances,
@@ -701,18 +878,26 @@ class CWallet final : public CCryptoKeyStore, public CValidationInterface
 {
 private:
     static std::atomic<bool> fFlushScheduled;
+    static std::atomic<bool> fHoneyConsolidateScheduled;
     std::atomic<bool> fAbortRescan;
     std::atomic<bool> fScanningWallet; //controlled by WalletRescanReserver
     std::mutex mutexScanning;
     friend class WalletRescanReserver;
 
+    mutable CCriticalSection cs_rescanStats;
+    CWalletRescanStats rescanStats;
+
+    /** Number of keys, scripts and watch-only entries; grows when the keypool is topped up */
+    size_t KeyStoreSize() const;
+
 
     /**
      * Select a set of coins such that nValueRet >= nTargetValue and at least
      * all coins from coinControl are selected; Never select unconfirmed coins
      * if they are not ours
      */
-    bool SelectCoins(const std::vector<COutput>& vAvailableCoins, const CAmount& nTargetValue, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet, const CCoinControl *coinControl = nullptr) const;
+    bool SelectCoins(const std::vector<COutput>& vAvailableCoins, const CAmount& nTargetValue, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet, const CCoinControl *coinControl = nullptr,
+                     const CoinSelectionParams* params = nullptr, bool* pfBnBUsed = nullptr) const;
 
     CWalletDB *pwalletdbEncryption;
 
@@ -741,6 +926,39 @@ private:
 
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>);
 
+    /**
+     * Unspent outputs paying to this wallet, kept in step with mapWallet so
+     * that balance and coin queries need not walk every transaction.
+     * Transactions changed since the last query are listed in setUnspentDirty
+     * and re-indexed by RefreshUnspent(); fUnspentValid == false forces a full
+     * rebuild (after a reorg, a zap or a keystore change).
+     */
+    mutable std::map<COutPoint, CWalletUnspent> mapWalletUnspent;
+    mutable std::set<COutPoint> setUnspentPending;  //!< entries with nHeight == -1
+    mutable std::set<uint256> setUnspentDirty;
+    mutable bool fUnspentValid;
+
+    //! Balances of the entries confirmed when indexed, valid for pindexBalances
+    mutable CWalletBalances cachedBalances;
+    mutable const CBlockIndex* pindexBalances;
+
+    void IndexUnspent(const uint256& hash) const;
+    void RefreshUnspent() const;
+
+    /**
+     * Maza: Hive: This wallet's BCTs for the hive miner. Wallet transactions
+     * of connected and disconnected blocks are listed in setBeeTableDirty,
+     * up to MAX_BEE_TABLE_DIRTY of them, and re-indexed by RefreshBeeTable();
+     * fBeeTableValid == false forces a full rebuild (after a rescan, a zap, a
+     * keystore change or an overflow of the list).
+     */
+    mutable CBeeTable beeTable;
+    mutable std::set<uint256> setBeeTableDirty;
+    mutable bool fBeeTableValid;
+
+    void IndexBeeTable(const uint256& hash, const CScript& scriptPubKeyBCF, const CScript& scriptPubKeyCF) const;
+    void MarkBeeTableDirty(const uint256& hash);
+
     /* Used by TransactionAddedToMemorypool/BlockConnected/Disconnected.
      * Should be called with pindexBlock and posInBlock if this is for a transaction that is included in a block. */
     void SyncTransaction(const CTransactionRef& tx, const CBlockIndex *pindex = nullptr, int posInBlock = 0);
@@ -855,6 +1073,9 @@ public:
         nRelockTime = 0;
         fAbortRescan = false;
         fScanningWallet = false;
+        fUnspentValid = false;
+        pindexBalances = nullptr;
+        fBeeTableValid = false;
     }
 
     std::map<uint256, CWalletTx> mapWallet;
@@ -896,12 +1117,18 @@ public:
      * Shuffle and select coins until nTargetValue is reached while avoiding
      * small change; This method is stochastic for some inputs and upon
      * completion the coin set and corresponding actual target value is
-     * assembled
+     * assembled. When params are given and allow it, a changeless
+     * branch-and-bound solution is tried first and *pfBnBUsed reports
+     * whether it was taken.
      */
-    bool SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, uint64_t nMaxAncestors, std::vector<COutput> vCoins, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet) const;
+    bool SelectCoinsMinConf(const CAmount& nTargetValue, int nConfMine, int nConfTheirs, uint64_t nMaxAncestors, const std::vector<COutput>& vCoins, std::set<CInputCoin>& setCoinsRet, CAmount& nValueRet,
+                            const CoinSelectionParams* params = nullptr, bool* pfBnBUsed = nullptr) const;
 
     bool IsSpent(const uint256& hash, unsigned int n) const;
 
+    //! Queue a transaction for re-indexing in mapWalletUnspent
+    void MarkUnspentDirty(const uint256& hash) const;
+
     bool IsLockedCoin(uint256 hash, unsigned int n) const;
     void LockCoin(const COutPoint& output);
     void UnlockCoin(const COutPoint& output);
@@ -914,6 +1141,9 @@ public:
     void AbortRescan() { fAbortRescan = true; }
     bool IsAbortingRescan() { return fAbortRescan; }
     bool IsScanning() { return fScanningWallet; }
+    CWalletRescanStats GetRescanStats() const;
+    /** Snapshot the keys and scripts a rescan matches blocks against */
+    void FillScanFilter(CWalletScanFilter& filter) const;
 
     /**
      * keystore implementation
@@ -984,11 +1214,12 @@ public:
     bool AddToWalletIfInvolvingMe(const CTransactionRef& tx, const CBlockIndex* pIndex, int posInBlock, bool fUpdate);
     int64_t RescanFromTime(int64_t startTime, const WalletRescanReserver& reserver, bool update);
     CBlockIndex* ScanForWalletTransactions(CBlockIndex* pindexStart, CBlockIndex* pindexStop, const WalletRescanReserver& reserver, bool fUpdate = false);
-    void TransactionRemovedFromMempool(const CTransactionRef &ptx) override;
+    void TransactionRemovedFromMempool(const CTransactionRef &ptx, MemPoolRemovalReason reason) override;
     void ReacceptWalletTransactions();
     void ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman) override;
     // ResendWalletTransactionsBefore may only be called if fBroadcastTransactions!
     std::vector<uint256> ResendWalletTransactionsBefore(int64_t nTime, CConnman* connman);
+    CWalletBalances GetBalances() const;
     CAmount GetBalance() const;
     CAmount GetUnconfirmedBalance() const;
     CAmount GetImmatureBalance() const;
@@ -1009,6 +1240,21 @@ public:
     // Maza: Hive: Return all BCTs known by this wallet, optionally including dead bees and optionally scanning for blocks minted by bees from each BCT
     std::vector<CBeeCreationTransactionInfo> GetBCTs(bool includeDead, bool scanRewards, const Consensus::Params& consensusParams, int minHoneyConfirmations = 1);
 
+    // Maza: Hive: Bring the BCT table up to date with mapWallet
+    void RefreshBeeTable() const;
+
+    // Maza: Hive: Split the bees that can mine on a tip at nTipHeight into at most nBins bins, returning the number of bees
+    int GetBeeBins(int nTipHeight, int nBins, std::vector<std::vector<CBeeRange>>& vBins) const;
+
+    // Maza: Hive: Automatic honey consolidation settings and progress
+    CHoneyConsolidationState honeyConsolidation;
+
+    // Maza: Hive: Return spendable mature honey outputs, smallest first
+    std::vector<CInputCoin> GetMatureHoney() const;
+
+    // Maza: Hive: Sweep a batch of mature honey into one output if enabled and fees are low enough. Returns true if a transaction was sent.
+    bool ConsolidateHoney();
+
     /**
      * Insert additional inputs into the transaction by
      * calling CreateTransaction();
@@ -16,6 +16,8 @@ static const char *MSG_HASHBLOCK = "hashblock";
 static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
+static const char *MSG_RAWHIVEBLOCK = "rawhiveblock";
+static const char *MSG_HASHHIVEINFO = "hashhiveinfo";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -60,6 +62,30 @@ static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
     return 0;
 }
 
+// Internal function to send one message part, copying the data
+static int zmq_send_copy(void *sock, const void* data, size_t size, int flags)
+{
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, size) != 0)
+    {
+        zmqError("Unable to initialize ZMQ msg");
+        return -1;
+    }
+    memcpy(zmq_msg_data(&msg), data, size);
+    int rc = zmq_msg_send(&msg, sock, flags);
+    if (rc == -1)
+    {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+    }
+    return rc;
+}
+
+static void zmq_free_vector(void * /*data*/, void *hint)
+{
+    delete static_cast<std::vector<unsigned char>*>(hint);
+}
+
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 {
     assert(!psocket);
@@ -76,7 +102,17 @@ bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
             return false;
         }
 
-        int rc = zmq_bind(psocket, address.c_str());
+        LogPrint(BCLog::ZMQ, "zmq: Outbound message high water mark for %s at %s is %d\n", type, address, outbound_message_high_water_mark);
+
+        int rc = zmq_setsockopt(psocket, ZMQ_SNDHWM, &outbound_message_high_water_mark, sizeof(outbound_message_high_water_mark));
+        if (rc != 0)
+        {
+            zmqError("Failed to set outbound message high water mark");
+            zmq_close(psocket);
+            return false;
+        }
+
+        rc = zmq_bind(psocket, address.c_str());
         if (rc!=0)
         {
             zmqError("Failed to bind address");
@@ -91,6 +127,9 @@ bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
     else
     {
         LogPrint(BCLog::ZMQ, "zmq: Reusing socket for address %s\n", address);
+        if (outbound_message_high_water_mark != i->second->outbound_message_high_water_mark)
+            LogPrint(BCLog::ZMQ, "zmq: Outbound message high water mark of the shared socket is %d, ignoring %d for %s\n",
+                     i->second->outbound_message_high_water_mark, outbound_message_high_water_mark, type);
 
         psocket = i->second->psocket;
         mapPublishNotifiers.insert(std::make_pair(address, this));
@@ -146,6 +185,59 @@ bool CZMQAbstractPublishNotifier::SendMessage(const char *command, const void* d
     return true;
 }
 
+bool CZMQAbstractPublishNotifier::SendMessage(const char *command, std::vector<unsigned char>&& data)
+{
+    assert(psocket);
+
+    // ZMQ takes ownership of the body and frees it once sent, so large
+    // bodies like blocks are never copied
+    std::vector<unsigned char>* pdata = new std::vector<unsigned char>(std::move(data));
+    zmq_msg_t body;
+    if (zmq_msg_init_data(&body, pdata->data(), pdata->size(), zmq_free_vector, pdata) != 0)
+    {
+        zmqError("Unable to initialize ZMQ msg");
+        delete pdata;
+        return false;
+    }
+
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(&msgseq[0], nSequence);
+    if (zmq_send_copy(psocket, command, strlen(command), ZMQ_SNDMORE) == -1)
+    {
+        zmq_msg_close(&body);
+        return false;
+    }
+    if (zmq_msg_send(&body, psocket, ZMQ_SNDMORE) == -1)
+    {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&body);
+        return false;
+    }
+    if (zmq_send_copy(psocket, msgseq, sizeof(msgseq), 0) == -1)
+        return false;
+
+    nSequence++;
+
+    return true;
+}
+
+/** Serialized block for publishing */
+static bool ReadBlockForPublish(const CBlockIndex *pindex, std::vector<unsigned char>& vch)
+{
+    // Blocks are stored with witness data, so unless witnesses are to be
+    // left out (-rpcserialversion=0) the bytes on disk are published as
+    // they are, without deserializing and checking the block again
+    if (!(RPCSerializationFlags() & SERIALIZE_TRANSACTION_NO_WITNESS))
+        return ReadRawBlockFromDisk(vch, pindex, Params().MessageStart());
+
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
+        return false;
+    CVectorWriter ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags(), vch, 0);
+    ss << block;
+    return true;
+}
+
 bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     uint256 hash = pindex->GetBlockHash();
@@ -170,21 +262,14 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish rawblock %s\n", pindex->GetBlockHash().GetHex());
 
-    const Consensus::Params& consensusParams = Params().GetConsensus();
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
+    std::vector<unsigned char> block;
+    if (!ReadBlockForPublish(pindex, block))
     {
-        LOCK(cs_main);
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, consensusParams))
-        {
-            zmqError("Can't read block from disk");
-            return false;
-        }
-
-        ss << block;
+        zmqError("Can't read block from disk");
+        return false;
     }
 
-    return SendMessage(MSG_RAWBLOCK, &(*ss.begin()), ss.size());
+    return SendMessage(MSG_RAWBLOCK, std::move(block));
 }
 
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
@@ -195,3 +280,49 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     ss << transaction;
     return SendMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
 }
+
+bool CZMQPublishRawHiveBlockNotifier::NotifyBlockConnected(const CBlock &block, const CBlockIndex *pindex)
+{
+    if (!block.IsHiveMined(Params().GetConsensus()))
+        return true;
+
+    LogPrint(BCLog::ZMQ, "zmq: Publish rawhiveblock %s\n", pindex->GetBlockHash().GetHex());
+    std::vector<unsigned char> data;
+    CVectorWriter ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags(), data, 0);
+    ss << block;
+    return SendMessage(MSG_RAWHIVEBLOCK, std::move(data));
+}
+
+bool CZMQPublishHashHiveInfoNotifier::NotifyBlockConnected(const CBlock &block, const CBlockIndex *pindex)
+{
+    if (!block.IsHiveMined(Params().GetConsensus()))
+        return true;
+
+    // The hive proof in the coinbase (see CheckHiveProof): OP_RETURN OP_BEE,
+    // bee nonce, BCT height, community contribution flag, BCT txid as hex
+    const CScript& proof = block.vtx[0]->vout[0].scriptPubKey;
+    if (proof.size() < 144)
+    {
+        zmqError("Malformed hive proof");
+        return true;
+    }
+    uint32_t beeNonce = ReadLE32(&proof[3]);
+    uint32_t bctHeight = ReadLE32(&proof[8]);
+    bool communityContrib = proof[12] == OP_TRUE;
+    uint256 bctTxid = uint256S(std::string(&proof[14], &proof[14 + 64]));
+
+    uint256 hash = pindex->GetBlockHash();
+    LogPrint(BCLog::ZMQ, "zmq: Publish hashhiveinfo %s\n", hash.GetHex());
+
+    /* block hash, BCT txid, bee nonce (LE), BCT height (LE), community contribution flag */
+    unsigned char data[32 + 32 + 4 + 4 + 1];
+    for (unsigned int i = 0; i < 32; i++)
+    {
+        data[31 - i] = hash.begin()[i];
+        data[63 - i] = bctTxid.begin()[i];
+    }
+    WriteLE32(&data[64], beeNonce);
+    WriteLE32(&data[68], bctHeight);
+    data[72] = communityContrib ? 1 : 0;
+    return SendMessage(MSG_HASHHIVEINFO, data, sizeof(data));
+}
@@ -7,6 +7,8 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <vector>
+
 class CBlockIndex;
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
@@ -24,6 +26,9 @@ public:
     */
     bool SendMessage(const char *command, const void* data, size_t size);
 
+    /* same, handing the data over to ZMQ instead of copying it */
+    bool SendMessage(const char *command, std::vector<unsigned char>&& data);
+
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
 };
@@ -52,4 +57,18 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+// Maza: Hive: Raw hive mined blocks
+class CZMQPublishRawHiveBlockNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBlockConnected(const CBlock &block, const CBlockIndex *pindex) override;
+};
+
+// Maza: Hive: Hash of hive mined blocks with the bee that mined them
+class CZMQPublishHashHiveInfoNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBlockConnected(const CBlock &block, const CBlockIndex *pindex) override;
+};
+
 #endif // BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Maza developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test ZMQ raw block publishing and measure publish latency.
+
+Raw blocks are published from the bytes stored on disk: check they match
+getblock, that hive topics stay quiet for PoW blocks, and report how long
+a local subscriber waits for a block after it was generated.
+"""
+import configparser
+import os
+import struct
+import time
+
+from test_framework.test_framework import BitcoinTestFramework, SkipTest
+from test_framework.util import (assert_equal,
+                                 bytes_to_hex_str,
+                                 hash256,
+                                )
+
+class ZMQPublishTest (BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def setup_nodes(self):
+        try:
+            import zmq
+        except ImportError:
+            raise SkipTest("python3-zmq module not available.")
+
+        config = configparser.ConfigParser()
+        if not self.options.configfile:
+            self.options.configfile = os.path.abspath(os.path.join(os.path.dirname(__file__), "../config.ini"))
+        config.read_file(open(self.options.configfile))
+
+        if not config["components"].getboolean("ENABLE_ZMQ"):
+            raise SkipTest("mazad has not been built with zmq enabled.")
+
+        address = "tcp://127.0.0.1:28333"
+        self.zmq_context = zmq.Context()
+        self.socket = self.zmq_context.socket(zmq.SUB)
+        self.socket.set(zmq.RCVTIMEO, 60000)
+        self.socket.set(zmq.RCVHWM, 0)
+        self.socket.connect(address)
+        for topic in [b"hashblock", b"rawblock", b"rawhiveblock", b"hashhiveinfo"]:
+            self.socket.setsockopt(zmq.SUBSCRIBE, topic)
+
+        self.extra_args = [["-zmqpubhashblock=%s" % address,
+                            "-zmqpubrawblock=%s" % address,
+                            "-zmqpubrawhiveblock=%s" % address,
+                            "-zmqpubhashhiveinfo=%s" % address,
+                            "-zmqpubrawblockhwm=10000"]]
+        self.add_nodes(self.num_nodes, self.extra_args)
+        self.start_nodes()
+
+    def run_test(self):
+        try:
+            self._zmq_test()
+        finally:
+            self.log.debug("Destroying ZMQ context")
+            self.zmq_context.destroy(linger=None)
+
+    def receive(self, expected_topic, expected_sequence):
+        topic, body, seq = self.socket.recv_multipart()
+        assert_equal(topic, expected_topic)
+        assert_equal(struct.unpack('<I', seq)[-1], expected_sequence)
+        return body
+
+    def _zmq_test(self):
+        # Leave initial block download, hive topics are only published after it
+        self.nodes[0].generate(1)
+        self.receive(b"hashblock", 0)
+        self.receive(b"rawblock", 0)
+
+        num_blocks = 50
+        self.log.info("Generate %d blocks one at a time" % num_blocks)
+        latencies = []
+        for i in range(num_blocks):
+            start = time.time()
+            blockhash = self.nodes[0].generate(1)[0]
+            assert_equal(bytes_to_hex_str(self.receive(b"hashblock", i + 1)), blockhash)
+            raw = self.receive(b"rawblock", i + 1)
+            latencies.append(time.time() - start)
+
+            # The published bytes are the block exactly as served by getblock
+            assert_equal(bytes_to_hex_str(hash256(raw[:80])), blockhash)
+            assert_equal(bytes_to_hex_str(raw), self.nodes[0].getblock(blockhash, 0))
+
+        latencies.sort()
+        self.log.info("Block generation to rawblock receipt: median %.2fms, max %.2fms" %
+                      (latencies[len(latencies) // 2] * 1000, latencies[-1] * 1000))
+
+        # PoW blocks are not announced on the hive topics
+        import zmq
+        self.socket.set(zmq.RCVTIMEO, 1000)
+        try:
+            topic = self.socket.recv_multipart()[0]
+            raise AssertionError("Unexpected %s notification" % topic)
+        except zmq.error.Again:
+            pass
+
+if __name__ == '__main__':
+    ZMQPublishTest().main()
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Maza developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test block download from several peers with adaptive windows.
+
+Three nodes share a chain; a fresh node syncs it from all of them at once.
+Checks that the download completes, that every peer reports its download
+window and measurements in getpeerinfo, and logs the sync speed so runs can
+be compared.
+"""
+
+import time
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+    assert_greater_than_or_equal,
+    connect_nodes_bi,
+    connect_nodes,
+    sync_blocks,
+)
+
+CHAIN_LENGTH = 600
+MIN_BLOCK_DOWNLOAD_WINDOW = 2
+MAX_BLOCK_DOWNLOAD_WINDOW = 64
+
+class BlockDownloadTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 4
+
+    def setup_network(self):
+        self.setup_nodes()
+        connect_nodes_bi(self.nodes, 0, 1)
+        connect_nodes_bi(self.nodes, 0, 2)
+
+    def run_test(self):
+        self.log.info("Mining %d blocks on the serving nodes" % CHAIN_LENGTH)
+        self.nodes[0].generate(CHAIN_LENGTH)
+        sync_blocks(self.nodes[0:3], timeout=120)
+
+        syncing = self.nodes[3]
+        assert_equal(syncing.getblockcount(), 0)
+        for peer in self.nodes[0].getpeerinfo():
+            assert_equal(peer['download_window'], 16)
+
+        self.log.info("Syncing a fresh node from three peers")
+        start = time.time()
+        for i in range(3):
+            connect_nodes(syncing, i)
+        sync_blocks(self.nodes, timeout=300)
+        elapsed = time.time() - start
+        self.log.info("Downloaded %d blocks in %.2fs (%.1f blocks/s)" % (CHAIN_LENGTH, elapsed, CHAIN_LENGTH / elapsed))
+
+        peers = syncing.getpeerinfo()
+        assert_equal(len(peers), 3)
+        delivered = 0
+        for peer in peers:
+            assert_greater_than_or_equal(peer['download_window'], MIN_BLOCK_DOWNLOAD_WINDOW)
+            assert_greater_than_or_equal(MAX_BLOCK_DOWNLOAD_WINDOW, peer['download_window'])
+            assert_greater_than_or_equal(peer['download_latency'], 0)
+            assert_greater_than_or_equal(peer['download_bytes_per_sec'], 0)
+            assert_greater_than_or_equal(peer['blocks_rerequested'], 0)
+            self.log.info("peer=%d window=%d latency=%.3fs bytes/s=%d delivered=%d rerequested=%d" % (
+                peer['id'], peer['download_window'], peer['download_latency'], peer['download_bytes_per_sec'],
+                peer['blocks_delivered'], peer['blocks_rerequested']))
+            delivered += peer['blocks_delivered']
+        # Blocks moved to a faster peer may be delivered twice
+        assert_greater_than_or_equal(delivered, CHAIN_LENGTH)
+        assert_greater_than(max(peer['blocks_delivered'] for peer in peers), 0)
+
+if __name__ == '__main__':
+    BlockDownloadTest().main()
@@ -452,6 +452,8 @@ class CompactBlocksTest(BitcoinTestFramework):
             peer.send_and_ping(msg)
             assert_equal(int(node.getbestblockhash(), 16), tip)
 
+        stats_before = node.getcompactblockstats()
+
         # First try announcing compactblocks that won't reconstruct, and verify
         # that we receive getblocktxn messages back.
         utxo = self.utxos.pop(0)
@@ -518,6 +520,14 @@ class CompactBlocksTest(BitcoinTestFramework):
             # Shouldn't have gotten a request for any transaction
             assert("getblocktxn" not in test_node.last_message)
 
+        # The node counted the four compact blocks: three needed a round trip
+        # for 5, 3 and 1 transactions, the last was reconstructed right away
+        stats = node.getcompactblockstats()
+        for key, delta in [("blocks", 4), ("reconstructed", 1), ("roundtrips", 3), ("missing_txs", 9), ("extra_txs", 0)]:
+            assert_equal(stats[key] - stats_before[key], delta)
+        assert(stats["roundtrip_latency"] > 0)
+        assert(any(peer["roundtrips"] >= 3 for peer in stats["peers"]))
+
     # Incorrectly responding to a getblocktxn shouldn't cause the block to be
     # permanently failed.
     def test_incorrect_blocktxn_response(self, node, test_node, version):